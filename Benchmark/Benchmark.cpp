@@ -0,0 +1,306 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib> // For malloc, free
+#include <new>
+
+// =================================================================================================
+#pragma mark - Global operator new
+
+// Counts every allocation made through the global operator new. The array and nothrow
+// forms are defined in terms of this one by the standard library.
+
+static std::atomic<ZooLib::uint64> spAllocations(0);
+
+void* operator new(std::size_t iSize)
+	{
+	++spAllocations;
+	if (void* result = std::malloc(iSize ? iSize : 1))
+		return result;
+	throw std::bad_alloc();
+	}
+
+void operator delete(void* iPtr) noexcept
+	{ std::free(iPtr); }
+
+void operator delete(void* iPtr, std::size_t) noexcept
+	{ std::free(iPtr); }
+
+namespace ZooLib {
+namespace Benchmark {
+
+// =================================================================================================
+#pragma mark - EShape
+
+const char* sName(EShape iShape)
+	{
+	switch (iShape)
+		{
+		case EShape::Deep: return "deep";
+		case EShape::Wide: return "wide";
+		case EShape::Strings: return "strings";
+		case EShape::Numbers: return "numbers";
+		}
+	return "?";
+	}
+
+// =================================================================================================
+#pragma mark - Options
+
+Options::Options()
+:	fShapes{EShape::Deep, EShape::Wide, EShape::Strings, EShape::Numbers}
+,	fSize(1024 * 1024)
+,	fSeconds(0.5)
+,	fSeed(1)
+	{}
+
+// =================================================================================================
+#pragma mark - Corpus helpers (anonymous)
+
+namespace { // anonymous
+
+// xorshift32, so corpora are the same on every platform.
+class Rand
+	{
+public:
+	Rand(uint32 iSeed) : fState(iSeed ? iSeed : 1) {}
+
+	uint32 Next()
+		{
+		fState ^= fState << 13;
+		fState ^= fState >> 17;
+		fState ^= fState << 5;
+		return fState;
+		}
+
+	size_t Below(size_t iLimit)
+		{ return iLimit ? this->Next() % iLimit : 0; }
+
+	bool Chance(size_t iOneIn)
+		{ return this->Below(iOneIn) == 0; }
+
+private:
+	uint32 fState;
+	};
+
+std::string spString(Rand& ioRand, size_t iLength, bool iAllowNonASCII)
+	{
+	static const char spWords[][8] = { "alpha", "beta", "gamma", "delta", "zoo", "lib", "chan",
+		"pull", "push", "daton", "melange", "walker", "index", "query" };
+
+	std::string result;
+	while (result.size() < iLength)
+		{
+		if (not result.empty())
+			result += ' ';
+		if (iAllowNonASCII && ioRand.Chance(8))
+			result += "\xC3\xA9t\xC3\xA9 \xE2\x82\xAC"; // "été €"
+		else
+			result += spWords[ioRand.Below(sizeof(spWords) / sizeof(spWords[0]))];
+		}
+	return result;
+	}
+
+std::string spName(Rand& ioRand)
+	{
+	static const char spNames[][8] = { "id", "name", "kind", "size", "when", "owner", "flags",
+		"score", "parent", "label", "count", "ratio" };
+	return spNames[ioRand.Below(sizeof(spNames) / sizeof(spNames[0]))];
+	}
+
+// Adds the approximate JSON size of what it generates to ioSize. JSON has no binary type and
+// Util_ZZ_JSON writes Data as null, so that's what Data is counted as.
+Val_ZZ spScalar(Rand& ioRand, EShape iShape, size_t& ioSize)
+	{
+	switch (iShape == EShape::Numbers ? 0 : ioRand.Below(iShape == EShape::Strings ? 12 : 6))
+		{
+		case 0:
+			{
+			ioSize += 16;
+			if (ioRand.Chance(2))
+				return Val_ZZ(int64(ioRand.Next()) - 0x7FFFFFFF);
+			return Val_ZZ(double(ioRand.Next()) / 1024.0);
+			}
+		case 1:
+			{
+			ioSize += 5;
+			return Val_ZZ(ioRand.Chance(2));
+			}
+		case 2:
+			{
+			const size_t theSize = 8 + ioRand.Below(56);
+			ioSize += 5;
+			std::vector<byte> theBytes(theSize);
+			for (byte& theByte: theBytes)
+				theByte = byte(ioRand.Next());
+			return Val_ZZ(Data_ZZ(&theBytes[0], theSize));
+			}
+		default:
+			{
+			const size_t theLength =
+				iShape == EShape::Strings ? 32 + ioRand.Below(224) : 4 + ioRand.Below(20);
+			const std::string theString = spString(ioRand, theLength, iShape == EShape::Strings);
+			ioSize += theString.size() + 3;
+			return Val_ZZ(theString);
+			}
+		}
+	}
+
+Val_ZZ spRecord(Rand& ioRand, EShape iShape, size_t& ioSize)
+	{
+	Map_ZZ result;
+	for (size_t xx = 6 + ioRand.Below(8); xx; --xx)
+		{
+		const std::string theName = spName(ioRand) + std::to_string(xx);
+		ioSize += theName.size() + 4;
+		result.Set(theName, spScalar(ioRand, iShape, ioSize));
+		}
+	ioSize += 2;
+	return result;
+	}
+
+Val_ZZ spDeep(Rand& ioRand, size_t iDepth, size_t iLimit, size_t& ioSize)
+	{
+	if (iDepth >= 40 || ioSize >= iLimit || (iDepth > 4 && ioRand.Chance(6)))
+		return spScalar(ioRand, EShape::Deep, ioSize);
+
+	ioSize += 2;
+	if (ioRand.Chance(2))
+		{
+		Seq_ZZ result;
+		for (size_t xx = 1 + ioRand.Below(3); xx; --xx)
+			result.Append(spDeep(ioRand, iDepth + 1, iLimit, ioSize));
+		return result;
+		}
+	else
+		{
+		Map_ZZ result;
+		for (size_t xx = 1 + ioRand.Below(3); xx; --xx)
+			{
+			// Unique within the map, or Set would replace an earlier entry.
+			const std::string theName = spName(ioRand) + std::to_string(xx);
+			ioSize += theName.size() + 4;
+			result.Set(theName, spDeep(ioRand, iDepth + 1, iLimit, ioSize));
+			}
+		return result;
+		}
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - Corpus
+
+Val_ZZ sCorpus(EShape iShape, size_t iSize, uint32 iSeed)
+	{
+	Rand theRand(iSeed);
+	size_t theSize = 0;
+	Seq_ZZ result;
+	while (theSize < iSize)
+		{
+		switch (iShape)
+			{
+			case EShape::Deep:
+				{
+				// Each top-level element is a deep tree of up to a sixteenth of the total.
+				result.Append(spDeep(theRand, 0, theSize + iSize / 16, theSize));
+				break;
+				}
+			case EShape::Wide:
+			case EShape::Strings:
+				{
+				result.Append(spRecord(theRand, iShape, theSize));
+				break;
+				}
+			case EShape::Numbers:
+				{
+				Seq_ZZ theRow;
+				for (size_t xx = 4 + theRand.Below(12); xx; --xx)
+					theRow.Append(spScalar(theRand, iShape, theSize));
+				result.Append(theRow);
+				break;
+				}
+			}
+		}
+	return result;
+	}
+
+std::vector<std::vector<std::string>> sCorpus_Table(EShape iShape, size_t iSize, uint32 iSeed)
+	{
+	Rand theRand(iSeed);
+	const size_t theColCount = iShape == EShape::Wide ? 24 : 8;
+
+	std::vector<std::vector<std::string>> result(1);
+	for (size_t xx = 0; xx < theColCount; ++xx)
+		result[0].push_back(spName(theRand) + std::to_string(xx));
+
+	size_t theSize = 0;
+	while (theSize < iSize)
+		{
+		std::vector<std::string> theRow;
+		for (size_t xx = 0; xx < theColCount; ++xx)
+			{
+			std::string theValue;
+			if (iShape == EShape::Numbers)
+				theValue = std::to_string(double(theRand.Next()) / 1024.0);
+			else if (iShape == EShape::Strings)
+				theValue = spString(theRand, 32 + theRand.Below(96), true);
+			else
+				theValue = spString(theRand, 2 + theRand.Below(14), false);
+			theSize += theValue.size() + 1;
+			theRow.push_back(theValue);
+			}
+		result.push_back(theRow);
+		}
+	return result;
+	}
+
+uint64 sCountTokens(const Val_ZZ& iVal)
+	{
+	if (const Seq_ZZ* theSeq = iVal.PGet<Seq_ZZ>())
+		{
+		uint64 result = 2;
+		for (size_t xx = 0, count = theSeq->Size(); xx < count; ++xx)
+			result += sCountTokens(theSeq->Get(xx));
+		return result;
+		}
+
+	if (const Map_ZZ* theMap = iVal.PGet<Map_ZZ>())
+		{
+		uint64 result = 2;
+		for (Map_ZZ::Index_t ii = theMap->Begin(); ii != theMap->End(); ++ii)
+			result += 1 + sCountTokens(theMap->Get(ii));
+		return result;
+		}
+
+	return 1;
+	}
+
+// =================================================================================================
+#pragma mark - Allocations
+
+uint64 sAllocations()
+	{ return spAllocations; }
+
+// =================================================================================================
+#pragma mark - sReport
+
+void sReport(const std::string& iName, const char* iShapeName,
+	uint64 iBytes, uint64 iTokens,
+	uint64 iIterations, double iElapsed, uint64 iAllocations)
+	{
+	const double perSecond = iIterations / iElapsed;
+	std::printf("%-32s %-8s %10llu %10.1f %10.2f %12.1f\n",
+		iName.c_str(), iShapeName,
+		(unsigned long long)iBytes,
+		iBytes * perSecond / (1024 * 1024),
+		iTokens * perSecond / 1e6,
+		double(iAllocations) / iIterations);
+	std::fflush(stdout);
+	}
+
+} // namespace Benchmark
+} // namespace ZooLib
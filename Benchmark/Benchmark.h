@@ -0,0 +1,119 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_Benchmark_h__
+#define __ZooLib_Benchmark_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/StdInt.h"
+#include "zoolib/Time.h"
+#include "zoolib/Val_ZZ.h"
+
+#include <string>
+#include <vector>
+
+namespace ZooLib {
+namespace Benchmark {
+
+// =================================================================================================
+#pragma mark - EShape
+
+// The shape of a synthetic corpus.
+//   Deep     nested Maps and Seqs, a few dozen levels, small fan-out
+//   Wide     a long Seq of flat records of mixed type, like rows from a table
+//   Strings  records dominated by long strings, some of them non-ASCII
+//   Numbers  a long Seq of short Seqs of int64 and double
+
+enum class EShape { Deep, Wide, Strings, Numbers };
+
+const char* sName(EShape iShape);
+
+// =================================================================================================
+#pragma mark - Options
+
+struct Options
+	{
+	Options();
+
+	std::vector<EShape> fShapes;
+
+	// Approximate size of each corpus, as JSON.
+	size_t fSize;
+
+	// Each benchmark repeats its operation for at least this long.
+	double fSeconds;
+
+	// Only benchmarks whose name contains fFilter are run.
+	std::string fFilter;
+
+	uint32 fSeed;
+	};
+
+// =================================================================================================
+#pragma mark - Corpus
+
+// Generates the same Val_ZZ for the same shape, size and seed. Corpora contain Maps, Seqs,
+// strings, int64, double, bool and Data_ZZ, but no nulls, so that every format can carry them.
+Val_ZZ sCorpus(EShape iShape, size_t iSize, uint32 iSeed);
+
+// Rows of strings, the first being the column names, for SeparatedValues.
+std::vector<std::vector<std::string>> sCorpus_Table(EShape iShape, size_t iSize, uint32 iSeed);
+
+// The number of PPTs a push of iVal generates -- one per scalar and Name, two per container.
+uint64 sCountTokens(const Val_ZZ& iVal);
+
+// =================================================================================================
+#pragma mark - Allocations
+
+// The number of calls to the global operator new since the process started.
+uint64 sAllocations();
+
+// =================================================================================================
+#pragma mark - sRun
+
+void sReport(const std::string& iName, const char* iShapeName,
+	uint64 iBytes, uint64 iTokens,
+	uint64 iIterations, double iElapsed, uint64 iAllocations);
+
+inline bool sWanted(const Options& iOptions, const std::string& iName)
+	{ return iOptions.fFilter.empty() || iName.find(iOptions.fFilter) != std::string::npos; }
+
+// Runs iOp once to warm up, then repeatedly for at least iOptions.fSeconds, and prints
+// throughput given that each run processes iBytes bytes and iTokens tokens.
+template <class Op_p>
+void sRun(const Options& iOptions, const std::string& iName, const char* iShapeName,
+	uint64 iBytes, uint64 iTokens, Op_p iOp)
+	{
+	if (not sWanted(iOptions, iName))
+		return;
+
+	iOp();
+
+	const uint64 allocationsAtStart = sAllocations();
+	const double start = Time::sSystem();
+	uint64 theIterations = 0;
+	double elapsed;
+	do
+		{
+		iOp();
+		++theIterations;
+		elapsed = Time::sSystem() - start;
+		}
+	while (elapsed < iOptions.fSeconds);
+
+	sReport(iName, iShapeName, iBytes, iTokens,
+		theIterations, elapsed, sAllocations() - allocationsAtStart);
+	}
+
+// =================================================================================================
+#pragma mark - Suites
+
+void sRun_Formats(const Options& iOptions);
+void sRun_Chans(const Options& iOptions);
+
+// Searcher_Datons, including searches built while another thread is writing.
+void sRun_Dataspace(const Options& iOptions);
+
+} // namespace Benchmark
+} // namespace ZooLib
+
+#endif // __ZooLib_Benchmark_h__
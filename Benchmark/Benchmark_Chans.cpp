@@ -0,0 +1,157 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "Benchmark.h"
+
+#include "zoolib/Callable_Lambda.h"
+#include "zoolib/Chan_Bin.h"
+#include "zoolib/ChanRPos_XX_PageBuffered.h"
+#include "zoolib/Chan_XX_Buffered.h"
+#include "zoolib/Chan_XX_Memory.h"
+#include "zoolib/Chan_XX_PipePair.h"
+#include "zoolib/StartOnNewThread.h"
+
+#include <vector>
+
+namespace ZooLib {
+namespace Benchmark {
+
+using std::vector;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const char spNoShape[] = "-";
+
+// Reads everything from iChanR in iChunkSize pieces, returning the number of reads.
+uint64 spReadAll(const ChanR_Bin& iChanR, byte* oBuffer, size_t iChunkSize)
+	{
+	uint64 result = 0;
+	while (sReadFully(iChanR, oBuffer, iChunkSize))
+		++result;
+	return result;
+	}
+
+// A writer on another thread pushes iSize bytes in iChunkSize pieces, we read them.
+void spPipePair(size_t iSize, size_t iChunkSize)
+	{
+	ZP<ImpPipePair<byte>> theImp = new ImpPipePair<byte>;
+	sStartOnNewThread(sCallable([theImp, iSize, iChunkSize]()
+		{
+		ChanWCon_XX_PipePair<byte> theChanW(theImp);
+		vector<byte> theChunk(iChunkSize, byte(0x5A));
+		for (size_t remaining = iSize; remaining; /*no inc*/)
+			{
+			const size_t countToWrite = std::min(remaining, iChunkSize);
+			sEWrite(theChanW, &theChunk[0], countToWrite);
+			remaining -= countToWrite;
+			}
+		sDisconnectWrite(theChanW);
+		}));
+
+	ChanR_XX_PipePair<byte> theChanR(theImp);
+	vector<byte> theBuffer(iChunkSize);
+	spReadAll(theChanR, &theBuffer[0], iChunkSize);
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - sRun_Chans
+
+void sRun_Chans(const Options& iOptions)
+	{
+	const size_t theSize = iOptions.fSize;
+	vector<byte> theSource(theSize);
+	for (size_t xx = 0; xx < theSize; ++xx)
+		theSource[xx] = byte(xx * 0x9E3779B1 >> 24);
+
+	vector<byte> theBuffer(64 * 1024);
+
+	// -----
+
+	for (size_t theChunkSize: {1, 16, 256})
+		{
+		const std::string theSuffix = " " + std::to_string(theChunkSize);
+		const uint64 theReads = (theSize + theChunkSize - 1) / theChunkSize;
+
+		sRun(iOptions, "Memory read" + theSuffix, spNoShape, theSize, theReads,
+			[&]()
+				{
+				ChanRPos_XX_Memory<byte> theChanR(&theSource[0], theSize);
+				spReadAll(theChanR, &theBuffer[0], theChunkSize);
+				});
+
+		sRun(iOptions, "Buffered read" + theSuffix, spNoShape, theSize, theReads,
+			[&]()
+				{
+				ChanRPos_XX_Memory<byte> theChanR(&theSource[0], theSize);
+				ChanR_XX_Buffered<ChanR_Bin> theChanR_Buffered(theChanR, 4096);
+				spReadAll(theChanR_Buffered, &theBuffer[0], theChunkSize);
+				});
+
+		sRun(iOptions, "Buffered write" + theSuffix, spNoShape, theSize, theReads,
+			[&]()
+				{
+				ChanW_XX_Discard<byte> theChanW;
+				ChanW_XX_Buffered<ChanW_Bin> theChanW_Buffered(theChanW, 4096);
+				for (size_t offset = 0; offset < theSize; offset += theChunkSize)
+					{
+					sEWrite(theChanW_Buffered,
+						&theSource[offset], std::min(theChunkSize, theSize - offset));
+					}
+				});
+		}
+
+	// -----
+
+	for (size_t theChunkSize: {64, 4096})
+		{
+		const std::string theSuffix = " " + std::to_string(theChunkSize);
+		const uint64 theWrites = (theSize + theChunkSize - 1) / theChunkSize;
+
+		sRun(iOptions, "PipePair" + theSuffix, spNoShape, theSize, theWrites,
+			[&]() { spPipePair(theSize, theChunkSize); });
+		}
+
+	// -----
+
+	// Sixteen 4K pages, over a source larger than that.
+	const size_t thePageCount = 16;
+	const size_t thePageSize = 4096;
+
+	sRun(iOptions, "PageBuffered sequential 64", spNoShape, theSize, theSize / 64,
+		[&]()
+			{
+			ChanRPos_XX_Memory<byte> theChanR(&theSource[0], theSize);
+			ChanRPos_XX_PageBuffered<byte> theChanR_Paged(theChanR, thePageCount, thePageSize);
+			spReadAll(theChanR_Paged, &theBuffer[0], 64);
+			});
+
+	const size_t theRandomReads = std::max<size_t>(1, theSize / 64);
+	sRun(iOptions, "PageBuffered random 64", spNoShape, theRandomReads * 64, theRandomReads,
+		[&]()
+			{
+			ChanRPos_XX_Memory<byte> theChanR(&theSource[0], theSize);
+			ChanRPos_XX_PageBuffered<byte> theChanR_Paged(theChanR, thePageCount, thePageSize);
+			uint32 theState = iOptions.fSeed | 1;
+			for (size_t xx = 0; xx < theRandomReads; ++xx)
+				{
+				// Mostly near the last read, sometimes anywhere.
+				theState ^= theState << 13;
+				theState ^= theState >> 17;
+				theState ^= theState << 5;
+				uint64 thePos = sPos(theChanR_Paged);
+				if (theState % 8 == 0)
+					thePos = theState % theSize;
+				else
+					thePos = (thePos + theState % (2 * thePageSize)) % theSize;
+				sPosSet(theChanR_Paged, thePos);
+				sReadFully(theChanR_Paged, &theBuffer[0], 64);
+				}
+			});
+	}
+
+} // namespace Benchmark
+} // namespace ZooLib
@@ -0,0 +1,261 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "Benchmark.h"
+
+#include "zoolib/Callable_Lambda.h"
+#include "zoolib/CountedWithoutFinalize.h"
+#include "zoolib/StartOnNewThread.h"
+#include "zoolib/ZMACRO_foreach.h"
+#include "zoolib/ZThread.h"
+
+#include "zoolib/Dataspace/Daton_Val.h"
+#include "zoolib/Dataspace/Searcher_Datons.h"
+
+#include "zoolib/Expr/Expr_Bool.h"
+
+#include "zoolib/ValPred/Expr_Bool_ValPred.h"
+#include "zoolib/ValPred/ValPred_DB.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+namespace ZooLib {
+namespace Benchmark {
+
+using namespace Dataspace;
+
+using std::vector;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const char spNoShape[] = "-";
+
+// Datons are small flat maps, a few dozen bytes of JSONB each.
+const size_t kBytesPerDaton = 64;
+
+// Each batch of changes asserts this many datons and retracts as many.
+const size_t kBatchSize = 64;
+
+class DatonSource
+	{
+public:
+	DatonSource(uint32 iSeed)
+	:	fState(iSeed | 1)
+	,	fNextID(0)
+		{}
+
+	Daton Make()
+		{
+		Map_ZZ theMap;
+		theMap.Set("id", int64(fNextID++));
+		theMap.Set("a", int64(this->pNext() % 16));
+		theMap.Set("b", int64(this->pNext() % 256));
+		theMap.Set("c", std::to_string(this->pNext() % 1024));
+		return sAsDaton_JSONB(theMap);
+		}
+
+private:
+	uint32 pNext()
+		{
+		fState ^= fState << 13;
+		fState ^= fState >> 17;
+		fState ^= fState << 5;
+		return fState;
+		}
+
+	uint32 fState;
+	uint64 fNextID;
+	};
+
+// Half use the index on a, half have to scan everything.
+vector<AddedSearch> spSearches(int64 iBaseRefcon, size_t iCount)
+	{
+	using RelationalAlgebra::RelHead;
+	vector<AddedSearch> result;
+	for (size_t xx = 0; xx < iCount; ++xx)
+		{
+		const int64 theVal = int64(xx % 16);
+		if (xx % 2)
+			{
+			result.push_back(AddedSearch(iBaseRefcon + xx,
+				SearchSpec(sConcreteHead(RelHead{"id", "b"}),
+					sExpr_Bool(CName("a") == CConst(Val_DB(theVal))))));
+			}
+		else
+			{
+			result.push_back(AddedSearch(iBaseRefcon + xx,
+				SearchSpec(sConcreteHead(RelHead{"id", "a"}),
+					sExpr_Bool(CName("b") < CConst(Val_DB(theVal * 16))))));
+			}
+		}
+	return result;
+	}
+
+// Asserts a batch and retracts the oldest batch, so the count stays the same.
+class Writer
+	{
+public:
+	Writer(const ZP<Searcher_Datons>& iSearcher, size_t iCount, uint32 iSeed)
+	:	fSearcher(iSearcher)
+	,	fSource(iSeed)
+	,	fOldest(0)
+		{
+		for (size_t xx = 0; xx < iCount; ++xx)
+			fLive.push_back(fSource.Make());
+		fSearcher->MakeChanges(&fLive[0], fLive.size(), nullptr, 0);
+		}
+
+	void WriteBatch()
+		{
+		vector<Daton> theAsserted;
+		vector<Daton> theRetracted;
+		for (size_t xx = 0; xx < kBatchSize; ++xx)
+			{
+			theAsserted.push_back(fSource.Make());
+			theRetracted.push_back(fLive[fOldest]);
+			fLive[fOldest] = theAsserted.back();
+			fOldest = (fOldest + 1) % fLive.size();
+			}
+		fSearcher->MakeChanges(&theAsserted[0], theAsserted.size(),
+			&theRetracted[0], theRetracted.size());
+		}
+
+private:
+	const ZP<Searcher_Datons> fSearcher;
+	DatonSource fSource;
+	vector<Daton> fLive;
+	size_t fOldest;
+	};
+
+// Registers iCount searches, collects until each has its first result, and unregisters them.
+void spBuild(const ZP<Searcher_Datons>& iSearcher, size_t iCount, int64& ioNextRefcon)
+	{
+	vector<AddedSearch> theAdded = spSearches(ioNextRefcon, iCount);
+	ioNextRefcon += iCount;
+	iSearcher->ModifyRegistrations(&theAdded[0], theAdded.size(), nullptr, 0);
+
+	std::set<int64> thePending;
+	foreacha (entry, theAdded)
+		thePending.insert(entry.GetRefcon());
+
+	vector<SearchResult> theChanged;
+	int64 theChangeCount;
+	while (not thePending.empty())
+		{
+		iSearcher->CollectResults(theChanged, theChangeCount);
+		foreacha (entry, theChanged)
+			thePending.erase(entry.GetRefcon());
+		}
+
+	vector<int64> theRemoved;
+	foreacha (entry, theAdded)
+		theRemoved.push_back(entry.GetRefcon());
+	iSearcher->ModifyRegistrations(nullptr, 0, &theRemoved[0], theRemoved.size());
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - sRun_Dataspace
+
+void sRun_Dataspace(const Options& iOptions)
+	{
+	const size_t theDatonCount = std::max<size_t>(kBatchSize, iOptions.fSize / kBytesPerDaton);
+	const size_t theSearchCount = 16;
+
+	vector<IndexSpec> theIndexSpecs;
+	theIndexSpecs.push_back(IndexSpec{"a", "id"});
+
+	int64 theNextRefcon = 1;
+
+	// Tokens are datons, so Mtok/s is millions of datons examined or written per second.
+
+	{
+	ZP<Searcher_Datons> theSearcher = new Searcher_Datons(theIndexSpecs);
+	Writer theWriter(theSearcher, theDatonCount, iOptions.fSeed);
+
+	sRun(iOptions, "Searcher build", spNoShape,
+		theDatonCount * kBytesPerDaton, theDatonCount * theSearchCount,
+		[&]() { spBuild(theSearcher, theSearchCount, theNextRefcon); });
+
+	// With the searches registered, every batch updates their results.
+	vector<AddedSearch> theAdded = spSearches(theNextRefcon, theSearchCount);
+	theNextRefcon += theSearchCount;
+	theSearcher->ModifyRegistrations(&theAdded[0], theAdded.size(), nullptr, 0);
+
+	vector<SearchResult> theChanged;
+	int64 theChangeCount;
+	sRun(iOptions, "Searcher write+collect", spNoShape,
+		kBatchSize * kBytesPerDaton, 2 * kBatchSize,
+		[&]()
+			{
+			theWriter.WriteBatch();
+			theSearcher->CollectResults(theChanged, theChangeCount);
+			});
+	}
+
+	// -----
+
+	// Mixed load. Another thread writes batches flat out while we build searches, and then
+	// we report the rate it managed while we were doing so.
+
+	if (not sWanted(iOptions, "Searcher mixed build")
+		&& not sWanted(iOptions, "Searcher mixed write"))
+		{ return; }
+
+	ZP<Searcher_Datons> theSearcher = new Searcher_Datons(theIndexSpecs);
+
+	struct Shared : public CountedWithoutFinalize
+		{
+		Shared() : fStop(false), fBatches(0), fStopped(false) {}
+		std::atomic<bool> fStop;
+		std::atomic<uint64> fBatches;
+		ZMtx fMtx;
+		ZCnd fCnd;
+		bool fStopped;
+		};
+
+	ZP<Shared> theShared = new Shared;
+
+	Writer* theWriter = new Writer(theSearcher, theDatonCount, iOptions.fSeed);
+	sStartOnNewThread(sCallable([theShared, theWriter]()
+		{
+		while (not theShared->fStop)
+			{
+			theWriter->WriteBatch();
+			++theShared->fBatches;
+			}
+		delete theWriter;
+		ZAcqMtx acq(theShared->fMtx);
+		theShared->fStopped = true;
+		theShared->fCnd.Broadcast();
+		}));
+
+	const uint64 batchesAtStart = theShared->fBatches;
+	const double start = Time::sSystem();
+
+	sRun(iOptions, "Searcher mixed build", spNoShape,
+		theDatonCount * kBytesPerDaton, theDatonCount * theSearchCount,
+		[&]() { spBuild(theSearcher, theSearchCount, theNextRefcon); });
+
+	const double elapsed = Time::sSystem() - start;
+	const uint64 theBatches = theShared->fBatches - batchesAtStart;
+
+	theShared->fStop = true;
+	{
+	ZAcqMtx acq(theShared->fMtx);
+	while (not theShared->fStopped)
+		theShared->fCnd.Wait(theShared->fMtx);
+	}
+
+	sReport("Searcher mixed write", spNoShape,
+		kBatchSize * kBytesPerDaton, 2 * kBatchSize,
+		theBatches, elapsed, 0);
+	}
+
+} // namespace Benchmark
+} // namespace ZooLib
@@ -0,0 +1,241 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "Benchmark.h"
+
+#include "zoolib/Chan_Bin_Data.h"
+#include "zoolib/Chan_UTF_string.h"
+#include "zoolib/ChanRU_UTF_ML.h"
+#include "zoolib/ChanW_UTF_ML.h"
+#include "zoolib/PullPush_SeparatedValues.h"
+#include "zoolib/PullPush_XMLPList.h"
+#include "zoolib/PullPush_ZZ.h"
+#include "zoolib/Pull_Bencode.h"
+#include "zoolib/Pull_bplist.h"
+#include "zoolib/Push_bplist.h"
+#include "zoolib/Util_ZZ_JSON.h"
+#include "zoolib/Util_ZZ_JSONB.h"
+
+namespace ZooLib {
+namespace Benchmark {
+
+using std::string;
+using std::vector;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+// There's a Bencode reader but no writer, so here's a minimal one. Bencode has no doubles
+// or bools, they're written as integers.
+void spWrite_Bencode(const Val_ZZ& iVal, string& ioString)
+	{
+	if (const Seq_ZZ* theSeq = iVal.PGet<Seq_ZZ>())
+		{
+		ioString += 'l';
+		for (size_t xx = 0, count = theSeq->Size(); xx < count; ++xx)
+			spWrite_Bencode(theSeq->Get(xx), ioString);
+		ioString += 'e';
+		}
+	else if (const Map_ZZ* theMap = iVal.PGet<Map_ZZ>())
+		{
+		// Map_ZZ iterates in name order, as Bencode requires.
+		ioString += 'd';
+		for (Map_ZZ::Index_t ii = theMap->Begin(); ii != theMap->End(); ++ii)
+			{
+			const string& theName = theMap->NameOf(ii).AsString8();
+			ioString += std::to_string(theName.size()) + ':' + theName;
+			spWrite_Bencode(theMap->Get(ii), ioString);
+			}
+		ioString += 'e';
+		}
+	else if (const string* theString = iVal.PGet<string>())
+		{
+		ioString += std::to_string(theString->size()) + ':' + *theString;
+		}
+	else if (const Data_ZZ* theData = iVal.PGet<Data_ZZ>())
+		{
+		ioString += std::to_string(theData->GetSize()) + ':';
+		ioString.append(static_cast<const char*>(theData->GetPtr()), theData->GetSize());
+		}
+	else if (const int64* theInt = iVal.PGet<int64>())
+		{
+		ioString += 'i' + std::to_string(*theInt) + 'e';
+		}
+	else if (const double* theDouble = iVal.PGet<double>())
+		{
+		ioString += 'i' + std::to_string(int64(*theDouble)) + 'e';
+		}
+	else if (const bool* theBool = iVal.PGet<bool>())
+		{
+		ioString += *theBool ? "i1e" : "i0e";
+		}
+	}
+
+// Readers other than JSON and JSONB don't have a Util_ZZ_xxx::sQRead.
+template <class Pull_p>
+ZQ<Val_ZZ> spQRead_PushWhole(Pull_p iPull)
+	{
+	ThreadVal_PushWhole tv_PushWhole(true);
+	ChanW_PPT_AsZZ theChanW;
+	iPull(theChanW);
+	return theChanW.QGet();
+	}
+
+string spAsXMLPList(const Val_ZZ& iVal)
+	{
+	string result;
+	ChanW_UTF_string8 theChanW(&result);
+	ChanW_UTF_ML theChanW_ML(false, theChanW);
+	sPull_PPT_Push_XMLPList(ChanR_PPT_FromZZ(iVal), theChanW_ML);
+	return result;
+	}
+
+string spAsSeparatedValues(const Val_ZZ& iTable)
+	{
+	string result;
+	sPull_PPT_Push_SeparatedValues(ChanR_PPT_FromZZ(iTable),
+		Push_SeparatedValues_Options('\t', '\n'),
+		ChanW_UTF_string8(&result));
+	return result;
+	}
+
+Data_ZZ spAsbplist(const Val_ZZ& iVal)
+	{
+	Data_ZZ result;
+	sFromZZ_Push_bplist(iVal, ChanW_Bin_Data<Data_ZZ>(&result));
+	return result;
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - sRun_Formats
+
+void sRun_Formats(const Options& iOptions)
+	{
+	for (EShape theShape: iOptions.fShapes)
+		{
+		const char* theShapeName = sName(theShape);
+		const Val_ZZ theCorpus = sCorpus(theShape, iOptions.fSize, iOptions.fSeed);
+		const uint64 theTokens = sCountTokens(theCorpus);
+
+		// -----
+
+		const string theJSON = Util_ZZ_JSON::sAsJSON(theCorpus);
+
+		sRun(iOptions, "JSON write", theShapeName, theJSON.size(), theTokens,
+			[&]()
+				{
+				string theString;
+				Util_ZZ_JSON::sWrite(ChanW_UTF_string8(&theString), theCorpus);
+				});
+
+		sRun(iOptions, "JSON read chan", theShapeName, theJSON.size(), theTokens,
+			[&]() { Util_ZZ_JSON::sQRead(ChanRU_UTF_string8(theJSON)); });
+
+		sRun(iOptions, "JSON read memory", theShapeName, theJSON.size(), theTokens,
+			[&]()
+				{
+				Util_ZZ_JSON::sQRead(
+					theJSON.data(), theJSON.data() + theJSON.size());
+				});
+
+		// -----
+
+		const Data_ZZ theJSONB = Util_ZZ_JSONB::sAsJSONB(theCorpus);
+
+		sRun(iOptions, "JSONB write", theShapeName, theJSONB.GetSize(), theTokens,
+			[&]() { Util_ZZ_JSONB::sAsJSONB(theCorpus); });
+
+		sRun(iOptions, "JSONB read", theShapeName, theJSONB.GetSize(), theTokens,
+			[&]() { Util_ZZ_JSONB::sQRead(ChanRPos_Bin_Data<Data_ZZ>(theJSONB)); });
+
+		const Data_ZZ theJSONB_Indexed = Util_ZZ_JSONB::sAsJSONB_Indexed(theCorpus);
+
+		sRun(iOptions, "JSONB indexed write", theShapeName,
+			theJSONB_Indexed.GetSize(), theTokens,
+			[&]() { Util_ZZ_JSONB::sAsJSONB_Indexed(theCorpus); });
+
+		sRun(iOptions, "JSONB indexed read", theShapeName,
+			theJSONB_Indexed.GetSize(), theTokens,
+			[&]() { Util_ZZ_JSONB::sQRead(ChanRPos_Bin_Data<Data_ZZ>(theJSONB_Indexed)); });
+
+		// -----
+
+		const Data_ZZ thebplist = spAsbplist(theCorpus);
+
+		sRun(iOptions, "bplist write", theShapeName, thebplist.GetSize(), theTokens,
+			[&]() { spAsbplist(theCorpus); });
+
+		sRun(iOptions, "bplist read", theShapeName, thebplist.GetSize(), theTokens,
+			[&]()
+				{
+				spQRead_PushWhole([&](const ChanW_PPT& iChanW)
+					{ sPull_bplist_Push_PPT(ChanRPos_Bin_Data<Data_ZZ>(thebplist), iChanW); });
+				});
+
+		// -----
+
+		const string theXMLPList = spAsXMLPList(theCorpus);
+
+		sRun(iOptions, "XMLPList write", theShapeName, theXMLPList.size(), theTokens,
+			[&]() { spAsXMLPList(theCorpus); });
+
+		sRun(iOptions, "XMLPList read", theShapeName, theXMLPList.size(), theTokens,
+			[&]()
+				{
+				spQRead_PushWhole([&](const ChanW_PPT& iChanW)
+					{
+					ChanRU_UTF_string8 theChanRU(theXMLPList);
+					ChanRU_UTF_ML theChanRU_ML(theChanRU);
+					sPull_XMLPList_Push_PPT(theChanRU_ML, iChanW);
+					});
+				});
+
+		// -----
+
+		string theBencode;
+		spWrite_Bencode(theCorpus, theBencode);
+		const Data_ZZ theBencodeData(theBencode.data(), theBencode.size());
+
+		sRun(iOptions, "Bencode read", theShapeName, theBencode.size(), theTokens,
+			[&]()
+				{
+				spQRead_PushWhole([&](const ChanW_PPT& iChanW)
+					{ sPull_Bencode_Push_PPT(ChanRPos_Bin_Data<Data_ZZ>(theBencodeData), iChanW); });
+				});
+
+		// -----
+
+		Seq_ZZ theTable;
+		for (const vector<string>& theRow:
+			sCorpus_Table(theShape, iOptions.fSize, iOptions.fSeed))
+			{
+			theTable.Append(Seq_ZZ(theRow.begin(), theRow.end()));
+			}
+
+		const string theSV = spAsSeparatedValues(theTable);
+
+		// Writing takes a Seq of Seqs, reading produces a Map per row after the first.
+		const uint64 theTokens_SV_Write = sCountTokens(theTable);
+		const uint64 theTokens_SV_Read =
+			2 + (theTable.Size() - 1) * (2 + 2 * theTable.Get<Seq_ZZ>(0).Size());
+
+		sRun(iOptions, "SeparatedValues write", theShapeName, theSV.size(), theTokens_SV_Write,
+			[&]() { spAsSeparatedValues(theTable); });
+
+		sRun(iOptions, "SeparatedValues read", theShapeName, theSV.size(), theTokens_SV_Read,
+			[&]()
+				{
+				spQRead_PushWhole([&](const ChanW_PPT& iChanW)
+					{
+					sPull_SeparatedValues_Push_PPT(
+						ChanRU_UTF_string8(theSV), '\t', '\n', iChanW);
+					});
+				});
+		}
+	}
+
+} // namespace Benchmark
+} // namespace ZooLib
@@ -0,0 +1,114 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib> // For strtod, strtoul
+#include <cstring> // For strncmp
+
+using namespace ZooLib;
+using namespace ZooLib::Benchmark;
+
+// =================================================================================================
+#pragma mark - Helpers
+
+static void spUsage(const char* iProgram)
+	{
+	std::fprintf(stderr,
+		"Usage: %s [options]\n"
+		"  --shape=deep|wide|strings|numbers  Corpus shape, may be repeated (default all)\n"
+		"  --size=N                           Approximate corpus size in bytes (default 1MiB)\n"
+		"  --seconds=S                        Minimum time per benchmark (default 0.5)\n"
+		"  --filter=TEXT                      Only run benchmarks whose name contains TEXT\n"
+		"  --seed=N                           Corpus seed (default 1)\n"
+		"  --formats-only, --chans-only, --dataspace-only\n",
+		iProgram);
+	}
+
+static bool spQShape(const char* iName, EShape& oShape)
+	{
+	for (EShape theShape: {EShape::Deep, EShape::Wide, EShape::Strings, EShape::Numbers})
+		{
+		if (0 == std::strcmp(iName, sName(theShape)))
+			{
+			oShape = theShape;
+			return true;
+			}
+		}
+	return false;
+	}
+
+// =================================================================================================
+#pragma mark - main
+
+int main(int argc, char** argv)
+	{
+	Options theOptions;
+	bool doFormats = true;
+	bool doChans = true;
+	bool doDataspace = true;
+	bool gotShape = false;
+
+	for (int xx = 1; xx < argc; ++xx)
+		{
+		const char* theArg = argv[xx];
+		EShape theShape;
+		if (0 == std::strncmp(theArg, "--shape=", 8) && spQShape(theArg + 8, theShape))
+			{
+			if (not gotShape)
+				theOptions.fShapes.clear();
+			gotShape = true;
+			theOptions.fShapes.push_back(theShape);
+			}
+		else if (0 == std::strncmp(theArg, "--size=", 7))
+			{
+			theOptions.fSize = std::max<size_t>(1024, std::strtoul(theArg + 7, nullptr, 10));
+			}
+		else if (0 == std::strncmp(theArg, "--seconds=", 10))
+			{
+			theOptions.fSeconds = std::strtod(theArg + 10, nullptr);
+			}
+		else if (0 == std::strncmp(theArg, "--filter=", 9))
+			{
+			theOptions.fFilter = theArg + 9;
+			}
+		else if (0 == std::strncmp(theArg, "--seed=", 7))
+			{
+			theOptions.fSeed = uint32(std::strtoul(theArg + 7, nullptr, 10));
+			}
+		else if (0 == std::strcmp(theArg, "--formats-only"))
+			{
+			doChans = false;
+			doDataspace = false;
+			}
+		else if (0 == std::strcmp(theArg, "--chans-only"))
+			{
+			doFormats = false;
+			doDataspace = false;
+			}
+		else if (0 == std::strcmp(theArg, "--dataspace-only"))
+			{
+			doFormats = false;
+			doChans = false;
+			}
+		else
+			{
+			spUsage(argv[0]);
+			return 1;
+			}
+		}
+
+	std::printf("%-32s %-8s %10s %10s %10s %12s\n",
+		"benchmark", "shape", "bytes", "MiB/s", "Mtok/s", "allocs/op");
+
+	if (doFormats)
+		sRun_Formats(theOptions);
+
+	if (doChans)
+		sRun_Chans(theOptions);
+
+	if (doDataspace)
+		sRun_Dataspace(theOptions);
+
+	return 0;
+	}
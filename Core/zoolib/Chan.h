@@ -104,6 +104,30 @@ using ChanRWPos = DeriveFrom
 	ChanAspect_Write<EE>
 	>;
 
+template <typename LL, typename EE>
+using ChanRAt = DeriveFrom
+	<
+	ChanAspect_ReadAt<LL,EE>,
+	ChanAspect_Size
+	>;
+
+template <typename LL, typename EE>
+using ChanWAt = DeriveFrom
+	<
+	ChanAspect_Size,
+	ChanAspect_SizeSet,
+	ChanAspect_WriteAt<LL,EE>
+	>;
+
+template <typename LL, typename EE>
+using ChanRWAt = DeriveFrom
+	<
+	ChanAspect_ReadAt<LL,EE>,
+	ChanAspect_Size,
+	ChanAspect_SizeSet,
+	ChanAspect_WriteAt<LL,EE>
+	>;
+
 template <typename EE>
 using ChanRW = DeriveFrom
 	<
@@ -122,6 +122,13 @@ public:
 
 	virtual size_t Readable()
 		{ return 0; }
+
+	// A chan that already holds elements in memory can lend them out. The span is
+	// valid until the next call on the chan, and Skip(n), for n up to its size,
+	// consumes the first n. An empty span just means there's nothing to borrow right
+	// now -- it doesn't indicate end of chan, so fall back to Read.
+	virtual PaC<const EE> Borrow()
+		{ return sPaC<const EE>(); }
 	};
 
 template <class EE>
@@ -140,6 +147,10 @@ template <class EE>
 size_t sReadable(const ChanAspect_Read<EE>& iAspect)
 	{ return sNonConst(iAspect).Readable(); }
 
+template <class EE>
+PaC<const EE> sBorrow(const ChanAspect_Read<EE>& iAspect)
+	{ return sNonConst(iAspect).Borrow(); }
+
 // =================================================================================================
 #pragma mark - ChanAspect_ReadAt
 
@@ -21,6 +21,9 @@ using ChanRSize_Bin = ChanRSize<byte>;
 using ChanRPos_Bin = ChanRPos<byte>;
 using ChanWPos_Bin = ChanWPos<byte>;
 using ChanRWPos_Bin = ChanRWPos<byte>;
+using ChanRAt_Bin = ChanRAt<uint64,byte>;
+using ChanWAt_Bin = ChanWAt<uint64,byte>;
+using ChanRWAt_Bin = ChanRWAt<uint64,byte>;
 using ChanRW_Bin = ChanRW<byte>;
 using ChanRAbort_Bin = ChanRAbort<byte>;
 using ChanWAbort_Bin = ChanWAbort<byte>;
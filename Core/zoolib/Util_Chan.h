@@ -161,6 +161,16 @@ bool sSkip_Until(const ChanR<EE>& iChanR, const EE& iTerminator)
 template <class EE>
 bool sTryRead(const ChanRU<EE>& iChanRU, EE iEE)
 	{
+	const PaC<const EE> theBorrowed = sBorrow(iChanRU);
+	if (sCount(theBorrowed))
+		{
+		// Look without reading, so a mismatch needs no unread.
+		if (not (*sPtr(theBorrowed) == iEE))
+			return false;
+		sSkip(iChanRU, 1);
+		return true;
+		}
+
 	if (ZQ<EE> theElement = sQRead(iChanRU))
 		{
 		if (*theElement == iEE)
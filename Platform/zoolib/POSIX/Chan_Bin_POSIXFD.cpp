@@ -164,6 +164,63 @@ size_t ChanRWPos_Bin_POSIXFD::Write(const byte* iSource, size_t iCount)
 size_t ChanRWPos_Bin_POSIXFD::Unread(const byte* iSource, size_t iCount)
 	{ return Util_POSIXFD::sUnread(fFDHolder->GetFD(), iSource, iCount); }
 
+// =================================================================================================
+#pragma mark - ChanRAt_Bin_POSIXFD
+
+ChanRAt_Bin_POSIXFD::ChanRAt_Bin_POSIXFD(const ZP<FDHolder>& iFDHolder)
+:	fFDHolder(iFDHolder)
+	{}
+
+ChanRAt_Bin_POSIXFD::~ChanRAt_Bin_POSIXFD()
+	{}
+
+size_t ChanRAt_Bin_POSIXFD::ReadAt(const uint64& iLoc, byte* oDest, size_t iCount)
+	{ return Util_POSIXFD::sReadAt(fFDHolder->GetFD(), iLoc, oDest, iCount); }
+
+uint64 ChanRAt_Bin_POSIXFD::Size()
+	{ return Util_POSIXFD::sSize(fFDHolder->GetFD()); }
+
+// =================================================================================================
+#pragma mark - ChanWAt_Bin_POSIXFD
+
+ChanWAt_Bin_POSIXFD::ChanWAt_Bin_POSIXFD(const ZP<FDHolder>& iFDHolder)
+:	fFDHolder(iFDHolder)
+	{}
+
+ChanWAt_Bin_POSIXFD::~ChanWAt_Bin_POSIXFD()
+	{}
+
+uint64 ChanWAt_Bin_POSIXFD::Size()
+	{ return Util_POSIXFD::sSize(fFDHolder->GetFD()); }
+
+void ChanWAt_Bin_POSIXFD::SizeSet(uint64 iSize)
+	{ Util_POSIXFD::sSizeSet(fFDHolder->GetFD(), iSize); }
+
+size_t ChanWAt_Bin_POSIXFD::WriteAt(const uint64& iLoc, const byte* iSource, size_t iCount)
+	{ return Util_POSIXFD::sWriteAt(fFDHolder->GetFD(), iLoc, iSource, iCount); }
+
+// =================================================================================================
+#pragma mark - ChanRWAt_Bin_POSIXFD
+
+ChanRWAt_Bin_POSIXFD::ChanRWAt_Bin_POSIXFD(const ZP<FDHolder>& iFDHolder)
+:	fFDHolder(iFDHolder)
+	{}
+
+ChanRWAt_Bin_POSIXFD::~ChanRWAt_Bin_POSIXFD()
+	{}
+
+size_t ChanRWAt_Bin_POSIXFD::ReadAt(const uint64& iLoc, byte* oDest, size_t iCount)
+	{ return Util_POSIXFD::sReadAt(fFDHolder->GetFD(), iLoc, oDest, iCount); }
+
+uint64 ChanRWAt_Bin_POSIXFD::Size()
+	{ return Util_POSIXFD::sSize(fFDHolder->GetFD()); }
+
+void ChanRWAt_Bin_POSIXFD::SizeSet(uint64 iSize)
+	{ Util_POSIXFD::sSizeSet(fFDHolder->GetFD(), iSize); }
+
+size_t ChanRWAt_Bin_POSIXFD::WriteAt(const uint64& iLoc, const byte* iSource, size_t iCount)
+	{ return Util_POSIXFD::sWriteAt(fFDHolder->GetFD(), iLoc, iSource, iCount); }
+
 // =================================================================================================
 #pragma mark - ChanRAbort_Bin_POSIXFD
 
@@ -186,6 +186,78 @@ protected:
 	const ZP<FDHolder> fFDHolder;
 	};
 
+// =================================================================================================
+#pragma mark - ChanRAt_Bin_POSIXFD
+
+// The At chans use pread/pwrite and never touch the fd's offset, so a single instance can
+// be used from multiple threads at once.
+
+class ChanRAt_Bin_POSIXFD
+:	public virtual ChanRAt_Bin
+	{
+public:
+	ChanRAt_Bin_POSIXFD(const ZP<FDHolder>& iFDHolder);
+	~ChanRAt_Bin_POSIXFD();
+
+// From ChanAspect_ReadAt<uint64,byte>
+	virtual size_t ReadAt(const uint64& iLoc, byte* oDest, size_t iCount);
+
+// From ChanAspect_Size
+	virtual uint64 Size();
+
+protected:
+	const ZP<FDHolder> fFDHolder;
+	};
+
+// =================================================================================================
+#pragma mark - ChanWAt_Bin_POSIXFD
+
+class ChanWAt_Bin_POSIXFD
+:	public virtual ChanWAt_Bin
+	{
+public:
+	ChanWAt_Bin_POSIXFD(const ZP<FDHolder>& iFDHolder);
+	~ChanWAt_Bin_POSIXFD();
+
+// From ChanAspect_Size
+	virtual uint64 Size();
+
+// From ChanAspect_SizeSet
+	virtual void SizeSet(uint64 iSize);
+
+// From ChanAspect_WriteAt<uint64,byte>
+	virtual size_t WriteAt(const uint64& iLoc, const byte* iSource, size_t iCount);
+
+protected:
+	const ZP<FDHolder> fFDHolder;
+	};
+
+// =================================================================================================
+#pragma mark - ChanRWAt_Bin_POSIXFD
+
+class ChanRWAt_Bin_POSIXFD
+:	public virtual ChanRWAt_Bin
+	{
+public:
+	ChanRWAt_Bin_POSIXFD(const ZP<FDHolder>& iFDHolder);
+	~ChanRWAt_Bin_POSIXFD();
+
+// From ChanAspect_ReadAt<uint64,byte>
+	virtual size_t ReadAt(const uint64& iLoc, byte* oDest, size_t iCount);
+
+// From ChanAspect_Size
+	virtual uint64 Size();
+
+// From ChanAspect_SizeSet
+	virtual void SizeSet(uint64 iSize);
+
+// From ChanAspect_WriteAt<uint64,byte>
+	virtual size_t WriteAt(const uint64& iLoc, const byte* iSource, size_t iCount);
+
+protected:
+	const ZP<FDHolder> fFDHolder;
+	};
+
 // =================================================================================================
 #pragma mark - ChanRAbort_Bin_POSIXFD
 
@@ -0,0 +1,244 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/POSIX/Chan_Bin_POSIXMap.h"
+
+#if ZCONFIG_SPI_Enabled(POSIX)
+
+#include "zoolib/Memory.h" // For sMemCompare, sMemCopy
+#include "zoolib/ZDebug.h"
+
+#include <algorithm> // For std::min
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h> // For sysconf
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - Helpers
+
+static int spAdvice(EMapAdvice iAdvice)
+	{
+	switch (iAdvice)
+		{
+		case EMapAdvice::Sequential: return MADV_SEQUENTIAL;
+		case EMapAdvice::Random: return MADV_RANDOM;
+		case EMapAdvice::WillNeed: return MADV_WILLNEED;
+		default: return MADV_NORMAL;
+		}
+	}
+
+// =================================================================================================
+#pragma mark - MappedFile_POSIX
+
+MappedFile_POSIX::MappedFile_POSIX(
+	const ZP<FDHolder>& iFDHolder, const byte* iAddress, size_t iSize)
+:	fFDHolder(iFDHolder)
+,	fAddress(iAddress)
+,	fSize(iSize)
+	{}
+
+ZP<MappedFile_POSIX> MappedFile_POSIX::sQMake(const ZP<FDHolder>& iFDHolder, EMapAdvice iAdvice)
+	{
+	if (not iFDHolder)
+		return null;
+
+	const int theFD = iFDHolder->GetFD();
+
+	struct stat theStat;
+	if (0 > ::fstat(theFD, &theStat))
+		return null;
+
+	// mmap of a zero-length range fails, and pipes, devices etc can't be mapped meaningfully.
+	if (not S_ISREG(theStat.st_mode) || theStat.st_size <= 0)
+		return null;
+
+	if (uint64(theStat.st_size) > uint64(size_t(-1)))
+		return null;
+
+	const size_t theSize = size_t(theStat.st_size);
+
+	void* theAddress = ::mmap(nullptr, theSize, PROT_READ, MAP_SHARED, theFD, 0);
+	if (theAddress == MAP_FAILED)
+		return null;
+
+	if (iAdvice != EMapAdvice::Normal)
+		::madvise(theAddress, theSize, spAdvice(iAdvice));
+
+	return new MappedFile_POSIX(iFDHolder, static_cast<const byte*>(theAddress), theSize);
+	}
+
+MappedFile_POSIX::~MappedFile_POSIX()
+	{ ::munmap(const_cast<byte*>(fAddress), fSize); }
+
+const byte* MappedFile_POSIX::GetPtr() const
+	{ return fAddress; }
+
+size_t MappedFile_POSIX::GetSize() const
+	{ return fSize; }
+
+void MappedFile_POSIX::Advise(EMapAdvice iAdvice)
+	{ ::madvise(const_cast<byte*>(fAddress), fSize, spAdvice(iAdvice)); }
+
+void MappedFile_POSIX::Advise(EMapAdvice iAdvice, size_t iOffset, size_t iCount)
+	{
+	if (iOffset >= fSize)
+		return;
+
+	iCount = std::min(iCount, fSize - iOffset);
+
+	// madvise wants a page-aligned start, so widen the range down to the page boundary.
+	static const size_t spPageSize = size_t(::sysconf(_SC_PAGESIZE));
+	const size_t alignedOffset = iOffset - iOffset % spPageSize;
+
+	::madvise(const_cast<byte*>(fAddress) + alignedOffset,
+		iCount + (iOffset - alignedOffset),
+		spAdvice(iAdvice));
+	}
+
+// =================================================================================================
+#pragma mark - Data_POSIXMap
+
+Data_POSIXMap::Data_POSIXMap()
+:	fOffset(0)
+,	fSize(0)
+	{}
+
+Data_POSIXMap::Data_POSIXMap(const ZP<MappedFile_POSIX>& iMappedFile)
+:	fMappedFile(iMappedFile)
+,	fOffset(0)
+,	fSize(iMappedFile ? iMappedFile->GetSize() : 0)
+	{}
+
+Data_POSIXMap::Data_POSIXMap(const ZP<MappedFile_POSIX>& iMappedFile,
+	size_t iOffset, size_t iSize)
+:	fMappedFile(iMappedFile)
+,	fOffset(0)
+,	fSize(0)
+	{
+	if (fMappedFile)
+		{
+		const size_t theSize = fMappedFile->GetSize();
+		fOffset = std::min(iOffset, theSize);
+		fSize = std::min(iSize, theSize - fOffset);
+		}
+	}
+
+int Data_POSIXMap::Compare(const Data_POSIXMap& iOther) const
+	{
+	// Same ordering as Data_ZZ::Compare -- shorter sorts first, then bytewise.
+	if (fSize < iOther.fSize)
+		return -1;
+	else if (iOther.fSize < fSize)
+		return 1;
+	else if (fSize == 0)
+		return 0;
+	else if (fMappedFile == iOther.fMappedFile && fOffset == iOther.fOffset)
+		return 0;
+	else
+		return sMemCompare(this->GetPtr(), iOther.GetPtr(), fSize);
+	}
+
+bool Data_POSIXMap::operator<(const Data_POSIXMap& iOther) const
+	{ return this->Compare(iOther) < 0; }
+
+bool Data_POSIXMap::operator==(const Data_POSIXMap& iOther) const
+	{ return this->Compare(iOther) == 0; }
+
+size_t Data_POSIXMap::GetSize() const
+	{ return fSize; }
+
+const void* Data_POSIXMap::GetPtr() const
+	{
+	if (fMappedFile)
+		return fMappedFile->GetPtr() + fOffset;
+	return nullptr;
+	}
+
+void Data_POSIXMap::CopyTo(size_t iOffset, void* oDest, size_t iCount) const
+	{
+	ZAssertStop(1, iCount + iOffset <= fSize);
+	if (iCount)
+		sMemCopy(oDest, static_cast<const byte*>(this->GetPtr()) + iOffset, iCount);
+	}
+
+void Data_POSIXMap::CopyTo(void* oDest, size_t iCount) const
+	{ this->CopyTo(0, oDest, iCount); }
+
+Data_POSIXMap Data_POSIXMap::Sub(size_t iOffset, size_t iSize) const
+	{
+	iOffset = std::min(iOffset, fSize);
+	return Data_POSIXMap(fMappedFile, fOffset + iOffset, std::min(iSize, fSize - iOffset));
+	}
+
+Data_ZZ Data_POSIXMap::AsData_ZZ() const
+	{ return Data_ZZ(this->GetPtr(), fSize); }
+
+const ZP<MappedFile_POSIX>& Data_POSIXMap::GetMappedFile() const
+	{ return fMappedFile; }
+
+// =================================================================================================
+#pragma mark - ChanRPos_Bin_POSIXMap
+
+ChanRPos_Bin_POSIXMap::ChanRPos_Bin_POSIXMap(const ZP<MappedFile_POSIX>& iMappedFile)
+:	fMappedFile(iMappedFile)
+,	fPosition(0)
+	{}
+
+ChanRPos_Bin_POSIXMap::~ChanRPos_Bin_POSIXMap()
+	{}
+
+uint64 ChanRPos_Bin_POSIXMap::Pos()
+	{ return fPosition; }
+
+void ChanRPos_Bin_POSIXMap::PosSet(uint64 iPos)
+	{ fPosition = iPos; }
+
+size_t ChanRPos_Bin_POSIXMap::Read(byte* oDest, size_t iCount)
+	{
+	const size_t countToCopy = std::min(iCount, this->Readable());
+	if (countToCopy)
+		{
+		sMemCopy(oDest, fMappedFile->GetPtr() + fPosition, countToCopy);
+		fPosition += countToCopy;
+		}
+	return countToCopy;
+	}
+
+uint64 ChanRPos_Bin_POSIXMap::Skip(uint64 iCount)
+	{
+	const uint64 countToSkip = std::min<uint64>(iCount, this->Readable());
+	fPosition += countToSkip;
+	return countToSkip;
+	}
+
+size_t ChanRPos_Bin_POSIXMap::Readable()
+	{
+	const size_t theSize = fMappedFile->GetSize();
+	return theSize > fPosition ? theSize - size_t(fPosition) : 0;
+	}
+
+PaC<const byte> ChanRPos_Bin_POSIXMap::Borrow()
+	{
+	if (const size_t theCount = this->Readable())
+		return sPaC<const byte>(fMappedFile->GetPtr() + fPosition, theCount);
+	return sPaC<const byte>();
+	}
+
+uint64 ChanRPos_Bin_POSIXMap::Size()
+	{ return fMappedFile->GetSize(); }
+
+size_t ChanRPos_Bin_POSIXMap::Unread(const byte* iSource, size_t iCount)
+	{
+	const size_t countToUnread = sClamped(std::min<uint64>(iCount, fPosition));
+	fPosition -= countToUnread;
+	return countToUnread;
+	}
+
+const ZP<MappedFile_POSIX>& ChanRPos_Bin_POSIXMap::GetMappedFile() const
+	{ return fMappedFile; }
+
+} // namespace ZooLib
+
+#endif // ZCONFIG_SPI_Enabled(POSIX)
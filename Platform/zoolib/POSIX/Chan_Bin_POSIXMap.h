@@ -0,0 +1,142 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_POSIX_Chan_Bin_POSIXMap_h__
+#define __ZooLib_POSIX_Chan_Bin_POSIXMap_h__ 1
+#include "zconfig.h"
+#include "zoolib/ZCONFIG_SPI.h"
+
+#include "zoolib/ChanR_Bin.h"
+#include "zoolib/Counted.h"
+#include "zoolib/Data_ZZ.h"
+
+#include "zoolib/POSIX/Chan_Bin_POSIXFD.h"
+
+#if ZCONFIG_SPI_Enabled(POSIX)
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - EMapAdvice
+
+// Passed through to madvise. Sequential suits a single front-to-back parse, Random suits
+// formats that chase offsets (bplist, zip central directories), WillNeed starts read-ahead
+// of the whole range straight away.
+
+enum class EMapAdvice { Normal, Sequential, Random, WillNeed };
+
+// =================================================================================================
+#pragma mark - MappedFile_POSIX
+
+// A read-only shared mapping of an entire regular file. It holds on to the FDHolder so
+// that any lock taken when the file was opened persists as long as the mapping does.
+// As with any mapping, if some other process truncates the file then touching the
+// now-missing pages raises SIGBUS -- don't map files that are being rewritten in place.
+
+class MappedFile_POSIX
+:	public Counted
+	{
+	MappedFile_POSIX(const ZP<FDHolder>& iFDHolder, const byte* iAddress, size_t iSize);
+
+public:
+	// Returns null if the fd doesn't refer to a non-empty regular file, or if mmap fails.
+	static ZP<MappedFile_POSIX> sQMake(const ZP<FDHolder>& iFDHolder, EMapAdvice iAdvice);
+
+	virtual ~MappedFile_POSIX();
+
+// Our protocol
+	const byte* GetPtr() const;
+	size_t GetSize() const;
+
+	void Advise(EMapAdvice iAdvice);
+	void Advise(EMapAdvice iAdvice, size_t iOffset, size_t iCount);
+
+private:
+	const ZP<FDHolder> fFDHolder;
+	const byte* const fAddress;
+	const size_t fSize;
+	};
+
+// =================================================================================================
+#pragma mark - Data_POSIXMap
+
+// The read-only half of Data_ZZ's API, over some or all of a MappedFile_POSIX. Copies
+// share the mapping. Use AsData_ZZ when a mutable, independent copy is needed.
+
+class Data_POSIXMap
+	{
+public:
+	Data_POSIXMap();
+	Data_POSIXMap(const ZP<MappedFile_POSIX>& iMappedFile);
+	Data_POSIXMap(const ZP<MappedFile_POSIX>& iMappedFile, size_t iOffset, size_t iSize);
+
+	int Compare(const Data_POSIXMap& iOther) const;
+	bool operator<(const Data_POSIXMap& iOther) const;
+	bool operator==(const Data_POSIXMap& iOther) const;
+
+	size_t GetSize() const;
+	const void* GetPtr() const;
+
+	void CopyTo(size_t iOffset, void* oDest, size_t iCount) const;
+	void CopyTo(void* oDest, size_t iCount) const;
+
+	Data_POSIXMap Sub(size_t iOffset, size_t iSize) const;
+
+	Data_ZZ AsData_ZZ() const;
+
+	const ZP<MappedFile_POSIX>& GetMappedFile() const;
+
+private:
+	ZP<MappedFile_POSIX> fMappedFile;
+	size_t fOffset;
+	size_t fSize;
+	};
+
+inline PaC<const void> sPaC(const Data_POSIXMap& iData)
+	{ return sPaC<const void>(iData.GetPtr(), iData.GetSize()); }
+
+template <class T>
+PaC<const T> sPaC(const Data_POSIXMap& iData)
+	{ return sPaC<const T>(static_cast<const T*>(iData.GetPtr()), iData.GetSize() / sizeof(T)); }
+
+// =================================================================================================
+#pragma mark - ChanRPos_Bin_POSIXMap
+
+// Reads are a memcpy out of the mapping, and Borrow lends out everything from the
+// current position to the end, so parsers that use it read straight from the page cache.
+
+class ChanRPos_Bin_POSIXMap
+:	public virtual ChanRPos<byte>
+	{
+public:
+	ChanRPos_Bin_POSIXMap(const ZP<MappedFile_POSIX>& iMappedFile);
+	~ChanRPos_Bin_POSIXMap();
+
+// From Aspect Pos
+	virtual uint64 Pos();
+	virtual void PosSet(uint64 iPos);
+
+// From ChanAspect_Read<byte>
+	virtual size_t Read(byte* oDest, size_t iCount);
+	virtual uint64 Skip(uint64 iCount);
+	virtual size_t Readable();
+	virtual PaC<const byte> Borrow();
+
+// From ChanAspect_Size
+	virtual uint64 Size();
+
+// From ChanAspect_Unread<byte>
+	virtual size_t Unread(const byte* iSource, size_t iCount);
+
+// Our protocol
+	const ZP<MappedFile_POSIX>& GetMappedFile() const;
+
+protected:
+	const ZP<MappedFile_POSIX> fMappedFile;
+	uint64 fPosition;
+	};
+
+} // namespace ZooLib
+
+#endif // ZCONFIG_SPI_Enabled(POSIX)
+
+#endif // __ZooLib_POSIX_Chan_Bin_POSIXMap_h__
@@ -7,6 +7,7 @@
 
 #include "zoolib/POSIX/Chan_Bin_POSIXFD.h"
 #include "zoolib/POSIX/Compat_fcntl.h"
+#include "zoolib/POSIX/Util_POSIXFD.h"
 
 #include <cstring>
 #include <vector>
@@ -809,6 +810,53 @@ ZP<ChannerRWPos_Bin> FileLoc_POSIX::CreateRWPos(bool iOpenExisting, bool iPreven
 	return null;
 	}
 
+ZP<ChannerRAt_Bin> FileLoc_POSIX::OpenRAt(bool iPreventWriters)
+	{
+	if (ZP<FDHolder> theFDHolder = spOpen(this->pGetPath(), true, false, iPreventWriters))
+		return sChanner_T<ChanRAt_Bin_POSIXFD>(theFDHolder);
+	return null;
+	}
+
+ZP<ChannerRWAt_Bin> FileLoc_POSIX::OpenRWAt(bool iPreventWriters)
+	{
+	if (ZP<FDHolder> theFDHolder = spOpen(this->pGetPath(), true, true, iPreventWriters))
+		return sChanner_T<ChanRWAt_Bin_POSIXFD>(theFDHolder);
+	return null;
+	}
+
+ZP<ChannerRPos_Bin> FileLoc_POSIX::OpenRPos_Mapped(bool iPreventWriters, EMapAdvice iAdvice)
+	{
+	if (ZP<FDHolder> theFDHolder = spOpen(this->pGetPath(), true, false, iPreventWriters))
+		{
+		if (ZP<MappedFile_POSIX> theMappedFile = MappedFile_POSIX::sQMake(theFDHolder, iAdvice))
+			return sChanner_T<ChanRPos_Bin_POSIXMap>(theMappedFile);
+		return sChanner_T<ChanRPos_Bin_POSIXFD>(theFDHolder);
+		}
+	return null;
+	}
+
+ZQ<Data_POSIXMap> FileLoc_POSIX::QData_Mapped(bool iPreventWriters, EMapAdvice iAdvice)
+	{
+	if (ZP<FDHolder> theFDHolder = spOpen(this->pGetPath(), true, false, iPreventWriters))
+		{
+		if (ZP<MappedFile_POSIX> theMappedFile = MappedFile_POSIX::sQMake(theFDHolder, iAdvice))
+			return Data_POSIXMap(theMappedFile);
+		}
+	return null;
+	}
+
+bool FileLoc_POSIX::Sync()
+	{
+	// Not spOpen, which takes a lock and refuses directories. A read-only fd will do, fsync
+	// applies to the file not to the fd that names it.
+	const int theFD = ::open(this->pGetPath().c_str(), O_RDONLY | O_NOCTTY);
+	if (theFD < 0)
+		return false;
+
+	const ZP<FDHolder> theFDHolder = new FDHolder_CloseOnDestroy(theFD);
+	return Util_POSIXFD::sSync(theFDHolder->GetFD());
+	}
+
 string FileLoc_POSIX::pGetPath()
 	{
 	if (fComps.empty())
@@ -829,6 +877,35 @@ string FileLoc_POSIX::pGetPath()
 	return result;
 	}
 
+// =================================================================================================
+#pragma mark - Mapped access via FileSpec
+
+ZP<ChannerRPos_Bin> sOpenRPos_Mapped(const FileSpec& iFS,
+	EMapAdvice iAdvice, bool iPreventWriters)
+	{
+	if (ZP<FileLoc_POSIX> theLoc = iFS.GetFileLoc().DynamicCast<FileLoc_POSIX>())
+		return theLoc->OpenRPos_Mapped(iPreventWriters, iAdvice);
+	return iFS.OpenRPos(iPreventWriters);
+	}
+
+ZQ<Data_POSIXMap> sQData_Mapped(const FileSpec& iFS,
+	EMapAdvice iAdvice, bool iPreventWriters)
+	{
+	if (ZP<FileLoc_POSIX> theLoc = iFS.GetFileLoc().DynamicCast<FileLoc_POSIX>())
+		return theLoc->QData_Mapped(iPreventWriters, iAdvice);
+	return null;
+	}
+
+// =================================================================================================
+#pragma mark - sSync
+
+bool sSync(const FileSpec& iFS)
+	{
+	if (ZP<FileLoc_POSIX> theLoc = iFS.GetFileLoc().DynamicCast<FileLoc_POSIX>())
+		return theLoc->Sync();
+	return false;
+	}
+
 } // namespace ZooLib
 
 #endif // ZCONFIG_API_Enabled(File_POSIX)
@@ -11,6 +11,8 @@
 #include "zoolib/ChanW_Bin.h"
 #include "zoolib/File.h"
 
+#include "zoolib/POSIX/Chan_Bin_POSIXMap.h"
+
 #ifndef ZCONFIG_API_Avail__File_POSIX
 	#define ZCONFIG_API_Avail__File_POSIX ZCONFIG_SPI_Enabled(POSIX)
 #endif
@@ -75,6 +77,15 @@ public:
 	ZP<ChannerWPos_Bin> CreateWPos(bool iOpenExisting, bool iPreventWriters) override;
 	ZP<ChannerRWPos_Bin> CreateRWPos(bool iOpenExisting, bool iPreventWriters) override;
 
+	ZP<ChannerRAt_Bin> OpenRAt(bool iPreventWriters) override;
+	ZP<ChannerRWAt_Bin> OpenRWAt(bool iPreventWriters) override;
+
+// Our protocol
+	ZP<ChannerRPos_Bin> OpenRPos_Mapped(bool iPreventWriters, EMapAdvice iAdvice);
+	ZQ<Data_POSIXMap> QData_Mapped(bool iPreventWriters, EMapAdvice iAdvice);
+
+	bool Sync();
+
 	std::string pGetPath();
 
 private:
@@ -82,6 +93,30 @@ private:
 	std::vector<std::string> fComps;
 	};
 
+// =================================================================================================
+#pragma mark - Mapped access via FileSpec
+
+// OpenRPos never maps, mapping is only ever done when asked for. If iFS isn't a POSIX file,
+// or it can't be mapped (it's empty, or it's not a regular file), sOpenRPos_Mapped falls
+// back to iFS.OpenRPos, and sQData_Mapped returns null. Touching the mapping of a file
+// that's been truncated raises SIGBUS, so unless iPreventWriters is true the caller must
+// know that nothing will shrink the file while the mapping is in use.
+
+ZP<ChannerRPos_Bin> sOpenRPos_Mapped(const FileSpec& iFS,
+	EMapAdvice iAdvice = EMapAdvice::Normal, bool iPreventWriters = false);
+
+ZQ<Data_POSIXMap> sQData_Mapped(const FileSpec& iFS,
+	EMapAdvice iAdvice = EMapAdvice::Normal, bool iPreventWriters = false);
+
+// =================================================================================================
+#pragma mark - sSync
+
+// Returns once the file's content is on stable storage, or false if it couldn't be opened or
+// synced, or isn't a POSIX file. For a directory it's the entries that are made durable, so
+// syncing the parent is what commits a file's creation, rename or deletion.
+
+bool sSync(const FileSpec& iFS);
+
 } // namespace ZooLib
 
 #endif // ZCONFIG_API_Enabled(File_POSIX)
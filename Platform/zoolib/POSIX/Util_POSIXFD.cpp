@@ -226,6 +226,36 @@ size_t sReadable(int iFD)
 	return 0;
 	}
 
+// pread and pwrite don't touch the fd's offset, so they're safe to use on one fd from
+// multiple threads at once, and they don't disturb anyone using Read/Write/PosSet.
+size_t sReadAt(int iFD, uint64 iLoc, byte* oDest, size_t iCount)
+	{
+	byte* localDest = oDest;
+	while (iCount)
+		{
+		#if (defined(linux) || defined(__linux__)) && not defined (__ANDROID__)
+			ssize_t countRead = ::pread64(iFD, localDest, iCount, iLoc);
+		#else
+			ssize_t countRead = ::pread(iFD, localDest, iCount, iLoc);
+		#endif
+
+		if (countRead == 0)
+			break;
+
+		if (countRead < 0)
+			{
+			int err = errno;
+			if (err == EINTR)
+				continue;
+			break;
+			}
+		iCount -= countRead;
+		localDest += countRead;
+		iLoc += countRead;
+		}
+	return localDest - oDest;
+	}
+
 uint64 sSize(int iFD)
 	{
 	#if (defined(linux) || defined(__linux__))
@@ -251,6 +281,24 @@ void sSizeSet(int iFD, uint64 iSize)
 	#endif
 	}
 
+// Returns once iFD's data and metadata are on stable storage. On MacOS fsync only gets them
+// as far as the drive, so we ask for F_FULLFSYNC, and fall back to fsync if it's refused.
+bool sSync(int iFD)
+	{
+	#if defined(__APPLE__) && defined(F_FULLFSYNC)
+		if (-1 != ::fcntl(iFD, F_FULLFSYNC))
+			return true;
+	#endif
+
+	for (;;)
+		{
+		if (0 == ::fsync(iFD))
+			return true;
+		if (errno != EINTR)
+			return false;
+		}
+	}
+
 size_t sUnread(int iFD, const byte* iSource, size_t iCount)
 	{
 	const uint64 pos = sPos(iFD);
@@ -288,6 +336,31 @@ size_t sWrite(int iFD, const byte* iSource, size_t iCount)
 	return localSource - iSource;
 	}
 
+size_t sWriteAt(int iFD, uint64 iLoc, const byte* iSource, size_t iCount)
+	{
+	const byte* localSource = iSource;
+	while (iCount)
+		{
+		#if (defined(linux) || defined(__linux__)) && not defined (__ANDROID__)
+			ssize_t countWritten = ::pwrite64(iFD, localSource, iCount, iLoc);
+		#else
+			ssize_t countWritten = ::pwrite(iFD, localSource, iCount, iLoc);
+		#endif
+
+		if (countWritten < 0)
+			{
+			int err = errno;
+			if (err == EINTR)
+				continue;
+			break;
+			}
+		iCount -= countWritten;
+		localSource += countWritten;
+		iLoc += countWritten;
+		}
+	return localSource - iSource;
+	}
+
 size_t sWriteCon(int iFD, const byte* iSource, size_t iCount)
 	{
 	const byte* localSource = iSource;
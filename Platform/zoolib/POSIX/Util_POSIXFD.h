@@ -33,12 +33,15 @@ uint64 sSkip(int iFD, uint64 iDelta);
 size_t sRead(int iFD, byte* oDest, size_t iCount);
 size_t sReadCon(int iFD, byte* oDest, size_t iCount);
 size_t sReadable(int iFD);
+size_t sReadAt(int iFD, uint64 iLoc, byte* oDest, size_t iCount);
 uint64 sSize(int iFD);
 void sSizeSet(int iFD, uint64 iSize);
+bool sSync(int iFD);
 size_t sUnread(int iFD, const byte* iSource, size_t iCount);
 // size_t sUnreadableLimit(int iFD);
 size_t sWrite(int iFD, const byte* iSource, size_t iCount);
 size_t sWriteCon(int iFD, const byte* iSource, size_t iCount);
+size_t sWriteAt(int iFD, uint64 iLoc, const byte* iSource, size_t iCount);
 
 } // namespace Util_POSIXFD
 } // namespace ZooLib
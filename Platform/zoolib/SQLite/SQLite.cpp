@@ -2,19 +2,97 @@
 
 #include "zoolib/SQLite/SQLite.h"
 
+#include "zoolib/Coerce_Any.h"
 #include "zoolib/Data_ZZ.h"
 
+#include "zoolib/ZMACRO_foreach.h"
+
 #include <stdexcept>
 
 namespace ZooLib {
 namespace SQLite {
 
+using std::vector;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const size_t kStatementCacheSize = 32;
+
+void spBind(sqlite3_stmt* iStmt, int iIndex, const Val_DB& iVal)
+	{
+	if (iVal.IsNull())
+		{
+		::sqlite3_bind_null(iStmt, iIndex);
+		}
+	else if (const string8* theString = iVal.PGet<string8>())
+		{
+		::sqlite3_bind_text(iStmt, iIndex,
+			theString->data(), theString->size(), SQLITE_TRANSIENT);
+		}
+	else if (const double* theDouble = iVal.PGet<double>())
+		{
+		::sqlite3_bind_double(iStmt, iIndex, *theDouble);
+		}
+	else if (const Data_ZZ* theData = iVal.PGet<Data_ZZ>())
+		{
+		::sqlite3_bind_blob(iStmt, iIndex,
+			theData->GetPtr(), theData->GetSize(), SQLITE_TRANSIENT);
+		}
+	else if (ZQ<int64> theQ = sQCoerceInt(iVal))
+		{
+		::sqlite3_bind_int64(iStmt, iIndex, *theQ);
+		}
+	else if (const bool* theBool = iVal.PGet<bool>())
+		{
+		::sqlite3_bind_int64(iStmt, iIndex, *theBool ? 1 : 0);
+		}
+	else
+		{
+		throw std::runtime_error(std::string(__FUNCTION__) + ", Unhandled parameter type");
+		}
+	}
+
+void spSetFromColumn(sqlite3_stmt* iStmt, int iIndex, Val_DB& oVal)
+	{
+	switch (::sqlite3_column_type(iStmt, iIndex))
+		{
+		case SQLITE_INTEGER:
+			{
+			oVal = int64(::sqlite3_column_int64(iStmt, iIndex));
+			break;
+			}
+		case SQLITE_FLOAT:
+			{
+			oVal = ::sqlite3_column_double(iStmt, iIndex);
+			break;
+			}
+		case SQLITE3_TEXT:
+			{
+			const unsigned char* theText = ::sqlite3_column_text(iStmt, iIndex);
+			oVal = string8((const char*)theText, ::sqlite3_column_bytes(iStmt, iIndex));
+			break;
+			}
+		case SQLITE_BLOB:
+			{
+			const void* theData = ::sqlite3_column_blob(iStmt, iIndex);
+			oVal = Data_ZZ(theData, ::sqlite3_column_bytes(iStmt, iIndex));
+			break;
+			}
+		}
+	}
+
+} // anonymous namespace
+
 // =================================================================================================
 #pragma mark - SQLite
 
 DB::DB(const string8& iPath)
 :	fDB(nullptr)
 ,	fAdopted(true)
+,	fStatementCacheSize(kStatementCacheSize)
 	{
 	if (SQLITE_OK != ::sqlite3_open(iPath.c_str(), &fDB))
 		throw std::runtime_error(std::string(__FUNCTION__) + ", Couldn't open sqlite database");
@@ -23,10 +101,15 @@ DB::DB(const string8& iPath)
 DB::DB(sqlite3* iDB, bool iAdopt)
 :	fDB(iDB)
 ,	fAdopted(iAdopt)
+,	fStatementCacheSize(kStatementCacheSize)
 	{}
 
 DB::~DB()
 	{
+	// Iters hold a ZP<DB>, so every statement is back in the cache by now.
+	foreacha (entry, fStatements)
+		::sqlite3_finalize(entry.second);
+
 	if (fDB && fAdopted)
 		::sqlite3_close(fDB);
 	}
@@ -34,6 +117,59 @@ DB::~DB()
 sqlite3* DB::GetDB()
 	{ return fDB; }
 
+void DB::SetStatementCacheSize(size_t iCount)
+	{
+	ZAcqMtx acq(fMtx);
+	fStatementCacheSize = iCount;
+	this->pTrim();
+	}
+
+sqlite3_stmt* DB::pCheckOut(const string8& iSQL)
+	{
+	{
+	ZAcqMtx acq(fMtx);
+	const auto iter = fStatements_BySQL.find(iSQL);
+	if (iter != fStatements_BySQL.end())
+		{
+		sqlite3_stmt* result = iter->second->second;
+		fStatements.erase(iter->second);
+		fStatements_BySQL.erase(iter);
+		return result;
+		}
+	}
+
+	sqlite3_stmt* result = nullptr;
+	::sqlite3_prepare_v2(fDB, iSQL.c_str(), iSQL.size(), &result, nullptr);
+	return result;
+	}
+
+void DB::pCheckIn(const string8& iSQL, sqlite3_stmt* iStmt)
+	{
+	::sqlite3_reset(iStmt);
+	::sqlite3_clear_bindings(iStmt);
+
+	ZAcqMtx acq(fMtx);
+	fStatements.push_front(std::make_pair(iSQL, iStmt));
+	fStatements_BySQL.insert(std::make_pair(iSQL, fStatements.begin()));
+	this->pTrim();
+	}
+
+void DB::pTrim()
+	{
+	while (fStatements.size() > fStatementCacheSize)
+		{
+		Statements::iterator theLRU = --fStatements.end();
+
+		auto theRange = fStatements_BySQL.equal_range(theLRU->first);
+		while (theRange.first->second != theLRU)
+			++theRange.first;
+		fStatements_BySQL.erase(theRange.first);
+
+		::sqlite3_finalize(theLRU->second);
+		fStatements.erase(theLRU);
+		}
+	}
+
 // =================================================================================================
 #pragma mark - Iter
 
@@ -43,14 +179,15 @@ sqlite3* DB::GetDB()
 // fPosition == 1 still references the first result, but sqlite3_step
 // has been called, and fHasValue tells us if we've got a value.
 
-Iter::Iter(ZP<DB> iDB, const string8& iSQL, uint64 iPosition)
+Iter::Iter(ZP<DB> iDB, const string8& iSQL, const vector<Val_DB>& iParams, uint64 iPosition)
 :	fDB(iDB)
 ,	fSQL(iSQL)
+,	fParams(iParams)
 ,	fStmt(nullptr)
 ,	fHasValue(false)
 ,	fPosition(0)
 	{
-	::sqlite3_prepare_v2(fDB->GetDB(), fSQL.c_str(), fSQL.size(), &fStmt, nullptr);
+	this->pPrepare();
 
 	if (fStmt)
 		{
@@ -71,12 +208,21 @@ Iter::Iter(ZP<DB> iDB, const string8& iSQL)
 ,	fStmt(nullptr)
 ,	fHasValue(false)
 ,	fPosition(0)
-	{ ::sqlite3_prepare_v2(fDB->GetDB(), fSQL.c_str(), fSQL.size(), &fStmt, nullptr); }
+	{ this->pPrepare(); }
+
+Iter::Iter(ZP<DB> iDB, const string8& iSQL, const vector<Val_DB>& iParams)
+:	fDB(iDB)
+,	fSQL(iSQL)
+,	fParams(iParams)
+,	fStmt(nullptr)
+,	fHasValue(false)
+,	fPosition(0)
+	{ this->pPrepare(); }
 
 Iter::~Iter()
 	{
 	if (fStmt)
-		::sqlite3_finalize(fStmt);
+		fDB->pCheckIn(fSQL, fStmt);
 	}
 
 ZP<Iter> Iter::Clone(bool iRewound)
@@ -84,8 +230,8 @@ ZP<Iter> Iter::Clone(bool iRewound)
 	if (fStmt)
 		{
 		if (iRewound)
-			return new Iter(fDB, fSQL);
-		return new Iter(fDB, fSQL, fPosition);
+			return new Iter(fDB, fSQL, fParams);
+		return new Iter(fDB, fSQL, fParams, fPosition);
 		}
 	return this;
 	}
@@ -170,6 +316,50 @@ Any Iter::Get(size_t iIndex)
 	return Any();
 	}
 
+size_t Iter::ReadRows(vector<Val_DB>& ioPackedRows, size_t iMaxRows)
+	{
+	if (not fStmt)
+		return 0;
+
+	if (fPosition == 0)
+		this->pAdvance();
+
+	const int theCount = ::sqlite3_column_count(fStmt);
+	size_t result = 0;
+	while (fHasValue && result < iMaxRows)
+		{
+		const size_t theOffset = ioPackedRows.size();
+		ioPackedRows.resize(theOffset + theCount);
+		for (int xx = 0; xx < theCount; ++xx)
+			spSetFromColumn(fStmt, xx, ioPackedRows[theOffset + xx]);
+		++result;
+		this->pAdvance();
+		}
+	return result;
+	}
+
+void Iter::pPrepare()
+	{
+	fStmt = fDB->pCheckOut(fSQL);
+
+	if (fStmt)
+		{
+		for (size_t xx = 0; xx < fParams.size(); ++xx)
+			{
+			try
+				{
+				spBind(fStmt, int(xx + 1), fParams[xx]);
+				}
+			catch (...)
+				{
+				fDB->pCheckIn(fSQL, fStmt);
+				fStmt = nullptr;
+				throw;
+				}
+			}
+		}
+	}
+
 void Iter::pAdvance()
 	{
 	ZAssert(fStmt);
@@ -8,6 +8,12 @@
 #include "zoolib/Counted.h"
 #include "zoolib/StdInt.h"
 #include "zoolib/UnicodeString.h"
+#include "zoolib/Val_DB.h"
+#include "zoolib/ZThread.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 #include <sqlite3.h>
 
@@ -27,9 +33,29 @@ public:
 
 	sqlite3* GetDB();
 
+	// Iters get their statements from a cache keyed by SQL text, and return them to it when
+	// they're done. Up to iCount statements not in use are kept, and the least recently
+	// used is finalized to make room. The default is 32.
+	void SetStatementCacheSize(size_t iCount);
+
 private:
+	friend class Iter;
+
+	sqlite3_stmt* pCheckOut(const string8& iSQL);
+	void pCheckIn(const string8& iSQL, sqlite3_stmt* iStmt);
+	void pTrim();
+
 	sqlite3* fDB;
 	bool fAdopted;
+
+	ZMtx fMtx;
+	size_t fStatementCacheSize;
+
+	// Most recently used at the front. A Clone can have the same SQL as its original, so
+	// there may be several statements for the same SQL.
+	typedef std::list<std::pair<string8,sqlite3_stmt*>> Statements;
+	Statements fStatements;
+	std::unordered_multimap<string8,Statements::iterator> fStatements_BySQL;
 	};
 
 // =================================================================================================
@@ -37,10 +63,14 @@ private:
 
 class Iter : public Counted
 	{
-	Iter(ZP<DB> iDB, const string8& iSQL, uint64 iPosition);
+	Iter(ZP<DB> iDB, const string8& iSQL, const std::vector<Val_DB>& iParams, uint64 iPosition);
 
 public:
 	Iter(ZP<DB> iDB, const string8& iSQL);
+
+	// iParams are bound, in order, to the SQL's '?' parameters.
+	Iter(ZP<DB> iDB, const string8& iSQL, const std::vector<Val_DB>& iParams);
+
 	virtual ~Iter();
 
 	ZP<Iter> Clone(bool iRewound);
@@ -52,11 +82,18 @@ public:
 	string8 NameOf(size_t iIndex);
 	Any Get(size_t iIndex);
 
+	// Appends up to iMaxRows rows of Count() values each to ioPackedRows, decoding straight
+	// from the statement, and advances past them. Returns the number of rows appended, which
+	// is less than iMaxRows only when there are no more.
+	size_t ReadRows(std::vector<Val_DB>& ioPackedRows, size_t iMaxRows);
+
 private:
+	void pPrepare();
 	void pAdvance();
 
 	ZP<DB> fDB;
 	const string8 fSQL;
+	const std::vector<Val_DB> fParams;
 	sqlite3_stmt* fStmt;
 	bool fHasValue;
 	uint64 fPosition;
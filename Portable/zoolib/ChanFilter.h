@@ -92,6 +92,9 @@ public:
 
 	virtual size_t Readable()
 		{ return sReadable(DerivedFrom_p::pGetChan()); }
+
+	// Borrow is deliberately not forwarded. A filter that overrides Read would otherwise
+	// expose its source's unfiltered elements.
 	};
 
 // =================================================================================================
@@ -7,68 +7,344 @@
 
 #include "zoolib/Chan.h"
 #include "zoolib/Memory.h"
+#include "zoolib/ZDebug.h" // For ZAssert
+
+#include <algorithm> // For std::sort
+#include <unordered_map>
+#include <vector>
 
 namespace ZooLib {
 
 // =================================================================================================
-#pragma mark - ChanRPos_XX_PageBuffered
+#pragma mark - PageBufferedCounters
 
-/** A positionable read filter stream that buffers a fixed number of fixed size chunks
-which are read in preference to accessing the source stream. Chunks are recycled in
-least recently used order.
+struct PageBufferedCounters
+	{
+	uint64 fHits;
+	uint64 fMisses;
+	uint64 fEvictions;
+	uint64 fPagesReadAhead;
+	uint64 fReads;
+	uint64 fWrites;
+	};
+
+// =================================================================================================
+#pragma mark - PageBuffered_Pages
+
+/** The bookkeeping shared by ChanRPos_XX_PageBuffered and ChanRWPos_XX_PageBuffered. A fixed
+number of fixed size pages, found by a hash of their start position and recycled in least
+recently used order. It also tracks misses, so that a run of misses on consecutive pages
+gets a growing read-ahead window, and it hands out runs of adjacent pages so callers can
+make a single underlying read or write for several pages.
 */
 template <class EE>
-class ChanRPos_XX_PageBuffered
-:	public virtual ChanRPos<EE>
+class PageBuffered_Pages
 	{
 public:
-	ChanRPos_XX_PageBuffered(const ChanRPos<EE>& iChanRPos, size_t iBufferCount, size_t iBufferSize)
-	:	fChanReal(iChanRPos)
+	struct Page
 		{
-		fBuffer_Head = nullptr;
-		fBuffer_Tail = nullptr;
+		Page* fPrev;
+		Page* fNext;
+		EE* fData;
+		uint64 fStartPosition;
+		bool fLoaded;
+		bool fDirty;
+		};
 
-		fBufferSize = iBufferSize;
+	PageBuffered_Pages(size_t iPageCount, size_t iPageSize)
+	:	fPage_Head(nullptr)
+	,	fPage_Tail(nullptr)
+	,	fPage_Last(nullptr)
+	,	fPageSize(iPageSize)
+	,	fPageCount(iPageCount)
+	,	fMaxRunPages(std::min<size_t>(32, std::max<size_t>(1, iPageCount / 2)))
+	,	fNextSequential(uint64(-1))
+	,	fReadAhead(1)
+		{
+		ZAssert(iPageCount && iPageSize);
 
-		fPosition = sPos(fChanReal);
+		fCounters = PageBufferedCounters();
 
-		// Allocate all the buffers now, so we don't have to do it dynamically
-		while (iBufferCount--)
+		fPages.reserve(iPageCount);
+
+		// Allocate all the pages now, so we don't have to do it dynamically
+		while (iPageCount--)
 			{
-			Buffer* aBuffer = new Buffer;
-			aBuffer->fData = aBuffer->fData = new EE[fBufferSize];
-			// By marking the start position as covering the last fBufferSize
-			// bytes of the 64 bit address space we don't need to carry
-			// a loaded flag. The weakness is if the user needs to read
-			// that part of the address space before all the buffers have
-			// been used for other portions. This is unlikely, but possible.
-			aBuffer->fStartPosition = 0 - fBufferSize;
-			aBuffer->fPrev = nullptr;
-			aBuffer->fNext = fBuffer_Head;
-			if (fBuffer_Head)
-				{
-				fBuffer_Head->fPrev = aBuffer;
-				fBuffer_Head = aBuffer;
-				}
+			Page* aPage = new Page;
+			aPage->fData = new EE[fPageSize];
+			aPage->fStartPosition = 0;
+			aPage->fLoaded = false;
+			aPage->fDirty = false;
+			aPage->fPrev = nullptr;
+			aPage->fNext = fPage_Head;
+			if (fPage_Head)
+				fPage_Head->fPrev = aPage;
 			else
+				fPage_Tail = aPage;
+			fPage_Head = aPage;
+			}
+		}
+
+	~PageBuffered_Pages()
+		{
+		for (Page* page_Current = fPage_Head; page_Current; /*no inc*/)
+			{
+			Page* nextPage = page_Current->fNext;
+			delete[] page_Current->fData;
+			delete page_Current;
+			page_Current = nextPage;
+			}
+		}
+
+	// How much of iCount elements starting at iPos lie within iSize.
+	static size_t sClampedToSize(uint64 iCount, uint64 iSize, uint64 iPos)
+		{ return sClamped(iPos < iSize ? std::min(iCount, iSize - iPos) : 0); }
+
+	size_t PageSize() const
+		{ return fPageSize; }
+
+	size_t MaxRunPages() const
+		{ return fMaxRunPages; }
+
+	uint64 PageStart(uint64 iPos) const
+		{ return iPos - iPos % fPageSize; }
+
+	// The resident page starting at iStartPosition, or null. Doesn't touch LRU order or counters.
+	Page* Find(uint64 iStartPosition) const
+		{
+		auto iter = fPages.find(iStartPosition);
+		if (iter == fPages.end())
+			return nullptr;
+		return iter->second;
+		}
+
+	// The resident page containing iPos, made most recently used, or null (counting a miss).
+	Page* Use(uint64 iPos)
+		{
+		Page* thePage = fPage_Last;
+		if (not thePage || not thePage->fLoaded
+			|| thePage->fStartPosition > iPos || thePage->fStartPosition + fPageSize <= iPos)
+			{
+			thePage = this->Find(this->PageStart(iPos));
+			if (not thePage)
 				{
-				fBuffer_Head = aBuffer;
-				fBuffer_Tail = aBuffer;
+				++fCounters.fMisses;
+				return nullptr;
 				}
 			}
+		++fCounters.fHits;
+		this->pMoveToHead(thePage);
+		fPage_Last = thePage;
+		return thePage;
+		}
+
+	// The page that the iIndex'th following Assign will recycle. Callers should write it
+	// back if it's dirty.
+	Page* Victim(size_t iIndex = 0) const
+		{
+		Page* thePage = fPage_Tail;
+		while (iIndex-- && thePage->fPrev)
+			thePage = thePage->fPrev;
+		return thePage;
+		}
+
+	// Recycle the least recently used page to hold iStartPosition, and make it the most
+	// recently used. The caller fills in its data.
+	Page* Assign(uint64 iStartPosition)
+		{
+		Page* thePage = fPage_Tail;
+		ZAssert(not thePage->fDirty);
+		if (thePage->fLoaded)
+			{
+			++fCounters.fEvictions;
+			fPages.erase(thePage->fStartPosition);
+			}
+		thePage->fStartPosition = iStartPosition;
+		thePage->fLoaded = true;
+		fPages[iStartPosition] = thePage;
+		this->pMoveToHead(thePage);
+		fPage_Last = thePage;
+		return thePage;
+		}
+
+	// Forget a page's contents, and make it the first to be recycled.
+	void Discard(Page* iPage)
+		{
+		if (iPage->fLoaded)
+			{
+			fPages.erase(iPage->fStartPosition);
+			iPage->fLoaded = false;
+			}
+		iPage->fDirty = false;
+		if (fPage_Last == iPage)
+			fPage_Last = nullptr;
+		this->pMoveToTail(iPage);
+		}
+
+	// Called on a miss at iStartPosition. Returns how many pages to load, starting there. A miss
+	// on the page following the previous load doubles the window, any other miss resets it.
+	size_t NoteMiss(uint64 iStartPosition)
+		{
+		if (iStartPosition == fNextSequential)
+			fReadAhead = std::min(fReadAhead * 2, fMaxRunPages);
+		else
+			fReadAhead = 1;
+		return fReadAhead;
+		}
+
+	void NoteLoaded(uint64 iStartPosition, size_t iPageCount)
+		{
+		fNextSequential = iStartPosition + iPageCount * fPageSize;
+		++fCounters.fReads;
+		if (iPageCount > 1)
+			fCounters.fPagesReadAhead += iPageCount - 1;
+		}
+
+	void NoteWrite()
+		{ ++fCounters.fWrites; }
+
+	// The dirty pages, in ascending order of position.
+	std::vector<Page*> DirtyPages() const
+		{
+		std::vector<Page*> result;
+		for (Page* page_Current = fPage_Head; page_Current; page_Current = page_Current->fNext)
+			{
+			if (page_Current->fDirty)
+				result.push_back(page_Current);
+			}
+		std::sort(result.begin(), result.end(),
+			[](const Page* iL, const Page* iR) { return iL->fStartPosition < iR->fStartPosition; });
+		return result;
 		}
 
-	~ChanRPos_XX_PageBuffered()
+	// Every resident page, in no particular order.
+	template <class Callable_p>
+	void ForEachLoaded(Callable_p iCallable)
 		{
-		for (Buffer* buffer_Current = fBuffer_Head; buffer_Current; /*no inc*/)
+		for (Page* page_Current = fPage_Head; page_Current; /*no inc*/)
 			{
-			Buffer* nextBuffer = buffer_Current->fNext;
-			delete[] buffer_Current->fData;
-			delete buffer_Current;
-			buffer_Current = nextBuffer;
+			// iCallable may Discard page_Current, which moves it to the tail.
+			Page* nextPage = page_Current->fNext;
+			if (page_Current->fLoaded)
+				iCallable(page_Current);
+			page_Current = nextPage;
 			}
 		}
 
+	// Assign the run of iPageCount pages starting at iStart from the iCountRead elements read
+	// into Staging. A page is assigned only if the read reached its end, or reached the end of
+	// the stream (iCountExpected), in which case the rest of the page is zeroed. Returns the
+	// page at iStart, or null if the read didn't get that far.
+	Page* AssignFromStaging(uint64 iStart, size_t iPageCount,
+		size_t iCountRead, size_t iCountExpected)
+		{
+		size_t countValid = iCountRead;
+		if (iCountRead == iCountExpected)
+			{
+			countValid = iPageCount * fPageSize;
+			std::fill(fStaging.begin() + iCountRead, fStaging.begin() + countValid, EE());
+			}
+
+		// Assign the furthest page first, so the one at iStart ends up most recently used.
+		Page* thePage = nullptr;
+		for (size_t xx = countValid / fPageSize; xx--; /*no inc*/)
+			{
+			thePage = this->Assign(iStart + xx * fPageSize);
+			std::copy_n(fStaging.begin() + xx * fPageSize, fPageSize, thePage->fData);
+			}
+		return thePage;
+		}
+
+	// Somewhere to assemble a run of pages for a single read or write.
+	EE* Staging(size_t iPageCount)
+		{
+		if (fStaging.size() < iPageCount * fPageSize)
+			fStaging.resize(iPageCount * fPageSize);
+		return &fStaging[0];
+		}
+
+	const PageBufferedCounters& GetCounters() const
+		{ return fCounters; }
+
+	void ResetCounters()
+		{ fCounters = PageBufferedCounters(); }
+
+private:
+	void pUnlink(Page* iPage)
+		{
+		if (iPage->fPrev)
+			iPage->fPrev->fNext = iPage->fNext;
+		else
+			fPage_Head = iPage->fNext;
+
+		if (iPage->fNext)
+			iPage->fNext->fPrev = iPage->fPrev;
+		else
+			fPage_Tail = iPage->fPrev;
+		}
+
+	void pMoveToHead(Page* iPage)
+		{
+		if (fPage_Head == iPage)
+			return;
+		this->pUnlink(iPage);
+		iPage->fPrev = nullptr;
+		iPage->fNext = fPage_Head;
+		fPage_Head->fPrev = iPage;
+		fPage_Head = iPage;
+		}
+
+	void pMoveToTail(Page* iPage)
+		{
+		if (fPage_Tail == iPage)
+			return;
+		this->pUnlink(iPage);
+		iPage->fNext = nullptr;
+		iPage->fPrev = fPage_Tail;
+		fPage_Tail->fNext = iPage;
+		fPage_Tail = iPage;
+		}
+
+	std::unordered_map<uint64,Page*> fPages;
+	Page* fPage_Head;
+	Page* fPage_Tail;
+	Page* fPage_Last;
+
+	const size_t fPageSize;
+	const size_t fPageCount;
+	const size_t fMaxRunPages;
+
+	uint64 fNextSequential;
+	size_t fReadAhead;
+
+	std::vector<EE> fStaging;
+
+	PageBufferedCounters fCounters;
+	};
+
+// =================================================================================================
+#pragma mark - ChanRPos_XX_PageBuffered
+
+/** A positionable read filter stream that buffers a fixed number of fixed size chunks
+which are read in preference to accessing the source stream. Chunks are recycled in
+least recently used order. Sequential access is detected, and satisfied with a single
+read of several chunks.
+*/
+template <class EE>
+class ChanRPos_XX_PageBuffered
+:	public virtual ChanRPos<EE>
+	{
+public:
+	typedef PageBuffered_Pages<EE> Pages;
+	typedef typename Pages::Page Page;
+
+	ChanRPos_XX_PageBuffered(const ChanRPos<EE>& iChanRPos, size_t iBufferCount, size_t iBufferSize)
+	:	fChanReal(iChanRPos)
+	,	fPages(iBufferCount, iBufferSize)
+		{
+		fPosition = sPos(fChanReal);
+		}
+
 // From ChanAspect_Pos,
 	virtual uint64 Pos()
 		{ return fPosition; }
@@ -80,55 +356,26 @@ public:
 // From ChanAspect_Read<EE>,
 	virtual size_t Read(EE* oDest, size_t iCount)
 		{
+		const size_t theBufferSize = fPages.PageSize();
 		EE* localDest = oDest;
-		iCount = sClamped(sClamped(iCount, sSize(fChanReal), fPosition));
+		const uint64 streamSize = sSize(fChanReal);
+		iCount = Pages::sClampedToSize(iCount, streamSize, fPosition);
 		while (iCount)
 			{
-			// Do we have the offset in our buffers?
-			Buffer* buffer_Found = fBuffer_Head;
-			while (buffer_Found)
+			Page* page_Found = fPages.Use(fPosition);
+			if (page_Found == nullptr)
 				{
-				if (buffer_Found->fStartPosition <= fPosition
-					&& buffer_Found->fStartPosition + fBufferSize > fPosition)
-					{
+				page_Found = this->pLoad(fPages.PageStart(fPosition), streamSize);
+				if (page_Found == nullptr)
 					break;
-					}
-				buffer_Found = buffer_Found->fNext;
 				}
 
-			if (buffer_Found == nullptr)
-				{
-				buffer_Found = fBuffer_Tail;
-				buffer_Found->fStartPosition = fPosition - (fPosition % fBufferSize);
-				sPosSet(fChanReal, buffer_Found->fStartPosition);
-				sRead(fChanReal, buffer_Found->fData, fBufferSize);
-				}
-
-			const size_t offsetInBuffer = fPosition % fBufferSize;
-			const size_t copyCount = sClamped(sClamped(iCount, fBufferSize, offsetInBuffer));
-			std::copy_n(buffer_Found->fData + offsetInBuffer, copyCount, localDest);
+			const size_t offsetInBuffer = fPosition % theBufferSize;
+			const size_t copyCount = std::min(iCount, theBufferSize - offsetInBuffer);
+			std::copy_n(page_Found->fData + offsetInBuffer, copyCount, localDest);
 			iCount -= copyCount;
 			fPosition += copyCount;
 			localDest += copyCount;
-
-			if (fBuffer_Head != buffer_Found)
-				{
-				// Move buffer_Found to the head of the list by removing it
-				if (buffer_Found->fPrev)
-					buffer_Found->fPrev->fNext = buffer_Found->fNext;
-				if (buffer_Found->fNext)
-					buffer_Found->fNext->fPrev = buffer_Found->fPrev;
-				if (fBuffer_Head == buffer_Found)
-					fBuffer_Head = buffer_Found->fNext;
-				if (fBuffer_Tail == buffer_Found)
-					fBuffer_Tail = buffer_Found->fPrev;
-
-				// and inserting it
-				buffer_Found->fPrev = nullptr;
-				buffer_Found->fNext = fBuffer_Head;
-				fBuffer_Head->fPrev = buffer_Found;
-				fBuffer_Head = buffer_Found;
-				}
 			}
 		return localDest - oDest;
 		}
@@ -149,20 +396,56 @@ public:
 		return countToCopy;
 		}
 
-protected:
-	const ChanRPos<EE>& fChanReal;
+// Our protocol
+	const PageBufferedCounters& GetCounters() const
+		{ return fPages.GetCounters(); }
 
-	struct Buffer
+	void ResetCounters()
+		{ fPages.ResetCounters(); }
+
+protected:
+	// Load the page starting at iStart, plus as many following pages as the read-ahead window
+	// allows -- stopping at the end of the stream or at a page that's already resident.
+	Page* pLoad(uint64 iStart, uint64 iStreamSize)
 		{
-		Buffer* fPrev;
-		Buffer* fNext;
-		EE* fData;
-		uint64 fStartPosition;
-		};
+		const size_t theBufferSize = fPages.PageSize();
+
+		size_t thePageCount = 1;
+		for (const size_t theWindow = fPages.NoteMiss(iStart); thePageCount < theWindow; ++thePageCount)
+			{
+			const uint64 nextStart = iStart + thePageCount * theBufferSize;
+			if (nextStart >= iStreamSize || fPages.Find(nextStart))
+				break;
+			}
+
+		sPosSet(fChanReal, iStart);
+		fPages.NoteLoaded(iStart, thePageCount);
+
+		// Only what lies within the stream is read. If the read comes up short, the pages
+		// it didn't reach aren't assigned.
+		const size_t countExpected =
+			Pages::sClampedToSize(thePageCount * theBufferSize, iStreamSize, iStart);
+
+		if (thePageCount == 1)
+			{
+			Page* thePage = fPages.Assign(iStart);
+			if (countExpected != sReadFully(fChanReal, thePage->fData, countExpected))
+				{
+				fPages.Discard(thePage);
+				return nullptr;
+				}
+			std::fill_n(thePage->fData + countExpected, theBufferSize - countExpected, EE());
+			return thePage;
+			}
+
+		EE* theStaging = fPages.Staging(thePageCount);
+		const size_t countRead = sReadFully(fChanReal, theStaging, countExpected);
+		return fPages.AssignFromStaging(iStart, thePageCount, countRead, countExpected);
+		}
+
+	const ChanRPos<EE>& fChanReal;
 
-	Buffer* fBuffer_Head;
-	Buffer* fBuffer_Tail;
-	size_t fBufferSize;
+	Pages fPages;
 
 	uint64 fPosition;
 	};
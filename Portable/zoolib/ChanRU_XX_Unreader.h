@@ -43,9 +43,27 @@ public:
 		return localDest - oDest;
 		}
 
+	virtual uint64 Skip(uint64 iCount)
+		{
+		if (fStack.empty())
+			return sSkip(fChanR, iCount);
+
+		const size_t countToSkip = sClamped(std::min<uint64>(fStack.size(), iCount));
+		fStack.resize(fStack.size() - countToSkip);
+		return countToSkip;
+		}
+
 	virtual size_t Readable()
 		{ return fStack.size() + sReadable(fChanR); }
 
+	virtual PaC<const EE> Borrow()
+		{
+		// The stack is in reverse order, so we can only lend out its top element.
+		if (fStack.empty())
+			return sBorrow(fChanR);
+		return sPaC<const EE>(&fStack.back(), 1);
+		}
+
 // From ChanU
 	virtual size_t Unread(const EE* iSource, size_t iCount)
 		{
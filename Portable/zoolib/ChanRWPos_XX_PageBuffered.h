@@ -5,7 +5,9 @@
 #define __ZooLib_ChanRWPos_XX_PageBuffered_h__ 1
 #include "zconfig.h"
 
-#include "zoolib/Chan.h"
+#include "zoolib/ChanRPos_XX_PageBuffered.h" // For PageBuffered_Pages
+#include "zoolib/ChanR.h" // For sThrow_ExhaustedR
+#include "zoolib/ChanW.h" // For sThrow_ExhaustedW
 
 namespace ZooLib {
 
@@ -14,49 +16,22 @@ namespace ZooLib {
 
 /** A positionable read filter stream that buffers a fixed number of fixed size chunks
 which are read in preference to accessing the source stream. Chunks are recycled in
-least recently used order.
+least recently used order. Sequential reads are satisfied with a single read of several
+chunks, and dirty chunks that are adjacent are written back with a single write.
 */
 template <class EE>
 class ChanRWPos_XX_PageBuffered
 :	public virtual ChanRWPos<EE>
 	{
 public:
+	typedef PageBuffered_Pages<EE> Pages;
+	typedef typename Pages::Page Page;
+
 	ChanRWPos_XX_PageBuffered(const ChanRWPos<EE>& iChanRWPos, size_t iBufferCount, size_t iBufferSize)
 	:	fChanReal(iChanRWPos)
+	,	fPages(iBufferCount, iBufferSize)
 		{
-		fBuffer_Head = nullptr;
-		fBuffer_Tail = nullptr;
-
-		fBufferSize = iBufferSize;
-
 		fPosition = sPos(fChanReal);
-
-		// Allocate all the buffers now, so we don't have to do it dynamically
-		while (iBufferCount--)
-			{
-			Buffer* aBuffer = new Buffer;
-			aBuffer->fData = new EE[fBufferSize];
-			aBuffer->fDirty = false;
-			// By marking the start position as covering the last fBufferSize
-			// bytes of the 64 bit address space we don't need to carry
-			// a loaded flag. The weakness is if the user needs to read
-			// that part of the address space before all the buffers have
-			// been used for other portions. This is basically impossible,
-			// 2^64 bytes is 16 exabytes.
-			aBuffer->fStartPosition = 0 - fBufferSize;
-			aBuffer->fPrev = nullptr;
-			aBuffer->fNext = fBuffer_Head;
-			if (fBuffer_Head)
-				{
-				fBuffer_Head->fPrev = aBuffer;
-				fBuffer_Head = aBuffer;
-				}
-			else
-				{
-				fBuffer_Head = aBuffer;
-				fBuffer_Tail = aBuffer;
-				}
-			}
 		}
 
 	~ChanRWPos_XX_PageBuffered()
@@ -65,15 +40,6 @@ public:
 		this->pFlush();
 
 		// ... but not fChanReal.
-
-		// Dispose buffers
-		for (Buffer* buffer_Current = fBuffer_Head; buffer_Current; /*no inc*/)
-			{
-			Buffer* nextBuffer = buffer_Current->fNext;
-			delete[] buffer_Current->fData;
-			delete buffer_Current;
-			buffer_Current = nextBuffer;
-			}
 		}
 
 // From ChanAspect_Pos
@@ -87,65 +53,26 @@ public:
 // From ChanAspect_Read<EE>
 	virtual size_t Read(EE* oDest, size_t iCount)
 		{
+		const size_t theBufferSize = fPages.PageSize();
 		EE* localDest = oDest;
-		uint64 streamSize = sSize(fChanReal);
-		iCount = sClamped(sClamped(iCount, streamSize, fPosition));
+		const uint64 streamSize = sSize(fChanReal);
+		iCount = Pages::sClampedToSize(iCount, streamSize, fPosition);
 		while (iCount)
 			{
-			// Do we have the offset in our buffers?
-			Buffer* buffer_Found = fBuffer_Head;
-			while (buffer_Found)
+			Page* page_Found = fPages.Use(fPosition);
+			if (page_Found == nullptr)
 				{
-				if (buffer_Found->fStartPosition <= fPosition
-					&& buffer_Found->fStartPosition + fBufferSize > fPosition)
-					{
+				page_Found = this->pLoad(fPages.PageStart(fPosition), streamSize);
+				if (page_Found == nullptr)
 					break;
-					}
-				buffer_Found = buffer_Found->fNext;
-				}
-
-			size_t offsetInBuffer = fPosition % fBufferSize;
-
-			if (buffer_Found == nullptr)
-				{
-				// We didn't find a buffer encompassing the position
-				if (fBuffer_Tail->fDirty)
-					{
-					sPosSet(fChanReal, fBuffer_Tail->fStartPosition);
-					sWrite(fChanReal, fBuffer_Tail->fData,
-						sClamped(sClamped(fBufferSize), streamSize, fBuffer_Tail->fStartPosition));
-					}
-				buffer_Found = fBuffer_Tail;
-				buffer_Found->fStartPosition = fPosition - offsetInBuffer;
-				sPosSet(fChanReal, buffer_Found->fStartPosition);
-				sRead(fChanReal, buffer_Found->fData, fBufferSize);
-				buffer_Found->fDirty = false;
 				}
 
-			size_t copySize = std::min(iCount, fBufferSize - offsetInBuffer);
-			std::copy_n(buffer_Found->fData + offsetInBuffer, copySize, localDest);
+			const size_t offsetInBuffer = fPosition % theBufferSize;
+			const size_t copySize = std::min(iCount, theBufferSize - offsetInBuffer);
+			std::copy_n(page_Found->fData + offsetInBuffer, copySize, localDest);
 			iCount -= copySize;
 			fPosition += copySize;
 			localDest += copySize;
-
-			if (fBuffer_Head != buffer_Found)
-				{
-				// Move buffer_Found to the head of the list by removing it
-				if (buffer_Found->fPrev)
-					buffer_Found->fPrev->fNext = buffer_Found->fNext;
-				if (buffer_Found->fNext)
-					buffer_Found->fNext->fPrev = buffer_Found->fPrev;
-				if (fBuffer_Head == buffer_Found)
-					fBuffer_Head = buffer_Found->fNext;
-				if (fBuffer_Tail == buffer_Found)
-					fBuffer_Tail = buffer_Found->fPrev;
-
-				// and inserting it
-				buffer_Found->fPrev = nullptr;
-				buffer_Found->fNext = fBuffer_Head;
-				fBuffer_Head->fPrev = buffer_Found;
-				fBuffer_Head = buffer_Found;
-				}
 			}
 		return localDest - oDest;
 		}
@@ -157,20 +84,20 @@ public:
 // From ChanAspect_SizeSet
 	virtual void SizeSet(uint64 iSize)
 		{
-		if (iSize < sSize(fChanReal))
+		// Any page reaching past the old or the new end holds data that's about to be
+		// wrong -- truncated, or garbage that'll read back as whatever fChanReal extends
+		// with. Write back what's valid and drop the page.
+		const size_t theBufferSize = fPages.PageSize();
+		const uint64 boundary = std::min(iSize, sSize(fChanReal));
+		fPages.ForEachLoaded([this,boundary,theBufferSize](Page* iPage)
 			{
-			// If we're shrinking, then ditch any buffers that cover space beyond
-			// the end of the new size
-			for (Buffer* buffer_Current = fBuffer_Head;
-				buffer_Current; buffer_Current = buffer_Current->fNext)
+			if (iPage->fStartPosition + theBufferSize > boundary)
 				{
-				if (buffer_Current->fStartPosition >= iSize)
-					{
-					buffer_Current->fDirty = false;
-					buffer_Current->fStartPosition = 0 - fBufferSize - 1;
-					}
+				if (iPage->fDirty)
+					this->pWriteRun(iPage->fStartPosition, 1) || sThrow_ExhaustedW();
+				fPages.Discard(iPage);
 				}
-			}
+			});
 		sSizeSet(fChanReal, iSize);
 		}
 
@@ -189,73 +116,45 @@ public:
 // From ChanAspect_Write
 	virtual size_t Write(const EE* iSource, size_t iCount)
 		{
+		const size_t theBufferSize = fPages.PageSize();
 		const EE* localSource = iSource;
 		while (iCount)
 			{
-			// Do we have the offset in our buffers?
-			Buffer* buffer_Found = fBuffer_Head;
-			while (buffer_Found)
-				{
-				if (buffer_Found->fStartPosition <= fPosition
-					&& buffer_Found->fStartPosition + fBufferSize > fPosition)
-					{
-					break;
-					}
-				buffer_Found = buffer_Found->fNext;
-				}
+			const size_t offsetInBuffer = fPosition % theBufferSize;
 
-			size_t offsetInBuffer = fPosition % fBufferSize;
-			if (buffer_Found == nullptr)
+			Page* page_Found = fPages.Use(fPosition);
+			if (page_Found == nullptr)
 				{
 				// We didn't find a buffer encompassing the position
-				if (fBuffer_Tail->fDirty)
-					{
-					sPosSet(fChanReal, fBuffer_Tail->fStartPosition);
-					sEWrite(fChanReal, fBuffer_Tail->fData,
-						sClamped(sClamped(fBufferSize), sSize(fChanReal), fBuffer_Tail->fStartPosition));
-					}
-				buffer_Found = fBuffer_Tail;
-				buffer_Found->fStartPosition = fPosition - offsetInBuffer;
+				this->pCleanVictims(1);
+				page_Found = fPages.Assign(fPosition - offsetInBuffer);
 
-				size_t countToFillBuffer =
-					sClamped(sClamped(fBufferSize, sSize(fChanReal), buffer_Found->fStartPosition));
+				const size_t countToFillBuffer =
+					Pages::sClampedToSize(theBufferSize, sSize(fChanReal), page_Found->fStartPosition);
 
 				if (offsetInBuffer || iCount < countToFillBuffer)
 					{
 					// We need to read the original data because we're either not going to write
 					// starting at the beginning of the buffer, or we're not going to overwrite
 					// the entire valid contents of the buffer (or both).
-					sPosSet(fChanReal, buffer_Found->fStartPosition);
-					sRead(fChanReal, buffer_Found->fData, countToFillBuffer);
+					sPosSet(fChanReal, page_Found->fStartPosition);
+					fPages.NoteLoaded(page_Found->fStartPosition, 1);
+					if (countToFillBuffer
+						!= sReadFully(fChanReal, page_Found->fData, countToFillBuffer))
+						{
+						fPages.Discard(page_Found);
+						sThrow_ExhaustedR();
+						}
 					}
 				}
 
-			size_t copySize = std::min(iCount, fBufferSize - offsetInBuffer);
-			std::copy_n(localSource, copySize, buffer_Found->fData + offsetInBuffer);
-			buffer_Found->fDirty = true;
+			const size_t copySize = std::min(iCount, theBufferSize - offsetInBuffer);
+			std::copy_n(localSource, copySize, page_Found->fData + offsetInBuffer);
+			page_Found->fDirty = true;
 
 			iCount -= copySize;
 			fPosition += copySize;
 			localSource += copySize;
-
-			if (fBuffer_Head != buffer_Found)
-				{
-				// Move buffer_Found to the head of the list by removing it
-				if (buffer_Found->fPrev)
-					buffer_Found->fPrev->fNext = buffer_Found->fNext;
-				if (buffer_Found->fNext)
-					buffer_Found->fNext->fPrev = buffer_Found->fPrev;
-				if (fBuffer_Head == buffer_Found)
-					fBuffer_Head = buffer_Found->fNext;
-				if (fBuffer_Tail == buffer_Found)
-					fBuffer_Tail = buffer_Found->fPrev;
-
-				// and inserting it
-				buffer_Found->fPrev = nullptr;
-				buffer_Found->fNext = fBuffer_Head;
-				fBuffer_Head->fPrev = buffer_Found;
-				fBuffer_Head = buffer_Found;
-				}
 			}
 		return localSource - iSource;
 		}
@@ -266,50 +165,162 @@ public:
 		sFlush(fChanReal);
 		}
 
+// Our protocol
+	const PageBufferedCounters& GetCounters() const
+		{ return fPages.GetCounters(); }
+
+	void ResetCounters()
+		{ fPages.ResetCounters(); }
+
 protected:
+	// As ChanRPos_XX_PageBuffered::pLoad, but first writing back any dirty pages to be recycled.
+	Page* pLoad(uint64 iStart, uint64 iStreamSize)
+		{
+		const size_t theBufferSize = fPages.PageSize();
+
+		size_t thePageCount = 1;
+		for (const size_t theWindow = fPages.NoteMiss(iStart); thePageCount < theWindow; ++thePageCount)
+			{
+			const uint64 nextStart = iStart + thePageCount * theBufferSize;
+			if (nextStart >= iStreamSize || fPages.Find(nextStart))
+				break;
+			}
+
+		this->pCleanVictims(thePageCount);
+
+		sPosSet(fChanReal, iStart);
+		fPages.NoteLoaded(iStart, thePageCount);
+
+		// Only what lies within the stream is read. If the read comes up short, the pages
+		// it didn't reach aren't assigned.
+		const size_t countExpected =
+			Pages::sClampedToSize(thePageCount * theBufferSize, iStreamSize, iStart);
+
+		if (thePageCount == 1)
+			{
+			Page* thePage = fPages.Assign(iStart);
+			if (countExpected != sReadFully(fChanReal, thePage->fData, countExpected))
+				{
+				fPages.Discard(thePage);
+				return nullptr;
+				}
+			std::fill_n(thePage->fData + countExpected, theBufferSize - countExpected, EE());
+			return thePage;
+			}
+
+		EE* theStaging = fPages.Staging(thePageCount);
+		const size_t countRead = sReadFully(fChanReal, theStaging, countExpected);
+		return fPages.AssignFromStaging(iStart, thePageCount, countRead, countExpected);
+		}
+
+	// Ensure the next iCount pages to be recycled are clean. Each dirty one is written back
+	// along with any dirty pages adjacent to it.
+	void pCleanVictims(size_t iCount)
+		{
+		const size_t theBufferSize = fPages.PageSize();
+		const size_t theMaxRun = fPages.MaxRunPages();
+		for (size_t xx = 0; xx < iCount; ++xx)
+			{
+			Page* theVictim = fPages.Victim(xx);
+			if (not theVictim->fDirty)
+				continue;
+
+			uint64 firstStart = theVictim->fStartPosition;
+			size_t runCount = 1;
+			while (runCount < theMaxRun && firstStart >= theBufferSize)
+				{
+				Page* prior = fPages.Find(firstStart - theBufferSize);
+				if (not prior || not prior->fDirty)
+					break;
+				firstStart -= theBufferSize;
+				++runCount;
+				}
+
+			while (runCount < theMaxRun)
+				{
+				Page* following = fPages.Find(firstStart + runCount * theBufferSize);
+				if (not following || not following->fDirty)
+					break;
+				++runCount;
+				}
+
+			this->pWriteRun(firstStart, runCount) || sThrow_ExhaustedW();
+			}
+		}
+
+	// Write back the iCount adjacent dirty pages starting at iStart with one write. Pages
+	// (or parts of pages) beyond the end of fChanReal are dropped, as they always have been --
+	// callers extend the real stream with SizeSet.
+	bool pWriteRun(uint64 iStart, size_t iCount)
+		{
+		const size_t theBufferSize = fPages.PageSize();
+		const size_t writeSize =
+			Pages::sClampedToSize(iCount * theBufferSize, sSize(fChanReal), iStart);
+
+		const EE* theSource;
+		if (iCount == 1)
+			{
+			theSource = fPages.Find(iStart)->fData;
+			}
+		else
+			{
+			EE* theStaging = fPages.Staging(iCount);
+			for (size_t xx = 0; xx < iCount; ++xx)
+				{
+				std::copy_n(fPages.Find(iStart + xx * theBufferSize)->fData,
+					theBufferSize, theStaging + xx * theBufferSize);
+				}
+			theSource = theStaging;
+			}
+
+		sPosSet(fChanReal, iStart);
+		fPages.NoteWrite();
+		for (size_t countWritten = 0; countWritten < writeSize; /*no inc*/)
+			{
+			const size_t countToWrite = writeSize - countWritten;
+			if (const size_t count = sWrite(fChanReal, theSource + countWritten, countToWrite))
+				countWritten += count;
+			else
+				return false;
+			}
+
+		for (size_t xx = 0; xx < iCount; ++xx)
+			fPages.Find(iStart + xx * theBufferSize)->fDirty = false;
+
+		return true;
+		}
+
 	void pFlush()
 		{
-		Buffer* buffer_Current = fBuffer_Head;
-		while (buffer_Current)
+		const size_t theBufferSize = fPages.PageSize();
+		const size_t theMaxRun = fPages.MaxRunPages();
+		const std::vector<Page*> theDirtyPages = fPages.DirtyPages();
+		for (size_t xx = 0; xx < theDirtyPages.size(); /*no inc*/)
 			{
-			if (buffer_Current->fDirty)
+			const uint64 firstStart = theDirtyPages[xx]->fStartPosition;
+			size_t runCount = 1;
+			while (runCount < theMaxRun && xx + runCount < theDirtyPages.size()
+				&& theDirtyPages[xx + runCount]->fStartPosition
+					== firstStart + runCount * theBufferSize)
 				{
-				sPosSet(fChanReal, buffer_Current->fStartPosition);
-				size_t flushSize =
-					sClamped(sClamped(fBufferSize, sSize(fChanReal), buffer_Current->fStartPosition));
+				++runCount;
+				}
 
-				size_t countWritten = sWrite(fChanReal, buffer_Current->fData, flushSize);
-				if (countWritten == flushSize)
-					{
-					buffer_Current->fDirty = false;
-					}
-				else
-					{
-					// We're pretty screwed if the underlying stream could not write all the data we
-					// asked it to. This should not ever happen, because we resize the real stream
-					// whenever we're asked to resize, and insufficient room to grow a stream is
-					// likely the only way that Write could fail.
-					ZDebugStop(1);
-					}
+			if (not this->pWriteRun(firstStart, runCount))
+				{
+				// We're pretty screwed if the underlying stream could not write all the data we
+				// asked it to. This should not ever happen, because we resize the real stream
+				// whenever we're asked to resize, and insufficient room to grow a stream is
+				// likely the only way that Write could fail.
+				ZDebugStop(1);
 				}
-			buffer_Current = buffer_Current->fNext;
+			xx += runCount;
 			}
 		}
 
 	const ChanRWPos<EE>& fChanReal;
 
-	struct Buffer
-		{
-		Buffer* fPrev;
-		Buffer* fNext;
-		EE* fData;
-		uint64 fStartPosition;
-		bool fDirty;
-		};
-
-	Buffer* fBuffer_Head;
-	Buffer* fBuffer_Tail;
-	size_t fBufferSize;
+	Pages fPages;
 
 	uint64 fPosition;
 	};
@@ -27,13 +27,29 @@ std::string sReadString(const ChanR_Bin& iChanR, size_t iCount)
 std::string sReadAllString(const ChanR_Bin& iChanR)
 	{
 	std::string result;
+	// Take whatever the chan can lend us directly, and copy the rest.
+	for (PaC<const byte> theBorrowed; sCount(theBorrowed = sBorrow(iChanR)); /*no inc*/)
+		{
+		result.append(sCastPtr<const char>(theBorrowed), sCount(theBorrowed));
+		sSkip(iChanR, sCount(theBorrowed));
+		}
 	sECopyAll(iChanR, ChanW_Bin_string(&result));
 	return result;
 	}
 
 bool sRead_String(const ChanR_Bin& iChanR, const std::string& iPattern)
 	{
-	if (ZQ<std::string> theQ = sQReadString(iChanR, iPattern.length()))
+	const size_t requiredLength = iPattern.length();
+	const PaC<const byte> theBorrowed = sBorrow(iChanR);
+	if (sCount(theBorrowed) >= requiredLength)
+		{
+		const bool result = 0 == iPattern.compare(0, requiredLength,
+			sCastPtr<const char>(theBorrowed), requiredLength);
+		sSkip(iChanR, requiredLength);
+		return result;
+		}
+
+	if (ZQ<std::string> theQ = sQReadString(iChanR, requiredLength))
 		return *theQ == iPattern;
 	return false;
 	}
@@ -41,6 +57,17 @@ bool sRead_String(const ChanR_Bin& iChanR, const std::string& iPattern)
 bool sTryRead_String(const ChanRU_Bin& iChanRU, const std::string& iPattern)
 	{
 	const size_t requiredLength = iPattern.length();
+	const PaC<const byte> theBorrowed = sBorrow(iChanRU);
+	if (sCount(theBorrowed) >= requiredLength)
+		{
+		// Compare in place, and only consume on a match.
+		if (0 != iPattern.compare(0, requiredLength,
+			sCastPtr<const char>(theBorrowed), requiredLength))
+			{ return false; }
+		sSkip(iChanRU, requiredLength);
+		return true;
+		}
+
 	std::string readString(requiredLength, 0);
 	const size_t countRead =
 		sReadMemFully(iChanRU, const_cast<char*>(readString.data()), requiredLength);
@@ -44,12 +44,29 @@ public:
 		return countToCopy;
 		}
 
+	virtual uint64 Skip(uint64 iCount)
+		{
+		const size_t countToSkip = sClamped(std::min<uint64>(iCount, this->Readable()));
+		fPosition += countToSkip;
+		return countToSkip;
+		}
+
 	virtual size_t Readable()
 		{
 		const size_t theSize = fData.GetSize();
 		return theSize >= fPosition ? theSize - fPosition : 0;
 		}
 
+	virtual PaC<const byte> Borrow()
+		{
+		if (const size_t countReadable = this->Readable())
+			{
+			return sPaC<const byte>(
+				static_cast<const byte*>(fData.GetPtr()) + fPosition, countReadable);
+			}
+		return sPaC<const byte>();
+		}
+
 // From ChanSize
 	virtual uint64 Size()
 		{ return fData.GetSize(); }
@@ -115,12 +132,29 @@ public:
 		return countToCopy;
 		}
 
+	virtual uint64 Skip(uint64 iCount)
+		{
+		const size_t countToSkip = sClamped(std::min<uint64>(iCount, this->Readable()));
+		fPosition += countToSkip;
+		return countToSkip;
+		}
+
 	virtual size_t Readable()
 		{
 		const size_t theSize = fDataPtr->GetSize();
 		return theSize >= fPosition ? theSize - fPosition : 0;
 		}
 
+	virtual PaC<const byte> Borrow()
+		{
+		if (const size_t countReadable = this->Readable())
+			{
+			return sPaC<const byte>(
+				static_cast<const byte*>(fDataPtr->GetPtr()) + fPosition, countReadable);
+			}
+		return sPaC<const byte>();
+		}
+
 // From ChanSize
 	virtual uint64 Size()
 		{ return fDataPtr->GetSize(); }
@@ -50,6 +50,20 @@ size_t ChanRPos_Bin_string::Readable()
 	return theSize >= fPosition ? theSize - fPosition : 0;
 	}
 
+uint64 ChanRPos_Bin_string::Skip(uint64 iCount)
+	{
+	const size_t countToSkip = sClamped(std::min<uint64>(iCount, this->Readable()));
+	fPosition += countToSkip;
+	return countToSkip;
+	}
+
+PaC<const byte> ChanRPos_Bin_string::Borrow()
+	{
+	if (const size_t countReadable = this->Readable())
+		return sPaC<const byte>((const byte*)fString.data() + fPosition, countReadable);
+	return sPaC<const byte>();
+	}
+
 uint64 ChanRPos_Bin_string::Size()
 	{ return fString.size(); }
 
@@ -96,6 +110,20 @@ size_t ChanRWPos_Bin_string::Readable()
 	return theSize >= fPosition ? theSize - fPosition : 0;
 	}
 
+uint64 ChanRWPos_Bin_string::Skip(uint64 iCount)
+	{
+	const size_t countToSkip = sClamped(std::min<uint64>(iCount, this->Readable()));
+	fPosition += countToSkip;
+	return countToSkip;
+	}
+
+PaC<const byte> ChanRWPos_Bin_string::Borrow()
+	{
+	if (const size_t countReadable = this->Readable())
+		return sPaC<const byte>((const byte*)(*fStringPtr).data() + fPosition, countReadable);
+	return sPaC<const byte>();
+	}
+
 uint64 ChanRWPos_Bin_string::Size()
 	{ return fStringPtr->size(); }
 
@@ -39,7 +39,9 @@ public:
 
 // From ChanR
 	virtual size_t Read(byte* oDest, size_t iCount);
+	virtual uint64 Skip(uint64 iCount);
 	virtual size_t Readable();
+	virtual PaC<const byte> Borrow();
 
 // From ChanSize
 	virtual uint64 Size();
@@ -67,7 +69,9 @@ public:
 
 // From ChanR
 	virtual size_t Read(byte* oDest, size_t iCount);
+	virtual uint64 Skip(uint64 iCount);
 	virtual size_t Readable();
+	virtual PaC<const byte> Borrow();
 
 // From ChanSize
 	virtual uint64 Size();
@@ -46,7 +46,7 @@ public:
 				{
 				// We have some data in our buffer, consume it first.
 				const size_t countToMove = std::min(fEnd - fBegin, iCount);
-				std::copy_n(&fBuffer[fBegin], countToMove, localDest);
+				std::copy_n(fBuffer.data() + fBegin, countToMove, localDest);
 				fBegin += countToMove;
 				localDest += countToMove;
 				iCount -= countToMove;
@@ -71,22 +71,37 @@ public:
 					// We're asking for less data than the stream guarantees it could provide
 					// without blocking, in which case we fill up as much of our buffer as we can,
 					// so some later request will be able to be satisfied straight from our buffer.
-					const size_t countRead = sRead(inherited::pGetChan(),
-						&fBuffer[0],
-						std::min(fBuffer.size(), countReadable));
-					if (countRead == 0)
+					if (not this->pFill(countReadable))
 						break;
-					fBegin = 0;
-					fEnd = countRead;
 					}
 				}
 			}
 		return localDest - oDest;
 		}
 
+	virtual uint64 Skip(uint64 iCount)
+		{
+		if (fEnd > fBegin)
+			{
+			const size_t countToSkip = sClamped(std::min<uint64>(fEnd - fBegin, iCount));
+			fBegin += countToSkip;
+			return countToSkip;
+			}
+		return sSkip(inherited::pGetChan(), iCount);
+		}
+
 	virtual size_t Readable()
 		{ return fEnd - fBegin + sReadable(inherited::pGetChan()); }
 
+	virtual PaC<const EE> Borrow()
+		{
+		// Refill when we're drained, so a caller scanning what we lend doesn't fall back to
+		// reading an element at a time. We lend nothing only at the end of the chan.
+		if (fEnd <= fBegin)
+			this->pFill(fBuffer.size());
+		return sPaC<const EE>(fBuffer.data() + fBegin, fEnd - fBegin);
+		}
+
 // From ChanAspect_WaitReadable (if Chan_p is derived from Aspect_WaitReadable)
 	virtual bool WaitReadable(double iTimeout)
 		{
@@ -96,6 +111,14 @@ public:
 		}
 
 protected:
+	// Read up to iCount elements into our (empty) buffer, returning how many arrived.
+	size_t pFill(size_t iCount)
+		{
+		fBegin = 0;
+		fEnd = sRead(inherited::pGetChan(), fBuffer.data(), std::min(fBuffer.size(), iCount));
+		return fEnd;
+		}
+
 	std::vector<EE> fBuffer;
 	size_t fBegin;
 	size_t fEnd;
@@ -168,7 +191,7 @@ public:
 				// Either we already have data in the buffer, or we have an empty buffer
 				// and less than a buffer's worth to send.
 				const size_t countToCopy = std::min(iCount, fBuffer.size() - fOffset);
-				std::copy_n(localSource, countToCopy, &fBuffer[fOffset]);
+				std::copy_n(localSource, countToCopy, fBuffer.data() + fOffset);
 				fOffset += countToCopy;
 				localSource += countToCopy;
 				iCount -= countToCopy;
@@ -194,7 +217,7 @@ protected:
 		{
 		if (size_t used = sGetSet(fOffset, 0))
 			{
-			if (used != sWriteFully(inherited::pGetChan(), &fBuffer[0], used))
+			if (used != sWriteFully(inherited::pGetChan(), fBuffer.data(), used))
 				sThrow_ExhaustedW();
 			}
 		}
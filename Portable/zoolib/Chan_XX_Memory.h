@@ -6,6 +6,7 @@
 
 #include "zoolib/Chan.h"
 #include "zoolib/ChanW.h" // For sThrow_ExhaustedW
+#include "zoolib/ZDebug.h" // For ZAssert
 
 namespace ZooLib {
 
@@ -57,6 +58,9 @@ public:
 	virtual size_t Readable()
 		{ return sClamped(fSize >= fPos ? fSize - fPos : 0); }
 
+	virtual PaC<const EE> Borrow()
+		{ return sPaC<const EE>(fAddress + fPos, this->Readable()); }
+
 // From ChanSize
 	virtual uint64 Size()
 		{ return fSize; }
@@ -142,6 +146,9 @@ public:
 	virtual size_t Readable()
 		{ return sClamped(fSize >= fPos ? fSize - fPos : 0); }
 
+	virtual PaC<const EE> Borrow()
+		{ return sPaC<const EE>(fAddress + fPos, this->Readable()); }
+
 // From ChanSize
 	virtual uint64 Size()
 		{ return fSize; }
@@ -51,6 +51,10 @@ template <class EE> using ChannerWPos = Channer<ChanWPos<EE>>;
 template <class EE> using ChannerRWPos = Channer<ChanRWPos<EE>>;
 template <class EE> using ChannerRW = Channer<ChanRW<EE>>;
 
+template <class LL, class EE> using ChannerRAt = Channer<ChanRAt<LL,EE>>;
+template <class LL, class EE> using ChannerWAt = Channer<ChanWAt<LL,EE>>;
+template <class LL, class EE> using ChannerRWAt = Channer<ChanRWAt<LL,EE>>;
+
 // using ChannerClose = Channer<ChanClose>;
 
 template <class EE> using ChannerRAbort = Channer<ChanRAbort<EE>>;
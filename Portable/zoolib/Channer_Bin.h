@@ -24,6 +24,10 @@ typedef ChannerRPos<byte> ChannerRPos_Bin;
 typedef ChannerWPos<byte> ChannerWPos_Bin;
 typedef ChannerRWPos<byte> ChannerRWPos_Bin;
 
+typedef ChannerRAt<uint64,byte> ChannerRAt_Bin;
+typedef ChannerWAt<uint64,byte> ChannerWAt_Bin;
+typedef ChannerRWAt<uint64,byte> ChannerRWAt_Bin;
+
 typedef ChannerRW<byte> ChannerRW_Bin;
 
 typedef ChannerRAbort<byte> ChannerRAbort_Bin;
@@ -501,6 +501,28 @@ ZP<ChannerRWPos_Bin> FileSpec::CreateRWPos(
 	return null;
 	}
 
+/// Return a new ChannerRAt backed by the contents of the file referenced by the file spec.
+ZP<ChannerRAt_Bin> FileSpec::OpenRAt(bool iPreventWriters) const
+	{
+	if (fLoc)
+		{
+		if (ZP<FileLoc> realLoc = this->pPhysicalLoc())
+			return realLoc->OpenRAt(iPreventWriters);
+		}
+	return null;
+	}
+
+/// Return a new ChannerRWAt backed by the contents of the file referenced by the file spec.
+ZP<ChannerRWAt_Bin> FileSpec::OpenRWAt(bool iPreventWriters) const
+	{
+	if (fLoc)
+		{
+		if (ZP<FileLoc> realLoc = this->pPhysicalLoc())
+			return realLoc->OpenRWAt(iPreventWriters);
+		}
+	return null;
+	}
+
 ZP<FileLoc> FileSpec::GetFileLoc() const
 	{ return this->pPhysicalLoc(); }
 
@@ -756,6 +778,12 @@ ZP<ChannerWPos_Bin> FileLoc::CreateWPos(bool iOpenExisting, bool iPreventWriters
 ZP<ChannerRWPos_Bin> FileLoc::CreateRWPos(bool iOpenExisting, bool iPreventWriters)
 	{ return null; }
 
+ZP<ChannerRAt_Bin> FileLoc::OpenRAt(bool iPreventWriters)
+	{ return null; }
+
+ZP<ChannerRWAt_Bin> FileLoc::OpenRWAt(bool iPreventWriters)
+	{ return null; }
+
 // =================================================================================================
 #pragma mark - FileLoc_Std
 
@@ -109,6 +109,10 @@ public:
 	ZP<ChannerWPos_Bin> CreateWPos(bool iOpenExisting, bool iPreventWriters = true) const;
 	ZP<ChannerRWPos_Bin> CreateRWPos(bool iOpenExisting, bool iPreventWriters = true) const;
 
+	// Open with positional API (stateless, so usable from multiple threads at once).
+	ZP<ChannerRAt_Bin> OpenRAt(bool iPreventWriters = false) const;
+	ZP<ChannerRWAt_Bin> OpenRWAt(bool iPreventWriters = true) const;
+
 	// As ever, do not abuse...
 	ZP<FileLoc> GetFileLoc() const;
 
@@ -226,6 +230,9 @@ public:
 
 	virtual ZP<ChannerWPos_Bin> CreateWPos(bool iOpenExisting, bool iPreventWriters);
 	virtual ZP<ChannerRWPos_Bin> CreateRWPos(bool iOpenExisting, bool iPreventWriters);
+
+	virtual ZP<ChannerRAt_Bin> OpenRAt(bool iPreventWriters);
+	virtual ZP<ChannerRWAt_Bin> OpenRWAt(bool iPreventWriters);
 	};
 
 // =================================================================================================
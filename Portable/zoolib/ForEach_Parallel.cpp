@@ -0,0 +1,132 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/ForEach_Parallel.h"
+
+#include "zoolib/Callable_Lambda.h"
+#include "zoolib/CountedWithoutFinalize.h"
+#include "zoolib/Starter_Pool.h"
+#include "zoolib/ZThread.h"
+
+#include <algorithm> // For std::max, std::min
+#include <atomic>
+#include <exception>
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - ForEachJob (anonymous)
+
+namespace { // anonymous
+
+// The job is complete once every index has been claimed and handled, so the caller can
+// return without waiting for workers that were queued by the starter but never got to run.
+// Those find nothing left to claim and touch only the (refcounted) job itself, and never
+// fFunction, which belongs to the caller.
+
+class ForEachJob
+:	public CountedWithoutFinalize
+	{
+public:
+	ForEachJob(size_t iCount, const std::function<void(size_t)>& iFunction)
+	:	fCount(iCount)
+	,	fFunction(iFunction)
+	,	fNext(0)
+	,	fDone(0)
+	,	fFailed(false)
+		{}
+
+	void Run()
+		{
+		for (;;)
+			{
+			const size_t index = fNext++;
+			if (index >= fCount)
+				return;
+
+			if (not fFailed)
+				{
+				try
+					{
+					fFunction(index);
+					}
+				catch (...)
+					{
+					ZAcqMtx acq(fMtx);
+					if (not fFailed)
+						{
+						fFailed = true;
+						fException = std::current_exception();
+						}
+					}
+				}
+
+			if (++fDone == fCount)
+				{
+				ZAcqMtx acq(fMtx);
+				fCnd.Broadcast();
+				}
+			}
+		}
+
+	void Wait()
+		{
+		ZAcqMtx acq(fMtx);
+		while (fDone < fCount)
+			fCnd.Wait(fMtx);
+
+		if (fException)
+			std::rethrow_exception(fException);
+		}
+
+private:
+	const size_t fCount;
+	const std::function<void(size_t)>& fFunction;
+
+	std::atomic<size_t> fNext;
+	std::atomic<size_t> fDone;
+	std::atomic<bool> fFailed;
+
+	ZMtx fMtx;
+	ZCnd fCnd;
+	std::exception_ptr fException;
+	};
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - sForEach_Parallel
+
+void sForEach_Parallel(size_t iCount, const std::function<void(size_t)>& iFunction,
+	size_t iMaxConcurrency, const ZP<Starter>& iStarter)
+	{
+	if (not iCount)
+		return;
+
+	if (iCount == 1 || iMaxConcurrency <= 1 || not iStarter)
+		{
+		for (size_t xx = 0; xx < iCount; ++xx)
+			iFunction(xx);
+		return;
+		}
+
+	ZP<ForEachJob> theJob = new ForEachJob(iCount, iFunction);
+
+	// The calling thread is one of the workers.
+	const size_t theHelpers = std::min(iMaxConcurrency, iCount) - 1;
+	for (size_t xx = 0; xx < theHelpers; ++xx)
+		{
+		if (not iStarter->QStart(sCallable([theJob](){ theJob->Run(); })))
+			break;
+		}
+
+	theJob->Run();
+	theJob->Wait();
+	}
+
+void sForEach_Parallel(size_t iCount, const std::function<void(size_t)>& iFunction)
+	{
+	sForEach_Parallel(iCount, iFunction,
+		std::max<size_t>(1, std::thread::hardware_concurrency()), sStarter_Pool());
+	}
+
+} // namespace ZooLib
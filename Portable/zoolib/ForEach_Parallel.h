@@ -0,0 +1,31 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_ForEach_Parallel_h__
+#define __ZooLib_ForEach_Parallel_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/Starter.h"
+
+#include <functional>
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - sForEach_Parallel
+
+// Calls iFunction with every index below iCount, using up to iMaxConcurrency threads. The
+// calling thread is one of them, and the others are started by iStarter. Workers take the
+// next index as they become free, so one slow call doesn't hold up the rest, and a worker
+// the starter doesn't get to until we're done finds nothing to do. Returns once every call
+// has returned. If a call throws, the indices not yet taken are abandoned and the first
+// exception is rethrown here.
+
+void sForEach_Parallel(size_t iCount, const std::function<void(size_t)>& iFunction,
+	size_t iMaxConcurrency, const ZP<Starter>& iStarter);
+
+// Uses sStarter_Pool, and one thread per hardware thread.
+void sForEach_Parallel(size_t iCount, const std::function<void(size_t)>& iFunction);
+
+} // namespace ZooLib
+
+#endif // __ZooLib_ForEach_Parallel_h__
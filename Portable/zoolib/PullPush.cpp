@@ -4,6 +4,9 @@
 
 #include "zoolib/Channer_Bin.h"
 #include "zoolib/Channer_UTF.h"
+#include "zoolib/Chan_Bin_Data.h"
+#include "zoolib/Chan_UTF_string.h"
+#include "zoolib/Data_ZZ.h"
 #include "zoolib/ParseException.h"
 #include "zoolib/Util_Chan.h" // For sCopyFully
 
@@ -116,6 +119,12 @@ bool sTryPush(const PPT& iVal, const ChanW_PPT& iChanW)
 
 void sPull_UTF_Push_PPT(const ChanR_UTF& iChanR, const ChanW_PPT& iChanW)
 	{
+	if (sPushWhole())
+		{
+		sPush(sReadAllUTF8(iChanR), iChanW);
+		return;
+		}
+
 	PullPushPair<UTF32> thePullPushPair = sMakePullPushPair<UTF32>();
 	sPush(sGetClear(thePullPushPair.second), iChanW);
 	sFlush(iChanW);
@@ -127,6 +136,14 @@ void sPull_UTF_Push_PPT(const ChanR_UTF& iChanR, const ChanW_PPT& iChanW)
 
 void sPull_UTF_Push_PPT(const ChanR_UTF& iChanR, uint64 iCount, const ChanW_PPT& iChanW)
 	{
+	if (sPushWhole())
+		{
+		string8 theString;
+		sCopyFully(iChanR, ChanW_UTF_string8(&theString), iCount);
+		sPush(theString, iChanW);
+		return;
+		}
+
 	PullPushPair<UTF32> thePullPushPair = sMakePullPushPair<UTF32>();
 	sPush(sGetClear(thePullPushPair.second), iChanW);
 	sFlush(iChanW);
@@ -138,6 +155,12 @@ void sPull_UTF_Push_PPT(const ChanR_UTF& iChanR, uint64 iCount, const ChanW_PPT&
 
 void sPull_Bin_Push_PPT(const ChanR_Bin& iChanR, const ChanW_PPT& iChanW)
 	{
+	if (sPushWhole())
+		{
+		sPush(sReadAll_T<Data_ZZ>(iChanR), iChanW);
+		return;
+		}
+
 	PullPushPair<byte> thePullPushPair = sMakePullPushPair<byte>();
 	sPush(sGetClear(thePullPushPair.second), iChanW);
 	sFlush(iChanW);
@@ -149,6 +172,14 @@ void sPull_Bin_Push_PPT(const ChanR_Bin& iChanR, const ChanW_PPT& iChanW)
 
 void sPull_Bin_Push_PPT(const ChanR_Bin& iChanR, uint64 iCount, const ChanW_PPT& iChanW)
 	{
+	if (sPushWhole())
+		{
+		Data_ZZ theData;
+		sCopyFully(iChanR, ChanW_Bin_Data<Data_ZZ>(&theData), iCount);
+		sPush(theData, iChanW);
+		return;
+		}
+
 	PullPushPair<byte> thePullPushPair = sMakePullPushPair<byte>();
 	sPush(sGetClear(thePullPushPair.second), iChanW);
 	sFlush(iChanW);
@@ -16,6 +16,7 @@
 #include "zoolib/ChanW.h"
 #include "zoolib/Name.h"
 #include "zoolib/StartOnNewThread.h"
+#include "zoolib/ThreadVal.h"
 
 namespace ZooLib {
 
@@ -130,6 +131,22 @@ void sPush(const Name& iName, const T& iVal, const ChanW_PPT& iChanW)
 template <>
 void sPush<Name>(const Name& iName, const Name&, const ChanW_PPT& iChanW) = delete;
 
+// =================================================================================================
+#pragma mark - ThreadVal_PushWhole
+
+// Producers generally push a string or binary value as a ChannerR_UTF or ChannerR_Bin
+// that's fed through a PullPushPair, and rely on the consumer draining it from another thread.
+// When the consumer is running on the pushing thread (eg ChanW_PPT_AsZZ) that would deadlock,
+// so it's bracketed by a true ThreadVal_PushWhole, and strings are pushed as string8
+// and binary as Data_ZZ.
+
+typedef ThreadVal<bool, struct Tag_PushWhole> ThreadVal_PushWhole;
+
+inline bool sPushWhole()
+	{ return ThreadVal_PushWhole::sGet(); }
+
+// ----------
+
 void sPull_UTF_Push_PPT(const ChanR_UTF& iChanR, const ChanW_PPT& iChanW);
 void sPull_UTF_Push_PPT(const ChanR_UTF& iChanR, uint64 iCount, const ChanW_PPT& iChanW);
 
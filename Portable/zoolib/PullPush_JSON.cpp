@@ -186,13 +186,15 @@ static bool spPull_JSON_String_Push_UTF(const ChanRU_UTF& iChanRU,
 static bool spPull_JSON_String_Push(const ChanRU_UTF& iChanRU,
 	UTF32 iTerminator, const ChanW_PPT& iChanW)
 	{
-#if 0
-	string theString;
-	bool result = spPull_JSON_String_Push_UTF(iChanRU,
-		iTerminator, ChanW_UTF_string<UTF8>(&theString));
-	sPush(theString, iChanW);
-	return result;
-#else
+	if (sPushWhole())
+		{
+		string theString;
+		bool result = spPull_JSON_String_Push_UTF(iChanRU,
+			iTerminator, ChanW_UTF_string<UTF8>(&theString));
+		sPush(theString, iChanW);
+		return result;
+		}
+
 	PullPushPair<UTF32> thePullPushPair = sMakePullPushPair<UTF32>();
 	sPush(sGetClear(thePullPushPair.second), iChanW);
 	sFlush(iChanW);
@@ -200,7 +202,6 @@ static bool spPull_JSON_String_Push(const ChanRU_UTF& iChanRU,
 	bool result = spPull_JSON_String_Push_UTF(iChanRU, iTerminator, *thePullPushPair.first);
 	sDisconnectWrite(*thePullPushPair.first);
 	return result;
-#endif
 	}
 
 // =================================================================================================
@@ -369,6 +370,18 @@ bool sPull_JSON_Push_PPT(const ChanRU_UTF& iChanRU,
 		{
 		sSkip_WSAndCPlusPlusComments(iChanRU);
 
+		if (sPushWhole())
+			{
+			Data_ZZ theData;
+			bool result;
+			if (sTryRead_CP(iChanRU, '='))
+				result = spPull_Base64_Push_Bin(iChanRU, ChanW_Bin_Data<Data_ZZ>(&theData));
+			else
+				result = spPull_Hex_Push_Bin(iChanRU, ChanW_Bin_Data<Data_ZZ>(&theData));
+			sPush(theData, iChanW);
+			return result;
+			}
+
 		PullPushPair<byte> thePullPushPair = sMakePullPushPair<byte>();
 		sPush(sGetClear(thePullPushPair.second), iChanW);
 		sFlush(iChanW);
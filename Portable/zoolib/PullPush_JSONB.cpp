@@ -5,6 +5,9 @@
 #include "zoolib/ChanR_UTF.h"
 #include "zoolib/ChanR_Bin_More.h"
 #include "zoolib/ChanW_Bin_More.h"
+#include "zoolib/Chan_Bin_Data.h"
+#include "zoolib/Chan_Bin_string.h"
+#include "zoolib/Chan_XX_Memory.h"
 #include "zoolib/Channer_Bin.h"
 #include "zoolib/Channer_UTF.h"
 #include "zoolib/Coerce_Any.h"
@@ -16,11 +19,13 @@
 #include "zoolib/Util_Chan.h"
 #include "zoolib/Util_Debug.h" // For sPrettyName
 
+#include <algorithm> // For std::stable_sort
 #include <vector>
 
 namespace ZooLib {
 
 using namespace PullPush;
+using std::pair;
 using std::string;
 using std::vector;
 
@@ -39,7 +44,9 @@ enum class EType : byte
 	Binary_Chunked = 0xE7,
 	UTF_Complete = 0xE8,
 	Seq = 0xEA,
+	IndexedSeq = 0xEB,
 	Map = 0xED,
+	IndexedMap = 0xEE,
 	End = 0xFF,
 	};
 
@@ -103,6 +110,20 @@ void spPull_JSONB_Push_PPT(byte iType, const ChanR_Bin& iChanR,
 			}
 		case EType::Binary_Chunked:
 			{
+			if (sPushWhole())
+				{
+				Data_ZZ theData;
+				for (;;)
+					{
+					if (uint64 theCount = sReadCount(iChanR))
+						sECopyFully(iChanR, ChanW_Bin_Data<Data_ZZ>(&theData), theCount);
+					else
+						break;
+					}
+				sPush(theData, iChanW);
+				break;
+				}
+
 			PullPushPair<byte> thePullPushPair = sMakePullPushPair<byte>();
 			sPush(sGetClear(thePullPushPair.second), iChanW);
 			sFlush(iChanW);
@@ -165,6 +186,32 @@ void spPull_JSONB_Push_PPT(byte iType, const ChanR_Bin& iChanR,
 			sPush_End(iChanW);
 			break;
 			}
+		case EType::IndexedSeq:
+			{
+			// The offsets are of no use when streaming, the elements are in order.
+			sReadCount(iChanR);
+			const uint64 theCount = sReadCount(iChanR);
+			sESkip(iChanR, theCount * sEReadBE<uint8>(iChanR));
+			sPush_Start_Seq(iChanW);
+			for (uint64 xx = 0; xx < theCount; ++xx)
+				spPull_JSONB_Push_PPT(sEReadBE<uint8>(iChanR), iChanR, iReadFilter, iChanW);
+			sPush_End(iChanW);
+			break;
+			}
+		case EType::IndexedMap:
+			{
+			sReadCount(iChanR);
+			const uint64 theCount = sReadCount(iChanR);
+			sESkip(iChanR, theCount * sEReadBE<uint8>(iChanR));
+			sPush_Start_Map(iChanW);
+			for (uint64 xx = 0; xx < theCount; ++xx)
+				{
+				sPush(sName(sReadCountPrefixedString(iChanR)), iChanW);
+				spPull_JSONB_Push_PPT(sEReadBE<uint8>(iChanR), iChanR, iReadFilter, iChanW);
+				}
+			sPush_End(iChanW);
+			break;
+			}
 		default:
 			{
 			sThrow_ParseException(sStringf("JSONB unhandled type %d", int(iType)));
@@ -176,8 +223,46 @@ void spPull_JSONB_Push_PPT(byte iType, const ChanR_Bin& iChanR,
 // =================================================================================================
 #pragma mark -
 
-bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
+static size_t spCountSize(uint64 iValue)
+	{
+	if (iValue < 253)
+		return 1;
+	if (iValue <= 0xFFFFU)
+		return 3;
+	if (iValue <= 0xFFFFFFFFU)
+		return 5;
+	return 9;
+	}
+
+static void spWriteIndexed(const ChanW_Bin& iChanW, EType iType,
+	const vector<uint64>& iOffsets, const string& iElements)
+	{
+	// Offsets are ascending, so the last one determines the width.
+	const uint64 maxOffset = iOffsets.empty() ? 0 : iOffsets.back();
+	const uint8 theWidth =
+		maxOffset <= 0xFFU ? 1 : maxOffset <= 0xFFFFU ? 2 : maxOffset <= 0xFFFFFFFFU ? 4 : 8;
+
+	sEWriteBE<byte>(iChanW, byte(iType));
+	sEWriteCount(iChanW,
+		spCountSize(iOffsets.size()) + 1 + theWidth * iOffsets.size() + iElements.size());
+	sEWriteCount(iChanW, iOffsets.size());
+	sEWriteBE<uint8>(iChanW, theWidth);
+	for (uint64 theOffset: iOffsets)
+		{
+		switch (theWidth)
+			{
+			case 1: sEWriteBE<uint8>(iChanW, uint8(theOffset)); break;
+			case 2: sEWriteBE<uint16>(iChanW, uint16(theOffset)); break;
+			case 4: sEWriteBE<uint32>(iChanW, uint32(theOffset)); break;
+			default: sEWriteBE<uint64>(iChanW, theOffset); break;
+			}
+		}
+	sEWrite(iChanW, iElements);
+	}
+
+static bool spPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
 	const ZP<Callable_JSONB_WriteFilter>& iWriteFilter,
+	bool iIndexed,
 	const ChanW_Bin& iChanW)
 	{
 	ZQ<PPT> thePPTQ = sQRead(iChanR);
@@ -235,6 +320,56 @@ bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
 		return true;
 		}
 
+	if (iIndexed && sIsStart_Map(thePPT))
+		{
+		// Each entry is serialized on its own so the entries can be sorted by name.
+		vector<pair<string,string>> theEntries;
+		for (;;)
+			{
+			if (NotQ<Name> theNameQ = sQEReadNameOrEnd(iChanR))
+				break;
+			else
+				{
+				theEntries.push_back(pair<string,string>(*theNameQ, string()));
+				ChanW_Bin_string theChanW(&theEntries.back().second);
+				if (not spPull_PPT_Push_JSONB(iChanR, iWriteFilter, true, theChanW))
+					sThrow_ParseException("Require value after Name from ChanR_PPT");
+				}
+			}
+
+		std::stable_sort(theEntries.begin(), theEntries.end(),
+			[](const pair<string,string>& l, const pair<string,string>& r)
+				{ return l.first < r.first; });
+
+		vector<uint64> theOffsets;
+		string theElements;
+		ChanW_Bin_string theChanW(&theElements);
+		for (const pair<string,string>& theEntry: theEntries)
+			{
+			theOffsets.push_back(theElements.size());
+			sEWriteCountPrefixedString(theChanW, theEntry.first);
+			theElements += theEntry.second;
+			}
+		spWriteIndexed(iChanW, EType::IndexedMap, theOffsets, theElements);
+		return true;
+		}
+
+	if (iIndexed && sIsStart_Seq(thePPT))
+		{
+		vector<uint64> theOffsets;
+		string theElements;
+		ChanW_Bin_string theChanW(&theElements);
+		for (;;)
+			{
+			const size_t theOffset = theElements.size();
+			if (not spPull_PPT_Push_JSONB(iChanR, iWriteFilter, true, theChanW))
+				break;
+			theOffsets.push_back(theOffset);
+			}
+		spWriteIndexed(iChanW, EType::IndexedSeq, theOffsets, theElements);
+		return true;
+		}
+
 	if (sIsStart_Map(thePPT))
 		{
 		sEWriteBE<byte>(iChanW, byte(EType::Map));
@@ -249,7 +384,7 @@ bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
 			else
 				{
 				sEWriteCountPrefixedString(iChanW, *theNameQ);
-				if (not sPull_PPT_Push_JSONB(iChanR, iWriteFilter, iChanW))
+				if (not spPull_PPT_Push_JSONB(iChanR, iWriteFilter, false, iChanW))
 					sThrow_ParseException("Require value after Name from ChanR_PPT");
 				}
 			}
@@ -263,7 +398,7 @@ bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
 		sEWriteBE<byte>(iChanW, byte(EType::Seq));
 		for (;;)
 			{
-			if (not sPull_PPT_Push_JSONB(iChanR, iWriteFilter, iChanW))
+			if (not spPull_PPT_Push_JSONB(iChanR, iWriteFilter, false, iChanW))
 				break;
 			}
 		sEWriteBE<byte>(iChanW, byte(EType::End));
@@ -305,6 +440,353 @@ bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
 	ZUnimplemented();
 	}
 
+bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
+	const ZP<Callable_JSONB_WriteFilter>& iWriteFilter,
+	const ChanW_Bin& iChanW)
+	{ return spPull_PPT_Push_JSONB(iChanR, iWriteFilter, false, iChanW); }
+
+// =================================================================================================
+#pragma mark - Indexed JSONB
+
+bool sPull_PPT_Push_JSONB_Indexed(const ChanR_PPT& iChanR,
+	const ZP<Callable_JSONB_WriteFilter>& iWriteFilter,
+	const ChanW_Bin& iChanW)
+	{ return spPull_PPT_Push_JSONB(iChanR, iWriteFilter, true, iChanW); }
+
+// =================================================================================================
+#pragma mark - JSONBView helpers
+
+namespace {
+
+typedef ChanRPos_XX_Memory<byte> ChanRPos_Bin_Memory;
+
+// Where the parts of an indexed container lie, as positions in the chan it was read from.
+struct IndexedHeader
+	{
+	uint64 fCount;
+	size_t fWidth;
+	uint64 fTable;
+	uint64 fElements;
+	uint64 fEnd;
+	};
+
+IndexedHeader spReadIndexedHeader(const ChanRPos_Bin_Memory& iChanR)
+	{
+	IndexedHeader result;
+	const uint64 theLength = sReadCount(iChanR);
+	const uint64 theStart = sPos(iChanR);
+	result.fEnd = theStart + theLength;
+	result.fCount = sReadCount(iChanR);
+	result.fWidth = sEReadBE<uint8>(iChanR);
+	result.fTable = sPos(iChanR);
+	result.fElements = result.fTable + result.fWidth * result.fCount;
+
+	if (result.fWidth != 1 && result.fWidth != 2 && result.fWidth != 4 && result.fWidth != 8)
+		sThrow_ParseException(sStringf("JSONB invalid offset width %d", int(result.fWidth)));
+
+	if (theLength > sSize(iChanR) - theStart
+		|| result.fCount > theLength
+		|| result.fElements > result.fEnd)
+		{
+		sThrow_ParseException("JSONB indexed container overruns its data");
+		}
+
+	return result;
+	}
+
+// Positions iChanR at the start of element or entry iIndex.
+void spSeekIndexed(const ChanRPos_Bin_Memory& iChanR, const IndexedHeader& iHeader, uint64 iIndex)
+	{
+	sPosSet(iChanR, iHeader.fTable + iIndex * iHeader.fWidth);
+	uint64 theOffset;
+	switch (iHeader.fWidth)
+		{
+		case 1: theOffset = sEReadBE<uint8>(iChanR); break;
+		case 2: theOffset = sEReadBE<uint16>(iChanR); break;
+		case 4: theOffset = sEReadBE<uint32>(iChanR); break;
+		default: theOffset = sEReadBE<uint64>(iChanR); break;
+		}
+
+	if (theOffset >= iHeader.fEnd - iHeader.fElements)
+		sThrow_ParseException("JSONB offset out of range");
+
+	sPosSet(iChanR, iHeader.fElements + theOffset);
+	}
+
+// Consumes the End that terminates a plain Seq or Map, if it's next.
+bool spReadEnd(const ChanRPos_Bin_Memory& iChanR)
+	{
+	if (sEReadBE<uint8>(iChanR) == byte(EType::End))
+		return true;
+	sPosSet(iChanR, sPos(iChanR) - 1);
+	return false;
+	}
+
+void spSkipValue(const ChanRPos_Bin_Memory& iChanR)
+	{
+	switch (EType(sEReadBE<uint8>(iChanR)))
+		{
+		case EType::Null:
+		case EType::False:
+		case EType::True:
+			{
+			break;
+			}
+		case EType::Int64:
+		case EType::Float64:
+			{
+			sESkip(iChanR, 8);
+			break;
+			}
+		case EType::Binary_Chunked:
+			{
+			while (const uint64 theCount = sReadCount(iChanR))
+				sESkip(iChanR, theCount);
+			break;
+			}
+		case EType::UTF_Complete:
+			{
+			sESkip(iChanR, sReadCount(iChanR));
+			break;
+			}
+		case EType::Seq:
+			{
+			while (not spReadEnd(iChanR))
+				spSkipValue(iChanR);
+			break;
+			}
+		case EType::Map:
+			{
+			for (;;)
+				{
+				// The terminator is an empty name followed by End.
+				sESkip(iChanR, sReadCount(iChanR));
+				if (spReadEnd(iChanR))
+					break;
+				spSkipValue(iChanR);
+				}
+			break;
+			}
+		case EType::IndexedSeq:
+		case EType::IndexedMap:
+			{
+			sESkip(iChanR, sReadCount(iChanR));
+			break;
+			}
+		default:
+			{
+			sThrow_ParseException("JSONB unhandled type in JSONBView");
+			break;
+			}
+		}
+	}
+
+// Positions iChanR at the name of entry iIndex of a plain Map (iIsMap), or at element iIndex
+// of a plain Seq. Returns false if there are too few.
+bool spSeekPlain(const ChanRPos_Bin_Memory& iChanR, bool iIsMap, size_t iIndex)
+	{
+	for (size_t xx = 0; /*no test*/; ++xx)
+		{
+		const uint64 thePos = sPos(iChanR);
+		if (iIsMap)
+			sESkip(iChanR, sReadCount(iChanR));
+		if (spReadEnd(iChanR))
+			return false;
+		if (xx == iIndex)
+			{
+			sPosSet(iChanR, thePos);
+			return true;
+			}
+		spSkipValue(iChanR);
+		}
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - JSONBView
+
+JSONBView::JSONBView()
+:	fPtr(nullptr)
+,	fAvailable(0)
+	{}
+
+JSONBView::JSONBView(const PaC<const byte>& iPaC)
+:	fPtr(iPaC.second ? iPaC.first : nullptr)
+,	fAvailable(iPaC.second)
+	{}
+
+JSONBView::operator bool() const
+	{ return fPtr; }
+
+PaC<const byte> JSONBView::GetPaC() const
+	{
+	if (not fPtr)
+		return PaC<const byte>();
+
+	ChanRPos_Bin_Memory theChanR(fPtr, fAvailable);
+	spSkipValue(theChanR);
+	return PaC<const byte>(fPtr, size_t(sPos(theChanR)));
+	}
+
+bool JSONBView::IsSeq() const
+	{ return fPtr && (*fPtr == byte(EType::Seq) || *fPtr == byte(EType::IndexedSeq)); }
+
+bool JSONBView::IsMap() const
+	{ return fPtr && (*fPtr == byte(EType::Map) || *fPtr == byte(EType::IndexedMap)); }
+
+size_t JSONBView::Count() const
+	{
+	if (not fPtr)
+		return 0;
+
+	ChanRPos_Bin_Memory theChanR(fPtr, fAvailable);
+	const EType theType = EType(sEReadBE<uint8>(theChanR));
+	if (theType == EType::IndexedSeq || theType == EType::IndexedMap)
+		return size_t(spReadIndexedHeader(theChanR).fCount);
+
+	if (theType != EType::Seq && theType != EType::Map)
+		return 0;
+
+	size_t result = 0;
+	while (spSeekPlain(theChanR, theType == EType::Map, 0))
+		{
+		if (theType == EType::Map)
+			sESkip(theChanR, sReadCount(theChanR));
+		spSkipValue(theChanR);
+		++result;
+		}
+	return result;
+	}
+
+JSONBView JSONBView::At(size_t iIndex) const
+	{
+	if (not fPtr)
+		return JSONBView();
+
+	ChanRPos_Bin_Memory theChanR(fPtr, fAvailable);
+	uint64 theEnd = fAvailable;
+	const EType theType = EType(sEReadBE<uint8>(theChanR));
+	if (theType == EType::IndexedSeq || theType == EType::IndexedMap)
+		{
+		const IndexedHeader theHeader = spReadIndexedHeader(theChanR);
+		if (iIndex >= theHeader.fCount)
+			return JSONBView();
+		spSeekIndexed(theChanR, theHeader, iIndex);
+		theEnd = theHeader.fEnd;
+		}
+	else if (theType == EType::Seq || theType == EType::Map)
+		{
+		if (not spSeekPlain(theChanR, theType == EType::Map, iIndex))
+			return JSONBView();
+		}
+	else
+		{
+		return JSONBView();
+		}
+
+	if (theType == EType::IndexedMap || theType == EType::Map)
+		sESkip(theChanR, sReadCount(theChanR));
+
+	const uint64 thePos = sPos(theChanR);
+	if (thePos >= theEnd)
+		sThrow_ParseException("JSONB value missing");
+
+	return JSONBView(PaC<const byte>(fPtr + thePos, size_t(theEnd - thePos)));
+	}
+
+ZQ<string> JSONBView::QNameAt(size_t iIndex) const
+	{
+	if (not this->IsMap())
+		return null;
+
+	ChanRPos_Bin_Memory theChanR(fPtr, fAvailable);
+	if (EType(sEReadBE<uint8>(theChanR)) == EType::IndexedMap)
+		{
+		const IndexedHeader theHeader = spReadIndexedHeader(theChanR);
+		if (iIndex >= theHeader.fCount)
+			return null;
+		spSeekIndexed(theChanR, theHeader, iIndex);
+		}
+	else if (not spSeekPlain(theChanR, true, iIndex))
+		{
+		return null;
+		}
+
+	return sReadCountPrefixedString(theChanR);
+	}
+
+JSONBView JSONBView::Get(const string& iName) const
+	{
+	if (not this->IsMap())
+		return JSONBView();
+
+	ChanRPos_Bin_Memory theChanR(fPtr, fAvailable);
+	if (EType(sEReadBE<uint8>(theChanR)) == EType::IndexedMap)
+		{
+		const IndexedHeader theHeader = spReadIndexedHeader(theChanR);
+
+		// Find the first entry whose name is not less than iName. Names are compared in
+		// place, in the same (unsigned, bytewise) order std::string used to sort them.
+		uint64 lo = 0;
+		uint64 hi = theHeader.fCount;
+		while (lo < hi)
+			{
+			const uint64 mid = lo + (hi - lo) / 2;
+			spSeekIndexed(theChanR, theHeader, mid);
+			const uint64 theLength = sReadCount(theChanR);
+			const uint64 thePos = sPos(theChanR);
+			if (theLength > theHeader.fEnd - thePos)
+				sThrow_ParseException("JSONB name overruns its container");
+
+			const int comparison = string::traits_type::compare(
+				reinterpret_cast<const char*>(fPtr + thePos), iName.data(),
+				size_t(std::min<uint64>(theLength, iName.size())));
+
+			if (comparison < 0 || (comparison == 0 && theLength < iName.size()))
+				lo = mid + 1;
+			else
+				hi = mid;
+			}
+
+		if (lo == theHeader.fCount)
+			return JSONBView();
+
+		spSeekIndexed(theChanR, theHeader, lo);
+		if (sReadCountPrefixedString(theChanR) != iName)
+			return JSONBView();
+
+		const uint64 thePos = sPos(theChanR);
+		if (thePos >= theHeader.fEnd)
+			sThrow_ParseException("JSONB value missing");
+
+		return JSONBView(PaC<const byte>(fPtr + thePos, size_t(theHeader.fEnd - thePos)));
+		}
+
+	for (;;)
+		{
+		const string theName = sReadCountPrefixedString(theChanR);
+		if (spReadEnd(theChanR))
+			return JSONBView();
+
+		if (theName == iName)
+			{
+			const uint64 thePos = sPos(theChanR);
+			return JSONBView(PaC<const byte>(fPtr + thePos, size_t(fAvailable - thePos)));
+			}
+
+		spSkipValue(theChanR);
+		}
+	}
+
+bool JSONBView::Pull_Push_PPT(const ZP<Callable_JSONB_ReadFilter>& iReadFilter,
+	const ChanW_PPT& iChanW) const
+	{
+	if (not fPtr)
+		return false;
+	return sPull_JSONB_Push_PPT(ChanRPos_Bin_Memory(fPtr, fAvailable), iReadFilter, iChanW);
+	}
+
 // =================================================================================================
 #pragma mark - sChannerR_PPT_xx
 
@@ -28,6 +28,64 @@ bool sPull_PPT_Push_JSONB(const ChanR_PPT& iChanR,
 	const ZP<Callable_JSONB_WriteFilter>& iWriteFilter,
 	const ChanW_Bin& iChanW);
 
+// =================================================================================================
+#pragma mark - Indexed JSONB
+
+// sPull_PPT_Push_JSONB_Indexed writes Seqs and Maps in a form that can be navigated without
+// decoding, and that sPull_JSONB_Push_PPT reads like any other JSONB. Each container is:
+//   type byte (IndexedSeq or IndexedMap)
+//   Count    length of everything that follows this Count
+//   Count    number of elements/entries
+//   uint8    width of an offset, 1, 2, 4 or 8
+//   offsets  big-endian, one per element/entry, relative to the start of the elements
+//   elements for a Seq each is a JSONB value, for a Map a count-prefixed name then a value.
+// A Map's entries are stored sorted by name, so a lookup is a binary search of its offsets.
+
+bool sPull_PPT_Push_JSONB_Indexed(const ChanR_PPT& iChanR,
+	const ZP<Callable_JSONB_WriteFilter>& iWriteFilter,
+	const ChanW_Bin& iChanW);
+
+// =================================================================================================
+#pragma mark - JSONBView
+
+// Refers to a JSONB value in memory that must outlive it. Indexed containers are navigated
+// by offset, plain ones by walking their content. A default-constructed JSONBView, or one
+// returned for a missing index or name, is false. Malformed data throws a ParseException.
+
+class JSONBView
+	{
+public:
+	JSONBView();
+	JSONBView(const PaC<const byte>& iPaC);
+
+	explicit operator bool() const;
+
+// Our protocol
+	// The bytes of this value, and nothing following it.
+	PaC<const byte> GetPaC() const;
+
+	bool IsSeq() const;
+	bool IsMap() const;
+
+	// Number of elements in a Seq or entries in a Map, zero for anything else.
+	size_t Count() const;
+
+	// The element of a Seq, or the value of the entry of a Map, at iIndex. Indexed Maps
+	// are ordered by name, plain ones in the order they were written.
+	JSONBView At(size_t iIndex) const;
+	ZQ<std::string> QNameAt(size_t iIndex) const;
+
+	// The value in a Map named iName.
+	JSONBView Get(const std::string& iName) const;
+
+	bool Pull_Push_PPT(const ZP<Callable_JSONB_ReadFilter>& iReadFilter,
+		const ChanW_PPT& iChanW) const;
+
+private:
+	const byte* fPtr;
+	size_t fAvailable;
+	};
+
 // =================================================================================================
 #pragma mark - sChannerR_PPT_xx
 
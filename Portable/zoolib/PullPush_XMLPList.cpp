@@ -4,6 +4,7 @@
 
 #include "zoolib/Chan_Bin_ASCIIStrim.h"
 #include "zoolib/Chan_Bin_Base64.h"
+#include "zoolib/Chan_Bin_Data.h"
 #include "zoolib/Chan_UTF_Chan_Bin.h"
 #include "zoolib/Chan_UTF_string.h"
 #include "zoolib/ChanRU_XX_Unreader.h"
@@ -27,6 +28,13 @@ using std::string;
 
 static void spPull_Base64_Push_PPT(const ZooLib::ChanR_UTF& iChanR, const ChanW_PPT& iChanW)
 	{
+	if (sPushWhole())
+		{
+		ChanR_Bin_ASCIIStrim theStreamR_ASCIIStrim(iChanR);
+		sPush(sReadAll_T<Data_ZZ>(ChanR_Bin_Base64Decode(theStreamR_ASCIIStrim)), iChanW);
+		return;
+		}
+
 	PullPushPair<byte> thePullPushPair = sMakePullPushPair<byte>();
 	sPush(sGetClear(thePullPushPair.second), iChanW);
 	sFlush(iChanW);
@@ -54,7 +54,10 @@ void sFromZZ_Push_PPT(const Val_ZZ& iVal,
 
 	else if (const Data_ZZ* theData = sPGet<Data_ZZ>(iVal))
 		{
-		sPull_Bin_Push_PPT(ChanRPos_Bin_Data<Data_ZZ>(*theData), iChanW);
+		if (sPushWhole())
+			sPush(*theData, iChanW);
+		else
+			sPull_Bin_Push_PPT(ChanRPos_Bin_Data<Data_ZZ>(*theData), iChanW);
 		}
 
 	else if (not iWriteFilter || not sCall(iWriteFilter, iVal, iChanW))
@@ -96,47 +99,55 @@ ZP<ChannerR_PPT> sChannerR_PPT(const Val_ZZ& iVal)
 // =================================================================================================
 #pragma mark - 
 
-void sPull_PPT_AsZZ(const PPT& iPPT,
-	const ChanR_PPT& iChanR,
-	const ZP<Callable_ZZ_ReadFilter>& iReadFilter,
-	Val_ZZ& oVal)
+static bool spPull_PPT_AsZZ_Leaf(const PPT& iPPT, Val_ZZ& oVal)
 	{
-	// Handle the filter *first*, in case we may have Start derivatives in the chan.
-	if (iReadFilter)
-		{
-		if (ZQ<bool> theQ = iReadFilter->QCall(iPPT, iChanR, oVal))
-			{
-			if (*theQ)
-				return;
-			}
-		}
-
-	// Handle standard stuff.
-
 	if (const string* theString = sPGet<string>(iPPT))
 		{
 		oVal = *theString;
-		return;
+		return true;
 		}
 
 	if (ZP<ChannerR_UTF> theChanner = sGet<ZP<ChannerR_UTF>>(iPPT))
 		{
 		oVal = sReadAllUTF8(*theChanner);
-		return;
+		return true;
 		}
 
 	if (const Data_ZZ* theData = sPGet<Data_ZZ>(iPPT))
 		{
 		oVal = *theData;
-		return;
+		return true;
 		}
 
 	if (ZP<ChannerR_Bin> theChanner = sGet<ZP<ChannerR_Bin>>(iPPT))
 		{
 		oVal = sReadAll_T<Data_ZZ>(*theChanner);
-		return;
+		return true;
 		}
 
+	return false;
+	}
+
+void sPull_PPT_AsZZ(const PPT& iPPT,
+	const ChanR_PPT& iChanR,
+	const ZP<Callable_ZZ_ReadFilter>& iReadFilter,
+	Val_ZZ& oVal)
+	{
+	// Handle the filter *first*, in case we may have Start derivatives in the chan.
+	if (iReadFilter)
+		{
+		if (ZQ<bool> theQ = iReadFilter->QCall(iPPT, iChanR, oVal))
+			{
+			if (*theQ)
+				return;
+			}
+		}
+
+	// Handle standard stuff.
+
+	if (spPull_PPT_AsZZ_Leaf(iPPT, oVal))
+		return;
+
 	if (sIsStart_Map(iPPT))
 		{
 		Map_ZZ theMap;
@@ -225,6 +236,319 @@ Val_ZZ sAsZZ(const ChanR_PPT& iChanR)
 	return Val_ZZ();
 	}
 
+// =================================================================================================
+#pragma mark - ChanR_PPT_FromZZ::ChanW_Pending
+
+class ChanR_PPT_FromZZ::ChanW_Pending
+:	public virtual ChanW_PPT
+	{
+public:
+	ChanW_Pending(std::vector<PPT>& ioPending)
+	:	fPending(ioPending)
+		{}
+
+// From ChanAspect_Write<PPT>
+	virtual size_t Write(const PPT* iSource, size_t iCount)
+		{
+		fPending.insert(fPending.end(), iSource, iSource + iCount);
+		return iCount;
+		}
+
+private:
+	std::vector<PPT>& fPending;
+	};
+
+// =================================================================================================
+#pragma mark - ChanR_PPT_FromZZ
+
+ChanR_PPT_FromZZ::ChanR_PPT_FromZZ(const Val_ZZ& iVal)
+:	fVal(iVal)
+,	fStarted(false)
+,	fPendingOffset(0)
+	{}
+
+ChanR_PPT_FromZZ::ChanR_PPT_FromZZ(const Val_ZZ& iVal,
+	const ZP<Callable_ZZ_WriteFilter>& iWriteFilter)
+:	fVal(iVal)
+,	fWriteFilter(iWriteFilter)
+,	fStarted(false)
+,	fPendingOffset(0)
+	{}
+
+ChanR_PPT_FromZZ::~ChanR_PPT_FromZZ()
+	{}
+
+size_t ChanR_PPT_FromZZ::Read(PPT* oDest, size_t iCount)
+	{
+	PPT* localDest = oDest;
+	PPT* const localDestEnd = oDest + iCount;
+	while (localDest < localDestEnd)
+		{
+		if (fPendingOffset < fPending.size())
+			{
+			const size_t countToMove =
+				std::min(size_t(localDestEnd - localDest), fPending.size() - fPendingOffset);
+			std::move(fPending.begin() + fPendingOffset,
+				fPending.begin() + fPendingOffset + countToMove,
+				localDest);
+			localDest += countToMove;
+			fPendingOffset += countToMove;
+			}
+		else
+			{
+			fPending.clear();
+			fPendingOffset = 0;
+			if (not this->pGenerate())
+				break;
+			}
+		}
+	return localDest - oDest;
+	}
+
+size_t ChanR_PPT_FromZZ::Readable()
+	{ return fPending.size() - fPendingOffset; }
+
+bool ChanR_PPT_FromZZ::pGenerate()
+	{
+	if (not fStarted)
+		{
+		fStarted = true;
+		this->pGenerate(fVal);
+		return true;
+		}
+
+	if (fStack.empty())
+		return false;
+
+	// The Seq_ZZ and Map_ZZ referenced by fStack are all within fVal, so the Val_ZZs
+	// we pass to pGenerate remain valid even when it pushes on fStack.
+	Frame& theFrame = fStack.back();
+	if (theFrame.fSeq)
+		{
+		if (theFrame.fIndex < theFrame.fSeq->Count())
+			{
+			this->pGenerate(theFrame.fSeq->Get(theFrame.fIndex++));
+			return true;
+			}
+		}
+	else if (theFrame.fIter != theFrame.fMap->End())
+		{
+		const Map_ZZ::Index_t theIter = theFrame.fIter++;
+		fPending.push_back(sName(theIter->first));
+		this->pGenerate(theIter->second);
+		return true;
+		}
+
+	fStack.pop_back();
+	fPending.push_back(PullPush::End::sPPT);
+	return true;
+	}
+
+void ChanR_PPT_FromZZ::pGenerate(const Val_ZZ& iVal)
+	{
+	if (const Seq_ZZ* theSeq = sPGet<Seq_ZZ>(iVal))
+		{
+		fPending.push_back(PullPush::Start_Seq::sPPT);
+		const Frame theFrame = { theSeq, 0, nullptr, Map_ZZ::Index_t() };
+		fStack.push_back(theFrame);
+		}
+
+	else if (const Map_ZZ* theMap = sPGet<Map_ZZ>(iVal))
+		{
+		fPending.push_back(PullPush::Start_Map::sPPT);
+		const Frame theFrame = { nullptr, 0, theMap, theMap->Begin() };
+		fStack.push_back(theFrame);
+		}
+
+	else if (const string* theString = sPGet<string>(iVal))
+		{
+		fPending.push_back(*theString);
+		}
+
+	else if (const Data_ZZ* theData = sPGet<Data_ZZ>(iVal))
+		{
+		fPending.push_back(*theData);
+		}
+
+	else if (fWriteFilter)
+		{
+		ThreadVal_PushWhole tv_PushWhole(true);
+		if (not sCall(fWriteFilter, iVal, ChanW_Pending(fPending)))
+			fPending.push_back(iVal.As<PPT>());
+		}
+
+	else
+		{
+		fPending.push_back(iVal.As<PPT>());
+		}
+	}
+
+// =================================================================================================
+#pragma mark - ChanR_PPT_Retained (anonymous)
+
+namespace { // anonymous
+
+// Returns the PPTs following the first one in a vector.
+class ChanR_PPT_Retained
+:	public virtual ChanR_PPT
+	{
+public:
+	ChanR_PPT_Retained(std::vector<PPT>& ioRetained)
+	:	fRetained(ioRetained)
+	,	fOffset(1)
+		{}
+
+// From ChanAspect_Read<PPT>
+	virtual size_t Read(PPT* oDest, size_t iCount)
+		{
+		const size_t countToMove = std::min(iCount, fRetained.size() - fOffset);
+		std::move(fRetained.begin() + fOffset,
+			fRetained.begin() + fOffset + countToMove,
+			oDest);
+		fOffset += countToMove;
+		return countToMove;
+		}
+
+	virtual size_t Readable()
+		{ return fRetained.size() - fOffset; }
+
+private:
+	std::vector<PPT>& fRetained;
+	size_t fOffset;
+	};
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - ChanW_PPT_AsZZ
+
+ChanW_PPT_AsZZ::ChanW_PPT_AsZZ()
+:	fRetainedDepth(0)
+	{}
+
+ChanW_PPT_AsZZ::ChanW_PPT_AsZZ(const ZP<Callable_ZZ_ReadFilter>& iReadFilter)
+:	fReadFilter(iReadFilter)
+,	fRetainedDepth(0)
+	{}
+
+ChanW_PPT_AsZZ::~ChanW_PPT_AsZZ()
+	{}
+
+size_t ChanW_PPT_AsZZ::Write(const PPT* iSource, size_t iCount)
+	{
+	const PPT* localSource = iSource;
+	for (const PPT* const localSourceEnd = iSource + iCount;
+		localSource < localSourceEnd && not fResultQ; ++localSource)
+		{
+		if (fReadFilter)
+			this->pWrite_Filtered(*localSource);
+		else
+			this->pWrite(*localSource);
+		}
+	return localSource - iSource;
+	}
+
+ZQ<Val_ZZ> ChanW_PPT_AsZZ::QGet() const
+	{ return fResultQ; }
+
+void ChanW_PPT_AsZZ::pWrite(const PPT& iPPT)
+	{
+	if (sIsEnd(iPPT))
+		{
+		if (fStack.empty())
+			sThrow_ParseException("Unbalanced End from ChanR_PPT");
+
+		Frame& theFrame = fStack.back();
+		if (theFrame.fNameQ)
+			sThrow_ParseException("Require value after Name from ChanR_PPT");
+
+		const Val_ZZ theVal =
+			theFrame.fIsMap ? Val_ZZ(theFrame.fMap) : Val_ZZ(theFrame.fSeq);
+		fStack.pop_back();
+		this->pDeliver(theVal);
+		return;
+		}
+
+	if (fStack.size() && fStack.back().fIsMap && not fStack.back().fNameQ)
+		{
+		if (const Name* theNameStar = sPGet<Name>(iPPT))
+			fStack.back().fNameQ = *theNameStar;
+		else
+			sThrow_ParseException("Expected Name");
+		return;
+		}
+
+	if (sIsStart_Map(iPPT))
+		{
+		fStack.push_back(Frame());
+		fStack.back().fIsMap = true;
+		return;
+		}
+
+	if (sIsStart_Seq(iPPT))
+		{
+		fStack.push_back(Frame());
+		fStack.back().fIsMap = false;
+		return;
+		}
+
+	Val_ZZ theVal;
+	if (not spPull_PPT_AsZZ_Leaf(iPPT, theVal))
+		theVal = iPPT.As<Val_ZZ>();
+	this->pDeliver(theVal);
+	}
+
+void ChanW_PPT_AsZZ::pWrite_Filtered(const PPT& iPPT)
+	{
+	fRetained.push_back(iPPT);
+
+	if (sIsStart(iPPT))
+		{
+		++fRetainedDepth;
+		}
+	else if (sIsEnd(iPPT))
+		{
+		if (not fRetainedDepth)
+			sThrow_ParseException("Unbalanced End from ChanR_PPT");
+		--fRetainedDepth;
+		}
+
+	if (fRetainedDepth)
+		return;
+
+	// fRetained holds a complete top level value, let sPull_PPT_AsZZ and the filter
+	// loose on it.
+	ChanR_PPT_Retained theChanR(fRetained);
+	Val_ZZ theVal;
+	sPull_PPT_AsZZ(fRetained[0], theChanR, fReadFilter, theVal);
+	fRetained.clear();
+	fResultQ = theVal;
+	}
+
+void ChanW_PPT_AsZZ::pDeliver(const Val_ZZ& iVal)
+	{
+	if (fStack.empty())
+		{
+		fResultQ = iVal;
+		}
+	else
+		{
+		Frame& theFrame = fStack.back();
+		if (theFrame.fIsMap)
+			{
+			theFrame.fMap.Set(*theFrame.fNameQ, iVal);
+			theFrame.fNameQ.Clear();
+			}
+		else
+			{
+			theFrame.fSeq.Append(iVal);
+			}
+		}
+	}
+
+// =================================================================================================
+#pragma mark - 
+
 static void spAsync_AsZZ(const ZP<ChannerR_PPT>& iChannerR,
 	const ZP<Callable_ZZ_ReadFilter>& iReadFilter,
 	const ZP<Promise<Val_ZZ>>& iPromise)
@@ -54,6 +54,92 @@ Val_ZZ sAsZZ(const PPT& iPPT, const ChanR_PPT& iChanR);
 ZQ<Val_ZZ> sQAsZZ(const ChanR_PPT& iChanR);
 Val_ZZ sAsZZ(const ChanR_PPT& iChanR);
 
+// =================================================================================================
+#pragma mark - ChanR_PPT_FromZZ
+
+// Walks a Val_ZZ on the calling thread, generating the same PPTs as sFromZZ_Push_PPT. Any
+// PPTs pushed by a WriteFilter are queued and returned by subsequent Reads. Strings and Data_ZZ
+// are returned whole, so the consumer need not be on another thread.
+
+class ChanR_PPT_FromZZ
+:	public virtual ChanR_PPT
+	{
+public:
+	ChanR_PPT_FromZZ(const Val_ZZ& iVal);
+	ChanR_PPT_FromZZ(const Val_ZZ& iVal, const ZP<Callable_ZZ_WriteFilter>& iWriteFilter);
+	virtual ~ChanR_PPT_FromZZ();
+
+// From ChanAspect_Read<PPT>
+	virtual size_t Read(PPT* oDest, size_t iCount);
+
+	virtual size_t Readable();
+
+private:
+	class ChanW_Pending;
+
+	struct Frame
+		{
+		const Seq_ZZ* fSeq;
+		size_t fIndex;
+		const Map_ZZ* fMap;
+		Map_ZZ::Index_t fIter;
+		};
+
+	bool pGenerate();
+	void pGenerate(const Val_ZZ& iVal);
+
+	const Val_ZZ fVal;
+	const ZP<Callable_ZZ_WriteFilter> fWriteFilter;
+	bool fStarted;
+	std::vector<Frame> fStack;
+	std::vector<PPT> fPending;
+	size_t fPendingOffset;
+	};
+
+// =================================================================================================
+#pragma mark - ChanW_PPT_AsZZ
+
+// Builds a Val_ZZ from the PPTs written to it, on the calling thread. Producers must push
+// strings and binary whole, so the producer should be called in the scope of a true
+// ThreadVal_PushWhole. When there's a ReadFilter the PPTs making up each top level value are
+// retained, and are then passed through sPull_PPT_AsZZ, so the filter can pull whatever
+// it needs from the chan.
+
+class ChanW_PPT_AsZZ
+:	public virtual ChanW_PPT
+	{
+public:
+	ChanW_PPT_AsZZ();
+	ChanW_PPT_AsZZ(const ZP<Callable_ZZ_ReadFilter>& iReadFilter);
+	virtual ~ChanW_PPT_AsZZ();
+
+// From ChanAspect_Write<PPT>
+	virtual size_t Write(const PPT* iSource, size_t iCount);
+
+// Our protocol
+	// Returns the first complete top level value written, if there's been one.
+	ZQ<Val_ZZ> QGet() const;
+
+private:
+	struct Frame
+		{
+		bool fIsMap;
+		Seq_ZZ fSeq;
+		Map_ZZ fMap;
+		ZQ<Name> fNameQ;
+		};
+
+	void pWrite(const PPT& iPPT);
+	void pWrite_Filtered(const PPT& iPPT);
+	void pDeliver(const Val_ZZ& iVal);
+
+	const ZP<Callable_ZZ_ReadFilter> fReadFilter;
+	std::vector<Frame> fStack;
+	std::vector<PPT> fRetained;
+	size_t fRetainedDepth;
+	ZQ<Val_ZZ> fResultQ;
+	};
+
 // =================================================================================================
 #pragma mark -
 
@@ -0,0 +1,1348 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/Pull_JSON_UTF8.h"
+
+#include "zoolib/ChanR_Bin_HexStrim.h"
+#include "zoolib/ChanR_XX_Boundary.h"
+#include "zoolib/ChanR_XX_Terminated.h"
+#include "zoolib/Chan_Bin_ASCIIStrim.h"
+#include "zoolib/Chan_Bin_Base64.h"
+#include "zoolib/Chan_Bin_Data.h"
+#include "zoolib/Chan_UTF_string.h"
+#include "zoolib/Data_ZZ.h"
+#include "zoolib/NameUniquifier.h" // For sName
+#include "zoolib/ParseException.h"
+#include "zoolib/Unicode.h"
+#include "zoolib/Util_Chan_UTF.h"
+
+#include <cmath> // For pow
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSSE3__)
+	#include <tmmintrin.h>
+#elif defined(__SSE2__) || ZCONFIG(Processor, x86_64)
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || ZCONFIG(Processor, ARM_64)
+	#include <arm_neon.h>
+#endif
+
+#if ZCONFIG(Compiler, MSVC)
+	#include <intrin.h>
+#endif
+
+namespace ZooLib {
+
+using namespace PullPush;
+using Util_Chan_JSON::PullTextOptions_JSON;
+using std::string;
+
+namespace { // anonymous
+
+// =================================================================================================
+#pragma mark - ChanRU_UTF_Buffer
+
+// Reads UTF-8 from a buffer we don't own, exactly as ChanRU_UTF_string8 does. We use it to hand
+// the less common constructs (comments, triple-quoted strings, binary data) to the chan-based
+// code, and then pick up from wherever it left off.
+
+class ChanRU_UTF_Buffer
+:	public virtual ChanRU<UTF32>
+	{
+public:
+	ChanRU_UTF_Buffer(const UTF8* iCur, const UTF8* iEnd)
+	:	fStart(iCur)
+	,	fCur(iCur)
+	,	fEnd(iEnd)
+		{}
+
+// From ChanR_UTF
+	virtual size_t Read(UTF32* oDest, size_t iCount)
+		{
+		if (fCur >= fEnd)
+			return 0;
+
+		size_t countConsumed;
+		size_t countProduced;
+		Unicode::sUTF8ToUTF32(
+			fCur, fEnd - fCur,
+			&countConsumed, nullptr,
+			oDest, iCount,
+			&countProduced);
+		fCur += countConsumed;
+		return countProduced;
+		}
+
+// From ChanU_UTF
+	virtual size_t Unread(const UTF32* iSource, size_t iCount)
+		{
+		size_t localCount = 0;
+		while (localCount < iCount && Unicode::sDec(fStart, fCur, fEnd))
+			++localCount;
+		return localCount;
+		}
+
+// Our protocol
+	const UTF8* GetCur() const
+		{ return fCur; }
+
+private:
+	const UTF8* const fStart;
+	const UTF8* fCur;
+	const UTF8* const fEnd;
+	};
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - Vector scanning
+
+static inline size_t spCountTrailingZeroes(uint32 iVal)
+	{
+	#if ZCONFIG(Compiler, MSVC)
+		unsigned long result;
+		_BitScanForward(&result, iVal);
+		return result;
+	#else
+		return __builtin_ctz(iVal);
+	#endif
+	}
+
+static inline bool spIsBasicWS(uint8 iByte)
+	{ return iByte == ' ' || iByte == '\t' || iByte == '\n' || iByte == '\r'; }
+
+// Returns the first byte at or after iCur that's not a space, tab, LF or CR. Those four are
+// whitespace under every configuration of Unicode::sIsWhitespace, anything else is left to
+// our caller to classify.
+static const UTF8* spSkip_BasicWS(const UTF8* iCur, const UTF8* iEnd)
+	{
+	#if defined(__AVX2__)
+
+		const __m256i kSpace = _mm256_set1_epi8(' ');
+		const __m256i kTab = _mm256_set1_epi8('\t');
+		const __m256i kLF = _mm256_set1_epi8('\n');
+		const __m256i kCR = _mm256_set1_epi8('\r');
+		while (iEnd - iCur >= 32)
+			{
+			const __m256i vv = _mm256_loadu_si256((const __m256i*)iCur);
+			const __m256i isWS = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(vv, kSpace), _mm256_cmpeq_epi8(vv, kTab)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(vv, kLF), _mm256_cmpeq_epi8(vv, kCR)));
+			if (const uint32 notWS = ~uint32(_mm256_movemask_epi8(isWS)))
+				return iCur + spCountTrailingZeroes(notWS);
+			iCur += 32;
+			}
+
+	#elif defined(__SSE2__) || ZCONFIG(Processor, x86_64)
+
+		const __m128i kSpace = _mm_set1_epi8(' ');
+		const __m128i kTab = _mm_set1_epi8('\t');
+		const __m128i kLF = _mm_set1_epi8('\n');
+		const __m128i kCR = _mm_set1_epi8('\r');
+		while (iEnd - iCur >= 16)
+			{
+			const __m128i vv = _mm_loadu_si128((const __m128i*)iCur);
+			const __m128i isWS = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(vv, kSpace), _mm_cmpeq_epi8(vv, kTab)),
+				_mm_or_si128(_mm_cmpeq_epi8(vv, kLF), _mm_cmpeq_epi8(vv, kCR)));
+			if (const uint32 notWS = ~uint32(_mm_movemask_epi8(isWS)) & 0xFFFF)
+				return iCur + spCountTrailingZeroes(notWS);
+			iCur += 16;
+			}
+
+	#elif defined(__ARM_NEON) || ZCONFIG(Processor, ARM_64)
+
+		while (iEnd - iCur >= 16)
+			{
+			const uint8x16_t vv = vld1q_u8((const uint8_t*)iCur);
+			const uint8x16_t isWS = vorrq_u8(
+				vorrq_u8(vceqq_u8(vv, vdupq_n_u8(' ')), vceqq_u8(vv, vdupq_n_u8('\t'))),
+				vorrq_u8(vceqq_u8(vv, vdupq_n_u8('\n')), vceqq_u8(vv, vdupq_n_u8('\r'))));
+			// Narrow to four bits per byte.
+			const uint64 notWS = ~vget_lane_u64(vreinterpret_u64_u8(
+				vshrn_n_u16(vreinterpretq_u16_u8(isWS), 4)), 0);
+			if (notWS)
+				return iCur + (__builtin_ctzll(notWS) >> 2);
+			iCur += 16;
+			}
+
+	#endif
+
+	while (iCur < iEnd && spIsBasicWS(*iCur))
+		++iCur;
+	return iCur;
+	}
+
+// =================================================================================================
+#pragma mark - UTF-8 validation
+
+// Keiser and Lemire's lookup algorithm ("Validating UTF-8 In Less Than One Instruction Per
+// Byte"). Each byte is classified by three 16-entry tables, indexed by its high nibble and by
+// the high and low nibbles of the byte before it. A bit that's set in all three lookups flags
+// an error. Overlong forms, surrogates and anything past U+10FFFF are all errors. Some errors
+// depend on the third or fourth byte of a sequence; for those we check the bytes two and
+// three back. The tables need a 16-entry byte shuffle, so SSE2 on its own and 32-bit NEON
+// get the scalar code.
+
+#if defined(__AVX2__) || defined(__SSSE3__) \
+	|| (defined(__ARM_NEON) && defined(__aarch64__)) || ZCONFIG(Processor, ARM_64)
+	#define ZooLib_Pull_JSON_UTF8_VectorUTF8 1
+#else
+	#define ZooLib_Pull_JSON_UTF8_VectorUTF8 0
+#endif
+
+#if ZooLib_Pull_JSON_UTF8_VectorUTF8
+
+enum
+	{
+	kTooShort = 1 << 0, // 11______ 0_______, 11______ 11______
+	kTooLong = 1 << 1, // 0_______ 10______
+	kOverlong3 = 1 << 2, // 11100000 100_____
+	kTooLarge = 1 << 3, // 11110100 1001____, 11110100 101_____, 111101__ 10______ etc
+	kSurrogate = 1 << 4, // 11101101 101_____
+	kOverlong2 = 1 << 5, // 1100000_ 10______
+	kTooLarge1000 = 1 << 6, // 11110101 1000____, 1111011_ 1000____, 11111___ 1000____
+	kOverlong4 = 1 << 6, // 11110000 1000____
+	kTwoConts = 1 << 7, // 10______ 10______
+	kCarry = kTooShort | kTooLong | kTwoConts
+	};
+
+// Indexed by the high nibble of the previous byte.
+static const uint8 spByte1High[16] =
+	{
+	kTooLong, kTooLong, kTooLong, kTooLong,
+	kTooLong, kTooLong, kTooLong, kTooLong,
+	kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+	kTooShort | kOverlong2,
+	kTooShort,
+	kTooShort | kOverlong3 | kSurrogate,
+	kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+	};
+
+// Indexed by the low nibble of the previous byte.
+static const uint8 spByte1Low[16] =
+	{
+	kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+	kCarry | kOverlong2,
+	kCarry,
+	kCarry,
+	kCarry | kTooLarge,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+	kCarry | kTooLarge | kTooLarge1000,
+	kCarry | kTooLarge | kTooLarge1000
+	};
+
+// Indexed by the high nibble of this byte.
+static const uint8 spByte2High[16] =
+	{
+	kTooShort, kTooShort, kTooShort, kTooShort,
+	kTooShort, kTooShort, kTooShort, kTooShort,
+	kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+	kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+	kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+	kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+	kTooShort, kTooShort, kTooShort, kTooShort
+	};
+
+// The largest byte that can end a vector without leaving a sequence incomplete, for each of
+// the last 32 positions.
+static const uint8 spMaxFinal[32] =
+	{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+	};
+
+#if defined(__AVX2__)
+
+	typedef __m256i Vec;
+	const size_t kVecSize = 32;
+
+	static inline Vec spLoad(const void* iPtr)
+		{ return _mm256_loadu_si256((const __m256i*)iPtr); }
+
+	static inline Vec spSplat(uint8 iVal)
+		{ return _mm256_set1_epi8(char(iVal)); }
+
+	static inline Vec spTable(const uint8* iTable)
+		{ return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)iTable)); }
+
+	static inline Vec spLookup(Vec iTable, Vec iNibbles)
+		{ return _mm256_shuffle_epi8(iTable, iNibbles); }
+
+	static inline Vec spHighNibbles(Vec iVec)
+		{ return _mm256_and_si256(_mm256_srli_epi16(iVec, 4), _mm256_set1_epi8(0x0F)); }
+
+	static inline Vec spLowNibbles(Vec iVec)
+		{ return _mm256_and_si256(iVec, _mm256_set1_epi8(0x0F)); }
+
+	static inline Vec spAnd(Vec iL, Vec iR) { return _mm256_and_si256(iL, iR); }
+	static inline Vec spOr(Vec iL, Vec iR) { return _mm256_or_si256(iL, iR); }
+	static inline Vec spXor(Vec iL, Vec iR) { return _mm256_xor_si256(iL, iR); }
+	static inline Vec spEq(Vec iL, Vec iR) { return _mm256_cmpeq_epi8(iL, iR); }
+	static inline Vec spSubSat(Vec iL, Vec iR) { return _mm256_subs_epu8(iL, iR); }
+
+	// iVec shifted along by N bytes, with the last N bytes of iPrior shifted in.
+	template <int N>
+	static inline Vec spPrev(Vec iVec, Vec iPrior)
+		{
+		return _mm256_alignr_epi8(iVec, _mm256_permute2x128_si256(iPrior, iVec, 0x21), 16 - N);
+		}
+
+	static inline bool spAny(Vec iVec)
+		{ return not _mm256_testz_si256(iVec, iVec); }
+
+	static inline bool spAnyNonASCII(Vec iVec)
+		{ return _mm256_movemask_epi8(iVec); }
+
+#elif defined(__SSSE3__)
+
+	typedef __m128i Vec;
+	const size_t kVecSize = 16;
+
+	static inline Vec spLoad(const void* iPtr)
+		{ return _mm_loadu_si128((const __m128i*)iPtr); }
+
+	static inline Vec spSplat(uint8 iVal)
+		{ return _mm_set1_epi8(char(iVal)); }
+
+	static inline Vec spTable(const uint8* iTable)
+		{ return _mm_loadu_si128((const __m128i*)iTable); }
+
+	static inline Vec spLookup(Vec iTable, Vec iNibbles)
+		{ return _mm_shuffle_epi8(iTable, iNibbles); }
+
+	static inline Vec spHighNibbles(Vec iVec)
+		{ return _mm_and_si128(_mm_srli_epi16(iVec, 4), _mm_set1_epi8(0x0F)); }
+
+	static inline Vec spLowNibbles(Vec iVec)
+		{ return _mm_and_si128(iVec, _mm_set1_epi8(0x0F)); }
+
+	static inline Vec spAnd(Vec iL, Vec iR) { return _mm_and_si128(iL, iR); }
+	static inline Vec spOr(Vec iL, Vec iR) { return _mm_or_si128(iL, iR); }
+	static inline Vec spXor(Vec iL, Vec iR) { return _mm_xor_si128(iL, iR); }
+	static inline Vec spEq(Vec iL, Vec iR) { return _mm_cmpeq_epi8(iL, iR); }
+	static inline Vec spSubSat(Vec iL, Vec iR) { return _mm_subs_epu8(iL, iR); }
+
+	// iVec shifted along by N bytes, with the last N bytes of iPrior shifted in.
+	template <int N>
+	static inline Vec spPrev(Vec iVec, Vec iPrior)
+		{ return _mm_alignr_epi8(iVec, iPrior, 16 - N); }
+
+	static inline bool spAny(Vec iVec)
+		{ return _mm_movemask_epi8(_mm_cmpeq_epi8(iVec, _mm_setzero_si128())) != 0xFFFF; }
+
+	static inline bool spAnyNonASCII(Vec iVec)
+		{ return _mm_movemask_epi8(iVec); }
+
+#else // AArch64 NEON
+
+	typedef uint8x16_t Vec;
+	const size_t kVecSize = 16;
+
+	static inline Vec spLoad(const void* iPtr)
+		{ return vld1q_u8((const uint8_t*)iPtr); }
+
+	static inline Vec spSplat(uint8 iVal)
+		{ return vdupq_n_u8(iVal); }
+
+	static inline Vec spTable(const uint8* iTable)
+		{ return vld1q_u8(iTable); }
+
+	static inline Vec spLookup(Vec iTable, Vec iNibbles)
+		{ return vqtbl1q_u8(iTable, iNibbles); }
+
+	static inline Vec spHighNibbles(Vec iVec)
+		{ return vshrq_n_u8(iVec, 4); }
+
+	static inline Vec spLowNibbles(Vec iVec)
+		{ return vandq_u8(iVec, vdupq_n_u8(0x0F)); }
+
+	static inline Vec spAnd(Vec iL, Vec iR) { return vandq_u8(iL, iR); }
+	static inline Vec spOr(Vec iL, Vec iR) { return vorrq_u8(iL, iR); }
+	static inline Vec spXor(Vec iL, Vec iR) { return veorq_u8(iL, iR); }
+	static inline Vec spEq(Vec iL, Vec iR) { return vceqq_u8(iL, iR); }
+	static inline Vec spSubSat(Vec iL, Vec iR) { return vqsubq_u8(iL, iR); }
+
+	// iVec shifted along by N bytes, with the last N bytes of iPrior shifted in.
+	template <int N>
+	static inline Vec spPrev(Vec iVec, Vec iPrior)
+		{ return vextq_u8(iPrior, iVec, 16 - N); }
+
+	static inline bool spAny(Vec iVec)
+		{ return vmaxvq_u8(iVec) != 0; }
+
+	static inline bool spAnyNonASCII(Vec iVec)
+		{ return vmaxvq_u8(iVec) >= 0x80; }
+
+#endif
+
+// Non-zero where iVec, following on from iPrior, isn't well-formed UTF-8, and at the last byte
+// of a U+2028 or U+2029. Those two are well-formed, but they're EOLs and can't be copied
+// into a string.
+static inline Vec spUTF8Problems(Vec iVec, Vec iPrior)
+	{
+	const Vec prev1 = spPrev<1>(iVec, iPrior);
+	const Vec prev2 = spPrev<2>(iVec, iPrior);
+	const Vec prev3 = spPrev<3>(iVec, iPrior);
+
+	const Vec specialCases = spAnd(
+		spAnd(
+			spLookup(spTable(spByte1High), spHighNibbles(prev1)),
+			spLookup(spTable(spByte1Low), spLowNibbles(prev1))),
+		spLookup(spTable(spByte2High), spHighNibbles(iVec)));
+
+	// The high bit is set where the byte two back is 111_____ or three back is 1111____,
+	// which is exactly where a continuation byte must be and specialCases can't tell.
+	const Vec mustBe23 = spOr(
+		spSubSat(prev2, spSplat(0xE0 - 0x80)),
+		spSubSat(prev3, spSplat(0xF0 - 0x80)));
+
+	const Vec isEOL = spAnd(
+		spAnd(spEq(prev2, spSplat(0xE2)), spEq(prev1, spSplat(0x80))),
+		spEq(spAnd(iVec, spSplat(0xFE)), spSplat(0xA8)));
+
+	return spOr(spXor(spAnd(mustBe23, spSplat(0x80)), specialCases), isEOL);
+	}
+
+// True if iVec ends part way through a multi-byte sequence.
+static inline bool spIsIncomplete(Vec iVec)
+	{ return spAny(spSubSat(iVec, spLoad(spMaxFinal + 32 - kVecSize))); }
+
+#endif // ZooLib_Pull_JSON_UTF8_VectorUTF8
+
+// The length of the well-formed UTF-8 sequence starting with the non-ASCII byte at iCur, or
+// zero if it's malformed, truncated, or is U+2028 or U+2029.
+static size_t spWellFormedLength(const UTF8* iCur, const UTF8* iEnd)
+	{
+	const uint8 lead = *iCur;
+	size_t length;
+	uint8 lo = 0x80;
+	uint8 hi = 0xBF;
+	if (lead >= 0xC2 && lead <= 0xDF)
+		{
+		length = 2;
+		}
+	else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+		length = 3;
+		if (lead == 0xE0)
+			lo = 0xA0;
+		else if (lead == 0xED)
+			hi = 0x9F;
+		}
+	else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+		length = 4;
+		if (lead == 0xF0)
+			lo = 0x90;
+		else if (lead == 0xF4)
+			hi = 0x8F;
+		}
+	else
+		{
+		return 0;
+		}
+
+	if (size_t(iEnd - iCur) < length)
+		return 0;
+
+	const uint8 second = iCur[1];
+	if (second < lo || second > hi)
+		return 0;
+
+	for (size_t xx = 2; xx < length; ++xx)
+		{
+		if ((uint8(iCur[xx]) & 0xC0) != 0x80)
+			return 0;
+		}
+
+	if (lead == 0xE2 && second == 0x80 && (uint8(iCur[2]) & 0xFE) == 0xA8)
+		return 0;
+
+	return length;
+	}
+
+// =================================================================================================
+#pragma mark - String bodies
+
+static inline bool spIsStringSpecial(uint8 iByte, uint8 iTerminator)
+	{ return iByte == iTerminator || iByte == '\\' || iByte == '\n' || iByte == '\r'; }
+
+// Returns the first byte at or after iCur that needs more than copying when it's in the
+// body of a string -- the terminator, a backslash, an ASCII EOL, a U+2028 or U+2029, or
+// the start of anything that's not well-formed UTF-8. Copying the bytes before it produces
+// exactly what decoding and re-encoding each code point would.
+static const UTF8* spFind_StringSpecial(const UTF8* iCur, const UTF8* iEnd, uint8 iTerminator)
+	{
+	#if ZooLib_Pull_JSON_UTF8_VectorUTF8
+
+		const Vec kTerminator = spSplat(iTerminator);
+		const Vec kBackslash = spSplat('\\');
+		const Vec kLF = spSplat('\n');
+		const Vec kCR = spSplat('\r');
+
+		// iCur is always at the start of a code point, so whatever precedes it counts as ASCII.
+		Vec prior = spSplat(0);
+		bool priorIncomplete = false;
+		while (size_t(iEnd - iCur) >= kVecSize)
+			{
+			const Vec vv = spLoad(iCur);
+			const Vec isSpecial = spOr(
+				spOr(spEq(vv, kTerminator), spEq(vv, kBackslash)),
+				spOr(spEq(vv, kLF), spEq(vv, kCR)));
+			if (spAny(isSpecial))
+				break;
+
+			if (spAnyNonASCII(vv))
+				{
+				if (spAny(spUTF8Problems(vv, prior)))
+					break;
+				priorIncomplete = spIsIncomplete(vv);
+				}
+			else if (priorIncomplete)
+				{
+				break;
+				}
+
+			prior = vv;
+			iCur += kVecSize;
+			}
+
+		// If the last vector we accepted ended part way through a sequence, back up to that
+		// sequence's lead byte and let the scalar code decide.
+		if (priorIncomplete)
+			{
+			do { --iCur; } while ((uint8(*iCur) & 0xC0) == 0x80);
+			}
+
+	#elif defined(__SSE2__) || ZCONFIG(Processor, x86_64)
+
+		// No byte shuffle, so we skip ASCII a vector at a time and validate what's left
+		// with spWellFormedLength.
+		const __m128i kTerminator = _mm_set1_epi8(iTerminator);
+		const __m128i kBackslash = _mm_set1_epi8('\\');
+		const __m128i kLF = _mm_set1_epi8('\n');
+		const __m128i kCR = _mm_set1_epi8('\r');
+		while (iEnd - iCur >= 16)
+			{
+			const __m128i vv = _mm_loadu_si128((const __m128i*)iCur);
+			const __m128i isSpecial = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(vv, kTerminator), _mm_cmpeq_epi8(vv, kBackslash)),
+				_mm_or_si128(_mm_cmpeq_epi8(vv, kLF), _mm_cmpeq_epi8(vv, kCR)));
+			// movemask picks up the high bit, so non-ASCII bytes come along for free.
+			if (const uint32 mask = _mm_movemask_epi8(_mm_or_si128(isSpecial, vv)))
+				{
+				iCur += spCountTrailingZeroes(mask);
+				break;
+				}
+			iCur += 16;
+			}
+
+	#endif
+
+	while (iCur < iEnd)
+		{
+		const uint8 theByte = *iCur;
+		if (theByte < 0x80)
+			{
+			if (spIsStringSpecial(theByte, iTerminator))
+				break;
+			++iCur;
+			}
+		else if (const size_t length = spWellFormedLength(iCur, iEnd))
+			{
+			iCur += length;
+			}
+		else
+			{
+			break;
+			}
+		}
+	return iCur;
+	}
+
+// =================================================================================================
+#pragma mark - Code points
+
+// Multi-byte sequences are decoded (and validated) by Unicode::sReadInc, which is what
+// ChanRU_UTF_string8 uses, so malformed input is skipped in exactly the same way. Like
+// ChanRU_UTF_string8 (by way of Unicode::sUTF8ToUTF32) we also skip sequences that decode
+// to something other than a valid code point -- surrogates, and anything past U+10FFFF.
+
+static inline bool spReadCP(const UTF8*& ioCur, const UTF8* iEnd, UTF32& oCP)
+	{
+	if (ioCur < iEnd && uint8(*ioCur) < 0x80)
+		{
+		oCP = uint8(*ioCur++);
+		return true;
+		}
+
+	while (Unicode::sReadInc(ioCur, iEnd, oCP))
+		{
+		if (Unicode::sIsValid(oCP))
+			return true;
+		}
+	return false;
+	}
+
+static inline bool spTryRead_CP(const UTF8*& ioCur, const UTF8* iEnd, UTF32 iCP)
+	{
+	if (ioCur >= iEnd)
+		return false;
+
+	if (uint8(*ioCur) == iCP)
+		{
+		++ioCur;
+		return true;
+		}
+
+	if (uint8(*ioCur) < 0x80)
+		return false;
+
+	const UTF8* cur = ioCur;
+	UTF32 theCP;
+	if (not spReadCP(cur, iEnd, theCP) || theCP != iCP)
+		return false;
+
+	ioCur = cur;
+	return true;
+	}
+
+static ZQ<int> spQRead_HexDigit(const UTF8*& ioCur, const UTF8* iEnd)
+	{
+	const UTF8* cur = ioCur;
+	UTF32 theCP;
+	if (spReadCP(cur, iEnd, theCP))
+		{
+		if (ZQ<int> theQ = Util_Chan::sQValueIfHex(theCP))
+			{
+			ioCur = cur;
+			return theQ;
+			}
+		}
+	return null;
+	}
+
+static bool spTryRead_Digit(const UTF8*& ioCur, const UTF8* iEnd, int& oDigit)
+	{
+	const UTF8* cur = ioCur;
+	UTF32 theCP;
+	if (spReadCP(cur, iEnd, theCP) && theCP >= '0' && theCP <= '9')
+		{
+		oDigit = theCP - '0';
+		ioCur = cur;
+		return true;
+		}
+	return false;
+	}
+
+static bool spTryRead_CaselessString(const UTF8*& ioCur, const UTF8* iEnd, const char* iPattern)
+	{
+	const UTF8* cur = ioCur;
+	for (/*no init*/; *iPattern; ++iPattern)
+		{
+		UTF32 theCP;
+		if (not spReadCP(cur, iEnd, theCP))
+			return false;
+		if (Unicode::sToLower(UTF32(*iPattern)) != Unicode::sToLower(theCP))
+			return false;
+		}
+	ioCur = cur;
+	return true;
+	}
+
+static bool spIsWhitespace(UTF32 iCP)
+	{
+	// As in Util_Chan_UTF, we treat a BOM as whitespace.
+	return Unicode::sIsWhitespace(iCP) || iCP == 0xFEFF;
+	}
+
+// =================================================================================================
+#pragma mark - Whitespace and comments
+
+static void spSkip_WSAndCPlusPlusComments(const UTF8*& ioCur, const UTF8* iEnd)
+	{
+	for (;;)
+		{
+		ioCur = spSkip_BasicWS(ioCur, iEnd);
+
+		const UTF8* cur = ioCur;
+		UTF32 theCP;
+		if (not spReadCP(cur, iEnd, theCP))
+			return;
+
+		if (theCP == '/')
+			{
+			ChanRU_UTF_Buffer theChanRU(ioCur, iEnd);
+			Util_Chan::sSkip_WSAndCPlusPlusComments(theChanRU);
+			if (theChanRU.GetCur() == ioCur)
+				return;
+			ioCur = theChanRU.GetCur();
+			}
+		else if (spIsWhitespace(theCP))
+			{
+			ioCur = cur;
+			}
+		else
+			{
+			return;
+			}
+		}
+	}
+
+// =================================================================================================
+#pragma mark - Strings
+
+// The equivalent of sCopyAll(ChanR_UTF_Escaped(iTerminator, ...), ChanW_UTF_string8(...)).
+// Stops with ioCur at the terminator. Invalid code points generated by escape sequences are
+// dropped, as they are by ChanW_UTF_string8.
+static void spCopy_EscapedString(const UTF8*& ioCur, const UTF8* iEnd,
+	UTF32 iTerminator, string& ioString)
+	{
+	for (;;)
+		{
+		const UTF8* runEnd = spFind_StringSpecial(ioCur, iEnd, iTerminator);
+		if (runEnd > ioCur)
+			{
+			ioString.append(ioCur, runEnd);
+			ioCur = runEnd;
+			}
+
+		if (ioCur >= iEnd)
+			sThrow_ParseException("Unexpected end of chan whilst parsing a string");
+
+		const UTF8* cur = ioCur;
+		UTF32 theCP;
+		if (not spReadCP(cur, iEnd, theCP))
+			sThrow_ParseException("Unexpected end of chan whilst parsing a string");
+
+		if (theCP == iTerminator)
+			return;
+
+		if (Unicode::sIsEOL(theCP))
+			sThrow_ParseException("Illegal end of line whilst parsing a string");
+
+		if (theCP < 0x80 && theCP != '\\' && uint8(cur[-1]) < 0x80)
+			{
+			// A malformed sequence was skipped, and we've landed on an ASCII byte.
+			// Go round again so it gets classified as such. (An overlong form of an ASCII
+			// code point is taken as that code point, as it is by the chan-based code.)
+			ioCur = cur - 1;
+			continue;
+			}
+
+		ioCur = cur;
+
+		if (theCP == '\\')
+			{
+			if (not spReadCP(ioCur, iEnd, theCP))
+				sThrow_ParseException("Unexpected end of chan after parsing escape");
+
+			switch (theCP)
+				{
+				case '\\': theCP = '\\'; break;
+				case 't': theCP = '\t'; break;
+				case 'n': theCP = '\n'; break;
+				case 'r': theCP = '\r'; break;
+				case 'b': theCP = '\b'; break;
+				case 'f': theCP = '\f'; break;
+				case '"': theCP = '\"'; break;
+				case '\'': theCP = '\''; break;
+				case '/': theCP = '/'; break;
+				case 'x':
+					{
+					if (NotQ<int> theQ = spQRead_HexDigit(ioCur, iEnd))
+						{
+						sThrow_ParseException("Illegal non-hex digit following \"\\x\"");
+						}
+					else
+						{
+						theCP = *theQ;
+						while (ZQ<int> theQ = spQRead_HexDigit(ioCur, iEnd))
+							theCP = (theCP << 4) + *theQ;
+						}
+					break;
+					}
+				case 'u':
+				case 'U':
+					{
+					int32 requiredChars = 4;
+					if (theCP == 'U')
+						requiredChars = 8;
+
+					UTF32 resultCP = 0;
+					while (requiredChars--)
+						{
+						if (NotQ<int> theQ = spQRead_HexDigit(ioCur, iEnd))
+							{
+							sThrow_ParseException(string8("Illegal non-hex digit in \"\\")
+								+ char(theCP) + "\" escape sequence");
+							}
+						else
+							{
+							resultCP = (resultCP << 4) + *theQ;
+							}
+						}
+					theCP = resultCP;
+					break;
+					}
+				default:
+					{
+					sThrow_ParseException("Illegal character following \"\\\"");
+					}
+				}
+			}
+
+		if (Unicode::sIsValid(theCP))
+			ioString += theCP;
+		}
+	}
+
+static const UTF32 spThreeQuotes[] = { '\"', '\"', '\"' };
+
+// Mirrors spPull_JSON_String_Push_UTF in PullPush_JSON.cpp -- adjacent strings are
+// concatenated, and a """ starts a raw string that runs until the next """.
+static void spRead_JSONString(const UTF8*& ioCur, const UTF8* iEnd,
+	UTF32 iTerminator, string& ioString)
+	{
+	int quotesSeen = 1;
+	for (;;)
+		{
+		switch (quotesSeen)
+			{
+			case 0:
+				{
+				spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+
+				if (spTryRead_CP(ioCur, iEnd, iTerminator))
+					quotesSeen = 1;
+				else
+					return;
+				break;
+				}
+			case 1:
+				{
+				if (spTryRead_CP(ioCur, iEnd, iTerminator))
+					{
+					// We have two quotes in a row.
+					quotesSeen = 2;
+					}
+				else
+					{
+					spCopy_EscapedString(ioCur, iEnd, iTerminator, ioString);
+
+					if (not spTryRead_CP(ioCur, iEnd, iTerminator))
+						sThrow_ParseException(string("Expected ") + iTerminator + " to close a string");
+					quotesSeen = 0;
+					}
+				break;
+				}
+			case 2:
+				{
+				if (spTryRead_CP(ioCur, iEnd, iTerminator))
+					{
+					// We have three quotes in a row.
+					quotesSeen = 3;
+					const UTF8* cur = ioCur;
+					UTF32 theCP;
+					if (spReadCP(cur, iEnd, theCP) && Unicode::sIsEOL(theCP))
+						{
+						// Strip the EOL that follows the opening quotes.
+						ioCur = cur;
+						}
+					}
+				else
+					{
+					// We have two quotes in a row, followed by something
+					// else, so we had an empty string segment.
+					quotesSeen = 0;
+					}
+				break;
+				}
+			case 3:
+				{
+				// Raw strings are rare enough that we just use the chan-based machinery.
+				ChanRU_UTF_Buffer theChanRU(ioCur, iEnd);
+				ChanR_XX_Boundary<UTF32> theChanR_Boundary(
+					spThreeQuotes, countof(spThreeQuotes), theChanRU);
+				sCopyAll(theChanR_Boundary, ChanW_UTF_string8(&ioString));
+				if (not theChanR_Boundary.HitBoundary())
+					sThrow_ParseException("Expected \"\"\" to close a string");
+				ioCur = theChanRU.GetCur();
+				quotesSeen = 0;
+				break;
+				}
+			}
+		}
+	}
+
+static bool spTryRead_EscapedString(const UTF8*& ioCur, const UTF8* iEnd,
+	UTF32 iDelimiter, string& oString)
+	{
+	if (not spTryRead_CP(ioCur, iEnd, iDelimiter))
+		return false;
+
+	spCopy_EscapedString(ioCur, iEnd, iDelimiter, oString);
+
+	if (not spTryRead_CP(ioCur, iEnd, iDelimiter))
+		sThrow_ParseException("Missing string delimiter");
+
+	return true;
+	}
+
+static bool spTryRead_Identifier(const UTF8*& ioCur, const UTF8* iEnd, string& oString)
+	{
+	for (bool gotAny = false; /*no test*/; gotAny = true)
+		{
+		const UTF8* cur = ioCur;
+		UTF32 theCP;
+		if (not spReadCP(cur, iEnd, theCP))
+			return gotAny;
+
+		if (theCP != '_')
+			{
+			if (gotAny ? not Unicode::sIsAlphaDigit(theCP) : not Unicode::sIsAlpha(theCP))
+				return gotAny;
+			}
+
+		oString += theCP;
+		ioCur = cur;
+		}
+	}
+
+static bool spTryRead_PropertyName(const UTF8*& ioCur, const UTF8* iEnd,
+	string& oName, bool iAllowUnquoted)
+	{
+	if (spTryRead_EscapedString(ioCur, iEnd, '"', oName))
+		return true;
+
+	if (spTryRead_EscapedString(ioCur, iEnd, '\'', oName))
+		return true;
+
+	if (iAllowUnquoted && spTryRead_Identifier(ioCur, iEnd, oName))
+		return true;
+
+	return false;
+	}
+
+// =================================================================================================
+#pragma mark - Numbers
+
+// Mirrors Util_Chan::sTryRead_SignedGenericNumber, including how the value is accumulated,
+// so that we generate bit-identical doubles.
+
+static void spAugmentFractional(const UTF8*& ioCur, const UTF8* iEnd, double& ioDouble)
+	{
+	double fracPart = 0.0;
+	double divisor = 1.0;
+
+	for (int curDigit; spTryRead_Digit(ioCur, iEnd, curDigit); /*no inc*/)
+		{
+		divisor *= 10;
+		fracPart *= 10;
+		fracPart += curDigit;
+		}
+	ioDouble += fracPart / divisor;
+	}
+
+static bool spTryRead_Sign(const UTF8*& ioCur, const UTF8* iEnd, bool& oIsNegative)
+	{
+	if (spTryRead_CP(ioCur, iEnd, '-'))
+		{
+		oIsNegative = true;
+		return true;
+		}
+	else if (spTryRead_CP(ioCur, iEnd, '+'))
+		{
+		oIsNegative = false;
+		return true;
+		}
+	return false;
+	}
+
+static bool spTryRead_SignedDecimalInteger(const UTF8*& ioCur, const UTF8* iEnd, int64& oInt64)
+	{
+	bool isNegative = false;
+	const bool hadSign = spTryRead_Sign(ioCur, iEnd, isNegative);
+
+	oInt64 = 0;
+	bool gotAny = false;
+	for (int curDigit; spTryRead_Digit(ioCur, iEnd, curDigit); gotAny = true)
+		{
+		oInt64 *= 10;
+		oInt64 += curDigit;
+		}
+
+	if (gotAny)
+		{
+		if (isNegative)
+			oInt64 = -oInt64;
+		return true;
+		}
+
+	if (hadSign)
+		sThrow_ParseException("Expected a valid integer after sign prefix");
+
+	return false;
+	}
+
+static bool spTryRead_DecimalNumber(const UTF8*& ioCur, const UTF8* iEnd,
+	int64& oInt64, double& oDouble, bool& oIsDouble)
+	{
+	if (spTryRead_CaselessString(ioCur, iEnd, "nan"))
+		{
+		oIsDouble = true;
+		oDouble = NAN;
+		return true;
+		}
+
+	if (spTryRead_CaselessString(ioCur, iEnd, "inf"))
+		{
+		oIsDouble = true;
+		oDouble = INFINITY;
+		return true;
+		}
+
+	if (spTryRead_CP(ioCur, iEnd, '.'))
+		{
+		oIsDouble = true;
+		oDouble = 0;
+		spAugmentFractional(ioCur, iEnd, oDouble);
+		}
+	else
+		{
+		oInt64 = 0;
+		oDouble = 0;
+		oIsDouble = false;
+
+		bool gotAny = false;
+		for (int curDigit; spTryRead_Digit(ioCur, iEnd, curDigit); gotAny = true)
+			{
+			if (not oIsDouble)
+				{
+				const int64 priorInt64 = oInt64;
+				oInt64 *= 10;
+				oInt64 += curDigit;
+				if (oInt64 < priorInt64)
+					{
+					// We've overflowed.
+					oIsDouble = true;
+					}
+				}
+			oDouble *= 10;
+			oDouble += curDigit;
+			}
+
+		if (not gotAny)
+			return false;
+
+		if (spTryRead_CP(ioCur, iEnd, '.'))
+			{
+			oIsDouble = true;
+			spAugmentFractional(ioCur, iEnd, oDouble);
+			}
+		}
+
+	if (spTryRead_CP(ioCur, iEnd, 'e') || spTryRead_CP(ioCur, iEnd, 'E'))
+		{
+		oIsDouble = true;
+		int64 exponent;
+		if (not spTryRead_SignedDecimalInteger(ioCur, iEnd, exponent))
+			sThrow_ParseException("Expected a valid exponent after 'e'");
+		oDouble = oDouble * pow(10.0, int(exponent));
+		}
+
+	return true;
+	}
+
+static bool spTryRead_SignedGenericNumber(const UTF8*& ioCur, const UTF8* iEnd,
+	int64& oInt64, double& oDouble, bool& oIsDouble)
+	{
+	oIsDouble = false;
+	bool isNegative = false;
+	const bool hadSign = spTryRead_Sign(ioCur, iEnd, isNegative);
+
+	const UTF8* const priorZero = ioCur;
+	if (spTryRead_CP(ioCur, iEnd, '0'))
+		{
+		const UTF8* cur = ioCur;
+		UTF32 theCP;
+		if (not spReadCP(cur, iEnd, theCP))
+			{
+			oInt64 = 0;
+			return true;
+			}
+		else if (theCP == 'X' || theCP == 'x')
+			{
+			ioCur = cur;
+			oInt64 = 0;
+			bool gotAny = false;
+			while (ZQ<int> theQ = spQRead_HexDigit(ioCur, iEnd))
+				{
+				oInt64 *= 16;
+				oInt64 += *theQ;
+				gotAny = true;
+				}
+			if (gotAny)
+				{
+				if (isNegative)
+					oInt64 = -oInt64;
+				return true;
+				}
+			sThrow_ParseException("Expected a valid hex integer after '0x' prefix");
+			}
+		else if (theCP != '.' and not Unicode::sIsDigit(theCP))
+			{
+			oInt64 = 0;
+			return true;
+			}
+		ioCur = priorZero;
+		}
+
+	if (spTryRead_DecimalNumber(ioCur, iEnd, oInt64, oDouble, oIsDouble))
+		{
+		if (isNegative)
+			{
+			oInt64 = -oInt64;
+			oDouble = -oDouble;
+			}
+		return true;
+		}
+
+	if (hadSign)
+		{
+		// We've already absorbed a plus or minus sign, hence we have a parse exception.
+		if (isNegative)
+			sThrow_ParseException("Expected a valid number after '-' prefix");
+		else
+			sThrow_ParseException("Expected a valid number after '+' prefix");
+		}
+
+	return false;
+	}
+
+static bool spPull_JSON_Other_Push(const UTF8*& ioCur, const UTF8* iEnd,
+	const ChanW_PPT& iChanW, bool iLooseNumbers)
+	{
+	int64 asInt64;
+	double asDouble;
+	bool isDouble;
+
+	if (spTryRead_SignedGenericNumber(ioCur, iEnd, asInt64, asDouble, isDouble))
+		{
+		if (isDouble)
+			{
+			sPush(asDouble, iChanW);
+			}
+		else
+			{
+			if (iLooseNumbers && asInt64 == -1)
+				{
+				// Read and discard an L suffix (that python puts on things sometimes)
+				spTryRead_CP(ioCur, iEnd, 'l') || spTryRead_CP(ioCur, iEnd, 'L');
+				}
+			sPush(asInt64, iChanW);
+			}
+		return true;
+		}
+
+	if (spTryRead_CaselessString(ioCur, iEnd, "null"))
+		{
+		sPush(PPT(null), iChanW);
+		return true;
+		}
+
+	if (spTryRead_CaselessString(ioCur, iEnd, "false"))
+		{
+		sPush(false, iChanW);
+		return true;
+		}
+
+	if (spTryRead_CaselessString(ioCur, iEnd, "true"))
+		{
+		sPush(true, iChanW);
+		return true;
+		}
+
+	return false;
+	}
+
+// =================================================================================================
+#pragma mark - Binary
+
+static bool spPull_Binary_Push(const UTF8*& ioCur, const UTF8* iEnd, const ChanW_PPT& iChanW)
+	{
+	// Binary data is rare enough that we just use the chan-based machinery.
+	ChanRU_UTF_Buffer theChanRU(ioCur, iEnd);
+
+	Util_Chan::sSkip_WSAndCPlusPlusComments(theChanRU);
+
+	Data_ZZ theData;
+	bool result;
+	if (Util_Chan::sTryRead_CP(theChanRU, '='))
+		{
+		ChanR_XX_Terminated<UTF32> theChanR_UTF_Terminated('>', theChanRU);
+		ChanR_Bin_ASCIIStrim theChanR_Bin_ASCIIStrim(theChanR_UTF_Terminated);
+		ChanR_Bin_Base64Decode theChanR_Bin_Base64Decode(theChanR_Bin_ASCIIStrim);
+
+		std::pair<int64,int64> counts =
+			sCopyAll(theChanR_Bin_Base64Decode, ChanW_Bin_Data<Data_ZZ>(&theData));
+
+		result = counts.first == counts.second;
+
+		if (result && not theChanR_UTF_Terminated.HitTerminator())
+			sThrow_ParseException("Expected '>' to close a base64 data");
+		}
+	else
+		{
+		std::pair<int64,int64> counts =
+			sCopyAll(ChanR_Bin_HexStrim(theChanRU), ChanW_Bin_Data<Data_ZZ>(&theData));
+
+		result = counts.first == counts.second;
+
+		if (result && not Util_Chan::sTryRead_CP(theChanRU, '>'))
+			sThrow_ParseException("Expected '>' to close a hex data");
+		}
+
+	ioCur = theChanRU.GetCur();
+	sPush(theData, iChanW);
+	return result;
+	}
+
+// =================================================================================================
+#pragma mark - Separators
+
+static void spRead_Separators(const UTF8*& ioCur, const UTF8* iEnd,
+	const PullTextOptions_JSON& iOptions, const char* iWhat)
+	{
+	if (iOptions.fLooseSeparators | false)
+		{
+		// We allow zero or more separators
+		for (;;)
+			{
+			spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+			if (spTryRead_CP(ioCur, iEnd, ','))
+				{}
+			else if ((iOptions.fAllowSemiColons | false) && spTryRead_CP(ioCur, iEnd, ';'))
+				{}
+			else
+				break;
+			}
+		}
+	else
+		{
+		spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+		if (spTryRead_CP(ioCur, iEnd, ','))
+			{}
+		else if (iOptions.fAllowSemiColons | false)
+			{
+			if (not spTryRead_CP(ioCur, iEnd, ';'))
+				sThrow_ParseException(string("Require ',' or ';' to separate ") + iWhat);
+			}
+		else
+			{
+			sThrow_ParseException(string("Require ',' to separate ") + iWhat);
+			}
+		}
+	}
+
+// =================================================================================================
+#pragma mark - sPull_JSON_Push_PPT
+
+bool sPull_JSON_Push_PPT(const UTF8*& ioCur, const UTF8* iEnd,
+	const PullTextOptions_JSON& iOptions,
+	const ChanW_PPT& iChanW)
+	{
+	spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+
+	if (spTryRead_CP(ioCur, iEnd, '['))
+		{
+		sPush_Start_Seq(iChanW);
+		for (;;)
+			{
+			spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+			if (spTryRead_CP(ioCur, iEnd, ']'))
+				{
+				sPush_End(iChanW);
+				return true;
+				}
+
+			if (not sPull_JSON_Push_PPT(ioCur, iEnd, iOptions, iChanW))
+				sThrow_ParseException("Expected value or ']'");
+
+			spRead_Separators(ioCur, iEnd, iOptions, "array elements");
+			}
+		}
+	else if (spTryRead_CP(ioCur, iEnd, '{'))
+		{
+		sPush_Start_Map(iChanW);
+		for (;;)
+			{
+			spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+			if (spTryRead_CP(ioCur, iEnd, '}'))
+				{
+				sPush_End(iChanW);
+				return true;
+				}
+
+			string theName;
+			if (not spTryRead_PropertyName(ioCur, iEnd,
+				theName, iOptions.fAllowUnquotedPropertyNames | false))
+				{ sThrow_ParseException("Expected a member name or '}'"); }
+
+			sPush(sName(theName), iChanW);
+
+			spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+
+			if (not spTryRead_CP(ioCur, iEnd, ':'))
+				{
+				if (not (iOptions.fAllowEquals | false))
+					sThrow_ParseException("Expected ':' after a member name");
+
+				if (not spTryRead_CP(ioCur, iEnd, '='))
+					sThrow_ParseException("Expected ':' or '=' after a member name");
+				}
+
+			spSkip_WSAndCPlusPlusComments(ioCur, iEnd);
+
+			if (not sPull_JSON_Push_PPT(ioCur, iEnd, iOptions, iChanW))
+				sThrow_ParseException("Expected value");
+
+			spRead_Separators(ioCur, iEnd, iOptions, "object elements");
+			}
+		}
+	else if (spTryRead_CP(ioCur, iEnd, '"'))
+		{
+		string theString;
+		spRead_JSONString(ioCur, iEnd, '"', theString);
+		sPush(theString, iChanW);
+		return true;
+		}
+	else if (spTryRead_CP(ioCur, iEnd, '\''))
+		{
+		string theString;
+		spRead_JSONString(ioCur, iEnd, '\'', theString);
+		sPush(theString, iChanW);
+		return true;
+		}
+	else if ((iOptions.fAllowBinary | false) && spTryRead_CP(ioCur, iEnd, '<'))
+		{
+		return spPull_Binary_Push(ioCur, iEnd, iChanW);
+		}
+	else
+		{
+		return spPull_JSON_Other_Push(ioCur, iEnd, iChanW, iOptions.fAllowBinary.Get());
+		}
+	}
+
+} // namespace ZooLib
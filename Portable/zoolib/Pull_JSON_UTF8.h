@@ -0,0 +1,31 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_Pull_JSON_UTF8_h__
+#define __ZooLib_Pull_JSON_UTF8_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/PullPush.h"
+#include "zoolib/Util_Chan_JSON.h"
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - sPull_JSON_Push_PPT
+
+// A front end for JSON that's already in memory as UTF-8 (a string8, a Data_ZZ, a mapped file).
+// It accepts exactly what the ChanRU_UTF version accepts, with the same PullTextOptions_JSON.
+// Runs of basic whitespace are skipped a vector at a time (SSE2/AVX2/NEON where available).
+// String bodies are scanned and their UTF-8 validated a vector at a time (AVX2/SSSE3/AArch64
+// NEON; SSE2 skips ASCII a vector at a time and validates the rest a sequence at a time), and
+// well-formed runs are copied whole rather than decoded and re-encoded. Structural characters,
+// numbers and keywords are still dispatched a code point at a time. Strings and binary data
+// are always pushed whole.
+// ioCur is advanced past the value that was read.
+
+bool sPull_JSON_Push_PPT(const UTF8*& ioCur, const UTF8* iEnd,
+	const Util_Chan_JSON::PullTextOptions_JSON& iOptions,
+	const ChanW_PPT& iChanW);
+
+} // namespace ZooLib
+
+#endif // __ZooLib_Pull_JSON_UTF8_h__
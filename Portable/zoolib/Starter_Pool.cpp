@@ -0,0 +1,91 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/Starter_Pool.h"
+
+#include "zoolib/Callable_PMF.h"
+#include "zoolib/StartOnNewThread.h"
+#include "zoolib/ZThread.h"
+
+#include <algorithm> // For std::max
+#include <deque>
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - Starter_Pool
+
+class Starter_Pool
+:	public Starter
+	{
+public:
+	Starter_Pool(size_t iMaxThreads)
+	:	fMaxThreads(std::max<size_t>(1, iMaxThreads))
+	,	fRunners(0)
+		{}
+
+// From Starter
+	bool QStart(const ZP<Startable>& iStartable) override
+		{
+		if (not iStartable)
+			return false;
+
+		ZAcqMtx acq(fMtx);
+		fStartables.push_back(iStartable);
+
+		if (fRunners >= fMaxThreads)
+			return true;
+
+		// The runner keeps us alive until it's emptied the queue.
+		try
+			{
+			sStartOnNewThread(sCallable(sZP(this), &Starter_Pool::pRun));
+			++fRunners;
+			}
+		catch (...)
+			{
+			// If there's a runner already it'll get to this startable eventually.
+			if (not fRunners)
+				{
+				fStartables.pop_back();
+				return false;
+				}
+			}
+		return true;
+		}
+
+private:
+	void pRun()
+		{
+		ZAcqMtx acq(fMtx);
+		while (not fStartables.empty())
+			{
+			const ZP<Startable> theStartable = fStartables.front();
+			fStartables.pop_front();
+
+			ZRelMtx rel(fMtx);
+			try { theStartable->Call(); }
+			catch (...) {}
+			}
+		--fRunners;
+		}
+
+	const size_t fMaxThreads;
+	ZMtx fMtx;
+	size_t fRunners;
+	std::deque<ZP<Startable>> fStartables;
+	};
+
+// =================================================================================================
+#pragma mark - sStarter_Pool
+
+ZP<Starter> sStarter_Pool(size_t iMaxThreads)
+	{ return new Starter_Pool(iMaxThreads); }
+
+ZP<Starter> sStarter_Pool()
+	{
+	static ZP<Starter> spStarter =
+		sStarter_Pool(std::max<size_t>(2, std::thread::hardware_concurrency()) - 1);
+	return spStarter;
+	}
+
+} // namespace ZooLib
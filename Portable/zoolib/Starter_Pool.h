@@ -0,0 +1,26 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_Starter_Pool_h__
+#define __ZooLib_Starter_Pool_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/Starter.h"
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - sStarter_Pool
+
+// Startables are run by at most iMaxThreads runners at a time, and a startable queued when
+// every runner is busy waits its turn. Runners are started with sStartOnNewThread, which
+// reuses idle threads, and each returns its thread once the queue is empty.
+
+ZP<Starter> sStarter_Pool(size_t iMaxThreads);
+
+// A process-wide pool, with one thread fewer than there are hardware threads (but at least
+// one), leaving room for the thread that's handing it work.
+ZP<Starter> sStarter_Pool();
+
+} // namespace ZooLib
+
+#endif // __ZooLib_Starter_Pool_h__
@@ -0,0 +1,49 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/Util_Chan_ReadAt.h"
+
+#include "zoolib/ForEach_Parallel.h"
+#include "zoolib/Starter_Pool.h"
+#include "zoolib/ZThread.h"
+
+#include <algorithm> // For std::max
+#include <atomic>
+
+namespace ZooLib {
+namespace Util_Chan {
+
+// =================================================================================================
+#pragma mark - sReadAt_Parallel
+
+uint64 sReadAt_Parallel(const ChanReadAt<uint64,byte>& iChan,
+	ReadAtRequest* ioRequests, size_t iCount,
+	size_t iMaxConcurrency, const ZP<Starter>& iStarter)
+	{
+	// Requests abandoned after a failure read nothing.
+	for (size_t xx = 0; xx < iCount; ++xx)
+		ioRequests[xx].fCountRead = 0;
+
+	std::atomic<uint64> theTotal(0);
+	sForEach_Parallel(iCount,
+		[&iChan, ioRequests, &theTotal](size_t iIndex)
+			{
+			ReadAtRequest& theRequest = ioRequests[iIndex];
+			theRequest.fCountRead =
+				sReadAt(iChan, theRequest.fLoc, theRequest.fDest, theRequest.fCount);
+			theTotal += theRequest.fCountRead;
+			},
+		iMaxConcurrency, iStarter);
+
+	return theTotal;
+	}
+
+uint64 sReadAt_Parallel(const ChanReadAt<uint64,byte>& iChan,
+	ReadAtRequest* ioRequests, size_t iCount)
+	{
+	return sReadAt_Parallel(iChan, ioRequests, iCount,
+		std::max<size_t>(1, std::thread::hardware_concurrency()),
+		sStarter_Pool());
+	}
+
+} // namespace Util_Chan
+} // namespace ZooLib
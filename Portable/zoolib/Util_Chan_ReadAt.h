@@ -0,0 +1,47 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_Util_Chan_ReadAt_h__
+#define __ZooLib_Util_Chan_ReadAt_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/Chan_Bin.h"
+#include "zoolib/Starter.h"
+
+namespace ZooLib {
+namespace Util_Chan {
+
+// =================================================================================================
+#pragma mark - ReadAtRequest
+
+struct ReadAtRequest
+	{
+	uint64 fLoc;
+	byte* fDest;
+	size_t fCount;
+
+	// Filled in by sReadAt_Parallel.
+	size_t fCountRead;
+	};
+
+// =================================================================================================
+#pragma mark - sReadAt_Parallel
+
+// Satisfies every request in ioRequests from iChan, using up to iMaxConcurrency threads. The
+// calling thread is one of them, and the others are started by iStarter. Workers take the
+// next outstanding request as they become free, so a few big reads don't hold up the rest.
+// iChan's ReadAt must be safe to call from multiple threads, as ChanRAt_Bin_POSIXFD's is.
+// Returns the total number of bytes read, once every request has been handled. If a ReadAt
+// throws, the remaining requests are abandoned and the first exception is rethrown here.
+
+uint64 sReadAt_Parallel(const ChanReadAt<uint64,byte>& iChan,
+	ReadAtRequest* ioRequests, size_t iCount,
+	size_t iMaxConcurrency, const ZP<Starter>& iStarter);
+
+// Uses sStarter_Pool, and one thread per hardware thread.
+uint64 sReadAt_Parallel(const ChanReadAt<uint64,byte>& iChan,
+	ReadAtRequest* ioRequests, size_t iCount);
+
+} // namespace Util_Chan
+} // namespace ZooLib
+
+#endif // __ZooLib_Util_Chan_ReadAt_h__
@@ -94,6 +94,16 @@ bool sTryRead_CP(const ChanRU_UTF& iChanRU, UTF32 iCP)
 
 ZQ<int> sQRead_Digit(const ChanRU_UTF& iChanRU)
 	{
+	const PaC<const UTF32> theBorrowed = sBorrow(iChanRU);
+	if (sCount(theBorrowed))
+		{
+		const UTF32 theCP = *sPtr(theBorrowed);
+		if (theCP < '0' || theCP > '9')
+			return null;
+		sSkip(iChanRU, 1);
+		return theCP - '0';
+		}
+
 	if (NotQ<UTF32> theCPQ = sQRead(iChanRU))
 		{ return null; }
 	else if (*theCPQ >= '0' && *theCPQ <= '9')
@@ -107,6 +117,15 @@ ZQ<int> sQRead_Digit(const ChanRU_UTF& iChanRU)
 
 ZQ<int> sQRead_HexDigit(const ChanRU_UTF& iChanRU)
 	{
+	const PaC<const UTF32> theBorrowed = sBorrow(iChanRU);
+	if (sCount(theBorrowed))
+		{
+		const ZQ<int> theValueQ = sQValueIfHex(*sPtr(theBorrowed));
+		if (theValueQ)
+			sSkip(iChanRU, 1);
+		return theValueQ;
+		}
+
 	if (NotQ<UTF32> theCPQ = sQRead(iChanRU))
 		{ return null; }
 	else if (ZQ<int> theValueQ = sQValueIfHex(*theCPQ))
@@ -151,6 +170,25 @@ bool sRead_String(const ChanR_UTF& iChanR, const string8& iPattern)
 
 bool sTryRead_String(const ChanRU_UTF& iChanRU, const string8& iPattern)
 	{
+	const PaC<const UTF32> theBorrowed = sBorrow(iChanRU);
+	if (sCount(theBorrowed) >= iPattern.size())
+		{
+		// A pattern can't have more code points than it has code units, so if the chan
+		// can lend us that many we can match in place, and there's nothing to unread.
+		const UTF32* cur = sPtr(theBorrowed);
+		for (string8::const_iterator iter = iPattern.begin(), iterEnd = iPattern.end();
+			/*no test*/; ++cur)
+			{
+			UTF32 targetCP;
+			if (not Unicode::sReadInc(iter, iterEnd, targetCP))
+				break;
+			if (targetCP != *cur)
+				return false;
+			}
+		sSkip(iChanRU, cur - sPtr(theBorrowed));
+		return true;
+		}
+
 	std::vector<UTF32> stack;
 
 	for (string8::const_iterator iter = iPattern.begin(), iterEnd = iPattern.end();
@@ -472,6 +510,19 @@ bool sTryRead_SignedGenericNumber(const ChanRU_UTF& iChanRU,
 bool sSkip_WS(const ChanRU_UTF& iChanRU)
 	{
 	bool readAny = false;
+	for (PaC<const UTF32> theBorrowed; sCount(theBorrowed = sBorrow(iChanRU)); /*no inc*/)
+		{
+		readAny = true;
+		const UTF32* const begin = sPtr(theBorrowed);
+		const UTF32* const end = begin + sCount(theBorrowed);
+		const UTF32* cur = begin;
+		while (cur < end && spIsWhitespace(*cur))
+			++cur;
+		sSkip(iChanRU, cur - begin);
+		if (cur < end)
+			return true;
+		}
+
 	while (ZQ<UTF32> theCPQ = sQRead(iChanRU))
 		{
 		readAny = true;
@@ -490,6 +541,24 @@ bool sSkip_WS(const ChanRU_UTF& iChanRU)
 bool sCopy_Line(const ChanR_UTF& iSource, const ChanW_UTF& oDest)
 	{
 	bool readAny = false;
+	for (PaC<const UTF32> theBorrowed; sCount(theBorrowed = sBorrow(iSource)); /*no inc*/)
+		{
+		readAny = true;
+		const UTF32* const begin = sPtr(theBorrowed);
+		const UTF32* const end = begin + sCount(theBorrowed);
+		const UTF32* cur = begin;
+		while (cur < end && not Unicode::sIsEOL(*cur))
+			++cur;
+		sEWrite(oDest, begin, cur - begin);
+		if (cur < end)
+			{
+			// Consume the EOL too.
+			sSkip(iSource, cur - begin + 1);
+			return true;
+			}
+		sSkip(iSource, cur - begin);
+		}
+
 	while (ZQ<UTF32> theCPQ = sQRead(iSource))
 		{
 		readAny = true;
@@ -9,6 +9,7 @@
 #include "zoolib/Chan_UTF_string.h"
 #include "zoolib/PullPush_JSON.h"
 #include "zoolib/PullPush_ZZ.h"
+#include "zoolib/Pull_JSON_UTF8.h"
 //#include "zoolib/StartOnNewThread.h"
 
 #include "zoolib/pdesc.h"
@@ -25,22 +26,30 @@ namespace Util_ZZ_JSON {
 
 ZQ<Val_ZZ> sQRead(const ChanRU_UTF& iChanRU, const PullTextOptions_JSON& iOptions)
 	{
-	PullPushPair<PPT> thePair = sMakePullPushPair<PPT>();
-	ZP<Delivery<Val_ZZ>> theDelivery = sStartAsync_AsZZ(sGetClear(thePair.second));
-	sPull_JSON_Push_PPT(iChanRU, iOptions, *thePair.first);
-	sDisconnectWrite(*thePair.first);
-
-	return theDelivery->QGet();
+	ThreadVal_PushWhole tv_PushWhole(true);
+	ChanW_PPT_AsZZ theChanW;
+	sPull_JSON_Push_PPT(iChanRU, iOptions, theChanW);
+	return theChanW.QGet();
 	}
 
 ZQ<Val_ZZ> sQRead(const ChanRU_UTF& iChanRU)
 	{ return sQRead(iChanRU, sPullTextOptions_Extended()); }
 
+ZQ<Val_ZZ> sQRead(const UTF8* iBegin, const UTF8* iEnd, const PullTextOptions_JSON& iOptions)
+	{
+	ChanW_PPT_AsZZ theChanW;
+	sPull_JSON_Push_PPT(iBegin, iEnd, iOptions, theChanW);
+	return theChanW.QGet();
+	}
+
+ZQ<Val_ZZ> sQRead(const UTF8* iBegin, const UTF8* iEnd)
+	{ return sQRead(iBegin, iEnd, sPullTextOptions_Extended()); }
+
 // =================================================================================================
 #pragma mark -
 
 void sWrite(const ChanW_UTF& iChanW, const Val_ZZ& iVal)
-	{ sPull_PPT_Push_JSON(*sChannerR_PPT(iVal), iChanW); }
+	{ sPull_PPT_Push_JSON(ChanR_PPT_FromZZ(iVal), iChanW); }
 
 void sWrite(const ChanW_UTF& iChanW, const Val_ZZ& iVal, bool iPrettyPrint)
 	{
@@ -70,7 +79,7 @@ string8 sAsJSON(const Val_ZZ& iVal)
 	}
 
 const Val_ZZ sFromJSON(const string8& iString)
-	{ return sQRead(ChanRU_UTF_string8(iString)).Get(); }
+	{ return sQRead(iString.data(), iString.data() + iString.size()).Get(); }
 
 } // namespace Util_ZZ_JSON
 
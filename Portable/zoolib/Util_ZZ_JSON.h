@@ -20,6 +20,10 @@ using namespace Util_Chan_JSON;
 ZQ<Val_ZZ> sQRead(const ChanRU_UTF& iChanRU);
 ZQ<Val_ZZ> sQRead(const ChanRU_UTF& iChanRU, const PullTextOptions_JSON& iOptions);
 
+// For UTF-8 that's already in memory.
+ZQ<Val_ZZ> sQRead(const UTF8* iBegin, const UTF8* iEnd);
+ZQ<Val_ZZ> sQRead(const UTF8* iBegin, const UTF8* iEnd, const PullTextOptions_JSON& iOptions);
+
 void sWrite(const ChanW_UTF& iChanW, const Val_ZZ& iVal);
 void sWrite(const ChanW_UTF& iChanW, const Val_ZZ& iVal, bool iPrettyPrint);
 void sWrite(const ChanW_UTF& iChanW, const Val_ZZ& iVal,
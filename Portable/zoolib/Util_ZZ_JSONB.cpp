@@ -14,18 +14,16 @@ namespace Util_ZZ_JSONB {
 
 ZQ<Val_ZZ> sQRead(const ChanR_Bin& iChanR)
 	{
-	PullPushPair<PPT> thePair = sMakePullPushPair<PPT>();
-	ZP<Delivery<Val_ZZ>> theDelivery = sStartAsync_AsZZ(sGetClear(thePair.second));
-	sPull_JSONB_Push_PPT(iChanR, null, *thePair.first);
-	sDisconnectWrite(*thePair.first);
-
-	return theDelivery->QGet();
+	ThreadVal_PushWhole tv_PushWhole(true);
+	ChanW_PPT_AsZZ theChanW;
+	sPull_JSONB_Push_PPT(iChanR, null, theChanW);
+	return theChanW.QGet();
 	}
 
 // -----
 
 void sWrite(const ChanW_Bin& iChanW, const Val_ZZ& iVal)
-	{ sPull_PPT_Push_JSONB(*sChannerR_PPT(iVal), null, iChanW); }
+	{ sPull_PPT_Push_JSONB(ChanR_PPT_FromZZ(iVal), null, iChanW); }
 
 // -----
 
@@ -36,6 +34,30 @@ Data_ZZ sAsJSONB(const Val_ZZ& iVal)
 	return result;
 	}
 
+// -----
+
+void sWrite_Indexed(const ChanW_Bin& iChanW, const Val_ZZ& iVal)
+	{ sPull_PPT_Push_JSONB_Indexed(ChanR_PPT_FromZZ(iVal), null, iChanW); }
+
+// -----
+
+Data_ZZ sAsJSONB_Indexed(const Val_ZZ& iVal)
+	{
+	Data_ZZ result;
+	sWrite_Indexed(ChanW_Bin_Data<Data_ZZ>(&result), iVal);
+	return result;
+	}
+
+// -----
+
+ZQ<Val_ZZ> sQAsZZ(const JSONBView& iView)
+	{
+	ThreadVal_PushWhole tv_PushWhole(true);
+	ChanW_PPT_AsZZ theChanW;
+	iView.Pull_Push_PPT(null, theChanW);
+	return theChanW.QGet();
+	}
+
 } // namespace Util_ZZ_JSONB
 } // namespace ZooLib
 
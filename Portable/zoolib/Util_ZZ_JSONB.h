@@ -6,6 +6,7 @@
 
 #include "zoolib/ChanR_Bin.h"
 #include "zoolib/ChanW_Bin.h"
+#include "zoolib/PullPush_JSONB.h"
 #include "zoolib/Val_ZZ.h"
 
 // =================================================================================================
@@ -20,6 +21,13 @@ void sWrite(const ChanW_Bin& iChanW, const Val_ZZ& iVal);
 
 Data_ZZ sAsJSONB(const Val_ZZ& iVal);
 
+// Indexed JSONB, see sPull_PPT_Push_JSONB_Indexed. sQRead reads either form.
+void sWrite_Indexed(const ChanW_Bin& iChanW, const Val_ZZ& iVal);
+
+Data_ZZ sAsJSONB_Indexed(const Val_ZZ& iVal);
+
+ZQ<Val_ZZ> sQAsZZ(const JSONBView& iView);
+
 } // namespace Util_ZZ_JSONB
 } // namespace ZooLib
 
@@ -0,0 +1,224 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/Val_JSONB.h"
+
+#include "zoolib/CountedWithoutFinalize.h"
+#include "zoolib/Util_ZZ_JSONB.h"
+#include "zoolib/ZThread.h"
+
+#include <algorithm> // For std::min
+#include <map>
+
+namespace ZooLib {
+
+using std::map;
+
+// =================================================================================================
+#pragma mark - Val_JSONB::Rep
+
+class Val_JSONB::Rep
+:	public CountedWithoutFinalize
+	{
+public:
+	Rep(const Val_ZZ& iVal)
+	:	fValQ(iVal)
+		{}
+
+	Rep(const Data_ZZ& iData, size_t iOffset)
+	:	fData(iData)
+	,	fView(sPaC<const byte>(static_cast<const byte*>(fData.GetPtr()) + iOffset,
+			fData.GetSize() - iOffset))
+		{}
+
+	const Val_ZZ* PGet(const Name& iName)
+		{
+		ZAcqMtx acq(fMtx);
+		if (fValQ)
+			{
+			if (const Map_ZZ* theMap = fValQ->PGet<Map_ZZ>())
+				return theMap->PGet(iName);
+			return nullptr;
+			}
+
+		map<Name,ZQ<Val_ZZ>>::iterator iter = fByName.find(iName);
+		if (iter == fByName.end())
+			{
+			ZQ<Val_ZZ> theQ;
+			try
+				{
+				if (const JSONBView theView = fView.Get(iName.AsString8()))
+					theQ = Util_ZZ_JSONB::sQAsZZ(theView);
+				}
+			catch (...) {}
+			iter = fByName.insert(std::make_pair(iName, theQ)).first;
+			}
+		return iter->second.PGet();
+		}
+
+	const Val_ZZ* PGet(size_t iIndex)
+		{
+		ZAcqMtx acq(fMtx);
+		if (fValQ)
+			{
+			if (const Seq_ZZ* theSeq = fValQ->PGet<Seq_ZZ>())
+				return theSeq->PGet(iIndex);
+			return nullptr;
+			}
+
+		map<size_t,ZQ<Val_ZZ>>::iterator iter = fByIndex.find(iIndex);
+		if (iter == fByIndex.end())
+			{
+			ZQ<Val_ZZ> theQ;
+			try
+				{
+				if (fView.IsSeq())
+					{
+					if (const JSONBView theView = fView.At(iIndex))
+						theQ = Util_ZZ_JSONB::sQAsZZ(theView);
+					}
+				}
+			catch (...) {}
+			iter = fByIndex.insert(std::make_pair(iIndex, theQ)).first;
+			}
+		return iter->second.PGet();
+		}
+
+	bool IsMap()
+		{
+		ZAcqMtx acq(fMtx);
+		if (fValQ)
+			return fValQ->PGet<Map_ZZ>();
+		return fView.IsMap();
+		}
+
+	bool IsSeq()
+		{
+		ZAcqMtx acq(fMtx);
+		if (fValQ)
+			return fValQ->PGet<Seq_ZZ>();
+		return fView.IsSeq();
+		}
+
+	size_t Count()
+		{
+		ZAcqMtx acq(fMtx);
+		if (fValQ)
+			{
+			if (const Map_ZZ* theMap = fValQ->PGet<Map_ZZ>())
+				return theMap->Count();
+			if (const Seq_ZZ* theSeq = fValQ->PGet<Seq_ZZ>())
+				return theSeq->Count();
+			return 0;
+			}
+
+		try { return fView.Count(); }
+		catch (...) { return 0; }
+		}
+
+	const Val_ZZ& AsVal_ZZ()
+		{
+		ZAcqMtx acq(fMtx);
+		if (not fValQ)
+			{
+			ZQ<Val_ZZ> theQ;
+			try { theQ = Util_ZZ_JSONB::sQAsZZ(fView); }
+			catch (...) {}
+
+			// Later lookups use fValQ. Callers may hold pointers into fByName and
+			// fByIndex, so those are left alone.
+			fValQ = theQ ? *theQ : Val_ZZ();
+			}
+		return *fValQ;
+		}
+
+private:
+	ZMtx fMtx;
+	const Data_ZZ fData;
+	const JSONBView fView;
+	ZQ<Val_ZZ> fValQ;
+	map<Name,ZQ<Val_ZZ>> fByName;
+	map<size_t,ZQ<Val_ZZ>> fByIndex;
+	};
+
+// =================================================================================================
+#pragma mark - Val_JSONB
+
+Val_JSONB::Val_JSONB()
+	{}
+
+Val_JSONB::Val_JSONB(const Val_JSONB& iOther)
+:	fRep(iOther.fRep)
+	{}
+
+Val_JSONB::~Val_JSONB()
+	{}
+
+Val_JSONB& Val_JSONB::operator=(const Val_JSONB& iOther)
+	{
+	fRep = iOther.fRep;
+	return *this;
+	}
+
+Val_JSONB::Val_JSONB(const Val_ZZ& iVal)
+:	fRep(new Rep(iVal))
+	{}
+
+Val_JSONB::Val_JSONB(const Data_ZZ& iData)
+:	fRep(new Rep(iData, 0))
+	{}
+
+Val_JSONB::Val_JSONB(const Data_ZZ& iData, size_t iOffset)
+:	fRep(new Rep(iData, std::min(iOffset, iData.GetSize())))
+	{}
+
+bool Val_JSONB::IsMap() const
+	{ return fRep && fRep->IsMap(); }
+
+bool Val_JSONB::IsSeq() const
+	{ return fRep && fRep->IsSeq(); }
+
+size_t Val_JSONB::Count() const
+	{ return fRep ? fRep->Count() : 0; }
+
+const Val_ZZ* Val_JSONB::PGet(const Name& iName) const
+	{ return fRep ? fRep->PGet(iName) : nullptr; }
+
+ZQ<Val_ZZ> Val_JSONB::QGet(const Name& iName) const
+	{
+	if (const Val_ZZ* theVal = this->PGet(iName))
+		return *theVal;
+	return null;
+	}
+
+const Val_ZZ& Val_JSONB::Get(const Name& iName) const
+	{
+	if (const Val_ZZ* theVal = this->PGet(iName))
+		return *theVal;
+	return sDefault<Val_ZZ>();
+	}
+
+const Val_ZZ* Val_JSONB::PGet(size_t iIndex) const
+	{ return fRep ? fRep->PGet(iIndex) : nullptr; }
+
+ZQ<Val_ZZ> Val_JSONB::QGet(size_t iIndex) const
+	{
+	if (const Val_ZZ* theVal = this->PGet(iIndex))
+		return *theVal;
+	return null;
+	}
+
+const Val_ZZ& Val_JSONB::Get(size_t iIndex) const
+	{
+	if (const Val_ZZ* theVal = this->PGet(iIndex))
+		return *theVal;
+	return sDefault<Val_ZZ>();
+	}
+
+const Val_ZZ& Val_JSONB::AsVal_ZZ() const
+	{
+	if (fRep)
+		return fRep->AsVal_ZZ();
+	return sDefault<Val_ZZ>();
+	}
+
+} // namespace ZooLib
@@ -0,0 +1,61 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_Val_JSONB_h__
+#define __ZooLib_Val_JSONB_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/PullPush_JSONB.h"
+#include "zoolib/Val_ZZ.h"
+
+namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - Val_JSONB
+
+// A read-only value held as JSONB in a Data_ZZ. Members of a Map and elements of a Seq are
+// decoded the first time they're asked for, and the result cached, so pulling a few fields
+// out of a large document costs little more than decoding those fields. With indexed JSONB
+// (see sPull_PPT_Push_JSONB_Indexed) finding a member is a binary search, with plain JSONB
+// it's a walk over the encoded members before it. Copies share the cache, which is safe
+// to use from multiple threads. Malformed data is treated as absent.
+// A Val_JSONB can also be made from an already-decoded Val_ZZ, so that callers can treat
+// JSONB and other sources the same way.
+
+class Val_JSONB
+	{
+public:
+	Val_JSONB();
+	Val_JSONB(const Val_JSONB& iOther);
+	~Val_JSONB();
+	Val_JSONB& operator=(const Val_JSONB& iOther);
+
+	Val_JSONB(const Val_ZZ& iVal);
+	Val_JSONB(const Data_ZZ& iData);
+	// The JSONB starts iOffset bytes into iData.
+	Val_JSONB(const Data_ZZ& iData, size_t iOffset);
+
+// Our protocol
+	bool IsMap() const;
+	bool IsSeq() const;
+
+	size_t Count() const;
+
+	const Val_ZZ* PGet(const Name& iName) const;
+	ZQ<Val_ZZ> QGet(const Name& iName) const;
+	const Val_ZZ& Get(const Name& iName) const;
+
+	const Val_ZZ* PGet(size_t iIndex) const;
+	ZQ<Val_ZZ> QGet(size_t iIndex) const;
+	const Val_ZZ& Get(size_t iIndex) const;
+
+	// The entire value, decoded on first use.
+	const Val_ZZ& AsVal_ZZ() const;
+
+private:
+	class Rep;
+	ZP<Rep> fRep;
+	};
+
+} // namespace ZooLib
+
+#endif // __ZooLib_Val_JSONB_h__
@@ -748,4 +748,60 @@ Map_ZZ sAugmented(const Map_ZZ& iUnder, const Map_ZZ& iOver)
 	return result;
 	}
 
+// =================================================================================================
+#pragma mark - sHash
+
+size_t sHash(const Val_ZZ& iVal)
+	{
+	size_t result = iVal.Type().hash_code();
+
+	if (const string8* theVal = iVal.PGet<string8>())
+		return result ^ std::hash<string8>()(*theVal);
+
+	if (const int64* theVal = iVal.PGet<int64>())
+		return result ^ std::hash<int64>()(*theVal);
+
+	if (const int32* theVal = iVal.PGet<int32>())
+		return result ^ std::hash<int32>()(*theVal);
+
+	if (const double* theVal = iVal.PGet<double>())
+		return result ^ std::hash<double>()(*theVal);
+
+	if (const float* theVal = iVal.PGet<float>())
+		return result ^ std::hash<float>()(*theVal);
+
+	if (const bool* theVal = iVal.PGet<bool>())
+		return result ^ std::hash<bool>()(*theVal);
+
+	if (const Name* theVal = iVal.PGet<Name>())
+		return result ^ theVal->Hash();
+
+	if (const Data_ZZ* theVal = iVal.PGet<Data_ZZ>())
+		{
+		const byte* thePtr = static_cast<const byte*>(theVal->GetPtr());
+		for (const byte* last = thePtr + theVal->GetSize(); thePtr != last; ++thePtr)
+			result = result * 31 + *thePtr;
+		return result;
+		}
+
+	if (const Seq_ZZ* theVal = iVal.PGet<Seq_ZZ>())
+		{
+		for (size_t xx = 0, count = theVal->Size(); xx < count; ++xx)
+			result = result * 1000003 ^ sHash(theVal->Get(xx));
+		return result;
+		}
+
+	if (const Map_ZZ* theVal = iVal.PGet<Map_ZZ>())
+		{
+		for (Map_ZZ::Index_t ii = theVal->Begin(); ii != theVal->End(); ++ii)
+			{
+			result = result * 1000003 ^ theVal->NameOf(ii).Hash();
+			result = result * 1000003 ^ sHash(theVal->Get(ii));
+			}
+		return result;
+		}
+
+	return result;
+	}
+
 } // namespace ZooLib
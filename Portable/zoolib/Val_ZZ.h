@@ -459,6 +459,24 @@ private:
 
 Map_ZZ sAugmented(const Map_ZZ& iUnder, const Map_ZZ& iOver);
 
+// =================================================================================================
+#pragma mark - sHash
+
+// Vals that compare equal hash equal. Vals of different types never compare equal, so the type
+// goes into the hash, and for types we don't look inside it's all there is.
+size_t sHash(const Val_ZZ& iVal);
+
 } // namespace ZooLib
 
+namespace std {
+
+template <>
+struct hash<ZooLib::Val_ZZ>
+	{
+	std::size_t operator()(const ZooLib::Val_ZZ& iVal) const
+		{ return ZooLib::sHash(iVal); }
+	};
+
+} // namespace std
+
 #endif // __ZooLib_Val_ZZ_h__
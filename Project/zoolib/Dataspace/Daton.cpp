@@ -16,14 +16,35 @@ int sCompare_T<Dataspace::Daton>(const Dataspace::Daton& iL, const Dataspace::Da
 namespace ZooLib {
 namespace Dataspace {
 
+// =================================================================================================
+#pragma mark - spHash
+
+// 64 bit FNV-1a, folded to size_t.
+static size_t spHash(const Data_ZZ& iData)
+	{
+	const byte* cur = static_cast<const byte*>(iData.GetPtr());
+	const byte* const end = cur + iData.GetSize();
+
+	uint64 result = 0xCBF29CE484222325ULL;
+	while (cur != end)
+		{
+		result ^= *cur++;
+		result *= 0x100000001B3ULL;
+		}
+
+	return size_t(result ^ (result >> 32));
+	}
+
 // =================================================================================================
 #pragma mark - Daton
 
 Daton::Daton()
+:	fHash(spHash(fData))
 	{}
 
 Daton::Daton(const Daton& iOther)
 :	fData(iOther.fData)
+,	fHash(iOther.fHash)
 	{}
 
 Daton::~Daton()
@@ -32,15 +53,17 @@ Daton::~Daton()
 Daton& Daton::operator=(const Daton& iOther)
 	{
 	fData = iOther.fData;
+	fHash = iOther.fHash;
 	return *this;
 	}
 
 Daton::Daton(Data_ZZ iData)
 :	fData(iData)
+,	fHash(spHash(fData))
 	{}
 
 bool Daton::operator==(const Daton& iOther) const
-	{ return fData == iOther.fData; }
+	{ return fHash == iOther.fHash && fData == iOther.fData; }
 
 bool Daton::operator<(const Daton& iOther) const
 	{ return fData < iOther.fData; }
@@ -48,5 +71,8 @@ bool Daton::operator<(const Daton& iOther) const
 Data_ZZ Daton::GetData() const
 	{ return fData; }
 
+size_t Daton::Hash() const
+	{ return fHash; }
+
 } // namespace Dataspace
 } // namespace ZooLib
@@ -17,6 +17,9 @@ namespace Dataspace {
 
 //! A trivial implementation till I get the signing stuff figured out
 
+// The hash of the content is computed once, when the Daton is made. It lets Datons key hashed
+// containers, and lets operator== reject most mismatches without touching the data.
+
 class Daton
 	{
 public:
@@ -32,8 +35,11 @@ public:
 
 	Data_ZZ GetData() const;
 
+	size_t Hash() const;
+
 private:
 	Data_ZZ fData;
+	size_t fHash;
 	};
 
 typedef Callable<int64(const Daton* iAsserted, size_t iAssertedCount,
@@ -46,4 +52,15 @@ template <> struct RelopsTraits_HasLT<Dataspace::Daton> : public RelopsTraits_Ha
 
 } // namespace ZooLib
 
+namespace std {
+
+template <>
+struct hash<ZooLib::Dataspace::Daton>
+	{
+	std::size_t operator()(const ZooLib::Dataspace::Daton& iDaton) const noexcept
+		{ return iDaton.Hash(); }
+	};
+
+} // namespace std
+
 #endif // __ZooLib_Dataspace_Daton_h__
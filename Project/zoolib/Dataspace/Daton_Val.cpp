@@ -6,6 +6,7 @@
 #include "zoolib/Chan_UTF_Chan_Bin.h"
 #include "zoolib/ChanRU_XX_Unreader.h"
 #include "zoolib/Util_ZZ_JSON.h"
+#include "zoolib/Util_ZZ_JSONB.h"
 
 namespace ZooLib {
 namespace Dataspace {
@@ -15,10 +16,29 @@ namespace Dataspace {
 
 namespace { // anonymous
 
+// A JSONB Daton starts with this byte, which UTF-8 never uses, so it can't be mistaken for
+// JSON text, however that starts. The JSONB follows it.
+const byte kJSONBMarker = 0xFF;
+
+bool spIsJSONB(const Data_ZZ& iData)
+	{
+	return iData.GetSize()
+		&& *static_cast<const byte*>(iData.GetPtr()) == kJSONBMarker;
+	}
+
 ZQ<Val_DB> spQAsVal(const Data_ZZ& iData)
 	{
 	try
 		{
+		if (spIsJSONB(iData))
+			{
+			ChanRPos_Bin_Data<Data_ZZ> theChanR(iData);
+			sSkip(theChanR, 1);
+			if (ZQ<Val_ZZ> theValQ = Util_ZZ_JSONB::sQRead(theChanR))
+				return theValQ->As<Val_DB>();
+			return null;
+			}
+
 		if (ZQ<Val_ZZ> theValQ = Util_ZZ_JSON::sQRead(
 			ChanRU_XX_Unreader<UTF32>(
 				ChanR_UTF_Chan_Bin_UTF8(
@@ -46,5 +66,22 @@ Daton sAsDaton(const Val_DB& iVal)
 	return theData;
 	}
 
+Val_JSONB sAsVal_JSONB(const Daton& iDaton)
+	{
+	const Data_ZZ theData = iDaton.GetData();
+	if (spIsJSONB(theData))
+		return Val_JSONB(theData, 1);
+	return Val_JSONB(spQAsVal(theData).Get());
+	}
+
+Daton sAsDaton_JSONB(const Val_DB& iVal)
+	{
+	Data_ZZ theData;
+	ChanW_Bin_Data<Data_ZZ> theChanW(&theData);
+	sEWrite<byte>(theChanW, kJSONBMarker);
+	Util_ZZ_JSONB::sWrite_Indexed(theChanW, iVal.As<Val_ZZ>());
+	return theData;
+	}
+
 } // namespace Dataspace
 } // namespace ZooLib
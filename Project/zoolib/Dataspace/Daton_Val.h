@@ -5,6 +5,7 @@
 #include "zconfig.h"
 
 #include "zoolib/Val_DB.h"
+#include "zoolib/Val_JSONB.h"
 
 #include "zoolib/Dataspace/Daton.h"
 
@@ -14,9 +15,18 @@
 namespace ZooLib {
 namespace Dataspace {
 
+// sAsVal accepts Datons holding either JSON or JSONB, sAsDaton writes JSON.
 Val_DB sAsVal(const Daton& iDaton);
 Daton sAsDaton(const Val_DB& iVal);
 
+// A JSONB Daton's members are decoded only when they're asked for. Others are decoded
+// straight away, as by sAsVal.
+Val_JSONB sAsVal_JSONB(const Daton& iDaton);
+
+// Writes indexed JSONB, see sPull_PPT_Push_JSONB_Indexed, after a leading 0xFF byte
+// that distinguishes it from JSON.
+Daton sAsDaton_JSONB(const Val_DB& iVal);
+
 } // namespace Dataspace
 } // namespace ZooLib
 
@@ -0,0 +1,361 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/Dataspace/Journal_Datons.h"
+
+#include "zoolib/Chan_Bin_Data.h"
+#include "zoolib/Chan_XX_Memory.h"
+#include "zoolib/ChanR_Bin_More.h"
+#include "zoolib/ChanW_Bin_More.h"
+#include "zoolib/Data_ZZ.h"
+#include "zoolib/ParseException.h"
+#include "zoolib/Stringf.h"
+
+#include "zoolib/ZMACRO_foreach.h"
+
+#include "zoolib/POSIX/File_POSIX.h"
+
+#include <algorithm> // For std::sort
+#include <unordered_set>
+
+namespace ZooLib {
+namespace Dataspace {
+
+using std::string;
+using std::vector;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const uint64 kSnapshotMagic = 0x5A446174536E6170ULL; // "ZDatSnap"
+
+const char spSnapshotName[] = "snapshot";
+const char spSnapshotName_Temp[] = "snapshot.tmp";
+const char spLogPrefix[] = "log.";
+
+uint32 spChecksum(const byte* iData, size_t iCount)
+	{
+	uint32 result = 2166136261U;
+	for (const byte* last = iData + iCount; iData != last; ++iData)
+		result = (result ^ *iData) * 16777619U;
+	return result;
+	}
+
+ZQ<uint64> spQLogGeneration(const string& iName)
+	{
+	const size_t thePrefixLength = sizeof(spLogPrefix) - 1;
+	if (iName.size() <= thePrefixLength || 0 != iName.compare(0, thePrefixLength, spLogPrefix))
+		return null;
+
+	uint64 result = 0;
+	for (size_t xx = thePrefixLength; xx < iName.size(); ++xx)
+		{
+		const char theChar = iName[xx];
+		if (theChar < '0' || theChar > '9')
+			return null;
+		result = result * 10 + (theChar - '0');
+		}
+	return result;
+	}
+
+vector<uint64> spLogGenerations(const FileSpec& iDir)
+	{
+	vector<uint64> result;
+	for (FileIter iter = iDir; iter; iter.Advance())
+		{
+		if (ZQ<uint64> theGenerationQ = spQLogGeneration(iter.CurrentName()))
+			result.push_back(*theGenerationQ);
+		}
+	std::sort(result.begin(), result.end());
+	return result;
+	}
+
+// The whole of a file's content. Every Daton copies its own bytes out of it anyway, so there's
+// nothing to be gained from a mapping.
+Data_ZZ spReadAll(const FileSpec& iFileSpec)
+	{
+	if (ZP<ChannerR_Bin> theChannerR = iFileSpec.OpenR())
+		return sReadAll_T<Data_ZZ>(*theChannerR);
+	return Data_ZZ();
+	}
+
+PaC<const byte> spPaC(const Data_ZZ& iData)
+	{ return sPaC<const byte>(static_cast<const byte*>(iData.GetPtr()), iData.GetSize()); }
+
+// Returns once iFS's content is on stable storage. Without File_POSIX we've no way to ask, and
+// have to settle for whatever the OS gets around to.
+void spSync(const FileSpec& iFS)
+	{
+	#if ZCONFIG_API_Enabled(File_POSIX)
+		if (not sSync(iFS))
+			sThrow_ExhaustedW();
+	#endif
+	}
+
+// Returns the snapshot's generation, or null if it's not a snapshot.
+ZQ<uint64> spQReadSnapshot(const PaC<const byte>& iPaC, vector<Daton>& oDatons)
+	{
+	ChanRPos_XX_Memory<byte> theChanR(iPaC);
+
+	const ZQ<uint64> theMagicQ = sQReadBE<uint64>(theChanR);
+	const ZQ<uint64> theGenerationQ = sQReadBE<uint64>(theChanR);
+	const ZQ<uint64> theCountQ = sQReadBE<uint64>(theChanR);
+	if (not theMagicQ || *theMagicQ != kSnapshotMagic || not theGenerationQ || not theCountQ)
+		return null;
+
+	const uint64 theCount = *theCountQ;
+	if (theCount >= iPaC.second / sizeof(uint64))
+		return null;
+
+	oDatons.reserve(theCount);
+	ZQ<uint64> thePriorQ = sQReadBE<uint64>(theChanR);
+	for (uint64 xx = 0; xx < theCount; ++xx)
+		{
+		const ZQ<uint64> theNextQ = sQReadBE<uint64>(theChanR);
+		if (not thePriorQ || not theNextQ || *theNextQ < *thePriorQ || *theNextQ > iPaC.second)
+			return null;
+
+		oDatons.push_back(Daton(Data_ZZ(iPaC.first + *thePriorQ, *theNextQ - *thePriorQ)));
+		thePriorQ = theNextQ;
+		}
+
+	return *theGenerationQ;
+	}
+
+// Applies each intact record in turn to ioDatons.
+void spReplayLog(const PaC<const byte>& iPaC, std::unordered_set<Daton>& ioDatons)
+	{
+	ChanRPos_XX_Memory<byte> theChanR(iPaC);
+	for (;;)
+		{
+		const ZQ<uint32> theLengthQ = sQReadBE<uint32>(theChanR);
+		const ZQ<uint32> theChecksumQ = sQReadBE<uint32>(theChanR);
+		if (not theLengthQ || not theChecksumQ)
+			return;
+
+		const uint64 theStart = sPos(theChanR);
+		if (*theLengthQ > iPaC.second - theStart
+			|| *theChecksumQ != spChecksum(iPaC.first + theStart, *theLengthQ))
+			{ return; }
+
+		ChanRPos_XX_Memory<byte> theChanR_Body(iPaC.first + theStart, *theLengthQ);
+		sSkip(theChanR, *theLengthQ);
+
+		const uint64 theAssertedCount = sReadCount(theChanR_Body);
+		const uint64 theRetractedCount = sReadCount(theChanR_Body);
+		for (uint64 xx = 0; xx < theAssertedCount + theRetractedCount; ++xx)
+			{
+			const uint64 theSize = sReadCount(theChanR_Body);
+			const uint64 thePos = sPos(theChanR_Body);
+			if (theSize > *theLengthQ - thePos)
+				return;
+			sSkip(theChanR_Body, theSize);
+
+			const Daton theDaton(Data_ZZ(iPaC.first + theStart + thePos, theSize));
+			if (xx < theAssertedCount)
+				ioDatons.insert(theDaton);
+			else
+				ioDatons.erase(theDaton);
+			}
+		}
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - Journal_Datons
+
+Journal_Datons::Journal_Datons(const FileSpec& iDir, bool iSyncEachAppend)
+:	fDir(iDir)
+,	fSyncEachAppend(iSyncEachAppend)
+,	fGeneration(0)
+,	fAppended(0)
+,	fGeneration_Snapshot(0)
+	{}
+
+Journal_Datons::~Journal_Datons()
+	{}
+
+vector<Daton> Journal_Datons::Load()
+	{
+	ZAcqMtx acq(fMtx);
+
+	ZAssert(not fChannerW);
+
+	if (not fDir.IsDir())
+		fDir.CreateDir();
+
+	// No snapshot is G zero, and every log is replayed. A snapshot we can't read is an error,
+	// not an empty one -- the logs it replaced are gone.
+	vector<Daton> theDatons_Snapshot;
+	const FileSpec theSnapshotSpec = fDir.Child(spSnapshotName);
+	if (theSnapshotSpec.Exists())
+		{
+		const Data_ZZ theData = spReadAll(theSnapshotSpec);
+		if (ZQ<uint64> theGenerationQ = spQReadSnapshot(spPaC(theData), theDatons_Snapshot))
+			fGeneration_Snapshot = *theGenerationQ;
+		else
+			{
+			sThrow_ParseException(
+				"Journal_Datons, damaged snapshot: " + theSnapshotSpec.AsString_Native());
+			}
+		}
+
+	std::unordered_set<Daton> theDatons(
+		theDatons_Snapshot.begin(), theDatons_Snapshot.end());
+	theDatons_Snapshot.clear();
+
+	uint64 theNextGeneration = fGeneration_Snapshot;
+	foreacha (entry, spLogGenerations(fDir))
+		{
+		if (entry < fGeneration_Snapshot)
+			{
+			// Made redundant by the snapshot, but we stopped before deleting it.
+			this->pLogSpec(entry).Delete();
+			continue;
+			}
+		const Data_ZZ theData = spReadAll(this->pLogSpec(entry));
+		spReplayLog(spPaC(theData), theDatons);
+		theNextGeneration = entry + 1;
+		}
+
+	// The last log may end with a torn record, so never append to an existing one.
+	this->pStartLog(theNextGeneration);
+
+	return vector<Daton>(theDatons.begin(), theDatons.end());
+	}
+
+void Journal_Datons::Append(const Daton* iAsserted, size_t iAssertedCount,
+	const Daton* iRetracted, size_t iRetractedCount)
+	{
+	// Build the whole record, so it can go to the log in one write.
+	Data_ZZ theRecord;
+	{
+	ChanW_Bin_Data<Data_ZZ> theChanW(&theRecord);
+	sEWriteBE<uint32>(theChanW, 0);
+	sEWriteBE<uint32>(theChanW, 0);
+	sEWriteCount(theChanW, iAssertedCount);
+	sEWriteCount(theChanW, iRetractedCount);
+	for (size_t xx = 0; xx < iAssertedCount + iRetractedCount; ++xx)
+		{
+		const Data_ZZ theData = xx < iAssertedCount
+			? iAsserted[xx].GetData() : iRetracted[xx - iAssertedCount].GetData();
+		sEWriteCount(theChanW, theData.GetSize());
+		sEWriteMem(theChanW, theData.GetPtr(), theData.GetSize());
+		}
+	}
+
+	byte* theHeader = static_cast<byte*>(theRecord.GetPtrMutable());
+	const size_t theLength = theRecord.GetSize() - 8;
+	const uint32 theChecksum = spChecksum(theHeader + 8, theLength);
+	for (size_t xx = 0; xx < 4; ++xx)
+		{
+		theHeader[xx] = byte(theLength >> (24 - 8 * xx));
+		theHeader[4 + xx] = byte(theChecksum >> (24 - 8 * xx));
+		}
+
+	ZAcqMtx acq(fMtx);
+	ZAssert(fChannerW);
+	sEWriteMem(*fChannerW, theRecord.GetPtr(), theRecord.GetSize());
+	fAppended += theRecord.GetSize();
+
+	if (fSyncEachAppend)
+		spSync(this->pLogSpec(fGeneration));
+	}
+
+void Journal_Datons::Sync()
+	{
+	ZAcqMtx acq(fMtx);
+	ZAssert(fChannerW);
+	spSync(this->pLogSpec(fGeneration));
+	}
+
+uint64 Journal_Datons::GetAppendedSinceGeneration()
+	{
+	ZAcqMtx acq(fMtx);
+	return fAppended;
+	}
+
+uint64 Journal_Datons::StartGeneration()
+	{
+	ZAcqMtx acq(fMtx);
+	this->pStartLog(fGeneration + 1);
+	return fGeneration;
+	}
+
+void Journal_Datons::WriteSnapshot(uint64 iGeneration, const vector<Daton>& iDatons)
+	{
+	ZAcqMtx acq(fMtx_Snapshot);
+
+	// A later snapshot may have beaten us to it, and deleted logs that ours needs.
+	if (iGeneration <= fGeneration_Snapshot)
+		return;
+
+	const FileSpec theTemp = fDir.Child(spSnapshotName_Temp);
+	theTemp.Delete();
+
+	{
+	ZP<ChannerWPos_Bin> theChannerW = theTemp.CreateWPos(false);
+	if (not theChannerW)
+		sThrow_ExhaustedW();
+
+	const ChanW_Bin& theChanW = *theChannerW;
+
+	sEWriteBE<uint64>(theChanW, kSnapshotMagic);
+	sEWriteBE<uint64>(theChanW, iGeneration);
+	sEWriteBE<uint64>(theChanW, iDatons.size());
+
+	uint64 theOffset = (4 + iDatons.size()) * sizeof(uint64);
+	sEWriteBE<uint64>(theChanW, theOffset);
+	foreacha (entry, iDatons)
+		{
+		theOffset += entry.GetData().GetSize();
+		sEWriteBE<uint64>(theChanW, theOffset);
+		}
+
+	foreacha (entry, iDatons)
+		{
+		const Data_ZZ theData = entry.GetData();
+		sEWriteMem(theChanW, theData.GetPtr(), theData.GetSize());
+		}
+	}
+
+	// The rename is what commits the snapshot, so the content must be durable before it, and
+	// the rename itself before we delete the logs it makes redundant.
+	spSync(theTemp);
+
+	if (not theTemp.MoveTo(fDir.Child(spSnapshotName)))
+		sThrow_ExhaustedW();
+
+	spSync(fDir);
+
+	fGeneration_Snapshot = iGeneration;
+
+	foreacha (entry, spLogGenerations(fDir))
+		{
+		if (entry < iGeneration)
+			this->pLogSpec(entry).Delete();
+		}
+	}
+
+FileSpec Journal_Datons::pLogSpec(uint64 iGeneration)
+	{ return fDir.Child(spLogPrefix + sStringf("%llu", (unsigned long long)iGeneration)); }
+
+void Journal_Datons::pStartLog(uint64 iGeneration)
+	{
+	ZP<ChannerWPos_Bin> theChannerW = this->pLogSpec(iGeneration).CreateWPos(false);
+	if (not theChannerW)
+		sThrow_ExhaustedW();
+
+	// A synced record is no use if the log holding it can vanish.
+	if (fSyncEachAppend)
+		spSync(fDir);
+
+	fChannerW = theChannerW;
+	fGeneration = iGeneration;
+	fAppended = 0;
+	}
+
+} // namespace Dataspace
+} // namespace ZooLib
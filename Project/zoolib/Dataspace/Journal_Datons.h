@@ -0,0 +1,85 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_Dataspace_Journal_Datons_h__
+#define __ZooLib_Dataspace_Journal_Datons_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/File.h"
+
+#include "zoolib/Dataspace/Daton.h"
+
+#include <vector>
+
+namespace ZooLib {
+namespace Dataspace {
+
+// =================================================================================================
+#pragma mark - Journal_Datons
+
+// Keeps a set of Datons in a directory, as a snapshot and a log of the batches of changes
+// made since. Generation numbers tie the two together. Each log file holds one generation,
+// and a snapshot written for generation G holds everything in the logs before G. So a load
+// reads the snapshot and replays only the logs from G on.
+//
+// The snapshot is all fixed-width big-endian integers -- an eight byte magic number, the
+// generation, the count of Datons, count + 1 offsets from the start of the file, and the
+// Datons' bytes back to back.
+//
+// A log record is the byte length of its body and an FNV-1a checksum of it, then the body --
+// the counts of asserted and retracted Datons, and each one's count-prefixed bytes. A record
+// is written with a single write, so it survives the process crashing. It survives the
+// machine crashing only once it's been synced, and a torn or damaged record just ends the
+// replay of that log. A snapshot is synced before it replaces the old one, and the
+// replacement is synced before the logs it makes redundant are deleted.
+
+class Journal_Datons
+:	public Counted
+	{
+public:
+	// With iSyncEachAppend, Append returns only once its record is on stable storage.
+	Journal_Datons(const FileSpec& iDir, bool iSyncEachAppend = false);
+	virtual ~Journal_Datons();
+
+// Our protocol
+
+	// Returns the Datons held, and starts a new log for subsequent Appends. It must be called
+	// before anything else is. Throws if the snapshot is damaged.
+	std::vector<Daton> Load();
+
+	void Append(const Daton* iAsserted, size_t iAssertedCount,
+		const Daton* iRetracted, size_t iRetractedCount);
+
+	// Returns once everything appended so far is on stable storage.
+	void Sync();
+
+	// The bytes appended since the last call to StartGeneration.
+	uint64 GetAppendedSinceGeneration();
+
+	// Ends the current log and starts the next. A snapshot of the Datons as they are when
+	// this is called can be written with the returned generation.
+	uint64 StartGeneration();
+
+	// Replaces the snapshot, if iGeneration is later than its, and deletes the logs that
+	// it makes redundant.
+	void WriteSnapshot(uint64 iGeneration, const std::vector<Daton>& iDatons);
+
+private:
+	FileSpec pLogSpec(uint64 iGeneration);
+	void pStartLog(uint64 iGeneration);
+
+	const FileSpec fDir;
+	const bool fSyncEachAppend;
+
+	ZMtx fMtx;
+	uint64 fGeneration;
+	ZP<ChannerWPos_Bin> fChannerW;
+	uint64 fAppended;
+
+	ZMtx fMtx_Snapshot;
+	uint64 fGeneration_Snapshot;
+	};
+
+} // namespace Dataspace
+} // namespace ZooLib
+
+#endif // __ZooLib_Dataspace_Journal_Datons_h__
@@ -12,7 +12,7 @@
 #include "zoolib/ChanW_Bin_More.h"
 #include "zoolib/Chan_Bin_Data.h"
 #include "zoolib/ChanR_XX_AbortOnSlowRead.h"
-#include "zoolib/Chan_XX_Buffered.h"
+#include "zoolib/ChanRU_XX_Unreader.h"
 #include "zoolib/Chan_XX_Count.h"
 #include "zoolib/Log.h"
 #include "zoolib/StartOnNewThread.h"
@@ -28,6 +28,8 @@
 
 #include "zoolib/RelationalAlgebra/Util_Strim_Rel.h"
 
+#include "zoolib/zlib/Chan_Bin_zlib.h"
+
 #include "zoolib/ZMACRO_foreach.h"
 
 namespace ZooLib {
@@ -38,8 +40,6 @@ using namespace Util_STL;
 
 using QueryEngine::Result;
 
-static size_t kBufSize = 16;
-
 // =================================================================================================
 #pragma mark -
 
@@ -160,12 +160,13 @@ static Map_ZZ spReadMessage(const ChanR_Bin& iChanR, const ZQ<string>& iDescript
 	// Result, Daton and for AbsentOptional_t
 	const ZP<ReadFilter> theReadFilter = sDefault<ZP_Counted<ReadFilter>>();
 
-	PullPushPair<PPT> thePair = sMakePullPushPair<PPT>();
-	ZP<Delivery<Val_ZZ>> theDelivery = sStartAsync_AsZZ(sGetClear(thePair.second), theReadFilter);
-	sPull_JSONB_Push_PPT(theChanR, theReadFilter, ChanW_XX_Buffered<ChanW_PPT>(*thePair.first, kBufSize));
-	sDisconnectWrite(*thePair.first);
+	// The message is built on this thread, as it's parsed.
+	ThreadVal_PushWhole tv_PushWhole(true);
+	ChanW_PPT_AsZZ theChanW(theReadFilter);
+	if (not sPull_JSONB_Push_PPT(theChanR, theReadFilter, theChanW))
+		sThrow_ExhaustedR();
 
-	ZQ<Val_ZZ> theQ = theDelivery->QGet();
+	ZQ<Val_ZZ> theQ = theChanW.QGet();
 	if (not theQ)
 		sThrow_ExhaustedR();
 
@@ -287,9 +288,8 @@ static void spWriteMessage(const ChanW_Bin& iChanW, Map_ZZ iMessage, const ZQ<st
 
 	iMessage.Set("AAA", sAtomic_Add(&spSentMessageCounter, 1));
 
-	sPull_PPT_Push_JSONB(*sChannerR_PPT(iMessage, theWriteFilter), theWriteFilter, iChanW);
-
-	sFlush(theChanW);
+	// The message is walked on this thread, as it's written.
+	sPull_PPT_Push_JSONB(ChanR_PPT_FromZZ(iMessage, theWriteFilter), theWriteFilter, theChanW);
 
 	const double finish = Time::sSystem();
 
@@ -313,6 +313,122 @@ static void spWriteMessage(const ChanW_Bin& iChanW, Map_ZZ iMessage, const ZQ<st
 		}
 	}
 
+// =================================================================================================
+#pragma mark - Frames
+
+// A frame carries any number of messages, and is written with a single flush:
+//   uint8   kFrameMarker
+//   uint8   flags, kFrame_Compressed and/or kFrame_AcceptsCompressed
+//   Count   number of messages
+//   Count   length of the payload
+//   payload the messages' JSONB back to back, deflated in zlib format if kFrame_Compressed.
+// kFrameMarker is not a JSONB type byte, so a reader can take frames and bare messages alike.
+// A frame's payload is only compressed if the peer's frames have said it accepts that.
+
+static const byte kFrameMarker = 0xF0;
+
+static const uint8 kFrame_Compressed = 1;
+static const uint8 kFrame_AcceptsCompressed = 2;
+
+// Smaller payloads gain little from compression.
+static const size_t kCompressThreshold = 4096;
+
+// Reads a frame, or a bare message, and appends its messages to ioMessages. Returns the
+// frame's flags, or null if it was a bare message.
+static ZQ<uint8> spReadMessages(const ChanR_Bin& iChanR, const ZQ<string>& iDescriptionQ,
+	vector<Map_ZZ>& ioMessages)
+	{
+	const ZQ<byte> theFirstQ = sQRead(iChanR);
+	if (not theFirstQ)
+		sThrow_ExhaustedR();
+
+	if (*theFirstQ != kFrameMarker)
+		{
+		ChanRU_XX_Unreader<byte> theChanRU(iChanR);
+		sUnread(theChanRU, &*theFirstQ, 1);
+		sPushBack(ioMessages, spReadMessage(theChanRU, iDescriptionQ));
+		return null;
+		}
+
+	const uint8 theFlags = sEReadBE<uint8>(iChanR);
+	const size_t theCount = size_t(sReadCount(iChanR));
+	const size_t theSize = size_t(sReadCount(iChanR));
+
+	// Take the whole payload, so a bad message can't leave us partway through a frame.
+	const Data_ZZ thePayload = sRead_T<Data_ZZ>(iChanR, theSize);
+	ChanRPos_Bin_Data<Data_ZZ> theChanR(thePayload);
+
+	if (ZLOGF(ww, eDebug + 1))
+		{
+		ww << "Frame, " << theCount << " messages, " << theSize << " bytes";
+		if (theFlags & kFrame_Compressed)
+			ww << " compressed";
+		}
+
+	if (theFlags & kFrame_Compressed)
+		{
+		ChanR_Bin_zlib theChanR_zlib(zlib::EFormatR::ZLib, theSize, theChanR);
+		for (size_t xx = 0; xx < theCount; ++xx)
+			sPushBack(ioMessages, spReadMessage(theChanR_zlib, iDescriptionQ));
+		}
+	else
+		{
+		for (size_t xx = 0; xx < theCount; ++xx)
+			sPushBack(ioMessages, spReadMessage(theChanR, iDescriptionQ));
+		}
+
+	return theFlags;
+	}
+
+// Writes iMessages as bare messages if iFrameFlagsQ is null, otherwise as a single frame with
+// those flags. Its kFrame_Compressed asks for a large enough payload to be deflated, and is
+// dropped if the payload's not large enough or doesn't get smaller. Flushes iChanW.
+static void spWriteMessages(const ChanW_Bin& iChanW, const vector<Map_ZZ>& iMessages,
+	const ZQ<uint8>& iFrameFlagsQ, const ZQ<string>& iDescriptionQ)
+	{
+	if (not iFrameFlagsQ)
+		{
+		foreacha (entry, iMessages)
+			spWriteMessage(iChanW, entry, iDescriptionQ);
+		sFlush(iChanW);
+		return;
+		}
+
+	Data_ZZ thePayload;
+	{
+	ChanW_Bin_Data<Data_ZZ> theChanW(&thePayload);
+	foreacha (entry, iMessages)
+		spWriteMessage(theChanW, entry, iDescriptionQ);
+	}
+
+	uint8 theFlags = *iFrameFlagsQ & ~kFrame_Compressed;
+	if ((*iFrameFlagsQ & kFrame_Compressed) && thePayload.GetSize() >= kCompressThreshold)
+		{
+		Data_ZZ theCompressed;
+		{
+		ChanW_Bin_Data<Data_ZZ> theChanW(&theCompressed);
+		ChanW_Bin_zlib theChanW_zlib(zlib::EFormatW::ZLib, 5, thePayload.GetSize(), theChanW);
+		sEWriteMem(theChanW_zlib, thePayload.GetPtr(), thePayload.GetSize());
+		}
+
+		if (ZLOGF(ww, eDebug + 1))
+			ww << "Frame, compressed " << thePayload.GetSize() << " to " << theCompressed.GetSize();
+
+		if (theCompressed.GetSize() < thePayload.GetSize())
+			{
+			thePayload = theCompressed;
+			theFlags |= kFrame_Compressed;
+			}
+		}
+
+	sEWriteBE<uint8>(iChanW, kFrameMarker);
+	sEWriteBE<uint8>(iChanW, theFlags);
+	sEWriteCount(iChanW, iMessages.size());
+	sEWriteCount(iChanW, thePayload.GetSize());
+	sEWriteMem(iChanW, thePayload.GetPtr(), thePayload.GetSize());
+	sFlush(iChanW);
+	}
+
 // =================================================================================================
 
 namespace { // anonymous
@@ -414,9 +530,16 @@ struct MelangeServer::ResultCC
 	{
 	int64 fCC;
 	ZP<Result> fResult;
-	ZP<ResultDeltas> fResultDeltas;
 	};
 
+// Deltas carry an index per changed row as well as its values, so they're only worth sending
+// if they have fewer values than the whole result would.
+static bool spDeltasAreSmaller(const ZP<ResultDeltas>& iDeltas, const ZP<Result>& iResult)
+	{
+	const size_t theColCount = iResult->GetRelHead().size();
+	return iDeltas->fMapping.size() * (theColCount + 1) < iResult->Count() * theColCount;
+	}
+
 MelangeServer::MelangeServer(const Melange_t& iMelange,
 	const ZP<ChannerRW_Bin>& iChannerRW,
 	int64 iClientVersion,
@@ -431,6 +554,8 @@ MelangeServer::MelangeServer(const Melange_t& iMelange,
 ,	fLastClientChangeCount(0)
 ,	fTimeout(10)
 ,	fConnectionTimeout(30)
+,	fPeerFramed(false)
+,	fPeerAcceptsCompressed(false)
 	{}
 
 MelangeServer::~MelangeServer()
@@ -473,17 +598,25 @@ void MelangeServer::pRead()
 		{
 		ZP<ChannerR_Bin> theChannerR = fChannerR;
 
-		Map_ZZ theMap;
+		vector<Map_ZZ> theMessages;
+		ZQ<uint8> theFlagsQ;
 		{
 		ZRelMtx rel(fMtx);
-		theMap = spReadMessage(*theChannerR, fDescriptionQ);
+		theFlagsQ = spReadMessages(*theChannerR, fDescriptionQ, theMessages);
 		}
 
+		// We reply in frames if the client uses them, compressed if it accepts that.
+		if (theFlagsQ)
+			{
+			fPeerFramed = true;
+			fPeerAcceptsCompressed = *theFlagsQ & kFrame_AcceptsCompressed;
+			}
+
 		fTimeOfLastRead = Time::sSystem();
 
 		fTrueOnce_SendAnEmptyMessage.Reset();
 
-		fQueue_Read.push_back(theMap);
+		fQueue_Read.insert(fQueue_Read.end(), theMessages.begin(), theMessages.end());
 		this->pWake();
 		}
 	}
@@ -502,9 +635,10 @@ void MelangeServer::pWrite()
 		{
 		if (fTrueOnce_SendAnEmptyMessage())
 			{
+			const ZQ<uint8> theFrameFlagsQ = this->pFrameFlagsQ();
 			{
 			ZRelMtx rel(fMtx);
-			spWriteMessage(*theChannerW, Map_ZZ(), fDescriptionQ);
+			spWriteMessages(*theChannerW, vector<Map_ZZ>(1), theFrameFlagsQ, fDescriptionQ);
 			}
 			fTimeOfLastWrite = Time::sSystem();
 			}
@@ -512,39 +646,73 @@ void MelangeServer::pWrite()
 	else while (not sIsEmpty(fMap_Refcon2ResultCC))
 		{
 		fTrueOnce_SendAnEmptyMessage.Reset();
-		vector<Map_ZZ> theMessages;
+
+		// Pair each result with what the client has for its refcon, if we can send deltas.
+		struct ToSend
+			{
+			int64 fRefcon;
+			ResultCC fResultCC;
+			ZP<Result> fPrior;
+			};
+
+		vector<ToSend> theToSends;
 		foreacha (entry, fMap_Refcon2ResultCC)
+			{
+			ZP<Result> thePrior;
+			if (not sQErase(fSet_NewRefcons, entry.first) && fClientVersion >= 2)
+				thePrior = sGet(fMap_Refcon2ResultSent, entry.first);
+
+			sSet(fMap_Refcon2ResultSent, entry.first, entry.second.fResult);
+
+			sPushBack(theToSends, ToSend({entry.first, entry.second, thePrior}));
+			}
+		sClear(fMap_Refcon2ResultCC);
+
+		const ZQ<uint8> theFrameFlagsQ = this->pFrameFlagsQ();
+
+		{
+		ZRelMtx rel(fMtx);
+
+		// Comparing with the prior results and writing are done without fMtx, and
+		// everything that's pending goes in one frame.
+		vector<Map_ZZ> theMessages;
+		foreacha (entry, theToSends)
 			{
 			Map_ZZ theMap;
 			theMap.Set("What", "Change");
-			theMap.Set("Refcon", entry.first);
-			if (sQErase(fSet_NewRefcons, entry.first)
-				|| fClientVersion < 2
-				|| not entry.second.fResultDeltas)
-				{
-				theMap.Set("Result", spAsVal(entry.second.fResult));
-				}
+			theMap.Set("Refcon", entry.fRefcon);
+
+			const ZP<Result>& theResult = entry.fResultCC.fResult;
+			ZP<ResultDeltas> theDeltas = QueryEngine::sDeltas(entry.fPrior, theResult);
+			if (theDeltas && spDeltasAreSmaller(theDeltas, theResult))
+				theMap.Set("Deltas", spAsVal(theDeltas));
 			else
-				{
-				theMap.Set("Deltas", spAsVal(entry.second.fResultDeltas));
-				}
-			theMap.Set("ChangeCount", entry.second.fCC);
+				theMap.Set("Result", spAsVal(theResult));
+
+			theMap.Set("ChangeCount", entry.fResultCC.fCC);
+
 			sPushBack(theMessages, theMap);
 			}
-		sClear(fMap_Refcon2ResultCC);
 
-		foreacha (entry, theMessages)
-			{
-			{
-			ZRelMtx rel(fMtx);
-			spWriteMessage(*theChannerW, entry, fDescriptionQ);
-			}
-			fTimeOfLastWrite = Time::sSystem();
-			}
+		spWriteMessages(*theChannerW, theMessages, theFrameFlagsQ, fDescriptionQ);
+		}
+
+		fTimeOfLastWrite = Time::sSystem();
 		}
 	fTrueOnce_WriteNeedsStart.Reset();
 	}
 
+ZQ<uint8> MelangeServer::pFrameFlagsQ()
+	{
+	if (not fPeerFramed)
+		return null;
+
+	if (fPeerAcceptsCompressed)
+		return kFrame_AcceptsCompressed | kFrame_Compressed;
+
+	return kFrame_AcceptsCompressed;
+	}
+
 void MelangeServer::pWake()
 	{
 	sNextStartIn(0, fJob);
@@ -612,8 +780,9 @@ void MelangeServer::pWork()
 					}
 				else
 					{
-					// Also toss any result for the refcon.
+					// Also toss any result for the refcon, and what the client had for it.
 					sErase(fMap_Refcon2ResultCC, *theRefconQ);
+					sErase(fMap_Refcon2ResultSent, *theRefconQ);
 					}
 				}
 			}
@@ -660,59 +829,6 @@ void MelangeServer::pWork()
 	sNextStartAt(fTimeOfLastWrite + fTimeout, fJob);
 	}
 
-//static ZP<ResultDeltas> spUnderOver(const ZP<ResultDeltas>& iUnder, const ZP<ResultDeltas>& iOver)
-//	{
-//	const size_t countU = iUnder ? iUnder->fMapping.size() : 0;
-//	if (countU == 0)
-//		return iOver;
-//
-//	const size_t countO = iOver ? iOver->fMapping.size() : 0;
-//	if (countO == 0)
-//		return iUnder;
-//
-//	const size_t colCount = iUnder->fPackedRows.size() / countU;
-//
-//	ZP<ResultDeltas> result = new ResultDeltas;
-//	result->fPackedRows.reserve(colCount * (countU + countO) / 4);
-//
-//	size_t iterU = 0, iterO = 0;
-//	for (;;)
-//		{
-//		if (iterU >= countU)
-//			{
-//			if (iterO >= countO)
-//				{
-//				break;
-//				}
-//
-//			// Take/inc O
-//			}
-//		else if (iterO >= countO)
-//			{
-//			// Take/inc U
-//			}
-//		else
-//			{
-//			size_t mappingU = iUnder->fMapping[iterU];
-//			size_t mappingO = iOver->fMapping[iterO];
-//			if (mappingU < mappingO)
-//				{
-//				// Take/inc U
-//				}
-//			else if (mappingU > mappingO)
-//				{
-//				// Take/inc O
-//				}
-//			else
-//				{
-//				// inc U
-//				// Take/inc O
-//				}
-//			}
-//		}
-//	return result;
-//	}
-
 void MelangeServer::pChanged(
 	const RefReg& iRegistration,
 	int64 iChangeCount,
@@ -721,26 +837,11 @@ void MelangeServer::pChanged(
 	{
 	ZAcqMtx acq(fMtx);
 
+	// iResultDeltas is relative to whatever our source last gave us, which the client may
+	// not have seen. pWrite works out deltas from what the client does have, so only the
+	// latest result matters, and it supersedes any that's not yet been sent.
 	const int64 theRefCon = sGetMust(fMap_Reg2Refcon, iRegistration);
-	ResultCC* theResultCC = sPMut(fMap_Refcon2ResultCC, theRefCon);
-	if (theResultCC && theResultCC->fResultDeltas)
-		{
-		if (ZLOGF(w, eInfo))
-			{
-			if (fDescriptionQ)
-				w << *fDescriptionQ << " ";
-			w << "Already had an entry for registration " << theRefCon;
-			}
-		theResultCC->fResult = iResult;
-		theResultCC->fResultDeltas.Clear();
-
-//		theResultCC->fResultDeltas = spUnderOver(theResultCC->fResultDeltas, iResultDelta);
-		}
-	else
-		{
-		sSet(fMap_Refcon2ResultCC, theRefCon,
-			ResultCC({fLastClientChangeCount, iResult, iResultDeltas}));
-		}
+	sSet(fMap_Refcon2ResultCC, theRefCon, ResultCC({fLastClientChangeCount, iResult}));
 
 	this->pWake();
 	}
@@ -774,8 +875,17 @@ public:
 
 Melange_Client::Melange_Client(const ZP<Factory_Channer>& iFactory,
 	const ZP<Callable_Status>& iCallable_Status)
+:	Melange_Client(iFactory, iCallable_Status, false, false)
+	{}
+
+Melange_Client::Melange_Client(const ZP<Factory_Channer>& iFactory,
+	const ZP<Callable_Status>& iCallable_Status,
+	bool iFramed, bool iCompress)
 :	fFactory(iFactory)
 ,	fCallable_Status(iCallable_Status)
+,	fFramed(iFramed)
+,	fCompress(iCompress)
+,	fPeerAcceptsCompressed(false)
 ,	fGettingChanner(false)
 ,	fReadSinceWrite(false)
 ,	fChangeCount(1)
@@ -868,16 +978,20 @@ void Melange_Client::pRead()
 			if (not theChanner)
 				continue;
 
-			Map_ZZ theMap;
+			vector<Map_ZZ> theMessages;
+			ZQ<uint8> theFlagsQ;
 			{
 			ZRelMtx rel(fMtx);
 			if (::getenv("ZOOLIB_DONT_ABORT_ON_SLOW_READ"))
-				theMap = spReadMessage(*theChanner, null);
+				theFlagsQ = spReadMessages(*theChanner, null, theMessages);
 			else
-				theMap = spReadMessage(ChanR_XX_AbortOnSlowRead<byte>(*theChanner, 15), null);
+				theFlagsQ = spReadMessages(ChanR_XX_AbortOnSlowRead<byte>(*theChanner, 15), null, theMessages);
 			}
 
-			fQueue_Read.push_back(theMap);
+			if (theFlagsQ)
+				fPeerAcceptsCompressed = *theFlagsQ & kFrame_AcceptsCompressed;
+
+			fQueue_Read.insert(fQueue_Read.end(), theMessages.begin(), theMessages.end());
 			this->pWake();
 			}
 		catch (...)
@@ -912,11 +1026,12 @@ void Melange_Client::pWrite()
 		vector<Map_ZZ> theMessages;
 		swap(fQueue_ToWrite, theMessages);
 
+		const ZQ<uint8> theFrameFlagsQ = this->pFrameFlagsQ();
+
 		try
 			{
 			ZRelMtx rel(fMtx);
-			foreacha (entry, theMessages)
-				spWriteMessage(*theChannerW, entry, null);
+			spWriteMessages(*theChannerW, theMessages, theFrameFlagsQ, null);
 			}
 		catch (...)
 			{
@@ -926,6 +1041,20 @@ void Melange_Client::pWrite()
 	fTrueOnce_WriteNeedsStart.Reset();
 	}
 
+ZQ<uint8> Melange_Client::pFrameFlagsQ()
+	{
+	if (not fFramed)
+		return null;
+
+	if (not fCompress)
+		return uint8(0);
+
+	if (fPeerAcceptsCompressed)
+		return kFrame_AcceptsCompressed | kFrame_Compressed;
+
+	return kFrame_AcceptsCompressed;
+	}
+
 void Melange_Client::pWake()
 	{
 	if (fJob.first)
@@ -1063,6 +1192,7 @@ ZP<Melange_Client::Channer_t> Melange_Client::pEnsureChanner()
 		sClear(fQueue_ToWrite);
 
 		fReadSinceWrite = false;
+		fPeerAcceptsCompressed = false;
 
 		this->pWake();
 
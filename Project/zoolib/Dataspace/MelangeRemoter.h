@@ -41,6 +41,8 @@ private:
 	void pRead();
 	void pWrite();
 
+	ZQ<uint8> pFrameFlagsQ();
+
 	void pWake();
 	void pWork();
 	StartScheduler::Job fJob;
@@ -74,9 +76,16 @@ private:
 	const double fTimeout;
 	const double fConnectionTimeout;
 
+	// Set by the first frame we read. Until then we write bare messages.
+	bool fPeerFramed;
+	bool fPeerAcceptsCompressed;
+
 	std::map<int64,RefReg> fMap_Refcon2Reg;
 	struct ResultCC;
 	std::map<int64,ResultCC> fMap_Refcon2ResultCC;
+
+	// What the client has for each refcon, which new results are sent as deltas against.
+	std::map<int64,ZP<Result>> fMap_Refcon2ResultSent;
 	std::map<RefReg,int64> fMap_Reg2Refcon;
 	std::set<int64> fSet_NewRefcons;
 	};
@@ -105,6 +114,13 @@ public:
 	Melange_Client(const ZP<Factory_Channer>& iFactory,
 		const ZP<Callable_Status>& iCallable_Status);
 
+	// With iFramed our messages are sent in frames, which a MelangeServer answers in kind.
+	// With iCompress too, large frames are compressed once the server says it accepts that,
+	// and we say that we do.
+	Melange_Client(const ZP<Factory_Channer>& iFactory,
+		const ZP<Callable_Status>& iCallable_Status,
+		bool iFramed, bool iCompress);
+
 // From Callable via Callable_Register
 	virtual ZP<Counted> QCall(
 		const ZP<RelsWatcher::Callable_Changed>& iCallable_Changed,
@@ -130,6 +146,8 @@ private:
 	void pRead();
 	void pWrite();
 
+	ZQ<uint8> pFrameFlagsQ();
+
 	void pWake();
 	void pWork();
 	StartScheduler::Job fJob;
@@ -150,6 +168,10 @@ private:
 	const ZP<Factory_Channer> fFactory;
 	const ZP<Callable_Status> fCallable_Status;
 
+	const bool fFramed;
+	const bool fCompress;
+	bool fPeerAcceptsCompressed;
+
 	ZMtx fMtx;
 	ZCnd fCnd;
 
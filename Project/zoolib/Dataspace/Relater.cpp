@@ -95,6 +95,10 @@ Relater::Relater()
 Relater::~Relater()
 	{}
 
+ZQ<QueryEngine::Estimate> Relater::QEstimate(const ConcreteHead& iConcreteHead,
+	const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction)
+	{ return null; }
+
 void Relater::SetCallable_RelaterResultsAvailable(ZP<Callable_RelaterResultsAvailable> iCallable)
 	{
 	ZAcqMtx acq(fMtx);
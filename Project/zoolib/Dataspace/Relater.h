@@ -9,6 +9,7 @@
 #include "zoolib/ValueOnce.h"
 
 #include "zoolib/Dataspace/Types.h"
+#include "zoolib/QueryEngine/Estimate.h"
 
 #include <set>
 #include <vector>
@@ -84,6 +85,12 @@ public:
 
 	virtual void CollectResults(std::vector<QueryResult>& oChanged, int64& oChangeCount) = 0;
 
+	// How big a search for the rows of iConcreteHead satisfying iRestriction is likely to be,
+	// and what it'd cost. iRestriction may reference iBoundNames, whose values aren't known
+	// yet. Returns null if we've no idea, which is the default.
+	virtual ZQ<QueryEngine::Estimate> QEstimate(const ConcreteHead& iConcreteHead,
+		const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction);
+
 	typedef Callable<void(ZP<Relater>)> Callable_RelaterResultsAvailable;
 	void SetCallable_RelaterResultsAvailable(ZP<Callable_RelaterResultsAvailable> iCallable);
 
@@ -92,6 +92,10 @@ void Relater_Asyncify::CollectResults(vector<QueryResult>& oChanged, int64& oCha
 	oChangeCount = 0xDEADBEEF;
 	}
 
+ZQ<QueryEngine::Estimate> Relater_Asyncify::QEstimate(const ConcreteHead& iConcreteHead,
+	const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction)
+	{ return fRelater->QEstimate(iConcreteHead, iBoundNames, iRestriction); }
+
 void Relater_Asyncify::CrankIt()
 	{
 	this->pUpdate();
@@ -35,6 +35,9 @@ public:
 
 	virtual void CollectResults(std::vector<QueryResult>& oChanged, int64& oChangeCount);
 
+	virtual ZQ<QueryEngine::Estimate> QEstimate(const ConcreteHead& iConcreteHead,
+		const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction);
+
 // Our protocol
 	void CrankIt();
 	void Shutdown();
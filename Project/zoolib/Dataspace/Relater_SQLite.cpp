@@ -27,6 +27,15 @@ using namespace Util_STL;
 
 namespace RA = RelationalAlgebra;
 
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const size_t kRowsPerRead = 1024;
+
+} // anonymous namespace
+
 // =================================================================================================
 #pragma mark - Relater_SQLite::ClientQuery
 
@@ -60,6 +69,7 @@ public:
 	ZP<RA::Expr_Rel> fRel;
 	RelHead fRelHead;
 	string8 fSQL;
+	vector<Val_DB> fParams;
 	DListHead<DLink_ClientQuery_InPQuery> fClientQueries;
 	};
 
@@ -115,7 +125,8 @@ void Relater_SQLite::ModifyRegistrations(
 
 		if (iterPQueryPair.second)
 			{
-			RA::sWriteAsSQL(fMap_Tables, theRel, ChanW_UTF_string8(&thePQuery->fSQL));
+			RA::sWriteAsSQL(fMap_Tables, theRel, ChanW_UTF_string8(&thePQuery->fSQL),
+				&thePQuery->fParams);
 			thePQuery->fRelHead = sGetRelHead(theRel);
 			}
 
@@ -159,14 +170,10 @@ void Relater_SQLite::CollectResults(std::vector<QueryResult>& oChanged)
 	foreacha (entry, fMap_Rel_PQuery)
 		{
 		const PQuery* thePQuery = &entry.second;
-		vector<Val_ZZ> thePackedRows;
-		for (ZP<Iter> theIter = new Iter(fDB, thePQuery->fSQL);
-			theIter->HasValue(); theIter->Advance())
-			{
-			const size_t theCount = theIter->Count();
-			for (size_t xx = 0; xx < theCount; ++xx)
-				thePackedRows.push_back(theIter->Get(xx).As<Val_ZZ>());
-			}
+		vector<Val_DB> thePackedRows;
+		ZP<Iter> theIter = new Iter(fDB, thePQuery->fSQL, thePQuery->fParams);
+		while (theIter->ReadRows(thePackedRows, kRowsPerRead) == kRowsPerRead)
+			{}
 
 		ZP<QueryEngine::Result> theResult =
 			new QueryEngine::Result(thePQuery->fRelHead, &thePackedRows);
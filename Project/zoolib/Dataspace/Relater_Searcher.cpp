@@ -287,11 +287,49 @@ public:
 
 namespace { // anonymous
 
+// Whether iExpr is an equality between a name we generate and one bound to our left.
+bool spIsJoinEquality(const ZP<Expr_Bool>& iExpr,
+	const RelHead& iGenerated, const RelHead& iBound)
+	{
+	ZP<Expr_Bool_ValPred> asValPred = iExpr.DynamicCast<Expr_Bool_ValPred>();
+	if (not asValPred)
+		return false;
+
+	const ValPred& theValPred = asValPred->GetValPred();
+
+	ZP<ValComparator_Simple> asSimple =
+		theValPred.GetComparator().DynamicCast<ValComparator_Simple>();
+	if (not asSimple || asSimple->GetEComparator() != ValComparator_Simple::eEQ)
+		return false;
+
+	ZP<ValComparand_Name> asNameL = theValPred.GetLHS().DynamicCast<ValComparand_Name>();
+	ZP<ValComparand_Name> asNameR = theValPred.GetRHS().DynamicCast<ValComparand_Name>();
+	if (not asNameL || not asNameR)
+		return false;
+
+	const RelHead theBound = iBound - iGenerated;
+	return (sContains(iGenerated, asNameL->GetName()) && sContains(theBound, asNameR->GetName()))
+		|| (sContains(iGenerated, asNameR->GetName()) && sContains(theBound, asNameL->GetName()));
+	}
+
+// The ConcreteHead a search's rename and optional names describe.
+ConcreteHead spConcreteHead(const ZP<QE::Expr_Rel_Search>& iExpr)
+	{
+	ConcreteHead result;
+	foreacha (entry, iExpr->GetRename())
+		result[entry.first] = not sContains(iExpr->GetRelHead_Optional(), entry.first);
+	return result;
+	}
+
 class Transform_PushDownRestricts_IntoSearch
 :	public virtual RA::Transform_PushDownRestricts
 ,	public virtual QE::Visitor_Expr_Rel_Search
 	{
 public:
+	Transform_PushDownRestricts_IntoSearch(const ZP<QE::Callable_Estimate>& iCallable_Estimate)
+	:	fCallable_Estimate(iCallable_Estimate)
+		{}
+
 	virtual void Visit_Expr_Rel_Search(const ZP<QE::Expr_Rel_Search>& iExpr)
 		{
 		const RA::Rename theRename = iExpr->GetRename();
@@ -305,6 +343,8 @@ public:
 		const RelHead boundTo = iExpr->GetRelHead_Bound();
 		const RelHead boundFrom = RA::sRenamed(theRenameInverted, boundTo);
 
+		const ConcreteHead theConcreteHead = spConcreteHead(iExpr);
+
 		// Start with the extant search expression.
 		ZP<Expr_Bool> result = iExpr->GetExpr_Bool();
 
@@ -312,6 +352,81 @@ public:
 
 		RelHead newBound;
 
+		const RelHead boundOnly = boundTo - generatedTo;
+		bool isCorrelated = sNotEmpty(sGetNames(result) & boundOnly);
+
+		const ZQ<double> leftLikelySizeQ = this->pQLikelySize(boundOnly);
+
+		if (not isCorrelated && leftLikelySizeQ && fCallable_Estimate)
+			{
+			// Taking a restriction that uses the left's values means we're searched afresh
+			// for each left row, which is the better deal if there are few left rows and
+			// the restriction lets us use an index. Otherwise it's left on the product,
+			// where an equality makes a hash join.
+			ZP<Expr_Bool> withoutLeft = result;
+			ZP<Expr_Bool> withLeft = result;
+			bool anyUseLeft = false;
+			bool anyNotJoin = false;
+			foreacha (theRestrictPtr, fRestricts)
+				{
+				const RelHead exprNames = sGetNames(theRestrictPtr->fExpr_Bool);
+				if ((exprNames & available).size() != exprNames.size())
+					continue;
+
+				const ZP<Expr_Bool> theExpr =
+					Util_Expr_Bool::sRenamed(theRenameInverted, theRestrictPtr->fExpr_Bool);
+				withLeft &= theExpr;
+
+				if (sIsEmpty(exprNames & boundOnly))
+					{
+					withoutLeft &= theExpr;
+					}
+				else
+					{
+					anyUseLeft = true;
+					if (not spIsJoinEquality(theRestrictPtr->fExpr_Bool, generatedTo, boundTo))
+						anyNotJoin = true;
+					}
+				}
+
+			if (anyUseLeft)
+				{
+				const ZQ<QE::Estimate> withoutLeftQ =
+					sCall(fCallable_Estimate, theConcreteHead, boundTo, withoutLeft);
+
+				const ZQ<QE::Estimate> withLeftQ =
+					sCall(fCallable_Estimate, theConcreteHead, boundTo, withLeft);
+
+				if (withoutLeftQ && withLeftQ)
+					{
+					// Anything but an equality is checked against every pair of rows.
+					const double theLeftSize = *leftLikelySizeQ;
+					const double theCost_Product = withoutLeftQ->fCost + (anyNotJoin
+						? theLeftSize * withoutLeftQ->fCount
+						: theLeftSize + withoutLeftQ->fCount);
+
+					isCorrelated = theLeftSize * withLeftQ->fCost < theCost_Product;
+					}
+				}
+			}
+		else if (not isCorrelated)
+			{
+			// An equality between one of our names and one bound to our left is left on the
+			// product, where it makes a hash join, unless something else we'll take in uses
+			// the left's values. If it does we're searched afresh for each left row anyway,
+			// and may as well take the equality too.
+			foreacha (theRestrictPtr, fRestricts)
+				{
+				const RelHead exprNames = sGetNames(theRestrictPtr->fExpr_Bool);
+				if ((exprNames & available).size() == exprNames.size()
+					&& sNotEmpty(exprNames & boundOnly)
+					&& not spIsJoinEquality(theRestrictPtr->fExpr_Bool, generatedTo, boundTo))
+					{
+					isCorrelated = true;
+					}
+				}
+			}
+
 		// Go through each active restriction.
 		foreacha (theRestrictPtr, fRestricts)
 			{
@@ -326,7 +441,8 @@ public:
 			if (intersection.size())
 				{
 				++theRestrict.fCountTouching;
-				if (intersection.size() == exprNames.size())
+				if (intersection.size() == exprNames.size()
+					&& (isCorrelated || sIsEmpty(exprNames & boundOnly)))
 					{
 					++theRestrict.fCountSubsuming;
 					result &= Util_Expr_Bool::sRenamed(theRenameInverted, theRestrict.fExpr_Bool);
@@ -337,20 +453,60 @@ public:
 
 		fRelHead |= generatedTo;
 
+		const ZQ<QE::Estimate> theEstimateQ =
+			sCall(fCallable_Estimate, theConcreteHead, newBound | boundTo, result);
+
+		if (theEstimateQ)
+			{
+			// A search using the left's values produces its rows for each left row.
+			double theLikelySize = theEstimateQ->fCount;
+			if (leftLikelySizeQ && sNotEmpty(sGetNames(result) & boundOnly))
+				theLikelySize *= *leftLikelySizeQ;
+
+			foreacha (entry, generatedTo)
+				fLikelySizes[entry] = theLikelySize;
+			}
+
 		ZP<QE::Expr_Rel_Search> theSearch = new QE::Expr_Rel_Search(
 			newBound | boundTo,
 			iExpr->GetRename(),
 			iExpr->GetRelHead_Optional(),
-			result);
+			result,
+			theEstimateQ);
 
 		this->pSetResult(theSearch);
 		}
+
+private:
+	// The left has at least as many rows as the biggest search contributing to it.
+	ZQ<double> pQLikelySize(const RelHead& iNames)
+		{
+		ZQ<double> result;
+		foreacha (entry, iNames)
+			{
+			if (ZQ<double> theQ = sQGet(fLikelySizes, entry))
+				{
+				if (not result || *result < *theQ)
+					result = theQ;
+				}
+			}
+		return result;
+		}
+
+	const ZP<QE::Callable_Estimate> fCallable_Estimate;
+
+	// The likely size of the relation generating each name, for those we know about.
+	map<ColName,double> fLikelySizes;
 	};
 
 } // anonymous namespace
 
 ZP<Expr_Rel> sTransform_PushDownRestricts_IntoSearch(const ZP<Expr_Rel>& iRel)
-	{ return Transform_PushDownRestricts_IntoSearch().Do(iRel); }
+	{ return sTransform_PushDownRestricts_IntoSearch(iRel, null); }
+
+ZP<Expr_Rel> sTransform_PushDownRestricts_IntoSearch(const ZP<Expr_Rel>& iRel,
+	const ZP<QE::Callable_Estimate>& iCallable_Estimate)
+	{ return Transform_PushDownRestricts_IntoSearch(iCallable_Estimate).Do(iRel); }
 
 // =================================================================================================
 #pragma mark - Relater_Searcher
@@ -386,27 +542,39 @@ void Relater_Searcher::ModifyRegistrations(
 	const AddedQuery* iAdded, size_t iAddedCount,
 	const int64* iRemoved, size_t iRemovedCount)
 	{
-	ZAcqMtx acq(fMtx);
+	// Estimates come from fSearcher, so plan the queries before taking fMtx.
+	const ZP<QE::Callable_Estimate> theCallable_Estimate =
+		sCallable(sWP(this), &Relater_Searcher::QEstimate);
 
-	for (/*no init*/; iAddedCount--; ++iAdded)
+	vector<ZP<Expr_Rel>> theRels;
+	for (size_t xx = 0; xx < iAddedCount; ++xx)
 		{
-		ZP<Expr_Rel> theRel = iAdded->GetRel();
+		ZP<Expr_Rel> theRel = iAdded[xx].GetRel();
 
 		if (true)
 			{
 			// This branch is much faster. sTransform_Search doesn't do a great job of pulling
 			// restricts into itself.
-			theRel = QE::sTransform_Search(theRel);
+			theRel = QE::sTransform_Search(theRel, theCallable_Estimate);
 			theRel = RA::Transform_DecomposeRestricts().Do(theRel);
-			theRel = Transform_PushDownRestricts_IntoSearch().Do(theRel);
+			theRel = sTransform_PushDownRestricts_IntoSearch(theRel, theCallable_Estimate);
 			}
 		else
 			{
 			theRel = RA::Transform_DecomposeRestricts().Do(theRel);
 			theRel = RA::Transform_PushDownRestricts().Do(theRel);
-			theRel = QE::sTransform_Search(theRel);
+			theRel = QE::sTransform_Search(theRel, theCallable_Estimate);
 			}
 
+		sPushBack(theRels, theRel);
+		}
+
+	ZAcqMtx acq(fMtx);
+
+	for (size_t xx = 0; xx < iAddedCount; ++xx, ++iAdded)
+		{
+		const ZP<Expr_Rel>& theRel = theRels[xx];
+
 		const pair<Map_Rel_PQuery::iterator,bool> iterPQueryPair =
 			fMap_Rel_PQuery.insert(make_pair(theRel, PQuery(theRel)));
 
@@ -583,6 +751,10 @@ void Relater_Searcher::CollectResults(vector<QueryResult>& oChanged, int64& oCha
 		fSearcher->ModifyRegistrations(nullptr, 0, &toRemove[0], toRemove.size());
 	}
 
+ZQ<QE::Estimate> Relater_Searcher::QEstimate(const ConcreteHead& iConcreteHead,
+	const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction)
+	{ return fSearcher->QEstimate(SearchSpec(iConcreteHead, iRestriction), iBoundNames); }
+
 void Relater_Searcher::ForceUpdate()
 	{ Relater::pTrigger_RelaterResultsAvailable(); }
 
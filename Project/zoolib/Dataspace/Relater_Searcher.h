@@ -37,6 +37,9 @@ public:
 
 	virtual void CollectResults(std::vector<QueryResult>& oChanged, int64& oChangeCount);
 
+	virtual ZQ<QueryEngine::Estimate> QEstimate(const ConcreteHead& iConcreteHead,
+		const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction);
+
 // Our protocol
 	void ForceUpdate();
 
@@ -119,6 +122,12 @@ protected:
 
 ZP<Expr_Rel> sTransform_PushDownRestricts_IntoSearch(const ZP<Expr_Rel>& iRel);
 
+// With iCallable_Estimate, an equality joining a search to its left is taken into the search
+// when a search per left row is likely cheaper than a hash join, and each search is given
+// its estimate.
+ZP<Expr_Rel> sTransform_PushDownRestricts_IntoSearch(const ZP<Expr_Rel>& iRel,
+	const ZP<QueryEngine::Callable_Estimate>& iCallable_Estimate);
+
 } // namespace Dataspace
 } // namespace ZooLib
 
@@ -2,8 +2,10 @@
 
 #include "zoolib/Dataspace/Relater_Union.h"
 
+#include "zoolib/Callable_Lambda.h"
 #include "zoolib/Callable_PMF.h"
 #include "zoolib/Chan_UTF_string.h"
+#include "zoolib/ForEach_Parallel.h"
 #include "zoolib/Log.h"
 #include "zoolib/Stringf.h"
 #include "zoolib/Util_Chan_UTF_Operators.h"
@@ -20,16 +22,21 @@
 #include "zoolib/QueryEngine/Visitor_DoMakeWalker.h"
 
 #include "zoolib/RelationalAlgebra/Expr_Rel_Concrete.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Difference.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Embed.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Intersect.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Project.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Rename.h"
 #include "zoolib/RelationalAlgebra/Util_Strim_Rel.h"
 #include "zoolib/RelationalAlgebra/Util_Strim_RelHead.h"
 
 #include "zoolib/ValPred/Expr_Bool_ValPred.h"
+#include "zoolib/ValPred/Util_Expr_Bool_ValPred_Rename.h"
 #include "zoolib/ValPred/ValPred_GetNames.h"
 #include "zoolib/ValPred/Visitor_Expr_Bool_ValPred_Do_GetNames.h"
 
+#include <exception>
+
 namespace ZooLib {
 namespace Dataspace {
 
@@ -317,6 +324,14 @@ public:
 	virtual void Visit_Proxy(const ZP<Proxy>& iExpr)
 		{ this->pSetResult(fRelater->pMakeWalker(iExpr)); }
 
+	virtual ZQ<RA::RelHead> QGetRelHead_Opaque(const ZP<RA::Expr_Rel>& iRel)
+		{
+		// A proxy's walker reads the proxy's result, and takes nothing from its surroundings.
+		if (ZP<Proxy> theProxy = iRel.DynamicCast<Proxy>())
+			return theProxy->fResultRelHead;
+		return null;
+		}
+
 private:
 	ZP<Relater_Union> const fRelater;
 	};
@@ -330,6 +345,8 @@ class Relater_Union::Analyze
 ,	public virtual RA::Visitor_Expr_Rel_Embed
 ,	public virtual RA::Visitor_Expr_Rel_Concrete
 ,	public virtual RA::Visitor_Expr_Rel_Const
+,	public virtual RA::Visitor_Expr_Rel_Difference
+,	public virtual RA::Visitor_Expr_Rel_Intersect
 ,	public virtual RA::Visitor_Expr_Rel_Product
 ,	public virtual RA::Visitor_Expr_Rel_Project
 ,	public virtual RA::Visitor_Expr_Rel_Rename
@@ -343,7 +360,9 @@ public:
 	virtual void Visit_Expr_Rel_Calc(const ZP<RA::Expr_Rel_Calc>& iExpr);
 	virtual void Visit_Expr_Rel_Const(const ZP<RA::Expr_Rel_Const>& iExpr);
 	virtual void Visit_Expr_Rel_Concrete(const ZP<RA::Expr_Rel_Concrete>& iExpr);
+	virtual void Visit_Expr_Rel_Difference(const ZP<RA::Expr_Rel_Difference>& iExpr);
 	virtual void Visit_Expr_Rel_Embed(const ZP<RA::Expr_Rel_Embed>& iExpr);
+	virtual void Visit_Expr_Rel_Intersect(const ZP<RA::Expr_Rel_Intersect>& iExpr);
 	virtual void Visit_Expr_Rel_Product(const ZP<RA::Expr_Rel_Product>& iExpr);
 	virtual void Visit_Expr_Rel_Project(const ZP<RA::Expr_Rel_Project>& iExpr);
 	virtual void Visit_Expr_Rel_Rename(const ZP<RA::Expr_Rel_Rename>& iExpr);
@@ -354,6 +373,9 @@ public:
 	ZP<RA::Expr_Rel> TopLevelDo(ZP<RA::Expr_Rel> iRel);
 
 private:
+	void pVisit_Matching(const ZP<Expr_Op2_T<RA::Expr_Rel>>& iExpr,
+		bool iKeepLeftAlone, bool iKeepRightAlone);
+
 	Relater_Union* fRelater_Union;
 	PQuery* fPQuery;
 	set<PRelater*> fPRelaters;
@@ -397,6 +419,13 @@ void Relater_Union::Analyze::Visit_Expr_Rel_Const(const ZP<RA::Expr_Rel_Const>&
 	fResultRelHead |= iExpr->GetColName();
 	}
 
+void Relater_Union::Analyze::Visit_Expr_Rel_Difference(
+	const ZP<RA::Expr_Rel_Difference>& iExpr)
+	{
+	// Taking nothing from the left leaves it, and taking anything from nothing leaves nothing.
+	this->pVisit_Matching(iExpr, true, false);
+	}
+
 void Relater_Union::Analyze::Visit_Expr_Rel_Embed(const ZP<RA::Expr_Rel_Embed>& iExpr)
 	{
 	// Visit parent
@@ -467,6 +496,12 @@ void Relater_Union::Analyze::Visit_Expr_Rel_Embed(const ZP<RA::Expr_Rel_Embed>&
 		}
 	}
 
+void Relater_Union::Analyze::Visit_Expr_Rel_Intersect(const ZP<RA::Expr_Rel_Intersect>& iExpr)
+	{
+	// Anything in common with an empty branch is empty.
+	this->pVisit_Matching(iExpr, false, false);
+	}
+
 void Relater_Union::Analyze::Visit_Expr_Rel_Product(const ZP<RA::Expr_Rel_Product>& iExpr)
 	{
 	// Visit left branch
@@ -587,6 +622,21 @@ void Relater_Union::Analyze::Visit_Expr_Rel_Restrict(const ZP<RA::Expr_Rel_Restr
 	}
 
 void Relater_Union::Analyze::Visit_Expr_Rel_Union(const ZP<RA::Expr_Rel_Union>& iExpr)
+	{ this->pVisit_Matching(iExpr, true, true); }
+
+ZP<RA::Expr_Rel> Relater_Union::Analyze::TopLevelDo(ZP<RA::Expr_Rel> iRel)
+	{
+	ZP<RA::Expr_Rel> result = this->Do(iRel);
+	if (fPRelaters.size() <= 1)
+		return fRelater_Union->pGetProxy(fPQuery, fPRelaters, fResultRelHead, result);
+	return result;
+	}
+
+// Union, difference and intersect, whose branches must have the same relhead. An empty branch
+// is one for which there's no relater, and iKeepLeftAlone and iKeepRightAlone say whether the
+// other branch is then our result. If not, we're empty too.
+void Relater_Union::Analyze::pVisit_Matching(const ZP<Expr_Op2_T<RA::Expr_Rel>>& iExpr,
+	bool iKeepLeftAlone, bool iKeepRightAlone)
 	{
 	// Visit left branch
 	const ZP<RA::Expr_Rel> newOp0 = this->Do(iExpr->GetOp0());
@@ -627,9 +677,15 @@ void Relater_Union::Analyze::Visit_Expr_Rel_Union(const ZP<RA::Expr_Rel_Union>&
 	fResultRelHead = leftRelHead;
 
 	if (not newOp0)
-		{ this->pSetResult(newOp1); }
+		{
+		if (iKeepRightAlone)
+			this->pSetResult(newOp1);
+		}
 	else if (not newOp1)
-		{ this->pSetResult(newOp0); }
+		{
+		if (iKeepLeftAlone)
+			this->pSetResult(newOp0);
+		}
 	else if (leftPRelaters.size() <= 1)
 		{
 		// Our left branch is simple, it references zero or one Relater.
@@ -675,14 +731,6 @@ void Relater_Union::Analyze::Visit_Expr_Rel_Union(const ZP<RA::Expr_Rel_Union>&
 		}
 	}
 
-ZP<RA::Expr_Rel> Relater_Union::Analyze::TopLevelDo(ZP<RA::Expr_Rel> iRel)
-	{
-	ZP<RA::Expr_Rel> result = this->Do(iRel);
-	if (fPRelaters.size() <= 1)
-		return fRelater_Union->pGetProxy(fPQuery, fPRelaters, fResultRelHead, result);
-	return result;
-	}
-
 // =================================================================================================
 #pragma mark - Relater_Union::PRelater
 
@@ -704,6 +752,9 @@ public:
 	bool Intersects(const RelHead& iRelHead);
 	ZP<RA::Expr_Rel> UsableRel(ZP<RA::Expr_Rel> iRel);
 
+	ZQ<QueryEngine::Estimate> QEstimate(const ConcreteHead& iConcreteHead,
+		const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction);
+
 	ZP<Relater> fRelater;
 	int64 fNextRefcon;
 
@@ -738,6 +789,26 @@ ZP<RA::Expr_Rel> Relater_Union::PRelater::UsableRel(ZP<RA::Expr_Rel> iRel)
 	return InsertPrefix(fPrefix).Do(iRel);
 	}
 
+ZQ<QueryEngine::Estimate> Relater_Union::PRelater::QEstimate(const ConcreteHead& iConcreteHead,
+	const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction)
+	{
+	if (fPrefix.empty())
+		return fRelater->QEstimate(iConcreteHead, iBoundNames, iRestriction);
+
+	// Our relater knows the concrete's names without the prefix.
+	ConcreteHead theConcreteHead;
+	RA::Rename theRename;
+	foreacha (entry, iConcreteHead)
+		{
+		const ColName theColName = RA::sPrefixErased(fPrefix, entry.first);
+		theConcreteHead[theColName] = entry.second;
+		theRename[entry.first] = theColName;
+		}
+
+	return fRelater->QEstimate(theConcreteHead, iBoundNames,
+		Util_Expr_Bool::sRenamed(theRename, iRestriction));
+	}
+
 // =================================================================================================
 #pragma mark - Relater_Union
 
@@ -847,6 +918,36 @@ void Relater_Union::ModifyRegistrations(
 	Relater::pTrigger_RelaterResultsAvailable();
 	}
 
+ZQ<QueryEngine::Estimate> Relater_Union::QEstimate(const ConcreteHead& iConcreteHead,
+	const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction)
+	{
+	ZAcqMtx acq(fMtx);
+
+	// Each of the relaters that can service the concrete contributes its rows to the union.
+	ZQ<QueryEngine::Estimate> result;
+	foreacha (thePRelater, this->pIdentifyPRelaters(RA::sRelHead(iConcreteHead)))
+		{
+		const ZQ<QueryEngine::Estimate> theQ =
+			thePRelater->QEstimate(iConcreteHead, iBoundNames, iRestriction);
+
+		// If any has no idea, then neither do we.
+		if (not theQ)
+			return null;
+
+		if (not result)
+			{
+			result = theQ;
+			}
+		else
+			{
+			result->fCount += theQ->fCount;
+			result->fCost += theQ->fCost;
+			result->fPlan += " + " + theQ->fPlan;
+			}
+		}
+	return result;
+	}
+
 void Relater_Union::CollectResults(vector<QueryResult>& oChanged, int64& oChangeCount)
 	{
 	Relater::pCalled_RelaterCollectResults();
@@ -894,34 +995,84 @@ void Relater_Union::CollectResults(vector<QueryResult>& oChanged, int64& oChange
 
 	// -----------------
 
+	// The PRelaters are independent of one another, so we collect from them concurrently.
 	while (sNotEmpty(fPRelater_CollectFrom))
 		{
-		PRelater* thePRelater = sGetEraseFront<PRelater>(fPRelater_CollectFrom);
-		ZP<Relater> theRelater = thePRelater->fRelater;
-		vector<QueryResult> theQueryResults;
+		struct Collect
+			{
+			PRelater* fPRelater;
+			ZP<Relater> fRelater;
+			vector<QueryResult> fQueryResults;
+			std::exception_ptr fException;
+			};
+
+		vector<Collect> theCollects;
+		while (sNotEmpty(fPRelater_CollectFrom))
+			{
+			PRelater* thePRelater = sGetEraseFront<PRelater>(fPRelater_CollectFrom);
+			theCollects.push_back(Collect());
+			theCollects.back().fPRelater = thePRelater;
+			theCollects.back().fRelater = thePRelater->fRelater;
+			}
+
 		{
 		ZRelMtx rel(fMtx);
-		int64 theCC;
-		theRelater->CollectResults(theQueryResults, theCC);
+		if (sNotEmpty(theCollects))
+			{
+			sForEach_Parallel(theCollects.size(), [&theCollects](size_t iIndex)
+				{
+				Collect& theCollect = theCollects[iIndex];
+				try
+					{
+					int64 theCC;
+					theCollect.fRelater->CollectResults(theCollect.fQueryResults, theCC);
+					}
+				catch (...)
+					{
+					theCollect.fException = std::current_exception();
+					}
+				});
+			}
 		}
 
-		// It's feasible that thePRelater got whacked while we were unlocked. Not sure what to do about it.
-		foreacha (entry, theQueryResults)
+		// It's feasible that a PRelater got whacked while we were unlocked. Not sure what to do about it.
+		std::exception_ptr theException;
+		foreacha (entryCollect, theCollects)
 			{
-			const int64 theRefcon = entry.GetRefcon();
-			if (PIP* thePIP = sPMut(thePRelater->fMap_Refcon_PIP, theRefcon))
+			if (entryCollect.fException && not theException)
+				theException = entryCollect.fException;
+
+			foreacha (entry, entryCollect.fQueryResults)
 				{
-				thePIP->fResult = entry.GetResult();
-				foreacha (entryPQuery, thePIP->fProxy->fDependentPQueries)
-					sQInsertBack(fPQuery_NeedsWork, entryPQuery);
+				const int64 theRefcon = entry.GetRefcon();
+				if (PIP* thePIP = sPMut(entryCollect.fPRelater->fMap_Refcon_PIP, theRefcon))
+					{
+					thePIP->fResult = entry.GetResult();
+					foreacha (entryPQuery, thePIP->fProxy->fDependentPQueries)
+						sQInsertBack(fPQuery_NeedsWork, entryPQuery);
+					}
 				}
 			}
+
+		if (theException)
+			std::rethrow_exception(theException);
 		}
 
 	// -----------------
 
+	// Walk every PQuery whose proxies all have results. The walks read only the PIPs' results,
+	// which nothing changes while we hold fMtx, so they can proceed concurrently.
 	if (sNotEmpty(fPQuery_NeedsWork))
 		{
+		struct Walk
+			{
+			PQuery* fPQuery;
+			ZP<QueryEngine::Walker> fWalker;
+			ZP<QueryEngine::Result> fResult;
+			std::exception_ptr fException;
+			};
+
+		vector<Walk> theWalks;
 		for (DListEraser<PQuery, DLink_PQuery_NeedsWork>
 			eraserPQuery = fPQuery_NeedsWork; eraserPQuery; eraserPQuery.Advance())
 			{
@@ -942,20 +1093,50 @@ void Relater_Union::CollectResults(vector<QueryResult>& oChanged, int64& oChange
 
 			if (allOK)
 				{
-				fWalkerCount = 0;
-				fReadCount = 0;
-				fStepCount = 0;
-
-				ZP<QueryEngine::Walker> theWalker =
+				theWalks.push_back(Walk());
+				theWalks.back().fPQuery = thePQuery;
+				theWalks.back().fWalker =
 					Relater_Union::Visitor_DoMakeWalker(this).Do(thePQuery->fRel_Analyzed);
+				}
+			}
 
-				thePQuery->fResult = QueryEngine::sResultFromWalker(theWalker);
+		if (sNotEmpty(theWalks))
+			{
+			sForEach_Parallel(theWalks.size(), [&theWalks](size_t iIndex)
+				{
+				Walk& theWalk = theWalks[iIndex];
+				try
+					{
+					theWalk.fResult = QueryEngine::sResultFromWalker(theWalk.fWalker);
+					}
+				catch (...)
+					{
+					theWalk.fException = std::current_exception();
+					}
+				theWalk.fWalker.Clear();
+				});
+			}
 
-				for (DListIterator<ClientQuery, DLink_ClientQuery_InPQuery>
-					iterCS = thePQuery->fClientQueries; iterCS; iterCS.Advance())
-					{ sQInsertBack(fClientQuery_NeedsWork, iterCS.Current()); }
+		std::exception_ptr theException;
+		foreacha (entry, theWalks)
+			{
+			if (entry.fException)
+				{
+				if (not theException)
+					theException = entry.fException;
+				continue;
 				}
+
+			PQuery* thePQuery = entry.fPQuery;
+			thePQuery->fResult = entry.fResult;
+
+			for (DListIterator<ClientQuery, DLink_ClientQuery_InPQuery>
+				iterCS = thePQuery->fClientQueries; iterCS; iterCS.Advance())
+				{ sQInsertBack(fClientQuery_NeedsWork, iterCS.Current()); }
 			}
+
+		if (theException)
+			std::rethrow_exception(theException);
 		}
 
 	for (DListEraser<ClientQuery, DLink_ClientQuery_NeedsWork>
@@ -1076,7 +1257,6 @@ void Relater_Union::pFinalizeProxy(Proxy* iProxy)
 
 ZP<Relater_Union::Walker_Proxy> Relater_Union::pMakeWalker(ZP<Proxy> iProxy)
 	{
-	++fWalkerCount;
 	return new Walker_Proxy(this, iProxy);
 	}
 
@@ -1098,10 +1278,8 @@ void Relater_Union::pPrime(ZP<Walker_Proxy> iWalker,
 
 bool Relater_Union::pReadInc(ZP<Walker_Proxy> iWalker, Val_DB* ioResults)
 	{
-	++fReadCount;
 	for (;;)
 		{
-		++fStepCount;
 		if (not iWalker->fCurrentResult)
 			{
 			if (not iWalker->fIter_PIP)
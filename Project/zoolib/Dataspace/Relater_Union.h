@@ -36,6 +36,9 @@ public:
 
 	virtual void CollectResults(std::vector<QueryResult>& oChanged, int64& oChangeCount);
 
+	virtual ZQ<QueryEngine::Estimate> QEstimate(const ConcreteHead& iConcreteHead,
+		const RelHead& iBoundNames, const ZP<Expr_Bool>& iRestriction);
+
 // Our protocol
 	void InsertRelater(ZP<Relater> iRelater, const string8& iPrefix);
 	void EraseRelater(ZP<Relater> iRelater);
@@ -83,10 +86,6 @@ private:
 
 	bool pReadInc(ZP<Walker_Proxy> iWalker, Val_DB* ioResults);
 
-	size_t fWalkerCount;
-	size_t fReadCount;
-	size_t fStepCount;
-
 	// -----
 
 	class DLink_ClientQuery_NeedsWork;
@@ -103,6 +103,7 @@ SearchResult::SearchResult()
 SearchResult::SearchResult(const SearchResult& iOther)
 :	fRefcon(iOther.fRefcon)
 ,	fResult(iOther.fResult)
+,	fResultDeltas(iOther.fResultDeltas)
 	{}
 
 SearchResult::~SearchResult()
@@ -112,6 +113,7 @@ SearchResult& SearchResult::operator=(const SearchResult& iOther)
 	{
 	fRefcon = iOther.fRefcon;
 	fResult = iOther.fResult;
+	fResultDeltas = iOther.fResultDeltas;
 	return *this;
 	}
 
@@ -120,12 +122,22 @@ SearchResult::SearchResult(int64 iRefcon, const ZP<QueryEngine::Result>& iResult
 ,	fResult(iResult)
 	{}
 
+SearchResult::SearchResult(int64 iRefcon, const ZP<QueryEngine::Result>& iResult,
+	const ZP<QueryEngine::ResultDeltas>& iResultDeltas)
+:	fRefcon(iRefcon)
+,	fResult(iResult)
+,	fResultDeltas(iResultDeltas)
+	{}
+
 int64 SearchResult::GetRefcon() const
 	{ return fRefcon; }
 
 ZP<QueryEngine::Result> SearchResult::GetResult() const
 	{ return fResult; }
 
+ZP<QueryEngine::ResultDeltas> SearchResult::GetResultDeltas() const
+	{ return fResultDeltas; }
+
 // =================================================================================================
 #pragma mark - Searcher
 
@@ -135,6 +147,10 @@ Searcher::Searcher()
 Searcher::~Searcher()
 	{}
 
+ZQ<QueryEngine::Estimate> Searcher::QEstimate(
+	const SearchSpec& iSearchSpec, const RelHead& iBoundNames)
+	{ return null; }
+
 void Searcher::SetCallable_SearcherResultsAvailable(
 	ZP<Callable_SearcherResultsAvailable> iCallable)
 	{
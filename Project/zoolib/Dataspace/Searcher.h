@@ -12,6 +12,7 @@
 #include "zoolib/Expr/Expr_Bool.h"
 
 #include "zoolib/Dataspace/Types.h"
+#include "zoolib/QueryEngine/Estimate.h"
 #include "zoolib/QueryEngine/Result.h"
 
 namespace ZooLib {
@@ -76,12 +77,18 @@ public:
 
 	SearchResult(int64 iRefcon, const ZP<QueryEngine::Result>& iResult);
 
+	// iResultDeltas, if not null, turns the result previously delivered for iRefcon into iResult.
+	SearchResult(int64 iRefcon, const ZP<QueryEngine::Result>& iResult,
+		const ZP<QueryEngine::ResultDeltas>& iResultDeltas);
+
 	int64 GetRefcon() const;
 	ZP<QueryEngine::Result> GetResult() const;
+	ZP<QueryEngine::ResultDeltas> GetResultDeltas() const;
 
 private:
 	int64 fRefcon;
 	ZP<QueryEngine::Result> fResult;
+	ZP<QueryEngine::ResultDeltas> fResultDeltas;
 	};
 
 // =================================================================================================
@@ -102,6 +109,12 @@ public:
 
 	virtual void CollectResults(std::vector<SearchResult>& oChanged, int64& oChangeCount) = 0;
 
+	// How big iSearchSpec's result is likely to be, and what it'd cost to produce. Its
+	// restriction may reference iBoundNames, whose values aren't known yet. Returns null if
+	// we've no idea, which is the default.
+	virtual ZQ<QueryEngine::Estimate> QEstimate(
+		const SearchSpec& iSearchSpec, const RelHead& iBoundNames);
+
 	typedef Callable<void(ZP<Searcher>)> Callable_SearcherResultsAvailable;
 	void SetCallable_SearcherResultsAvailable(ZP<Callable_SearcherResultsAvailable> iCallable);
 
@@ -2,24 +2,31 @@
 
 #include "zoolib/Dataspace/Searcher_Datons.h"
 
+#include "zoolib/Callable_Lambda.h"
 #include "zoolib/Callable_PMF.h"
+#include "zoolib/CountedWithoutFinalize.h"
+#include "zoolib/ForEach_Parallel.h"
 #include "zoolib/Log.h"
+#include "zoolib/Starter_EachOnNewThread.h"
 #include "zoolib/Stringf.h"
 #include "zoolib/Util_STL.h"
 #include "zoolib/Util_STL_map.h"
+#include "zoolib/Util_STL_set.h"
+#include "zoolib/Util_STL_unordered_set.h"
 #include "zoolib/Util_STL_vector.h"
 #include "zoolib/Util_ZZ_JSON.h"
+#include "zoolib/ZThread.h"
 
 #include "zoolib/ZMACRO_foreach.h"
 
 #include "zoolib/Dataspace/Daton_Val.h"
 
 #include "zoolib/Expr/Util_Expr_Bool_CNF.h"
+#include "zoolib/Expr/Visitor_Expr_Op_Do_Transform_T.h"
 
 #include "zoolib/QueryEngine/ResultFromWalker.h"
 #include "zoolib/QueryEngine/Util_Strim_Result.h"
 #include "zoolib/QueryEngine/Util_Strim_Walker.h"
-#include "zoolib/QueryEngine/Walker_Project.h"
 #include "zoolib/QueryEngine/Walker_Result.h"
 #include "zoolib/QueryEngine/Walker_Restrict.h"
 
@@ -27,11 +34,33 @@
 #include "zoolib/RelationalAlgebra/Util_Strim_Rel.h"
 #include "zoolib/RelationalAlgebra/Util_Strim_RelHead.h"
 
+#include "zoolib/ValPred/Expr_Bool_ValPred.h"
 #include "zoolib/ValPred/ValPred_DB.h"
 #include "zoolib/ValPred/Visitor_Expr_Bool_ValPred_DB_ToStrim.h"
 #include "zoolib/ValPred/Visitor_Expr_Bool_ValPred_Do_GetNames.h"
 
+#include <algorithm> // For std::sort
+#include <cmath> // For std::log2, std::pow
+#include <exception>
+#include <functional> // For std::greater
+
 namespace ZooLib {
+
+// =================================================================================================
+#pragma mark - Unbound_t (anonymous)
+
+namespace { // anonymous
+
+// Stands in for the value of a name that'll be bound when a search is made, for estimates made
+// before then. No daton can hold one.
+struct Unbound_t {};
+
+} // anonymous namespace
+
+template <>
+inline int sCompare_T(const Unbound_t&, const Unbound_t&)
+	{ return 0; }
+
 namespace Dataspace {
 
 using namespace Operators_ZZ_JSON;
@@ -53,14 +82,52 @@ const ChanW_UTF& operator<<(const ChanW_UTF& ww, const Val_DB& iVal)
 	return ww;
 	}
 
+// =================================================================================================
+#pragma mark - IndexSpec
+
+IndexSpec::IndexSpec()
+:	fHashed(false)
+	{}
+
+IndexSpec::IndexSpec(const vector<ColName>& iColNames)
+:	fColNames(iColNames)
+,	fHashed(false)
+	{}
+
+IndexSpec::IndexSpec(std::initializer_list<ColName> iColNames)
+:	fColNames(iColNames)
+,	fHashed(false)
+	{}
+
+IndexSpec::IndexSpec(const vector<ColName>& iColNames, bool iHashed)
+:	fColNames(iColNames)
+,	fHashed(iHashed)
+	{}
+
+const vector<ColName>& IndexSpec::GetColNames() const
+	{ return fColNames; }
+
+bool IndexSpec::IsHashed() const
+	{ return fHashed; }
+
 // =================================================================================================
 #pragma mark - Index
 
+typedef ZQ<pair<Val_DB,bool>> Bound_t; // Value, inclusive
+
+namespace { // anonymous
+template <class PP>
+PP* spAllOnesPointer()
+	{ return reinterpret_cast<PP*>((char*)(0)-1); }
+} // anonymous namespace
+
 struct Searcher_Datons::Key
 	{
-	static const size_t kMaxCols = 4;
 	const Searcher_Datons::Map_Thing::value_type* fMapEntryP;
-	const Val_DB* fValues[kMaxCols];
+
+	// A key with fewer values than its index has columns is equivalent to every key having
+	// those values as a prefix, which is how we find the range of keys matching a search.
+	vector<const Val_DB*> fValues;
 	};
 
 class Searcher_Datons::Index
@@ -68,123 +135,479 @@ class Searcher_Datons::Index
 public:
 	typedef Searcher_Datons::Key Key;
 
+	class Set;
+
+	// Hashed on every column's value. Collisions are resolved by the caller comparing values.
+	typedef unordered_multimap<size_t,const Map_Thing::value_type*> HashSet;
+
+	static const Val_DB* const spEmptyValPtr;
+
 	// -----
 
-	struct Comparer
+	Index(const IndexSpec& iIndexSpec, size_t iOrdinal)
+	:	fColNames(iIndexSpec.GetColNames())
+	,	fCount(fColNames.size())
+	,	fHashed(iIndexSpec.IsHashed())
+	,	fOrdinal(iOrdinal)
 		{
-		Comparer(size_t iCount)
-		:	fCount(iCount)
-			{}
+		ZAssert(fCount);
+		}
+
+	bool pAsKey(const Map_Thing::value_type* iMapEntryP, Key& oKey) const
+		{
+		const Val_JSONB& asMap = iMapEntryP->second;
+		if (not asMap.IsMap())
+			{
+			// iValPtr is not a map, can't index.
+			return false;
+			}
+
+		const Val_DB* firstVal = asMap.PGet(fColNames[0]);
+		if (not firstVal)
+			{
+			// The map does not have our first property, which we treat as a null. So it's
+			// unlikely that anything will search for that with that as the first criteria
+			// and we need not index it.
+			return false;
+			}
 
-		bool spDoIt(const Key& iLeft, const Key& iRight) const
+		oKey.fValues.resize(fCount);
+		oKey.fValues[0] = firstVal;
+		for (size_t xx = 1; xx < fCount; ++xx)
 			{
-			// When called by lower_bound iLeft is a key in the set, and iRight
-			// is a key that's being looked for. So when iLeft has more entries
-			// than iRight then iLeft is considered bigger than iRight.
+			if (const Val_DB* theVal = asMap.PGet(fColNames[xx]))
+				oKey.fValues[xx] = theVal;
+			else
+				oKey.fValues[xx] = spEmptyValPtr;
+			}
+
+		oKey.fMapEntryP = iMapEntryP;
+
+		return true;
+		}
+
+	const vector<ColName> fColNames;
+	const size_t fCount;
+	const bool fHashed;
+
+	// Our Set is Store::fSets[fOrdinal], or our HashSet is Store::fHashSets[fOrdinal].
+	const size_t fOrdinal;
+
+	DListHead<DLink_PSearch_InIndex> fPSearch_InIndex;
+
+	// For estimates. fDistinct[xx] is how many distinct values our first xx + 1 columns take
+	// between them, or zero if we don't know, as of when we had fStatsSizeQ keys.
+	ZQ<size_t> fStatsSizeQ;
+	vector<double> fDistinct;
+	};
+
+const Val_DB* const Searcher_Datons::Index::spEmptyValPtr = &sDefault<Val_DB>();
+
+// =================================================================================================
+#pragma mark - Searcher_Datons::Index::Set
+
+// The keys of an ordered index. It's a B+tree of fixed height two -- keys are held in order
+// in leaves of up to kLeafCapacity, and the leaves are held in order in fLeaves. Each leaf
+// is a pair of flat arrays, the entry pointers and fCount value pointers per key, so a
+// lookup touches a handful of contiguous blocks rather than a node per key as std::set does,
+// and copying a Set for Store's copy-on-write is a series of memcpys.
+
+class Searcher_Datons::Index::Set
+	{
+	static const size_t kLeafCapacity = 256;
+
+	struct Leaf
+		{
+		vector<const Map_Thing::value_type*> fMapEntryPs;
+		vector<const Val_DB*> fValues;
+		};
+
+public:
+	class const_iterator
+		{
+	public:
+		const_iterator()
+		:	fSet(nullptr)
+		,	fLeaf(0)
+		,	fOffset(0)
+			{}
+
+		const_iterator(const Set* iSet, size_t iLeaf, size_t iOffset)
+		:	fSet(iSet)
+		,	fLeaf(iLeaf)
+		,	fOffset(iOffset)
+			{}
 
-			// When called by upper_bound iLeft is a key that's being looked for
-			// and iRight is a key in the set. So when iLeft has fewer entries
-			// than iRight then iLeft is is considered bigger than iRight.
+		const Map_Thing::value_type* GetMapEntryP() const
+			{ return fSet->fLeaves[fLeaf].fMapEntryPs[fOffset]; }
 
-			// The upshot being that when one or other vector of values is
-			// exhausted we return false, indicating that iLeft is not smaller
-			// than iRight.
+		const Val_DB* const* GetValues() const
+			{ return &fSet->fLeaves[fLeaf].fValues[fOffset * fSet->fCount]; }
 
-			for (size_t xx = 0; xx < fCount; ++xx)
+		const_iterator& operator++()
+			{
+			if (++fOffset == fSet->fLeaves[fLeaf].fMapEntryPs.size())
 				{
-				const Val_DB* valL = iLeft.fValues[xx];
-				if (not valL)
-					return false;
-				const Val_DB* valR = iRight.fValues[xx];
-				if (not valR)
-					return false;
-
-				if (const int compare = valL->Compare(*valR))
-					return compare < 0;
+				++fLeaf;
+				fOffset = 0;
 				}
-			// Tie-break on the *pointer*, just so keys are distinct.
-			return iLeft.fMapEntryP < iRight.fMapEntryP;
+			return *this;
 			}
 
-		static void spDump(bool result, const Key& iLeft, const Key& iRight);
+		bool operator==(const const_iterator& iOther) const
+			{ return fLeaf == iOther.fLeaf && fOffset == iOther.fOffset; }
 
-		bool operator()(const Key& iLeft, const Key& iRight) const
+		bool operator!=(const const_iterator& iOther) const
+			{ return not (*this == iOther); }
+
+		bool operator<(const const_iterator& iOther) const
 			{
-			bool result = spDoIt(iLeft, iRight);
-			return result;
+			return fLeaf < iOther.fLeaf || (fLeaf == iOther.fLeaf && fOffset < iOther.fOffset);
 			}
 
-		const size_t fCount;
+	private:
+		friend class Set;
+
+		const Set* fSet;
+		size_t fLeaf;
+		size_t fOffset;
 		};
 
 	// -----
 
-	typedef std::set<Key,Comparer> Set;
+	Set(size_t iCount)
+	:	fCount(iCount)
+	,	fSize(0)
+		{}
 
-	static const Val_DB* const spEmptyValPtr;
+	size_t size() const
+		{ return fSize; }
 
-	// -----
+	const_iterator begin() const
+		{ return const_iterator(this, 0, 0); }
+
+	const_iterator end() const
+		{ return const_iterator(this, fLeaves.size(), 0); }
 
-	Index(const IndexSpec& iIndexSpec)
-	:	fCount(iIndexSpec.size())
-	,	fSet(Comparer(fCount))
+	// The first key not less than iKey.
+	const_iterator lower_bound(const Key& iKey) const
+		{ return this->pBound(iKey, false); }
+
+	// The first key greater than iKey.
+	const_iterator upper_bound(const Key& iKey) const
+		{ return this->pBound(iKey, true); }
+
+	// How many keys there are from iBegin up to iEnd, without visiting each of them.
+	size_t Distance(const const_iterator& iBegin, const const_iterator& iEnd) const
 		{
-		ZAssert(fCount <= Key::kMaxCols);
-		std::copy_n(iIndexSpec.begin(), fCount, fColNames);
+		if (not (iBegin < iEnd))
+			return 0;
+
+		if (iBegin.fLeaf == iEnd.fLeaf)
+			return iEnd.fOffset - iBegin.fOffset;
+
+		size_t result = fLeaves[iBegin.fLeaf].fMapEntryPs.size() - iBegin.fOffset;
+		for (size_t xx = iBegin.fLeaf + 1; xx < iEnd.fLeaf; ++xx)
+			result += fLeaves[xx].fMapEntryPs.size();
+		return result + iEnd.fOffset;
 		}
 
-	bool pAsKey(const Map_Thing::value_type* iMapEntryP, Key& oKey)
+	// The keys having iValsEqual as a prefix, and within iLo and iHi on the column after.
+	void Range(const vector<Val_DB>& iValsEqual, const Bound_t& iLo, const Bound_t& iHi,
+		const_iterator& oBegin, const_iterator& oEnd) const
 		{
-		const Map_ZZ* asMap = iMapEntryP->second.PGet<Map_ZZ>();
-		if (not asMap)
+		// The equality values, then the range's bound if there is one.
+		Key theKey;
+		foreacha (entry, iValsEqual)
+			theKey.fValues.push_back(&entry);
+
+		if (not iLo)
 			{
-			// iValPtr is not a map, can't index.
-			return false;
+			theKey.fMapEntryP = nullptr;
+			oBegin = this->lower_bound(theKey);
+			}
+		else
+			{
+			theKey.fValues.push_back(&iLo->first);
+			if (iLo->second)
+				{
+				theKey.fMapEntryP = nullptr;
+				oBegin = this->lower_bound(theKey);
+				}
+			else
+				{
+				theKey.fMapEntryP = spAllOnesPointer<Map_Thing::value_type>();
+				oBegin = this->upper_bound(theKey);
+				}
+			theKey.fValues.pop_back();
 			}
 
-		const Val_DB* firstVal = asMap->PGet(fColNames[0]);
-		if (not firstVal)
+		if (not iHi)
 			{
-			// The map does not have our first property, which we treat as a null. So it's
-			// unlikely that anything will search for that with that as the first criteria
-			// and we need not index it.
+			theKey.fMapEntryP = spAllOnesPointer<Map_Thing::value_type>();
+			oEnd = this->upper_bound(theKey);
+			}
+		else
+			{
+			theKey.fValues.push_back(&iHi->first);
+			if (iHi->second)
+				{
+				theKey.fMapEntryP = spAllOnesPointer<Map_Thing::value_type>();
+				oEnd = this->upper_bound(theKey);
+				}
+			else
+				{
+				theKey.fMapEntryP = nullptr;
+				oEnd = this->lower_bound(theKey);
+				}
+			}
+
+		// Contradictory bounds, eg a > 3 && a < 2, leave the end before the beginning.
+		if (oEnd < oBegin)
+			oBegin = oEnd;
+		}
+
+	bool Less(const Key& iLeft, const Key& iRight) const
+		{
+		return this->pLess(iLeft.fMapEntryP, iLeft.fValues.data(), iLeft.fValues.size(),
+			iRight.fMapEntryP, iRight.fValues.data(), iRight.fValues.size());
+		}
+
+	void Insert(const Key& iKey)
+		{
+		ZAssert(iKey.fValues.size() == fCount);
+
+		size_t theLeafIndex = 0;
+		size_t theOffset = 0;
+		if (fLeaves.empty())
+			{
+			fLeaves.resize(1);
+			}
+		else
+			{
+			const const_iterator theIter = this->lower_bound(iKey);
+			theLeafIndex = theIter.fLeaf;
+			theOffset = theIter.fOffset;
+			if (theLeafIndex == fLeaves.size())
+				{
+				// It goes after everything, at the end of the last leaf.
+				--theLeafIndex;
+				theOffset = fLeaves[theLeafIndex].fMapEntryPs.size();
+				}
+			}
+
+		Leaf& theLeaf = fLeaves[theLeafIndex];
+		theLeaf.fMapEntryPs.insert(theLeaf.fMapEntryPs.begin() + theOffset, iKey.fMapEntryP);
+		theLeaf.fValues.insert(theLeaf.fValues.begin() + theOffset * fCount,
+			iKey.fValues.begin(), iKey.fValues.end());
+		++fSize;
+
+		if (theLeaf.fMapEntryPs.size() > kLeafCapacity)
+			{
+			// Move the upper half into a new leaf following this one.
+			const size_t theHalf = theLeaf.fMapEntryPs.size() / 2;
+			Leaf theNew;
+			theNew.fMapEntryPs.assign(
+				theLeaf.fMapEntryPs.begin() + theHalf, theLeaf.fMapEntryPs.end());
+			theNew.fValues.assign(
+				theLeaf.fValues.begin() + theHalf * fCount, theLeaf.fValues.end());
+			theLeaf.fMapEntryPs.resize(theHalf);
+			theLeaf.fValues.resize(theHalf * fCount);
+			fLeaves.insert(fLeaves.begin() + theLeafIndex + 1, std::move(theNew));
+			}
+		}
+
+	// Replaces our content with iKeys, which must be in order. Leaves are filled to three
+	// quarters of capacity, so subsequent inserts don't immediately split them.
+	void Assign(const vector<Key>& iKeys)
+		{
+		const size_t theFill = kLeafCapacity * 3 / 4;
+
+		fLeaves.clear();
+		fLeaves.reserve((iKeys.size() + theFill - 1) / theFill);
+		for (size_t xx = 0; xx < iKeys.size(); xx += theFill)
+			{
+			const size_t theEnd = std::min(iKeys.size(), xx + theFill);
+			Leaf theLeaf;
+			theLeaf.fMapEntryPs.reserve(theEnd - xx);
+			theLeaf.fValues.reserve((theEnd - xx) * fCount);
+			for (size_t yy = xx; yy < theEnd; ++yy)
+				{
+				ZAssert(iKeys[yy].fValues.size() == fCount);
+				theLeaf.fMapEntryPs.push_back(iKeys[yy].fMapEntryP);
+				theLeaf.fValues.insert(theLeaf.fValues.end(),
+					iKeys[yy].fValues.begin(), iKeys[yy].fValues.end());
+				}
+			fLeaves.push_back(std::move(theLeaf));
+			}
+		fSize = iKeys.size();
+		}
+
+	void EraseMust(const Key& iKey)
+		{
+		const_iterator theIter = this->lower_bound(iKey);
+		ZAssert(theIter != this->end() && theIter.GetMapEntryP() == iKey.fMapEntryP);
+
+		Leaf& theLeaf = fLeaves[theIter.fLeaf];
+		theLeaf.fMapEntryPs.erase(theLeaf.fMapEntryPs.begin() + theIter.fOffset);
+		theLeaf.fValues.erase(theLeaf.fValues.begin() + theIter.fOffset * fCount,
+			theLeaf.fValues.begin() + (theIter.fOffset + 1) * fCount);
+		--fSize;
+
+		// Iterators rely on there being no empty leaves.
+		if (theLeaf.fMapEntryPs.empty())
+			fLeaves.erase(fLeaves.begin() + theIter.fLeaf);
+		}
+
+	// For Store's copy, which must point our keys at its own entries.
+	template <class Callable_p>
+	void MapEntryPs(Callable_p iCallable)
+		{
+		foreacha (aLeaf, fLeaves)
+			{
+			foreacha (entry, aLeaf.fMapEntryPs)
+				entry = iCallable(entry);
+			}
+		}
+
+private:
+	// Does iLeft sort before iRight? Values beyond the shorter of the two are ignored, and the
+	// tie-break on the Daton, which just keeps keys distinct, only applies when both are
+	// complete. So a short key sorts the same as every key it's a prefix of. The tie-break
+	// can't be the entry pointer, because Store's copy changes those without re-sorting. But
+	// pMakeWalker's probes use null and all-ones pointers, to sort before and after any entry.
+	bool pLess(const Map_Thing::value_type* iLeftP, const Val_DB* const* iLeft, size_t iLeftCount,
+		const Map_Thing::value_type* iRightP, const Val_DB* const* iRight, size_t iRightCount) const
+		{
+		const size_t theCount = std::min(iLeftCount, iRightCount);
+		for (size_t xx = 0; xx < theCount; ++xx)
+			{
+			if (const int compare = iLeft[xx]->Compare(*iRight[xx]))
+				return compare < 0;
+			}
+
+		if (theCount < fCount)
 			return false;
+
+		if (spIsProbe(iLeftP) || spIsProbe(iRightP))
+			return iLeftP < iRightP;
+
+		return iLeftP->first < iRightP->first;
+		}
+
+	static bool spIsProbe(const Map_Thing::value_type* iP)
+		{
+		return not iP || reinterpret_cast<uintptr_t>(iP) == ~uintptr_t(0);
+		}
+
+	// Is the key at iLeaf/iOffset before iKey, or with iUpper, not after it?
+	bool pBefore(const Leaf& iLeaf, size_t iOffset, const Key& iKey, bool iUpper) const
+		{
+		const Map_Thing::value_type* theP = iLeaf.fMapEntryPs[iOffset];
+		const Val_DB* const* theValues = &iLeaf.fValues[iOffset * fCount];
+		if (iUpper)
+			{
+			return not pLess(iKey.fMapEntryP, iKey.fValues.data(), iKey.fValues.size(),
+				theP, theValues, fCount);
 			}
+		return pLess(theP, theValues, fCount, iKey.fMapEntryP, iKey.fValues.data(), iKey.fValues.size());
+		}
 
-		oKey.fValues[0] = firstVal;
-		for (size_t xx = 1; xx < fCount; ++xx)
+	const_iterator pBound(const Key& iKey, bool iUpper) const
+		{
+		// Find the first leaf whose last key isn't before iKey,
+		size_t loLeaf = 0;
+		size_t hiLeaf = fLeaves.size();
+		while (loLeaf < hiLeaf)
 			{
-			if (const Val_DB* theVal = asMap->PGet(fColNames[xx]))
-				oKey.fValues[xx] = theVal;
+			const size_t mid = loLeaf + (hiLeaf - loLeaf) / 2;
+			const Leaf& theLeaf = fLeaves[mid];
+			if (this->pBefore(theLeaf, theLeaf.fMapEntryPs.size() - 1, iKey, iUpper))
+				loLeaf = mid + 1;
 			else
-				oKey.fValues[xx] = spEmptyValPtr;
+				hiLeaf = mid;
 			}
 
-		for (size_t xx = fCount; xx < Key::kMaxCols; ++xx)
-			oKey.fValues[xx] = nullptr;
+		if (loLeaf == fLeaves.size())
+			return this->end();
 
-		oKey.fMapEntryP = iMapEntryP;
+		// and then the first key within it that isn't.
+		const Leaf& theLeaf = fLeaves[loLeaf];
+		size_t lo = 0;
+		size_t hi = theLeaf.fMapEntryPs.size();
+		while (lo < hi)
+			{
+			const size_t mid = lo + (hi - lo) / 2;
+			if (this->pBefore(theLeaf, mid, iKey, iUpper))
+				lo = mid + 1;
+			else
+				hi = mid;
+			}
 
-		return true;
+		return const_iterator(this, loLeaf, lo);
 		}
 
-	ColName fColNames[Key::kMaxCols];
 	const size_t fCount;
+	size_t fSize;
+	vector<Leaf> fLeaves;
+	};
 
-	Set fSet;
+// =================================================================================================
+#pragma mark - Searcher_Datons::Store
 
-	DListHead<DLink_PSearch_InIndex> fPSearch_InIndex;
-	};
+class Searcher_Datons::Store
+:	public CountedWithoutFinalize
+	{
+public:
+	Store(const vector<Index*>& iIndexes)
+		{
+		foreacha (anIndex, iIndexes)
+			{
+			if (anIndex->fHashed)
+				fHashSets.push_back(Index::HashSet());
+			else
+				fSets.push_back(Index::Set(anIndex->fCount));
+			}
+		}
 
-const Val_DB* const Searcher_Datons::Index::spEmptyValPtr = &sDefault<Val_DB>();
+	// The copy shares the decoded values, so the value pointers in iOther's keys remain
+	// good, but the entry pointers must be pointed at our own entries.
+	Store(const Store& iOther)
+	:	fMap_Thing(iOther.fMap_Thing)
+	,	fSets(iOther.fSets)
+	,	fHashSets(iOther.fHashSets)
+		{
+		const auto ourEntry = [this](const Map_Thing::value_type* iOtherEntryP)
+			{ return &*fMap_Thing.find(iOtherEntryP->first); };
 
-const ChanW_UTF& operator<<(const ChanW_UTF& ww, const Searcher_Datons::Index::Key& iKey);
+		foreacha (aSet, fSets)
+			aSet.MapEntryPs(ourEntry);
 
-void Searcher_Datons::Index::Comparer::spDump(bool iResult, const Key& iLeft, const Key& iRight)
-	{
-	if (ZLOGF(w, eDebug))
-		w << iLeft << "/" << iResult<< "/" << iRight;
-	}
+		foreacha (aHashSet, fHashSets)
+			{
+			foreacha (entry, aHashSet)
+				entry.second = ourEntry(entry.second);
+			}
+		}
+
+	Index::Set& GetSet(const Index* iIndex)
+		{
+		ZAssert(not iIndex->fHashed);
+		return fSets[iIndex->fOrdinal];
+		}
+
+	Index::HashSet& GetHashSet(const Index* iIndex)
+		{
+		ZAssert(iIndex->fHashed);
+		return fHashSets[iIndex->fOrdinal];
+		}
+
+	Map_Thing fMap_Thing;
+	vector<Index::Set> fSets;
+	vector<Index::HashSet> fHashSets;
+	};
+
+const ChanW_UTF& operator<<(const ChanW_UTF& ww, const Searcher_Datons::Index::Key& iKey);
 
 // =================================================================================================
 #pragma mark - Searcher_Datons::Walker_Map
@@ -193,8 +616,10 @@ class Searcher_Datons::Walker_Map
 :	public QE::Walker
 	{
 public:
-	Walker_Map(ZP<Searcher_Datons> iSearcher, const ConcreteHead& iConcreteHead)
+	Walker_Map(ZP<Searcher_Datons> iSearcher, const ZP<Store>& iStore,
+		const ConcreteHead& iConcreteHead)
 	:	fSearcher(iSearcher)
+	,	fStore(iStore)
 	,	fConcreteHead(iConcreteHead)
 		{}
 
@@ -223,10 +648,11 @@ public:
 		}
 
 	const ZP<Searcher_Datons> fSearcher;
+	const ZP<Store> fStore;
 	const ConcreteHead fConcreteHead;
 	size_t fBaseOffset;
 	Map_Thing::const_iterator fCurrent;
-	std::set<std::vector<Val_DB>> fPriors;
+	QE::RowSet fPriors;
 	};
 
 // =================================================================================================
@@ -236,11 +662,12 @@ class Searcher_Datons::Walker_Index
 :	public QE::Walker
 	{
 public:
-	Walker_Index(ZP<Searcher_Datons> iSearcher, Index* iIndex,
+	Walker_Index(ZP<Searcher_Datons> iSearcher, const ZP<Store>& iStore, Index* iIndex,
 		size_t iUsableIndexNames,
 		const ConcreteHead& iConcreteHead,
 		Index::Set::const_iterator iBegin, Index::Set::const_iterator iEnd)
 	:	fSearcher(iSearcher)
+	,	fStore(iStore)
 	,	fIndex(iIndex)
 	,	fUsableIndexNames(iUsableIndexNames)
 	,	fNameBoolVector(iConcreteHead.begin(), iConcreteHead.end())
@@ -274,6 +701,7 @@ public:
 		}
 
 	const ZP<Searcher_Datons> fSearcher;
+	const ZP<Store> fStore;
 	Index* const fIndex;
 	const size_t fUsableIndexNames;
 	typedef pair<Name,bool> NameBool;
@@ -288,6 +716,57 @@ public:
 	std::vector<Val_DB> fPrior;
 	};
 
+// =================================================================================================
+#pragma mark - Searcher_Datons::Walker_Entries
+
+// Walks an explicit list of entries, which may include ones no longer in fMap_Thing. Unlike
+// Walker_Map it does not suppress duplicate rows, each entry produces its own. If the entries
+// are in a Store, iStore keeps it alive.
+
+class Searcher_Datons::Walker_Entries
+:	public QE::Walker
+	{
+public:
+	Walker_Entries(ZP<Searcher_Datons> iSearcher, const ZP<Store>& iStore,
+		const ConcreteHead& iConcreteHead, const MapEntries& iMapEntries)
+	:	fSearcher(iSearcher)
+	,	fStore(iStore)
+	,	fConcreteHead(iConcreteHead)
+	,	fMapEntries(iMapEntries)
+		{}
+
+	virtual ~Walker_Entries()
+		{}
+
+// From QE::Walker
+	virtual void Rewind()
+		{
+		this->Called_Rewind();
+		fSearcher->pRewind(this);
+		}
+
+	virtual ZP<QE::Walker> Prime(const map<string8,size_t>& iOffsets,
+		map<string8,size_t>& oOffsets,
+		size_t& ioBaseOffset)
+		{
+		fSearcher->pPrime(this, iOffsets, oOffsets, ioBaseOffset);
+		return this;
+		}
+
+	virtual bool QReadInc(Val_DB* ioResults)
+		{
+		this->Called_QReadInc();
+		return fSearcher->pReadInc(this, ioResults);
+		}
+
+	const ZP<Searcher_Datons> fSearcher;
+	const ZP<Store> fStore;
+	const ConcreteHead fConcreteHead;
+	const MapEntries fMapEntries;
+	size_t fBaseOffset;
+	size_t fCurrent;
+	};
+
 // =================================================================================================
 #pragma mark - Searcher_Datons::ClientSearch
 
@@ -311,13 +790,15 @@ public:
 
 	int64 const fRefcon;
 	PSearch* const fPSearch;
+
+	// The result most recently passed to the client, so we know whether the PSearch's
+	// ResultDeltas apply to what the client has.
+	ZP<QE::Result> fResultSent;
 	};
 
 // =================================================================================================
 #pragma mark - Searcher_Datons::PSearch
 
-typedef ZQ<pair<Val_DB,bool>> Bound_t; // Value, inclusive
-
 class Searcher_Datons::DLink_PSearch_InIndex
 :	public DListLink<PSearch, DLink_PSearch_InIndex, kDebug>
 	{};
@@ -334,13 +815,15 @@ public:
 	PSearch(const SearchSpec& iSearchSpec)
 	:	fSearchSpec(iSearchSpec)
 	,	fIndex(nullptr)
+	,	fBuildID(0)
 		{}
 
 	const SearchSpec fSearchSpec;
 
 	size_t fUsableIndexNames;
 	ConcreteHead fConcreteHead;
-	RelHead fProjectionIfNecessary;
+	ConcreteHead fConcreteHead_Entries;
+	RelHead fRelHead;
 
 	Index* fIndex;
 
@@ -349,19 +832,164 @@ public:
 	Bound_t fRangeHi;
 	ZP<Expr_Bool> fRestrictionRemainder;
 
+	ScanShape fScanShape;
+
 	DListHead<DLink_ClientSearch_InPSearch> fClientSearch_InPSearch;
 
+	// Every distinct row of the result, with the number of datons producing it and its
+	// position in fSlots. fSlots is the order of rows in the published result -- a new row
+	// takes the slot of a departed one where it can, so that a daton being replaced shows
+	// up as a ResultDeltas rather than as a whole new result.
+	struct RowInfo
+		{
+		size_t fCount;
+		size_t fSlot;
+		};
+
+	typedef map<vector<Val_DB>,RowInfo> Map_Rows;
+	Map_Rows fRows;
+	vector<Map_Rows::iterator> fSlots;
+	set<size_t> fTouchedSlots;
+
+	// Null until we've done the initial walk, after which fRows is maintained incrementally.
 	ZP<QE::Result> fResult;
+
+	// Non-zero while CollectResults is doing the initial walk against a pinned Store. Any
+	// changes MakeChanges makes in the meantime are held here, and applied when it's done.
+	uint64 fBuildID;
+	vector<Map_Thing::value_type> fBuild_Asserted;
+	vector<Map_Thing::value_type> fBuild_Retracted;
+
+	// fResultDeltas turns fResultPrior into fResult, if it's not null.
+	ZP<QE::Result> fResultPrior;
+	ZP<QE::ResultDeltas> fResultDeltas;
 	};
 
 // =================================================================================================
-#pragma mark - Searcher_Datons
+#pragma mark - Searcher_Datons::ScanShape
+
+bool Searcher_Datons::ScanShape::operator<(const ScanShape& iOther) const
+	{
+	if (fRelHead < iOther.fRelHead)
+		return true;
+
+	if (iOther.fRelHead < fRelHead)
+		return false;
+
+	if (fNames_Equal < iOther.fNames_Equal)
+		return true;
+
+	if (iOther.fNames_Equal < fNames_Equal)
+		return false;
+
+	return fNames_Range < iOther.fNames_Range;
+	}
+
+// =================================================================================================
+#pragma mark - Searcher_Datons::ScanStats
+
+Searcher_Datons::ScanStats::ScanStats()
+:	fCount(0)
+,	fRowsScanned(0)
+,	fElapsed(0)
+,	fIndexAdded(false)
+	{}
+
+// =================================================================================================
+#pragma mark - Searcher_Datons::Plan
+
+// How a search would be done -- by walking fIndex, or every daton if it's null -- and what
+// doing it is likely to cost and to produce.
+
+struct Searcher_Datons::Plan
+	{
+	Plan()
+	:	fIndex(nullptr)
+	,	fCount(0)
+	,	fCost(0)
+		{}
+
+	Util_Expr_Bool::CNF fCNF;
+
+	Index* fIndex;
+	vector<Val_DB> fValsEqual;
+	Bound_t fLo;
+	Bound_t fHi;
+
+	// The clauses of fCNF that fIndex doesn't take care of.
+	Util_Expr_Bool::CNF fDClauses;
+
+	double fCount;
+	double fCost;
+	};
+
+// =================================================================================================
+#pragma mark - DoReplaceNames (anonymous)
+
+namespace { // anonymous
+
+// Replaces the names in iNames with iVal.
+class DoReplaceNames
+:	public virtual Visitor_Expr_Op_Do_Transform_T<Expr_Bool>
+,	public virtual Visitor_Expr_Bool_ValPred
+	{
+public:
+	DoReplaceNames(const RelHead& iNames, const Val_DB& iVal)
+	:	fNames(iNames)
+	,	fVal(iVal)
+		{}
+
+	virtual void Visit_Expr_Bool_ValPred(const ZP<Expr_Bool_ValPred>& iExpr)
+		{
+		const ValPred& theValPred = iExpr->GetValPred();
+		const ZP<ValComparand> theLHS = this->pReplaced(theValPred.GetLHS());
+		const ZP<ValComparand> theRHS = this->pReplaced(theValPred.GetRHS());
+
+		if (theLHS == theValPred.GetLHS() && theRHS == theValPred.GetRHS())
+			this->pSetResult(iExpr);
+		else
+			this->pSetResult(new Expr_Bool_ValPred(ValPred(theLHS, theValPred.GetComparator(), theRHS)));
+		}
+
+private:
+	ZP<ValComparand> pReplaced(const ZP<ValComparand>& iValComparand)
+		{
+		if (ZP<ValComparand_Name> asName = iValComparand.DynamicCast<ValComparand_Name>())
+			{
+			if (sContains(fNames, asName->GetName()))
+				return new ValComparand_Const_DB(fVal);
+			}
+		return iValComparand;
+		}
+
+	const RelHead& fNames;
+	const Val_DB fVal;
+	};
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - Searcher_Datons
 
 Searcher_Datons::Searcher_Datons(const vector<IndexSpec>& iIndexSpecs)
-:	fChangeCount(0)
+:	fNextBuildID(0)
+,	fAutoIndexThreshold(0)
+,	fIndexBuild_InFlight(false)
+,	fSnapshotThreshold(0)
+,	fSnapshot_InFlight(false)
+,	fChangeCount(0)
 	{
+	size_t theCount_Sets = 0;
+	size_t theCount_HashSets = 0;
 	foreacha (entry, iIndexSpecs)
-		fIndexes.push_back(new Index(entry));
+		{
+		if (entry.IsHashed())
+			fIndexes.push_back(new Index(entry, theCount_HashSets++));
+		else
+			fIndexes.push_back(new Index(entry, theCount_Sets++));
+		}
+
+	fStore = new Store(fIndexes);
 	}
 
 Searcher_Datons::~Searcher_Datons()
@@ -441,229 +1069,508 @@ static void spDump(const ChanW_UTF& ww,
 		}
 	}
 
-void Searcher_Datons::pSetupPSearch(PSearch* ioPSearch)
+// The names that single-term clauses of iCNF compare with constants -- those are the clauses
+// an index could serve. A name compared for equality isn't also reported as a range.
+static void spIndexableNames(const Util_Expr_Bool::CNF& iCNF,
+	RelHead& oNames_Equal, RelHead& oNames_Range)
 	{
 	using namespace Util_Expr_Bool;
 
-	const SearchSpec& theSearchSpec = ioPSearch->fSearchSpec;
-
-	const CNF theCNF = sAsCNF(theSearchSpec.GetRestriction());
+	foreacha (aDClause, iCNF)
+		{
+		if (aDClause.size() != 1)
+			continue;
 
-	CNF bestDClauses;
-	Index* bestIndex = nullptr;
-	vector<Val_DB> bestValsEqual;
-	Bound_t bestLo, bestHi;
+		ZP<Expr_Bool_ValPred> theExpr = aDClause.begin()->Get().DynamicCast<Expr_Bool_ValPred>();
+		if (not theExpr)
+			continue;
 
-	foreachv (Index* curIndex, fIndexes)
-		{
-		CNF curDClauses = theCNF;
+		const ValPred& theValPred = theExpr->GetValPred();
 
-		vector<Val_DB> valsEqual;
+		ZP<ValComparator_Simple> theValComparator =
+			theValPred.GetComparator().DynamicCast<ValComparator_Simple>();
+		if (not theValComparator)
+			continue;
 
-		Bound_t finalLo, finalHi;
+		ZP<ValComparand_Name> theComparand_Name =
+			theValPred.GetLHS().DynamicCast<ValComparand_Name>();
+		ZP<ValComparand_Const_DB> theComparand_Const =
+			theValPred.GetRHS().DynamicCast<ValComparand_Const_DB>();
 
-		for (size_t xxColName = 0; xxColName < curIndex->fCount; ++xxColName)
+		if (not theComparand_Name || not theComparand_Const)
 			{
-			const ColName& curColName = curIndex->fColNames[xxColName];
+			theComparand_Name = theValPred.GetRHS().DynamicCast<ValComparand_Name>();
+			theComparand_Const = theValPred.GetLHS().DynamicCast<ValComparand_Const_DB>();
+			}
 
-			Bound_t clausesLo, clausesHi;
+		if (not theComparand_Name || not theComparand_Const)
+			continue;
 
-			for (set<DClause>::iterator iterDClauses = curDClauses.begin();
-				iterDClauses != curDClauses.end();
-				/*no inc*/)
+		switch (theValComparator->GetEComparator())
+			{
+			case ValComparator_Simple::eEQ:
+				{
+				oNames_Equal.insert(theComparand_Name->GetName());
+				break;
+				}
+			case ValComparator_Simple::eNE:
+				{
+				break;
+				}
+			default:
 				{
-				// Hack for now -- only start with success if we have a single clause.
-				bool everyTermIsRelevant = iterDClauses->size() == 1;
+				oNames_Range.insert(theComparand_Name->GetName());
+				break;
+				}
+			}
+		}
+
+	foreacha (entry, oNames_Equal)
+		oNames_Range.erase(entry);
+	}
+
+// Which clauses of ioDClauses iIndex can serve -- equalities with constants on its leading
+// columns, perhaps followed by a range on the next. They're removed from ioDClauses, and what
+// they require is put in oValsEqual, oLo and oHi.
+static void spMatch(const Searcher_Datons::Index* iIndex,
+	Util_Expr_Bool::CNF& ioDClauses,
+	vector<Val_DB>& oValsEqual, Bound_t& oLo, Bound_t& oHi)
+	{
+	using namespace Util_Expr_Bool;
+
+	for (size_t xxColName = 0; xxColName < iIndex->fCount; ++xxColName)
+		{
+		const ColName& curColName = iIndex->fColNames[xxColName];
+
+		Bound_t clausesLo, clausesHi;
+
+		for (set<DClause>::iterator iterDClauses = ioDClauses.begin();
+			iterDClauses != ioDClauses.end();
+			/*no inc*/)
+			{
+			// Hack for now -- only start with success if we have a single clause.
+			bool everyTermIsRelevant = iterDClauses->size() == 1;
 
-				Bound_t termsLo, termsHi;
+			Bound_t termsLo, termsHi;
 
-				for (set<Term>::iterator iterTerms = iterDClauses->begin();
-					everyTermIsRelevant && iterTerms != iterDClauses->end();
-					++iterTerms)
+			for (set<Term>::iterator iterTerms = iterDClauses->begin();
+				everyTermIsRelevant && iterTerms != iterDClauses->end();
+				++iterTerms)
+				{
+				bool termIsRelevant = false;
+				if (ZP<Expr_Bool_ValPred> theExpr = iterTerms->Get().DynamicCast<Expr_Bool_ValPred>())
 					{
-					bool termIsRelevant = false;
-					if (ZP<Expr_Bool_ValPred> theExpr = iterTerms->Get().DynamicCast<Expr_Bool_ValPred>())
-						{
-						const ValPred& theValPred = theExpr->GetValPred();
+					const ValPred& theValPred = theExpr->GetValPred();
 
-						if (ZP<ValComparator_Simple> theValComparator =
-							theValPred.GetComparator().DynamicCast<ValComparator_Simple>())
-							{
-							EComparator theEComparator = theValComparator->GetEComparator();
+					if (ZP<ValComparator_Simple> theValComparator =
+						theValPred.GetComparator().DynamicCast<ValComparator_Simple>())
+						{
+						EComparator theEComparator = theValComparator->GetEComparator();
 
-							ZP<ValComparand_Const_DB> theComparand_Const =
-								theValPred.GetRHS().DynamicCast<ValComparand_Const_DB>();
+						ZP<ValComparand_Const_DB> theComparand_Const =
+							theValPred.GetRHS().DynamicCast<ValComparand_Const_DB>();
 
-							ZP<ValComparand_Name> theComparand_Name =
-								theValPred.GetLHS().DynamicCast<ValComparand_Name>();
+						ZP<ValComparand_Name> theComparand_Name =
+							theValPred.GetLHS().DynamicCast<ValComparand_Name>();
 
-							if (not theComparand_Const || not theComparand_Name)
-								{
-								theComparand_Const = theValPred.GetLHS().DynamicCast<ValComparand_Const_DB>();
-								theComparand_Name = theValPred.GetRHS().DynamicCast<ValComparand_Name>();
-								theEComparator = spFlipped(theEComparator);
-								}
+						if (not theComparand_Const || not theComparand_Name)
+							{
+							theComparand_Const = theValPred.GetLHS().DynamicCast<ValComparand_Const_DB>();
+							theComparand_Name = theValPred.GetRHS().DynamicCast<ValComparand_Name>();
+							theEComparator = spFlipped(theEComparator);
+							}
 
-							if (theComparand_Const
-								&& theComparand_Name
-								&& theComparand_Name->GetName() == curColName)
-								{
-								termIsRelevant = true;
+						if (theComparand_Const
+							&& theComparand_Name
+							&& theComparand_Name->GetName() == curColName)
+							{
+							termIsRelevant = true;
 
-								const Val_DB& theVal = theComparand_Const->GetVal();
+							const Val_DB& theVal = theComparand_Const->GetVal();
 
-								switch (theEComparator)
+							switch (theEComparator)
+								{
+								case ValComparator_Simple::eLT:
+									{
+									termsLo.Clear();
+									termsHi = Bound_t(theVal, false);
+									break;
+									}
+								case ValComparator_Simple::eLE:
+									{
+									termsLo.Clear();
+									termsHi = Bound_t(theVal, true);
+									break;
+									}
+								case ValComparator_Simple::eEQ:
+									{
+									termsLo = Bound_t(theVal, true);
+									termsHi = Bound_t(theVal, true);
+									break;
+									}
+								case ValComparator_Simple::eGE:
+									{
+									termsLo = Bound_t(theVal, true);
+									termsHi.Clear();
+									break;
+									}
+								case ValComparator_Simple::eGT:
+									{
+									termsLo = Bound_t(theVal, false);
+									termsHi.Clear();
+									break;
+									}
+								default:
 									{
-									case ValComparator_Simple::eLT:
-										{
-										termsLo.Clear();
-										termsHi = Bound_t(theVal, false);
-										break;
-										}
-									case ValComparator_Simple::eLE:
-										{
-										termsLo.Clear();
-										termsHi = Bound_t(theVal, true);
-										break;
-										}
-									case ValComparator_Simple::eEQ:
-										{
-										termsLo = Bound_t(theVal, true);
-										termsHi = Bound_t(theVal, true);
-										break;
-										}
-									case ValComparator_Simple::eGE:
-										{
-										termsLo = Bound_t(theVal, true);
-										termsHi.Clear();
-										break;
-										}
-									case ValComparator_Simple::eGT:
-										{
-										termsLo = Bound_t(theVal, false);
-										termsHi.Clear();
-										break;
-										}
-									default:
-										{
-										termIsRelevant = false;
-										break;
-										}
+									termIsRelevant = false;
+									break;
 									}
 								}
 							}
 						}
+					}
 
-					everyTermIsRelevant = everyTermIsRelevant && termIsRelevant;
-					} // iterTerms
+				everyTermIsRelevant = everyTermIsRelevant && termIsRelevant;
+				} // iterTerms
+
+			if (not everyTermIsRelevant)
+				{
+				++iterDClauses;
+				}
+			else
+				{
+				// Remove this DClause from further consideration -- its constraints will be
+				// represented in curComparison.
+				iterDClauses = sEraseInc(ioDClauses, iterDClauses);
 
-				if (not everyTermIsRelevant)
+				if (not clausesLo)
+					{
+					clausesLo = termsLo;
+					}
+				else if (not termsLo)
+					{}
+				else if (termsLo->second == clausesLo->second)
+					{
+					// terms and clauses are both inclusive or exclusive.
+					if (clausesLo->first < termsLo->first)
+						clausesLo = termsLo;
+					}
+				else if (termsLo->second)
 					{
-					++iterDClauses;
+					// clauses is inclusive and terms is exclusive. So C1 <= XX && T1 < XX
+					if (clausesLo->first <= termsLo->first)
+						clausesLo = termsLo;
 					}
 				else
 					{
-					// Remove this DClause from further consideration -- its constraints will be
-					// represented in curComparison.
-					iterDClauses = sEraseInc(curDClauses, iterDClauses);
-
-					if (not clausesLo)
-						{
+					// clauses is exclusive and terms is inclusive. So C1 < XX && T1 <= XX
+					if (clausesLo->first < termsLo->first)
 						clausesLo = termsLo;
-						}
-					else if (not termsLo)
-						{}
-					else if (termsLo->second == clausesLo->second)
-						{
-						// terms and clauses are both inclusive or exclusive.
-						if (clausesLo->first < termsLo->first)
-							clausesLo = termsLo;
-						}
-					else if (termsLo->second)
-						{
-						// clauses is inclusive and terms is exclusive. So C1 <= XX && T1 < XX
-						if (clausesLo->first <= termsLo->first)
-							clausesLo = termsLo;
-						}
-					else
-						{
-						// clauses is exclusive and terms is inclusive. So C1 < XX && T1 <= XX
-						if (clausesLo->first < termsLo->first)
-							clausesLo = termsLo;
-						}
+					}
 
-					if (not clausesHi)
-						{
+				if (not clausesHi)
+					{
+					clausesHi = termsHi;
+					}
+				else if (not termsHi)
+					{}
+				else if (termsHi->second == clausesHi->second)
+					{
+					// terms and clauses are both inclusive or exclusive.
+					if (clausesHi->first > termsHi->first)
 						clausesHi = termsHi;
-						}
-					else if (not termsHi)
-						{}
-					else if (termsHi->second == clausesHi->second)
-						{
-						// terms and clauses are both inclusive or exclusive.
-						if (clausesHi->first > termsHi->first)
-							clausesHi = termsHi;
-						}
-					else if (termsHi->second)
-						{
-						// clauses is exclusive and terms is inclusive. So XX < C1 && XX <= T1
-						if (clausesHi->first > termsHi->first)
-							clausesHi = termsHi;
-						}
-					else
-						{
-						// clauses is inclusive and terms is exclusive. So XX <= C1 && XX < T1
-						if (clausesHi->first >= termsHi->first)
-							clausesHi = termsHi;
-						}
-					} // not everyTermIsRelevant
-				} // iterDClauses
+					}
+				else if (termsHi->second)
+					{
+					// clauses is exclusive and terms is inclusive. So XX < C1 && XX <= T1
+					if (clausesHi->first > termsHi->first)
+						clausesHi = termsHi;
+					}
+				else
+					{
+					// clauses is inclusive and terms is exclusive. So XX <= C1 && XX < T1
+					if (clausesHi->first >= termsHi->first)
+						clausesHi = termsHi;
+					}
+				} // not everyTermIsRelevant
+			} // iterDClauses
 
-			if (clausesLo && clausesHi // We have lo and hi
-				&& clausesLo->second && clausesHi->second // they're both inclusive
-				&& clausesLo->first == clausesHi->first) // with the same value
-				{
-				// It's an equality.
-				valsEqual.push_back(clausesLo->first);
-				}
-			else
+		if (clausesLo && clausesHi // We have lo and hi
+			&& clausesLo->second && clausesHi->second // they're both inclusive
+			&& clausesLo->first == clausesHi->first) // with the same value
+			{
+			// It's an equality.
+			oValsEqual.push_back(clausesLo->first);
+			}
+		else
+			{
+			// Only a range on this column can be used, or nothing at all if it has no
+			// clauses. Either way later columns can't help -- their keys aren't in
+			// any useful order within the range -- so their clauses stay in ioDClauses.
+			oLo = clausesLo;
+			oHi = clausesHi;
+			break;
+			}
+		} // xxColName
+	}
+
+// The fraction of datons we expect to satisfy iCNF. An equality with a constant keeps one of
+// however many distinct values the name takes, if iDistincts knows, and otherwise a tenth.
+// Anything else keeps a quarter, or a half if it's a disjunction.
+static double spSelectivity(const Util_Expr_Bool::CNF& iCNF,
+	const map<ColName,double>& iDistincts)
+	{
+	double result = 1;
+	foreacha (aDClause, iCNF)
+		{
+		double theSelectivity = aDClause.size() == 1 ? 0.25 : 0.5;
+
+		ZP<Expr_Bool_ValPred> theExpr;
+		if (aDClause.size() == 1)
+			{
+			// TRUE rules nothing out.
+			if (aDClause.begin()->Get().DynamicCast<Expr_Bool_True>())
+				continue;
+			theExpr = aDClause.begin()->Get().DynamicCast<Expr_Bool_ValPred>();
+			}
+
+		if (theExpr)
+			{
+			const ValPred& theValPred = theExpr->GetValPred();
+
+			ZP<ValComparator_Simple> theValComparator =
+				theValPred.GetComparator().DynamicCast<ValComparator_Simple>();
+
+			if (theValComparator
+				&& (theValComparator->GetEComparator() == ValComparator_Simple::eEQ
+				|| theValComparator->GetEComparator() == ValComparator_Simple::eNE))
 				{
-				// We can only use one relative clause. Use first we encounter, later
-				// we'd want the one with the best discrimination, although that's
-				// harder to arrange. We could do it by holding *all* of the relative clauses
-				// and picking the one that has the smallest result set. That's harder to arrange.
-				if (not finalLo and not finalHi)
+				ZP<ValComparand_Name> theComparand_Name =
+					theValPred.GetLHS().DynamicCast<ValComparand_Name>();
+				if (not theComparand_Name || not theValPred.GetRHS().DynamicCast<ValComparand_Const_DB>())
+					{
+					theComparand_Name = theValPred.GetRHS().DynamicCast<ValComparand_Name>();
+					if (not theValPred.GetLHS().DynamicCast<ValComparand_Const_DB>())
+						theComparand_Name.Clear();
+					}
+
+				double theEqual = 0.1;
+				if (theComparand_Name)
 					{
-					finalLo = clausesLo;
-					finalHi = clausesHi;
+					if (ZQ<double> theDistinctQ = sQGet(iDistincts, theComparand_Name->GetName()))
+						theEqual = 1 / *theDistinctQ;
 					}
+
+				if (theValComparator->GetEComparator() == ValComparator_Simple::eEQ)
+					theSelectivity = theEqual;
+				else
+					theSelectivity = 1 - theEqual;
+				}
+			}
+
+		result *= theSelectivity;
+		}
+	return result;
+	}
+
+// Whether any of the values is a stand-in for one that's not known yet.
+static bool spAnyUnbound(const vector<Val_DB>& iValsEqual, const Bound_t& iLo, const Bound_t& iHi)
+	{
+	foreacha (entry, iValsEqual)
+		{
+		if (entry.PGet<Unbound_t>())
+			return true;
+		}
+	return (iLo && iLo->first.PGet<Unbound_t>()) || (iHi && iHi->first.PGet<Unbound_t>());
+	}
+
+void Searcher_Datons::pUpdateStats(Index* ioIndex)
+	{
+	// A pass over the keys is as much work as a scan, so it's only redone once the number of
+	// keys has drifted by more than an eighth.
+	const size_t theSize = ioIndex->fHashed
+		? fStore->GetHashSet(ioIndex).size() : fStore->GetSet(ioIndex).size();
+
+	if (const ZQ<size_t>& theQ = ioIndex->fStatsSizeQ)
+		{
+		const size_t theDrift = theSize > *theQ ? theSize - *theQ : *theQ - theSize;
+		if (theDrift * 8 <= *theQ)
+			return;
+		}
+
+	ioIndex->fStatsSizeQ = theSize;
+	ioIndex->fDistinct.assign(ioIndex->fCount, 0);
+
+	if (ioIndex->fHashed)
+		{
+		// Keys with the same hash are adjacent, and we can only tell whole keys apart.
+		const Index::HashSet& theHashSet = fStore->GetHashSet(ioIndex);
+		for (Index::HashSet::const_iterator iter = theHashSet.begin(), end = theHashSet.end();
+			iter != end; iter = theHashSet.equal_range(iter->first).second)
+			{ ++ioIndex->fDistinct.back(); }
+		}
+	else
+		{
+		// Keys are in order, so a key brings a new value for each prefix that's at least as
+		// long as the first column in which it differs from the key before it.
+		const Index::Set& theSet = fStore->GetSet(ioIndex);
+		const Val_DB* const* priorValues = nullptr;
+		for (Index::Set::const_iterator iter = theSet.begin(), end = theSet.end();
+			iter != end; ++iter)
+			{
+			const Val_DB* const* theValues = iter.GetValues();
+
+			size_t firstDifferent = 0;
+			if (priorValues)
+				{
+				while (firstDifferent < ioIndex->fCount
+					&& 0 == theValues[firstDifferent]->Compare(*priorValues[firstDifferent]))
+					{ ++firstDifferent; }
 				}
-			} // xxColName
 
-		if (curDClauses.size() < theCNF.size())
+			for (size_t xx = firstDifferent; xx < ioIndex->fCount; ++xx)
+				++ioIndex->fDistinct[xx];
+
+			priorValues = theValues;
+			}
+		}
+	}
+
+double Searcher_Datons::pDistinct(const ColName& iColName)
+	{
+	// Any index leading with iColName knows how many values it takes.
+	foreacha (anIndex, fIndexes)
+		{
+		if (anIndex->fColNames[0] == iColName)
+			{
+			this->pUpdateStats(anIndex);
+			if (anIndex->fDistinct[0] >= 1)
+				return anIndex->fDistinct[0];
+			}
+		}
+	return 0;
+	}
+
+void Searcher_Datons::pPlan(const ZP<Expr_Bool>& iRestriction, Plan& oPlan)
+	{
+	using namespace Util_Expr_Bool;
+
+	oPlan.fCNF = sAsCNF(iRestriction);
+
+	map<ColName,double> theDistincts;
+	foreacha (entry, sGetNames(iRestriction))
+		{
+		if (const double theDistinct = this->pDistinct(entry))
+			theDistincts[entry] = theDistinct;
+		}
+
+	const double theSize = fStore->fMap_Thing.size();
+
+	// A search persists as the store grows, and the store's current size is a poor guide when
+	// it's still being filled. So walking every daton is treated as walking at least a thousand.
+	oPlan.fIndex = nullptr;
+	oPlan.fValsEqual.clear();
+	oPlan.fLo.Clear();
+	oPlan.fHi.Clear();
+	oPlan.fDClauses = oPlan.fCNF;
+	oPlan.fCost = std::max<double>(1000, theSize);
+	oPlan.fCount = theSize * spSelectivity(oPlan.fCNF, theDistincts);
+
+	foreachv (Index* curIndex, fIndexes)
+		{
+		CNF curDClauses = oPlan.fCNF;
+		vector<Val_DB> valsEqual;
+		Bound_t curLo, curHi;
+		spMatch(curIndex, curDClauses, valsEqual, curLo, curHi);
+
+		if (curDClauses.size() == oPlan.fCNF.size())
 			{
-			// We were able to remove at least one clause.
+			// It can't take care of any clause.
+			continue;
+			}
+
+		if (curIndex->fHashed && valsEqual.size() < curIndex->fCount)
+			{
+			// A hash index needs a value for every column.
+			continue;
+			}
 
-			if (not bestIndex
-				|| curDClauses.size() < bestDClauses.size()
-				|| (not bestLo && finalLo) || (not bestHi && finalHi))
+		// How many keys we'd walk. With the values in hand we count them, otherwise we go by
+		// how many distinct values the columns take, and assume a range keeps a quarter.
+		double curWalked;
+		if (spAnyUnbound(valsEqual, curLo, curHi))
+			{
+			this->pUpdateStats(curIndex);
+			curWalked = theSize;
+			if (const size_t countEqual = valsEqual.size())
 				{
-				// This is the first usable index, we've removed more clauses than the prior best
-				// index, or this is the first index to satisfy a rel clause.
-				bestIndex = curIndex;
-				bestValsEqual = valsEqual;
-				bestLo = finalLo;
-				bestHi = finalHi;
-				bestDClauses = curDClauses;
+				if (curIndex->fDistinct[countEqual - 1] >= 1)
+					curWalked /= curIndex->fDistinct[countEqual - 1];
+				else
+					curWalked *= std::pow(0.1, double(countEqual));
 				}
+
+			if (curLo || curHi)
+				curWalked *= 0.25;
+			}
+		else if (curIndex->fHashed)
+			{
+			vector<const Val_DB*> theValsEqual;
+			foreacha (entry, valsEqual)
+				theValsEqual.push_back(&entry);
+
+			curWalked = fStore->GetHashSet(curIndex).count(
+				QE::sHash(theValsEqual.data(), curIndex->fCount));
+			}
+		else
+			{
+			const Index::Set& theSet = fStore->GetSet(curIndex);
+			Index::Set::const_iterator theBegin, theEnd;
+			theSet.Range(valsEqual, curLo, curHi, theBegin, theEnd);
+			curWalked = theSet.Distance(theBegin, theEnd);
+			}
+
+		// Lookup is a descent of an ordered index and a single probe of a hashed one.
+		const double curCost = curWalked
+			+ (curIndex->fHashed ? 1 : std::log2(std::max<double>(2, theSize)));
+
+		// Whichever way we'd do it, the result is the same, so take the tightest estimate.
+		const double curCount = curWalked * spSelectivity(curDClauses, theDistincts);
+		oPlan.fCount = std::min(oPlan.fCount, curCount);
+
+		if (curCost < oPlan.fCost
+			|| (curCost == oPlan.fCost && curDClauses.size() < oPlan.fDClauses.size()))
+			{
+			// It's cheaper than walking everything, and than the prior best.
+			oPlan.fIndex = curIndex;
+			oPlan.fValsEqual = valsEqual;
+			oPlan.fLo = curLo;
+			oPlan.fHi = curHi;
+			oPlan.fDClauses = curDClauses;
+			oPlan.fCost = curCost;
 			}
 		}
+	}
+
+void Searcher_Datons::pSetupPSearch(PSearch* ioPSearch)
+	{
+	const SearchSpec& theSearchSpec = ioPSearch->fSearchSpec;
+
+	Plan thePlan;
+	this->pPlan(theSearchSpec.GetRestriction(), thePlan);
 
-	// We've got valsEqual filled in with stuff we're doing an equality search on, and
-	// may have a comparison in finalLo/finalHi.
+	const Util_Expr_Bool::CNF& theCNF = thePlan.fCNF;
+
+	// If thePlan has an index, we walk its keys starting with thePlan.fValsEqual, and perhaps
+	// within a range on the next column in thePlan.fLo/fHi.
 
 	const RelHead theRH_Wanted = RA::sRelHead(theSearchSpec.GetConcreteHead());
 
+	ioPSearch->fScanShape = ScanShape();
+	ioPSearch->fScanShape.fRelHead = theRH_Wanted;
+	spIndexableNames(theCNF,
+		ioPSearch->fScanShape.fNames_Equal, ioPSearch->fScanShape.fNames_Range);
+
 	RelHead theRH_Required, theRH_Optional;
 	RA::sRelHeads(theSearchSpec.GetConcreteHead(), theRH_Required, theRH_Optional);
 
@@ -672,28 +1579,32 @@ void Searcher_Datons::pSetupPSearch(PSearch* ioPSearch)
 		theSearchSpec.GetConcreteHead(),
 		sGetNames(theSearchSpec.GetRestriction()));
 
-	if (theRH_Wanted != sRelHead(ioPSearch->fConcreteHead))
-		{
-		// There were names in the restriction that aren't in
-		// the searchspec's CH, so we must project them out.
-		ioPSearch->fProjectionIfNecessary = theRH_Wanted;
-		}
+	// Rows are projected down to theRH_Wanted as they're added to fRows.
+	ioPSearch->fRelHead = theRH_Wanted;
 
-	if (true && bestIndex)
+	// Also get the Daton itself, so each daton produces a distinct row, which lets us
+	// count how many datons contribute to each projected row.
+	ioPSearch->fConcreteHead.insert(make_pair(string8(), false));
+
+	// Walker_Entries evaluates the whole restriction, and so needs every name.
+	ioPSearch->fConcreteHead_Entries = ioPSearch->fConcreteHead;
+
+	if (true && thePlan.fIndex)
 		{
-		ioPSearch->fIndex = bestIndex;
+		ioPSearch->fIndex = thePlan.fIndex;
 
-		sInsertBackMust(bestIndex->fPSearch_InIndex, ioPSearch);
-		ioPSearch->fValsEqual.swap(bestValsEqual);
-		ioPSearch->fRangeLo = bestLo;
-		ioPSearch->fRangeHi = bestHi;
-		ioPSearch->fRestrictionRemainder = sFromCNF(bestDClauses);
+		sInsertBackMust(thePlan.fIndex->fPSearch_InIndex, ioPSearch);
+		ioPSearch->fValsEqual.swap(thePlan.fValsEqual);
+		ioPSearch->fRangeLo = thePlan.fLo;
+		ioPSearch->fRangeHi = thePlan.fHi;
+		ioPSearch->fRestrictionRemainder = Util_Expr_Bool::sFromCNF(thePlan.fDClauses);
 
 		ioPSearch->fUsableIndexNames = ioPSearch->fValsEqual.size();
-		if (bestLo || bestHi)
+		if (thePlan.fLo || thePlan.fHi)
 			++ioPSearch->fUsableIndexNames;
 
-		// Remove the indexed names from theCH.
+		// Walker_Index provides the indexed names from the keys, so remove them from theCH. A
+		// hashed index's matches are walked by Walker_Entries, which uses fConcreteHead_Entries.
 		for (size_t xxColName = 0; xxColName < ioPSearch->fUsableIndexNames; ++xxColName)
 			sQErase(ioPSearch->fConcreteHead, ioPSearch->fIndex->fColNames[xxColName]);
 		}
@@ -701,7 +1612,8 @@ void Searcher_Datons::pSetupPSearch(PSearch* ioPSearch)
 
 static void spDump(const ChanW_UTF& ww,
 	const SearchSpec& theSearchSpec,
-	const vector<Searcher_Datons::Index*>& fIndexes)
+	const vector<Searcher_Datons::Index*>& fIndexes,
+	const vector<Searcher_Datons::Index::Set>& iSets)
 	{
 	ww << "\n" << "ConcreteHead: " << theSearchSpec.GetConcreteHead();
 	ww << "\n" << "Restriction: ";
@@ -710,16 +1622,21 @@ static void spDump(const ChanW_UTF& ww,
 
 	foreacha (anIndex, fIndexes)
 		{
-		ww << "\n" << anIndex->fSet.size() << " entries, indexed on: ";
+		if (anIndex->fHashed)
+			continue;
+
+		const Searcher_Datons::Index::Set& theSet = iSets[anIndex->fOrdinal];
+		ww << "\n" << theSet.size() << " entries, indexed on: ";
 		for (size_t xx = 0; xx < anIndex->fCount; ++xx)
 			ww << anIndex->fColNames[xx] << " ";
 
-		foreacha (entry, anIndex->fSet)
+		for (Searcher_Datons::Index::Set::const_iterator
+			iter = theSet.begin(), end = theSet.end(); iter != end; ++iter)
 			{
 			ww << "\n";
 			for (size_t xx = 0; xx < anIndex->fCount; ++xx)
-				ww << *(entry.fValues[xx]) << " ";
-			ww << "--> " << entry.fMapEntryP->second;
+				ww << *(iter.GetValues()[xx]) << " ";
+			ww << "--> " << iter.GetMapEntryP()->second.AsVal_ZZ();
 			}
 		}
 	}
@@ -780,6 +1697,8 @@ void Searcher_Datons::ModifyRegistrations(
 		sEraseMust(thePSearch->fClientSearch_InPSearch, theClientSearch);
 		if (sIsEmpty(thePSearch->fClientSearch_InPSearch))
 			{
+			if (thePSearch->fBuildID)
+				sEraseMust(kDebug, fBuilds_InFlight, thePSearch->fBuildID);
 			sQErase(fPSearch_NeedsWork, thePSearch);
 			sEraseMust(kDebug, fMap_SearchSpec_PSearch, thePSearch->fSearchSpec);
 			}
@@ -795,197 +1714,471 @@ void Searcher_Datons::ModifyRegistrations(
 		}
 	}
 
-namespace { // anonymous
-template <class PP>
-PP* spAllOnesPointer()
-	{ return reinterpret_cast<PP*>((char*)(0)-1); }
-} // anonymous namespace
-
-void Searcher_Datons::CollectResults(vector<SearchResult>& oChanged, int64& oChangeCount)
+// Adds iDelta to the count for each row iWalker produces, projected down to iRelHead.
+static void spAccumulate(ZP<QE::Walker> iWalker, const RelHead& iRelHead, int iDelta,
+	map<vector<Val_DB>,int>& ioCountDeltas)
 	{
-	Searcher::pCollectResultsCalled();
-
-	ZAcqMtx acq(fMtx);
+	map<string8,size_t> theOffsets;
+	size_t theBaseOffset = 0;
+	iWalker = iWalker->Prime(sDefault(), theOffsets, theBaseOffset);
+	if (not iWalker)
+		return;
+
+	vector<size_t> theRowOffsets;
+	theRowOffsets.reserve(iRelHead.size());
+	foreacha (entry, iRelHead)
+		theRowOffsets.push_back(sGetMust(theOffsets, entry));
+
+	const size_t kRowsPerBatch = 256;
+	vector<Val_DB> theVals(theBaseOffset * kRowsPerBatch);
+	vector<Val_DB> theRow(theRowOffsets.size());
+	for (;;)
+		{
+		const size_t theRead = iWalker->QReadBatch(theVals.data(), theBaseOffset, kRowsPerBatch);
+		for (size_t yy = 0; yy < theRead; ++yy)
+			{
+			const Val_DB* theVals_Row = theVals.data() + yy * theBaseOffset;
+			for (size_t xx = 0; xx < theRowOffsets.size(); ++xx)
+				theRow[xx] = theVals_Row[theRowOffsets[xx]];
+			ioCountDeltas[theRow] += iDelta;
+			}
 
-	oChanged.clear();
-	oChangeCount = fChangeCount;
+		if (theRead < kRowsPerBatch)
+			break;
+		}
+	}
 
-	for (DListEraser<PSearch,DLink_PSearch_NeedsWork> eraser = fPSearch_NeedsWork;
-		eraser; eraser.Advance())
+// =================================================================================================
+#pragma mark - Searcher_Datons::Build
+
+// The initial walk of a PSearch, done by CollectResults with fMtx released.
+
+struct Searcher_Datons::Build
+	{
+	PSearch* fPSearch;
+	uint64 fBuildID;
+	ZP<QE::Walker> fWalker;
+	RelHead fRelHead;
+
+	// Non-zero if fWalker walks every entry, rather than using an index.
+	uint64 fRowsScanned;
+
+	map<vector<Val_DB>,int> fCountDeltas;
+	double fElapsed;
+	std::exception_ptr fException;
+	};
+
+// =================================================================================================
+#pragma mark - Searcher_Datons
+
+ZP<QE::Walker> Searcher_Datons::pMakeWalker(const ZP<Store>& iStore, PSearch* iPSearch)
+	{
+	ZP<QE::Walker> theWalker;
+
+	if (iPSearch->fIndex && iPSearch->fIndex->fHashed)
 		{
-		PSearch* thePSearch = eraser.Current();
+		Index* theIndex = iPSearch->fIndex;
+		const Index::HashSet& theHashSet = iStore->GetHashSet(theIndex);
 
-		if (not thePSearch->fResult)
+		vector<const Val_DB*> theValsEqual;
+		foreacha (entry, iPSearch->fValsEqual)
+			theValsEqual.push_back(&entry);
+
+		const pair<Index::HashSet::const_iterator,Index::HashSet::const_iterator> theRange =
+			theHashSet.equal_range(QE::sHash(theValsEqual.data(), theIndex->fCount));
+
+		// Skip any whose hash merely collides.
+		MapEntries theMapEntries;
+		Key theKey;
+		for (Index::HashSet::const_iterator iter = theRange.first; iter != theRange.second; ++iter)
 			{
-			const SearchSpec& theSearchSpec = thePSearch->fSearchSpec;
+			if (theIndex->pAsKey(iter->second, theKey) && this->pKeyMatches(iPSearch, theKey))
+				theMapEntries.push_back(iter->second);
+			}
 
-			ZP<QE::Walker> theWalker;
+		theWalker = new Walker_Entries(this, iStore,
+			iPSearch->fConcreteHead_Entries, theMapEntries);
 
-			if (thePSearch->fIndex)
-				{
-				Index::Key theKey;
+		if (iPSearch->fRestrictionRemainder && iPSearch->fRestrictionRemainder != sTrue())
+			theWalker = new QE::Walker_Restrict(theWalker, iPSearch->fRestrictionRemainder);
+		}
+	else if (iPSearch->fIndex)
+		{
+		ZAssert(iPSearch->fValsEqual.size() <= iPSearch->fIndex->fCount);
 
-				const size_t countEqual = thePSearch->fValsEqual.size();
-				const size_t countAll = Key::kMaxCols;//thePSearch->fIndex->fCount;
-				ZAssert(countEqual <= countAll);
-				for (size_t xx = 0; xx < countEqual; ++xx)
-					theKey.fValues[xx] = &thePSearch->fValsEqual[xx];
+		Index::Set::const_iterator theBegin, theEnd;
+		iStore->GetSet(iPSearch->fIndex).Range(
+			iPSearch->fValsEqual, iPSearch->fRangeLo, iPSearch->fRangeHi, theBegin, theEnd);
 
-				for (size_t xx = countEqual + 1; xx < countAll; ++xx)
-					theKey.fValues[xx] = nullptr;
+		theWalker = new Walker_Index(this, iStore,
+			iPSearch->fIndex, iPSearch->fUsableIndexNames, iPSearch->fConcreteHead,
+			theBegin, theEnd);
 
-				Index::Set::const_iterator theBegin;
-				if (not thePSearch->fRangeLo)
-					{
-					theKey.fValues[countEqual] = nullptr;
-					theKey.fMapEntryP = nullptr;
-					theBegin = thePSearch->fIndex->fSet.lower_bound(theKey);
-					}
-				else
-					{
-					theKey.fValues[countEqual] = &thePSearch->fRangeLo->first;
-					if (thePSearch->fRangeLo->second)
-						{
-						theKey.fMapEntryP = nullptr;
-						theBegin = thePSearch->fIndex->fSet.lower_bound(theKey);
-						}
-					else
-						{
-						theKey.fMapEntryP = spAllOnesPointer<Map_Thing::value_type>();
-						theBegin = thePSearch->fIndex->fSet.upper_bound(theKey);
-						}
-					}
+		if (iPSearch->fRestrictionRemainder && iPSearch->fRestrictionRemainder != sTrue())
+			theWalker = new QE::Walker_Restrict(theWalker, iPSearch->fRestrictionRemainder);
+		}
+	else
+		{
+		theWalker = new Walker_Map(this, iStore, iPSearch->fConcreteHead);
 
-				Index::Set::const_iterator theEnd;
-				if (not thePSearch->fRangeHi)
-					{
-					theKey.fValues[countEqual] = nullptr;
-					theKey.fMapEntryP = spAllOnesPointer<Map_Thing::value_type>();
-					theEnd = thePSearch->fIndex->fSet.upper_bound(theKey);
-					}
-				else
-					{
-					theKey.fValues[countEqual] = &thePSearch->fRangeHi->first;
-					if (thePSearch->fRangeHi->second)
-						{
-						theKey.fMapEntryP = spAllOnesPointer<Map_Thing::value_type>();
-						theEnd = thePSearch->fIndex->fSet.upper_bound(theKey);
-						}
-					else
-						{
-						theKey.fMapEntryP = nullptr;
-						theEnd = thePSearch->fIndex->fSet.lower_bound(theKey);
-						}
-					}
+		const ZP<Expr_Bool>& theRestriction = iPSearch->fSearchSpec.GetRestriction();
+		if (theRestriction && theRestriction != sTrue())
+			theWalker = new QE::Walker_Restrict(theWalker, theRestriction);
+		}
 
-				theWalker = new Walker_Index(this,
-					thePSearch->fIndex, thePSearch->fUsableIndexNames, thePSearch->fConcreteHead,
-					theBegin, theEnd);
+	return theWalker;
+	}
 
-				if (thePSearch->fRestrictionRemainder && thePSearch->fRestrictionRemainder != sTrue())
-					theWalker = new QE::Walker_Restrict(theWalker, thePSearch->fRestrictionRemainder);
-				}
-			else
-				{
-				theWalker = new Walker_Map(this, thePSearch->fConcreteHead);
+void Searcher_Datons::pInstall(Build& ioBuild)
+	{
+	PSearch* thePSearch = ioBuild.fPSearch;
+	const SearchSpec& theSearchSpec = thePSearch->fSearchSpec;
 
-				const ZP<Expr_Bool>& theRestriction = theSearchSpec.GetRestriction();
-				if (theRestriction && theRestriction != sTrue())
-					theWalker = new QE::Walker_Restrict(theWalker, theRestriction);
-				}
+	thePSearch->fBuildID = 0;
 
-			if (sNotEmpty(thePSearch->fProjectionIfNecessary))
-				theWalker = new QE::Walker_Project(theWalker, thePSearch->fProjectionIfNecessary);
+	if (ioBuild.fException)
+		{
+		// Try again next time.
+		thePSearch->fBuild_Asserted.clear();
+		thePSearch->fBuild_Retracted.clear();
+		sQInsertBack(fPSearch_NeedsWork, thePSearch);
+		return;
+		}
 
-			const double start = Time::sSystem();
+	thePSearch->fRows.clear();
+	thePSearch->fSlots.clear();
+	thePSearch->fTouchedSlots.clear();
 
-			thePSearch->fResult = QE::sResultFromWalker(theWalker);
+	this->pUpdateRows(thePSearch, ioBuild.fCountDeltas);
 
-			const double elapsed = Time::sSystem() - start;
+	// Bring in what MakeChanges did while the walk was in progress.
+	if (sNotEmpty(thePSearch->fBuild_Asserted) || sNotEmpty(thePSearch->fBuild_Retracted))
+		{
+		MapEntries theAsserted;
+		foreacha (entry, thePSearch->fBuild_Asserted)
+			theAsserted.push_back(&entry);
 
-			if (elapsed > 10e-3)
-				{
-				if (ZLOGPF(ww, eDebug))
-					{
-					ww << "\nSlow PSearch " << elapsed * 1e3 << "ms: ";
-					Visitor_Expr_Bool_ValPred_DB_ToStrim()
-						.ToStrim(ww, sDefault(), theSearchSpec.GetRestriction());
-					if (thePSearch->fRestrictionRemainder)
-						{
-						ww << "\nRestrictionRemainder: ";
-						Visitor_Expr_Bool_ValPred_DB_ToStrim()
-							.ToStrim(ww, sDefault(), thePSearch->fRestrictionRemainder);
-						}
+		MapEntries theRetracted;
+		foreacha (entry, thePSearch->fBuild_Retracted)
+			theRetracted.push_back(&entry);
 
-					ww << "\n";
-					sToStrim(ww, thePSearch->fResult);
+		this->pApplyChanges(thePSearch, theAsserted, theRetracted);
 
-					sDumpWalkers(ww, theWalker);
-					}
+		thePSearch->fBuild_Asserted.clear();
+		thePSearch->fBuild_Retracted.clear();
+		}
+
+	this->pPublish(thePSearch);
+
+	if (ioBuild.fRowsScanned)
+		this->pRecordScan(thePSearch, ioBuild.fRowsScanned, ioBuild.fElapsed);
+
+	if (ioBuild.fElapsed > 10e-3)
+		{
+		if (ZLOGPF(ww, eDebug))
+			{
+			ww << "\nSlow PSearch " << ioBuild.fElapsed * 1e3 << "ms: ";
+			Visitor_Expr_Bool_ValPred_DB_ToStrim()
+				.ToStrim(ww, sDefault(), theSearchSpec.GetRestriction());
+			if (thePSearch->fRestrictionRemainder)
+				{
+				ww << "\nRestrictionRemainder: ";
+				Visitor_Expr_Bool_ValPred_DB_ToStrim()
+					.ToStrim(ww, sDefault(), thePSearch->fRestrictionRemainder);
 				}
 
+			ww << "\n";
+			sToStrim(ww, thePSearch->fResult);
+
+			sDumpWalkers(ww, ioBuild.fWalker);
+			}
+		}
+
+	for (DListIterator<ClientSearch, DLink_ClientSearch_InPSearch>
+		iter = thePSearch->fClientSearch_InPSearch; iter; iter.Advance())
+		{ sQInsertBack(fClientSearch_NeedsWork, iter.Current()); }
+	}
+
+void Searcher_Datons::CollectResults(vector<SearchResult>& oChanged, int64& oChangeCount)
+	{
+	Searcher::pCollectResultsCalled();
+
+	// Declared ahead of acq, so the walkers and any Store only they were holding are
+	// disposed of after fMtx has been released.
+	vector<Build> theBuilds;
+	ZP<Store> theStore;
+
+	ZAcqMtx acq(fMtx);
+
+	oChanged.clear();
+
+	for (DListEraser<PSearch,DLink_PSearch_NeedsWork> eraser = fPSearch_NeedsWork;
+		eraser; eraser.Advance())
+		{
+		PSearch* thePSearch = eraser.Current();
+
+		if (thePSearch->fResult)
+			{
+			// MakeChanges has already brought fRows up to date.
+			this->pPublish(thePSearch);
+
 			for (DListIterator<ClientSearch, DLink_ClientSearch_InPSearch>
 				iter = thePSearch->fClientSearch_InPSearch; iter; iter.Advance())
 				{ sQInsertBack(fClientSearch_NeedsWork, iter.Current()); }
 			}
+		else if (not thePSearch->fBuildID)
+			{
+			if (not theStore)
+				theStore = fStore;
+
+			thePSearch->fBuildID = ++fNextBuildID;
+			sInsertMust(kDebug, fBuilds_InFlight, thePSearch->fBuildID, thePSearch);
+
+			Build theBuild;
+			theBuild.fPSearch = thePSearch;
+			theBuild.fBuildID = thePSearch->fBuildID;
+			theBuild.fWalker = this->pMakeWalker(theStore, thePSearch);
+			theBuild.fRelHead = thePSearch->fRelHead;
+			theBuild.fRowsScanned = thePSearch->fIndex ? 0 : theStore->fMap_Thing.size();
+			theBuild.fElapsed = 0;
+			theBuilds.push_back(theBuild);
+			}
 		}
 
+	if (sNotEmpty(theBuilds))
+		{
+		// Walk the pinned store with fMtx released. MakeChanges can carry on meanwhile,
+		// it will copy the Store rather than change this one.
+		{
+		ZRelMtx rel(fMtx);
+
+		// Builds only touch their walker and their own fields, never the PSearch.
+		sForEach_Parallel(theBuilds.size(), [&theBuilds](size_t iIndex)
+			{
+			Build& theBuild = theBuilds[iIndex];
+			const double start = Time::sSystem();
+			try
+				{ spAccumulate(theBuild.fWalker, theBuild.fRelHead, 1, theBuild.fCountDeltas); }
+			catch (...)
+				{ theBuild.fException = std::current_exception(); }
+			theBuild.fElapsed = Time::sSystem() - start;
+			});
+		}
+
+		foreacha (entry, theBuilds)
+			{
+			// If the PSearch was removed while we were walking, there's nothing to do.
+			if (ZQ<PSearch*> theQ = sQGetErase(fBuilds_InFlight, entry.fBuildID))
+				this->pInstall(entry);
+			}
+		}
+
+	oChangeCount = fChangeCount;
+
 	for (DListEraser<ClientSearch,DLink_ClientSearch_NeedsWork> eraser = fClientSearch_NeedsWork;
 		eraser; eraser.Advance())
 		{
 		ClientSearch* theClientSearch = eraser.Current();
 		PSearch* thePSearch = theClientSearch->fPSearch;
-		oChanged.push_back(SearchResult(theClientSearch->fRefcon, thePSearch->fResult));
+
+		if (not thePSearch->fResult)
+			{
+			// Its PSearch is being walked by another CollectResults, which will queue it again.
+			continue;
+			}
+
+		ZP<QE::ResultDeltas> theResultDeltas;
+		if (theClientSearch->fResultSent && theClientSearch->fResultSent == thePSearch->fResultPrior)
+			theResultDeltas = thePSearch->fResultDeltas;
+
+		theClientSearch->fResultSent = thePSearch->fResult;
+
+		oChanged.push_back(
+			SearchResult(theClientSearch->fRefcon, thePSearch->fResult, theResultDeltas));
 		}
 	}
 
+ZQ<QE::Estimate> Searcher_Datons::QEstimate(
+	const SearchSpec& iSearchSpec, const RelHead& iBoundNames)
+	{
+	// Bound names get a stand-in value, so they're matched to indexes like any constant, and
+	// pPlan falls back on statistics for how many keys they'd find.
+	ZP<Expr_Bool> theRestriction = iSearchSpec.GetRestriction();
+	if (theRestriction && sNotEmpty(iBoundNames))
+		theRestriction = DoReplaceNames(iBoundNames, Unbound_t()).Do(theRestriction);
+
+	ZAcqMtx acq(fMtx);
+
+	Plan thePlan;
+	this->pPlan(theRestriction, thePlan);
+
+	string8 thePlanText = "scan";
+	if (const Index* theIndex = thePlan.fIndex)
+		{
+		thePlanText = theIndex->fHashed ? "hashed index " : "index ";
+		for (size_t xx = 0; xx < theIndex->fCount; ++xx)
+			{
+			if (xx)
+				thePlanText += ",";
+			thePlanText += theIndex->fColNames[xx];
+			}
+		}
+
+	return QE::Estimate(thePlan.fCount, thePlan.fCost, thePlanText);
+	}
+
 int64 Searcher_Datons::MakeChanges(
 	const Daton* iAsserted, size_t iAssertedCount,
 	const Daton* iRetracted, size_t iRetractedCount)
 	{
 	ZAcqMtx acq(fMtx);
 
+	// Log the batch before making it, so a failure to log leaves everything untouched.
+	if (fJournal && (iAssertedCount || iRetractedCount))
+		fJournal->Append(iAsserted, iAssertedCount, iRetracted, iRetractedCount);
+
 	ThreadVal_NameUniquifier theTVNU;
 	theTVNU.Mut().GetStorage().swap(fUniquifiedNames);
 
+	// If CollectResults is walking the current Store, leave it be and work on a copy.
+	if ((iAssertedCount || iRetractedCount) && fStore->IsShared())
+		fStore = new Store(*fStore);
+
+	Map_Thing& theMap_Thing = fStore->fMap_Thing;
+
+	// Datons that actually went into or out of theMap_Thing. Retracted entries are kept
+	// in theRetracted so searches can still work out what rows they had contributed.
+	std::unordered_set<Daton> theAsserted;
+	Map_Thing theRetracted;
+
+	theMap_Thing.reserve(theMap_Thing.size() + iAssertedCount);
+
 	while (iAssertedCount--)
 		{
-		const Daton theDaton = *iAsserted++;
-		Map_Thing::iterator iterLB = fMap_Thing.lower_bound(theDaton);
-
-		if (iterLB == fMap_Thing.end() || theDaton != iterLB->first)
+		const Daton& theDaton = *iAsserted++;
+		if (theMap_Thing.find(theDaton) == theMap_Thing.end())
 			{
-			Map_Thing::const_iterator iter =
-				fMap_Thing.insert(iterLB, make_pair(theDaton, sAsVal(theDaton)));
-			this->pIndexInsert(&*iter);
+			// Only decode Datons we don't already have.
+			theMap_Thing.insert(make_pair(theDaton, sAsVal_JSONB(theDaton)));
+			theAsserted.insert(theDaton);
 			}
 		}
 
 	while (iRetractedCount--)
 		{
-		const Daton theDaton = *iRetracted++;
-		Map_Thing::iterator iter = fMap_Thing.find(theDaton);
-		if (iter != fMap_Thing.end())
+		const Daton& theDaton = *iRetracted++;
+		Map_Thing::iterator iter = theMap_Thing.find(theDaton);
+		if (iter != theMap_Thing.end())
 			{
-			this->pIndexErase(&*iter);
-			fMap_Thing.erase(iter);
+			// Datons asserted by this call haven't been indexed yet.
+			if (not sQErase(theAsserted, theDaton))
+				{
+				this->pIndexErase(&*iter);
+				theRetracted.insert(*iter);
+				}
+			theMap_Thing.erase(iter);
 			}
 		}
 
-	// Invalidate all PSearches unattached to indexes.
-	for (Map_SearchSpec_PSearch::iterator
-		iter = fMap_SearchSpec_PSearch.begin(), end = fMap_SearchSpec_PSearch.end();
-		iter != end; ++iter)
+	if (fIndexBuild_InFlight)
 		{
-		if (not iter->second.fIndex)
+		foreacha (entry, theAsserted)
+			fIndexBuild_Touched.insert(entry);
+		foreacha (entry, theRetracted)
+			fIndexBuild_Touched.insert(entry.first);
+		}
+
+	if (sNotEmpty(theAsserted) || sNotEmpty(theRetracted))
+		{
+		MapEntries theAssertedEntries;
+		theAssertedEntries.reserve(theAsserted.size());
+		foreacha (entry, theAsserted)
+			theAssertedEntries.push_back(&*theMap_Thing.find(entry));
+
+		this->pIndexInsert(theAssertedEntries);
+
+		MapEntries theRetractedEntries;
+		theRetractedEntries.reserve(theRetracted.size());
+		foreacha (entry, theRetracted)
+			theRetractedEntries.push_back(&entry);
+
+		// PSearches that have never been walked will be walked in full by CollectResults.
+		// The others get just the changed entries that could possibly affect them -- applied
+		// now if they have a result, or held until their walk is done if one's in progress.
+		Key theKey;
+		for (Map_SearchSpec_PSearch::iterator
+			iter = fMap_SearchSpec_PSearch.begin(), end = fMap_SearchSpec_PSearch.end();
+			iter != end; ++iter)
 			{
-			iter->second.fResult.Clear();
-			sQInsertBack(fPSearch_NeedsWork, &iter->second);
+			PSearch* thePSearch = &iter->second;
+			if (not thePSearch->fResult && not thePSearch->fBuildID)
+				continue;
+
+			const MapEntries* theAssertedP = &theAssertedEntries;
+			const MapEntries* theRetractedP = &theRetractedEntries;
+
+			MapEntries theAssertedInRange;
+			MapEntries theRetractedInRange;
+			if (thePSearch->fIndex)
+				{
+				foreacha (entry, theAssertedEntries)
+					{
+					if (thePSearch->fIndex->pAsKey(entry, theKey)
+						&& this->pKeyMatches(thePSearch, theKey))
+						{ theAssertedInRange.push_back(entry); }
+					}
+
+				foreacha (entry, theRetractedEntries)
+					{
+					if (thePSearch->fIndex->pAsKey(entry, theKey)
+						&& this->pKeyMatches(thePSearch, theKey))
+						{ theRetractedInRange.push_back(entry); }
+					}
+
+				theAssertedP = &theAssertedInRange;
+				theRetractedP = &theRetractedInRange;
+				}
+
+			if (thePSearch->fBuildID)
+				{
+				foreacha (entry, *theAssertedP)
+					thePSearch->fBuild_Asserted.push_back(*entry);
+				foreacha (entry, *theRetractedP)
+					thePSearch->fBuild_Retracted.push_back(*entry);
+				}
+			else if (this->pApplyChanges(thePSearch, *theAssertedP, *theRetractedP))
+				{
+				sQInsertBack(fPSearch_NeedsWork, thePSearch);
+				}
 			}
 		}
 
 	int64 theChangeCount = ++fChangeCount;
 
+	if (fJournal && fSnapshotThreshold && not fSnapshot_InFlight
+		&& fJournal->GetAppendedSinceGeneration() >= fSnapshotThreshold)
+		{
+		ZP<Searcher_Datons> theSearcher = this;
+		fSnapshot_InFlight = true;
+		if (not sStarter_EachOnNewThread()->QStart(sCallable([theSearcher]()
+			{
+			try
+				{
+				theSearcher->WriteSnapshot();
+				}
+			catch (std::exception& ex)
+				{
+				if (ZLOGF(w, eErr))
+					w << "Failed to write snapshot: " << ex.what();
+				}
+			ZAcqMtx acq(theSearcher->fMtx);
+			theSearcher->fSnapshot_InFlight = false;
+			})))
+			{
+			fSnapshot_InFlight = false;
+			}
+		}
+
 	if (sNotEmpty(fClientSearch_NeedsWork) || sNotEmpty(fPSearch_NeedsWork))
 		{
 		ZRelMtx rel(fMtx);
@@ -997,97 +2190,529 @@ int64 Searcher_Datons::MakeChanges(
 	return theChangeCount;
 	}
 
-void Searcher_Datons::pInvalidateSearchIfAppropriate(PSearch* iPSearch, const Key& iKey)
+std::map<Searcher_Datons::ScanShape,Searcher_Datons::ScanStats> Searcher_Datons::GetScanStats()
 	{
-	if (iPSearch->fResult && not sContains(fPSearch_NeedsWork, iPSearch))
-		{
-		// We will invalidate only if iKey matches iPSearch.
-		const size_t countEqual = iPSearch->fValsEqual.size();
+	ZAcqMtx acq(fMtx);
+	return fScanStats;
+	}
 
-		bool allMatch = true;
+void Searcher_Datons::SetAutoIndexThreshold(size_t iScanCount)
+	{
+	ZAcqMtx acq(fMtx);
+	fAutoIndexThreshold = iScanCount;
+	}
 
-		if (allMatch)
+void Searcher_Datons::SetJournal(const ZP<Journal_Datons>& iJournal)
+	{
+	const vector<Daton> theDatons = iJournal->Load();
+
+	ZAcqMtx acq(fMtx);
+
+	ZAssert(not fJournal);
+	ZAssert(fStore->fMap_Thing.empty() && fMap_SearchSpec_PSearch.empty());
+
+	fJournal = iJournal;
+
+	ThreadVal_NameUniquifier theTVNU;
+	theTVNU.Mut().GetStorage().swap(fUniquifiedNames);
+
+	fStore = new Store(fIndexes);
+
+	Map_Thing& theMap_Thing = fStore->fMap_Thing;
+	theMap_Thing.reserve(theDatons.size());
+	foreacha (entry, theDatons)
+		theMap_Thing.insert(make_pair(entry, sAsVal_JSONB(entry)));
+
+	// Rather than inserting keys one at a time, extract every index's keys, order them if
+	// it's an ordered index, and build the index from them in one go.
+	vector<Key> theKeys;
+	theKeys.reserve(theMap_Thing.size());
+	foreacha (anIndex, fIndexes)
+		{
+		theKeys.clear();
+		Key theKey;
+		foreacha (entry, theMap_Thing)
 			{
-			if (iPSearch->fRangeLo)
+			if (anIndex->pAsKey(&entry, theKey))
+				theKeys.push_back(theKey);
+			}
+
+		if (anIndex->fHashed)
+			{
+			Index::HashSet& theHashSet = fStore->GetHashSet(anIndex);
+			theHashSet.reserve(theKeys.size());
+			foreacha (entry, theKeys)
 				{
-				if (iPSearch->fRangeLo->second)
-					allMatch = iPSearch->fRangeLo->first <= *iKey.fValues[countEqual];
-				else
-					allMatch = iPSearch->fRangeLo->first < *iKey.fValues[countEqual];
+				theHashSet.insert(make_pair(
+					QE::sHash(entry.fValues.data(), anIndex->fCount), entry.fMapEntryP));
 				}
 			}
+		else
+			{
+			Index::Set& theSet = fStore->GetSet(anIndex);
+			std::sort(theKeys.begin(), theKeys.end(),
+				[&theSet](const Key& iLeft, const Key& iRight)
+					{ return theSet.Less(iLeft, iRight); });
+			theSet.Assign(theKeys);
+			}
+		}
+
+	theTVNU.Mut().GetStorage().swap(fUniquifiedNames);
+	}
 
-		if (allMatch)
+void Searcher_Datons::WriteSnapshot()
+	{
+	ZP<Journal_Datons> theJournal;
+	uint64 theGeneration;
+	vector<Daton> theDatons;
+	{
+	// Pin the Store at the point the new log starts, and release it as soon as we've
+	// got its Datons, so MakeChanges only has to copy it if it's called meanwhile.
+	ZP<Store> theStore;
+	{
+	ZAcqMtx acq(fMtx);
+	if (not fJournal)
+		return;
+	theJournal = fJournal;
+	theGeneration = fJournal->StartGeneration();
+	theStore = fStore;
+	}
+
+	theDatons.reserve(theStore->fMap_Thing.size());
+	foreacha (entry, theStore->fMap_Thing)
+		theDatons.push_back(entry.first);
+	}
+
+	theJournal->WriteSnapshot(theGeneration, theDatons);
+	}
+
+void Searcher_Datons::SetSnapshotThreshold(uint64 iLogBytes)
+	{
+	ZAcqMtx acq(fMtx);
+	fSnapshotThreshold = iLogBytes;
+	}
+
+void Searcher_Datons::pRecordScan(PSearch* iPSearch, uint64 iRowsScanned, double iElapsed)
+	{
+	ScanStats& theStats = fScanStats[iPSearch->fScanShape];
+
+	if (not theStats.fCount)
+		{
+		// First time we've seen this shape, work out what would serve it. Equality alone can
+		// use a hashed index, equality and a range needs an ordered index whose last column
+		// is the range. A restriction that compares no names can't be helped by any index.
+		const ScanShape& theShape = iPSearch->fScanShape;
+		vector<ColName> theColNames(theShape.fNames_Equal.begin(), theShape.fNames_Equal.end());
+		if (sNotEmpty(theShape.fNames_Range))
+			{
+			theColNames.push_back(*theShape.fNames_Range.begin());
+			theStats.fSuggestion = IndexSpec(theColNames, false);
+			}
+		else if (sNotEmpty(theColNames))
+			{
+			theStats.fSuggestion = IndexSpec(theColNames, true);
+			}
+		}
+
+	++theStats.fCount;
+	theStats.fRowsScanned += iRowsScanned;
+	theStats.fElapsed += iElapsed;
+
+	if (not fAutoIndexThreshold
+		|| theStats.fCount < fAutoIndexThreshold
+		|| not theStats.fSuggestion
+		|| theStats.fIndexAdded
+		|| fIndexBuild_InFlight)
+		{ return; }
+
+	theStats.fIndexAdded = true;
+
+	foreacha (anIndex, fIndexes)
+		{
+		if (anIndex->fColNames == theStats.fSuggestion->GetColNames()
+			&& anIndex->fHashed == theStats.fSuggestion->IsHashed())
+			{
+			// We already have it, it must be the restriction's form that stops it being used.
+			return;
+			}
+		}
+
+	ZP<Searcher_Datons> theSearcher = this;
+	ZP<Store> theStore = fStore;
+	const IndexSpec theIndexSpec = *theStats.fSuggestion;
+
+	fIndexBuild_InFlight = true;
+	if (not sStarter_EachOnNewThread()->QStart(sCallable([theSearcher, theStore, theIndexSpec]()
+		{ theSearcher->pBuildIndex(theIndexSpec, theStore); })))
+		{
+		fIndexBuild_InFlight = false;
+		}
+	}
+
+void Searcher_Datons::pBuildIndex(const IndexSpec& iIndexSpec, const ZP<Store>& iStore)
+	{
+	// Extract and order the keys from iStore, which MakeChanges leaves alone, without fMtx.
+	const Index theProbe(iIndexSpec, 0);
+
+	vector<Key> theKeys;
+	Key theKey;
+	try
+		{
+		foreacha (entry, iStore->fMap_Thing)
+			{
+			if (theProbe.pAsKey(&entry, theKey))
+				theKeys.push_back(theKey);
+			}
+
+		if (not theProbe.fHashed)
+			{
+			const Index::Set theSet(theProbe.fCount);
+			std::sort(theKeys.begin(), theKeys.end(),
+				[&theSet](const Key& iLeft, const Key& iRight)
+					{ return theSet.Less(iLeft, iRight); });
+			}
+		}
+	catch (...)
+		{
+		ZAcqMtx acq(fMtx);
+		fIndexBuild_Touched.clear();
+		fIndexBuild_InFlight = false;
+		return;
+		}
+
+	ZAcqMtx acq(fMtx);
+
+	// The new Set goes into fStore, so get one that no walk is using.
+	if (fStore->IsShared())
+		fStore = new Store(*fStore);
+
+	Map_Thing& theMap_Thing = fStore->fMap_Thing;
+
+	// Datons untouched since iStore was pinned have the same decoded values in fStore, so
+	// their keys just need pointing at fStore's entries. The touched ones are redone.
+	vector<Key> theKeys_Touched;
+	foreacha (entry, fIndexBuild_Touched)
+		{
+		Map_Thing::iterator iter = theMap_Thing.find(entry);
+		if (iter != theMap_Thing.end() && theProbe.pAsKey(&*iter, theKey))
+			theKeys_Touched.push_back(theKey);
+		}
+
+	Index* theIndex;
+	if (theProbe.fHashed)
+		{
+		Index::HashSet theHashSet;
+		foreacha (entry, theKeys)
 			{
-			if (iPSearch->fRangeHi)
+			if (not sContains(fIndexBuild_Touched, entry.fMapEntryP->first))
 				{
-				if (iPSearch->fRangeHi->second)
-					allMatch = iPSearch->fRangeHi->first >= *iKey.fValues[countEqual];
-				else
-					allMatch = iPSearch->fRangeHi->first > *iKey.fValues[countEqual];
+				theHashSet.insert(make_pair(QE::sHash(entry.fValues.data(), theProbe.fCount),
+					&*theMap_Thing.find(entry.fMapEntryP->first)));
 				}
 			}
 
-		if (allMatch)
+		foreacha (entry, theKeys_Touched)
+			{
+			theHashSet.insert(make_pair(QE::sHash(entry.fValues.data(), theProbe.fCount),
+				entry.fMapEntryP));
+			}
+
+		theIndex = new Index(iIndexSpec, fStore->fHashSets.size());
+		fStore->fHashSets.push_back(theHashSet);
+		}
+	else
+		{
+		// Pointing a key at fStore's entry for the same Daton doesn't change its order.
+		vector<Key> theKeys_Untouched;
+		theKeys_Untouched.reserve(theKeys.size());
+		foreacha (entry, theKeys)
 			{
-			for (size_t xx = countEqual; xx > 0;)
+			if (not sContains(fIndexBuild_Touched, entry.fMapEntryP->first))
 				{
-				--xx;
-				if (*iKey.fValues[xx] != iPSearch->fValsEqual[xx])
-					{
-					allMatch = false;
-					break;
-					}
+				entry.fMapEntryP = &*theMap_Thing.find(entry.fMapEntryP->first);
+				theKeys_Untouched.push_back(entry);
 				}
 			}
 
-		// We're ignoring iPSearch->fRestrictionRemainder, so we will have some false positives.
+		Index::Set theSet(theProbe.fCount);
+		theSet.Assign(theKeys_Untouched);
+
+		foreacha (entry, theKeys_Touched)
+			theSet.Insert(entry);
+
+		theIndex = new Index(iIndexSpec, fStore->fSets.size());
+		fStore->fSets.push_back(theSet);
+		}
 
-		if (allMatch)
+	fIndexes.push_back(theIndex);
+
+	fIndexBuild_Touched.clear();
+	fIndexBuild_InFlight = false;
+
+	// Searches that were walking everything may be able to use the new index. Those that
+	// already have results aren't affected, except that MakeChanges can filter changes for them.
+	for (Map_SearchSpec_PSearch::iterator
+		iter = fMap_SearchSpec_PSearch.begin(), end = fMap_SearchSpec_PSearch.end();
+		iter != end; ++iter)
+		{
+		PSearch* thePSearch = &iter->second;
+		if (not thePSearch->fIndex)
+			this->pSetupPSearch(thePSearch);
+		}
+	}
+
+bool Searcher_Datons::pKeyMatches(PSearch* iPSearch, const Key& iKey)
+	{
+	// We're ignoring iPSearch->fRestrictionRemainder, Walker_Entries will evaluate it.
+	const size_t countEqual = iPSearch->fValsEqual.size();
+
+	if (iPSearch->fRangeLo)
+		{
+		if (iPSearch->fRangeLo->second)
 			{
-			sQInsertBack(fPSearch_NeedsWork, iPSearch);
-			iPSearch->fResult.Clear();
+			if (not (iPSearch->fRangeLo->first <= *iKey.fValues[countEqual]))
+				return false;
 			}
+		else
+			{
+			if (not (iPSearch->fRangeLo->first < *iKey.fValues[countEqual]))
+				return false;
+			}
+		}
+
+	if (iPSearch->fRangeHi)
+		{
+		if (iPSearch->fRangeHi->second)
+			{
+			if (not (iPSearch->fRangeHi->first >= *iKey.fValues[countEqual]))
+				return false;
+			}
+		else
+			{
+			if (not (iPSearch->fRangeHi->first > *iKey.fValues[countEqual]))
+				return false;
+			}
+		}
+
+	for (size_t xx = countEqual; xx > 0;)
+		{
+		--xx;
+		if (*iKey.fValues[xx] != iPSearch->fValsEqual[xx])
+			return false;
 		}
+
+	return true;
 	}
 
-void Searcher_Datons::pIndexInsert(const Map_Thing::value_type* iMapEntryP)
+void Searcher_Datons::pIndexInsert(const MapEntries& iMapEntries)
 	{
+	vector<Key> theKeys;
+	theKeys.reserve(iMapEntries.size());
+
 	foreacha (anIndex, fIndexes)
 		{
+		theKeys.clear();
 		Key theKey;
-		if (anIndex->pAsKey(iMapEntryP, theKey))
+		foreacha (entry, iMapEntries)
+			{
+			if (anIndex->pAsKey(entry, theKey))
+				theKeys.push_back(theKey);
+			}
+
+		if (anIndex->fHashed)
 			{
-			sInsertMust(anIndex->fSet, theKey);
-			for (DListIterator<PSearch,DLink_PSearch_InIndex> iter = anIndex->fPSearch_InIndex;
-				iter; iter.Advance())
+			Index::HashSet& theHashSet = fStore->GetHashSet(anIndex);
+			foreacha (entry, theKeys)
 				{
-				this->pInvalidateSearchIfAppropriate(iter.Current(), theKey);
+				theHashSet.insert(make_pair(
+					QE::sHash(entry.fValues.data(), anIndex->fCount), entry.fMapEntryP));
 				}
 			}
+		else
+			{
+			// Inserting in order means each key goes near the end of a leaf, and consecutive
+			// keys go into the same leaf, so there's little to move and the leaf stays in cache.
+			Index::Set& theSet = fStore->GetSet(anIndex);
+			std::sort(theKeys.begin(), theKeys.end(),
+				[&theSet](const Key& iLeft, const Key& iRight)
+					{ return theSet.Less(iLeft, iRight); });
+
+			foreacha (entry, theKeys)
+				theSet.Insert(entry);
+			}
 		}
 	}
 
 void Searcher_Datons::pIndexErase(const Map_Thing::value_type* iMapEntryP)
 	{
+	Key theKey;
 	foreacha (anIndex, fIndexes)
 		{
-		Key theKey;
-		if (anIndex->pAsKey(iMapEntryP, theKey))
+		if (not anIndex->pAsKey(iMapEntryP, theKey))
+			continue;
+
+		if (anIndex->fHashed)
+			{
+			Index::HashSet& theHashSet = fStore->GetHashSet(anIndex);
+			const pair<Index::HashSet::iterator,Index::HashSet::iterator> theRange =
+				theHashSet.equal_range(QE::sHash(theKey.fValues.data(), anIndex->fCount));
+
+			Index::HashSet::iterator iter = theRange.first;
+			while (iter != theRange.second && iter->second != iMapEntryP)
+				++iter;
+
+			ZAssert(iter != theRange.second);
+			theHashSet.erase(iter);
+			}
+		else
+			{
+			fStore->GetSet(anIndex).EraseMust(theKey);
+			}
+		}
+	}
+
+bool Searcher_Datons::pApplyChanges(PSearch* ioPSearch,
+	const MapEntries& iAsserted, const MapEntries& iRetracted)
+	{
+	const ZP<Expr_Bool>& theRestriction = ioPSearch->fSearchSpec.GetRestriction();
+	const bool restricted = theRestriction && theRestriction != sTrue();
+
+	map<vector<Val_DB>,int> theCountDeltas;
+
+	if (sNotEmpty(iAsserted))
+		{
+		ZP<QE::Walker> theWalker =
+			new Walker_Entries(this, null, ioPSearch->fConcreteHead_Entries, iAsserted);
+		if (restricted)
+			theWalker = new QE::Walker_Restrict(theWalker, theRestriction);
+		spAccumulate(theWalker, ioPSearch->fRelHead, 1, theCountDeltas);
+		}
+
+	if (sNotEmpty(iRetracted))
+		{
+		ZP<QE::Walker> theWalker =
+			new Walker_Entries(this, null, ioPSearch->fConcreteHead_Entries, iRetracted);
+		if (restricted)
+			theWalker = new QE::Walker_Restrict(theWalker, theRestriction);
+		spAccumulate(theWalker, ioPSearch->fRelHead, -1, theCountDeltas);
+		}
+
+	return this->pUpdateRows(ioPSearch, theCountDeltas);
+	}
+
+bool Searcher_Datons::pUpdateRows(PSearch* ioPSearch,
+	const map<vector<Val_DB>,int>& iCountDeltas)
+	{
+	PSearch::Map_Rows& theRows = ioPSearch->fRows;
+	vector<PSearch::Map_Rows::iterator>& theSlots = ioPSearch->fSlots;
+
+	vector<PSearch::Map_Rows::iterator> theAdded;
+	vector<size_t> theFreedSlots;
+
+	foreacha (entry, iCountDeltas)
+		{
+		const int theDelta = entry.second;
+		if (not theDelta)
+			continue;
+
+		PSearch::Map_Rows::iterator iter = theRows.lower_bound(entry.first);
+		if (iter == theRows.end() || iter->first != entry.first)
+			{
+			ZAssert(theDelta > 0);
+			const PSearch::RowInfo theRowInfo = { size_t(theDelta), size_t(-1) };
+			theAdded.push_back(theRows.insert(iter, make_pair(entry.first, theRowInfo)));
+			}
+		else if (theDelta > 0)
 			{
-			sEraseMust(anIndex->fSet, theKey);
-			for (DListIterator<PSearch,DLink_PSearch_InIndex> iter = anIndex->fPSearch_InIndex;
-				iter; iter.Advance())
+			iter->second.fCount += theDelta;
+			}
+		else
+			{
+			ZAssert(iter->second.fCount >= size_t(-theDelta));
+			iter->second.fCount -= size_t(-theDelta);
+			if (not iter->second.fCount)
 				{
-				this->pInvalidateSearchIfAppropriate(iter.Current(), theKey);
+				theFreedSlots.push_back(iter->second.fSlot);
+				theRows.erase(iter);
 				}
 			}
 		}
+
+	// New rows reuse freed slots first, so a replaced row keeps its position.
+	foreacha (entry, theAdded)
+		{
+		size_t theSlot;
+		if (sNotEmpty(theFreedSlots))
+			{
+			theSlot = theFreedSlots.back();
+			theFreedSlots.pop_back();
+			theSlots[theSlot] = entry;
+			}
+		else
+			{
+			theSlot = theSlots.size();
+			theSlots.push_back(entry);
+			}
+		entry->second.fSlot = theSlot;
+		ioPSearch->fTouchedSlots.insert(theSlot);
+		}
+
+	// Fill any remaining holes from the end, highest first so that what we move from the
+	// end is never itself a hole.
+	std::sort(theFreedSlots.begin(), theFreedSlots.end(), std::greater<size_t>());
+	foreacha (theSlot, theFreedSlots)
+		{
+		const size_t theLast = theSlots.size() - 1;
+		if (theSlot != theLast)
+			{
+			theSlots[theSlot] = theSlots[theLast];
+			theSlots[theSlot]->second.fSlot = theSlot;
+			ioPSearch->fTouchedSlots.insert(theSlot);
+			}
+		theSlots.pop_back();
+		}
+
+	return sNotEmpty(theAdded) || sNotEmpty(theFreedSlots) || sNotEmpty(ioPSearch->fTouchedSlots);
+	}
+
+void Searcher_Datons::pPublish(PSearch* ioPSearch)
+	{
+	const vector<PSearch::Map_Rows::iterator>& theSlots = ioPSearch->fSlots;
+	const size_t theColCount = ioPSearch->fRelHead.size();
+
+	vector<Val_DB> thePackedRows;
+	thePackedRows.reserve(theSlots.size() * theColCount);
+	foreacha (entry, theSlots)
+		thePackedRows.insert(thePackedRows.end(), entry->first.begin(), entry->first.end());
+
+	ZP<QE::Result> theResult = new QE::Result(ioPSearch->fRelHead, &thePackedRows);
+
+	ioPSearch->fResultDeltas.Clear();
+	if (ioPSearch->fResult && ioPSearch->fResult->Count() == theSlots.size())
+		{
+		// Same number of rows, so the changed ones are all in touched slots.
+		ZP<QE::ResultDeltas> theDeltas = new QE::ResultDeltas;
+		foreacha (theSlot, ioPSearch->fTouchedSlots)
+			{
+			if (theSlot >= theSlots.size())
+				break;
+			theDeltas->fMapping.push_back(theSlot);
+			const vector<Val_DB>& theRow = theSlots[theSlot]->first;
+			theDeltas->fPackedRows.insert(
+				theDeltas->fPackedRows.end(), theRow.begin(), theRow.end());
+			}
+		ioPSearch->fResultDeltas = theDeltas;
+		}
+
+	ioPSearch->fTouchedSlots.clear();
+	ioPSearch->fResultPrior = ioPSearch->fResult;
+	ioPSearch->fResult = theResult;
 	}
 
 void Searcher_Datons::pRewind(ZP<Walker_Map> iWalker_Map)
 	{
-	iWalker_Map->fCurrent = fMap_Thing.begin();
+	iWalker_Map->fCurrent = iWalker_Map->fStore->fMap_Thing.begin();
+	iWalker_Map->fPriors.Clear();
 	}
 
 void Searcher_Datons::pPrime(ZP<Walker_Map> iWalker_Map,
@@ -1095,60 +2720,66 @@ void Searcher_Datons::pPrime(ZP<Walker_Map> iWalker_Map,
 	map<string8,size_t>& oOffsets,
 	size_t& ioBaseOffset)
 	{
-	iWalker_Map->fCurrent = fMap_Thing.begin();
+	iWalker_Map->fCurrent = iWalker_Map->fStore->fMap_Thing.begin();
 	iWalker_Map->fBaseOffset = ioBaseOffset;
+	iWalker_Map->fPriors = QE::RowSet(iWalker_Map->fConcreteHead.size());
 	foreacha (entry, iWalker_Map->fConcreteHead)
 		oOffsets[entry.first] = ioBaseOffset++;
 	}
 
+// Fills in the values iConcreteHead wants from iDaton and its decoded iMap. Returns false if
+// iMap is not a map, or lacks a required name.
+static bool spReadEntry(const Daton& iDaton, const Val_JSONB& iMap,
+	const ConcreteHead& iConcreteHead, size_t iBaseOffset, Val_DB* ioResults)
+	{
+	if (not iMap.IsMap())
+		return false;
+
+	size_t offset = iBaseOffset;
+	for (ConcreteHead::const_iterator
+		ii = iConcreteHead.begin(), end = iConcreteHead.end();
+		ii != end; ++ii, ++offset)
+		{
+		const string8& theName = ii->first;
+		if (theName.empty())
+			{
+			// Empty name indicates that we want the Daton itself.
+			ioResults[offset] = iDaton;
+			}
+		else if (const Val_DB* theVal = iMap.PGet(theName))
+			{
+			ioResults[offset] = *theVal;
+			}
+		else if (not ii->second)
+			{
+			ioResults[offset] = AbsentOptional_t();
+			}
+		else
+			{
+			return false;
+			}
+		}
+	return true;
+	}
+
 bool Searcher_Datons::pReadInc(ZP<Walker_Map> iWalker_Map, Val_DB* ioResults)
 	{
 	const ConcreteHead& theConcreteHead = iWalker_Map->fConcreteHead;
+	const size_t theBaseOffset = iWalker_Map->fBaseOffset;
+	const Map_Thing::const_iterator theEnd = iWalker_Map->fStore->fMap_Thing.end();
 
-	while (iWalker_Map->fCurrent != fMap_Thing.end())
+	while (iWalker_Map->fCurrent != theEnd)
 		{
-		if (const Map_ZZ* theMap = iWalker_Map->fCurrent->second.PGet<Map_ZZ>())
+		const Map_Thing::value_type& theEntry = *iWalker_Map->fCurrent++;
+		if (spReadEntry(theEntry.first, theEntry.second, theConcreteHead, theBaseOffset, ioResults))
 			{
-			bool gotAll = true;
-			vector<Val_DB> subset;
-			subset.reserve(theConcreteHead.size());
-			size_t offset = iWalker_Map->fBaseOffset;
-			for (ConcreteHead::const_iterator
-				ii = theConcreteHead.begin(), end = theConcreteHead.end();
-				ii != end; ++ii, ++offset)
-				{
-				const string8& theName = ii->first;
-				if (theName.empty())
-					{
-					// Empty name indicates that we want the Daton itself.
-					const Val_DB& theVal = iWalker_Map->fCurrent->first;
-					ioResults[offset] = theVal;
-					subset.push_back(theVal);
-					}
-				else if (const Val_DB* theVal = sPGet(*theMap, theName))
-					{
-					ioResults[offset] = *theVal;
-					subset.push_back(*theVal);
-					}
-				else if (not ii->second)
-					{
-					ioResults[offset] = AbsentOptional_t();
-					subset.push_back(AbsentOptional_t());
-					}
-				else
-					{
-					gotAll = false;
-					break;
-					}
-				}
+			// Rows that include the Daton itself can't repeat.
+			if (sNotEmpty(theConcreteHead) && theConcreteHead.begin()->first.empty())
+				return true;
 
-			if (gotAll && sQInsert(iWalker_Map->fPriors, subset))
-				{
-				++iWalker_Map->fCurrent;
+			if (iWalker_Map->fPriors.Insert(ioResults + theBaseOffset))
 				return true;
-				}
 			}
-		++iWalker_Map->fCurrent;
 		}
 
 	return false;
@@ -1174,12 +2805,8 @@ void Searcher_Datons::pPrime(ZP<Walker_Index> iWalker_Index,
 
 static const Val_DB spVal_AbsentOptional = AbsentOptional_t();
 
-static long long countOfPReadIncs;
-
 bool Searcher_Datons::pReadInc(ZP<Walker_Index> iWalker_Index, Val_DB* ioResults)
 	{
-	++countOfPReadIncs;
-
 	const size_t theCount_Indexed = iWalker_Index->fUsableIndexNames;
 	const auto& theNBV = iWalker_Index->fNameBoolVector;
 	const size_t theCount_NBV = theNBV.size();
@@ -1189,15 +2816,17 @@ bool Searcher_Datons::pReadInc(ZP<Walker_Index> iWalker_Index, Val_DB* ioResults
 
 	while (iWalker_Index->fCurrent != iWalker_Index->fEnd)
 		{
-		const Map_Thing::value_type* theTarget = iWalker_Index->fCurrent->fMapEntryP;
+		const Map_Thing::value_type* theTarget = iWalker_Index->fCurrent.GetMapEntryP();
 
-		if (const Map_ZZ* theMap = theTarget->second.PGet<Map_ZZ>())
+		const Val_JSONB& theMap = theTarget->second;
+		if (theMap.IsMap())
 			{
 			// It's a map, and thus usable.
 
 			// Transcribe the values in the current key into theValPtrs.
+			const Val_DB* const* theKeyValues = iWalker_Index->fCurrent.GetValues();
 			for (size_t xx = 0; xx < theCount_Indexed; ++xx)
-				theValPtrs[xx] = iWalker_Index->fCurrent->fValues[xx];
+				theValPtrs[xx] = theKeyValues[xx];
 
 			bool gotAll = true;
 			for (size_t xx = 0; xx < theCount_NBV; ++xx)
@@ -1210,7 +2839,7 @@ bool Searcher_Datons::pReadInc(ZP<Walker_Index> iWalker_Index, Val_DB* ioResults
 					theVal_Daton = theTarget->first;
 					theValPtrs[theCount_Indexed + xx] = &theVal_Daton;
 					}
-				else if (const Val_DB* theValPtr = sPGet(*theMap, theName))
+				else if (const Val_DB* theValPtr = theMap.PGet(theName))
 					{
 					theValPtrs[theCount_Indexed + xx] = theValPtr;
 					}
@@ -1265,16 +2894,41 @@ bool Searcher_Datons::pReadInc(ZP<Walker_Index> iWalker_Index, Val_DB* ioResults
 	return false;
 	}
 
+void Searcher_Datons::pRewind(ZP<Walker_Entries> iWalker_Entries)
+	{ iWalker_Entries->fCurrent = 0; }
+
+void Searcher_Datons::pPrime(ZP<Walker_Entries> iWalker_Entries,
+	const map<string8,size_t>& iOffsets,
+	map<string8,size_t>& oOffsets,
+	size_t& ioBaseOffset)
+	{
+	iWalker_Entries->fCurrent = 0;
+	iWalker_Entries->fBaseOffset = ioBaseOffset;
+	foreacha (entry, iWalker_Entries->fConcreteHead)
+		oOffsets[entry.first] = ioBaseOffset++;
+	}
+
+bool Searcher_Datons::pReadInc(ZP<Walker_Entries> iWalker_Entries, Val_DB* ioResults)
+	{
+	const MapEntries& theMapEntries = iWalker_Entries->fMapEntries;
+	while (iWalker_Entries->fCurrent < theMapEntries.size())
+		{
+		const Map_Thing::value_type* theEntry = theMapEntries[iWalker_Entries->fCurrent++];
+		if (spReadEntry(theEntry->first, theEntry->second,
+			iWalker_Entries->fConcreteHead, iWalker_Entries->fBaseOffset, ioResults))
+			{ return true; }
+		}
+	return false;
+	}
+
 // =================================================================================================
 #pragma mark - XCode function popup chokes if this is earlier
 
 const ChanW_UTF& operator<<(const ChanW_UTF& ww, const Searcher_Datons::Index::Key& iKey)
 	{
 	ww << sStringf("%p", iKey.fMapEntryP) << ": ";
-	for (size_t xx = 0; xx < countof(iKey.fValues); ++xx)
+	for (size_t xx = 0; xx < iKey.fValues.size(); ++xx)
 		{
-		if (not iKey.fValues[xx])
-			break;
 		if (xx)
 			ww << ", ";
 		ww << *iKey.fValues[xx];
@@ -4,20 +4,48 @@
 #define __ZooLib_Dataspace_Searcher_Datons_h__ 1
 #include "zconfig.h"
 
+#include "zoolib/Compat_unordered_map.h"
 #include "zoolib/DList.h"
 #include "zoolib/NameUniquifier.h"
+#include "zoolib/Val_JSONB.h"
+#include "zoolib/ZQ.h"
 
 #include "zoolib/Dataspace/Daton.h"
+#include "zoolib/Dataspace/Journal_Datons.h"
 #include "zoolib/Dataspace/Searcher.h"
 
 #include "zoolib/QueryEngine/Walker.h"
 
+#include <initializer_list>
+#include <map>
 #include <set>
+#include <unordered_set>
 
 namespace ZooLib {
 namespace Dataspace {
 
-typedef std::vector<ColName> IndexSpec;
+// =================================================================================================
+#pragma mark - IndexSpec
+
+// An ordered index serves equality on its leading columns, optionally followed by a range on
+// the next column. A hashed index serves only equality on every one of its columns, but
+// finds matching datons without comparing values.
+
+class IndexSpec
+	{
+public:
+	IndexSpec();
+	IndexSpec(const std::vector<ColName>& iColNames);
+	IndexSpec(std::initializer_list<ColName> iColNames);
+	IndexSpec(const std::vector<ColName>& iColNames, bool iHashed);
+
+	const std::vector<ColName>& GetColNames() const;
+	bool IsHashed() const;
+
+private:
+	std::vector<ColName> fColNames;
+	bool fHashed;
+	};
 
 // =================================================================================================
 #pragma mark - Searcher_Datons
@@ -40,25 +68,123 @@ public:
 
 	virtual void CollectResults(std::vector<SearchResult>& oChanged, int64& oChangeCount);
 
+	virtual ZQ<QueryEngine::Estimate> QEstimate(
+		const SearchSpec& iSearchSpec, const RelHead& iBoundNames);
+
 // Our protocol
 	int64 MakeChanges(const Daton* iAsserted, size_t iAssertedCount,
 		const Daton* iRetracted, size_t iRetractedCount);
 
+	// Searches that no index serves are walked in full. Those walks are tallied by the shape of
+	// the search -- the names it wants, and the names its restriction compares with constants,
+	// for equality and for order.
+	struct ScanShape
+		{
+		RelHead fRelHead;
+		RelHead fNames_Equal;
+		RelHead fNames_Range;
+
+		bool operator<(const ScanShape& iOther) const;
+		};
+
+	struct ScanStats
+		{
+		ScanStats();
+
+		size_t fCount;
+		uint64 fRowsScanned;
+		double fElapsed;
+
+		// An index that would serve the shape, if there is one.
+		ZQ<IndexSpec> fSuggestion;
+
+		// Set once we've started building the suggested index.
+		bool fIndexAdded;
+		};
+
+	std::map<ScanShape,ScanStats> GetScanStats();
+
+	// Once a shape has been walked in full iScanCount times, build its suggested index on
+	// another thread and move searches onto it. Zero, the default, disables this.
+	void SetAutoIndexThreshold(size_t iScanCount);
+
+	// Replaces our Datons with those iJournal holds, building the indexes in bulk, and
+	// logs every subsequent change to it before making it. Call it before making any changes
+	// or registering any searches.
+	void SetJournal(const ZP<Journal_Datons>& iJournal);
+
+	// Writes a snapshot of the current Datons to the journal, so a load needn't replay the
+	// log written so far.
+	void WriteSnapshot();
+
+	// Once iLogBytes have been logged since the last snapshot, write another on another
+	// thread. Zero, the default, disables this.
+	void SetSnapshotThreshold(uint64 iLogBytes);
+
 private:
 	ZMtx fMtx;
 
-	typedef std::map<Daton,Val_DB> Map_Thing;
+	// JSONB Datons are decoded lazily, so indexing and searching only pay for the
+	// members they look at. Keyed by the Daton's cached hash -- nothing needs the Datons
+	// in order, and unordered_map's nodes don't move, so Index keys can point into it.
+	typedef unordered_map<Daton,Val_JSONB> Map_Thing;
 
 	// -----
 
 	struct Key;
 	class PSearch;
 
-	void pInvalidateSearchIfAppropriate(PSearch* thePSearch, const Key& iKey);
+	typedef std::vector<const Map_Thing::value_type*> MapEntries;
 
-	void pIndexInsert(const Map_Thing::value_type* iMapEntryP);
+	bool pKeyMatches(PSearch* iPSearch, const Key& iKey);
+
+	void pIndexInsert(const MapEntries& iMapEntries);
 	void pIndexErase(const Map_Thing::value_type* iMapEntryP);
 
+	bool pApplyChanges(PSearch* ioPSearch,
+		const MapEntries& iAsserted, const MapEntries& iRetracted);
+
+	bool pUpdateRows(PSearch* ioPSearch, const std::map<std::vector<Val_DB>,int>& iCountDeltas);
+
+	void pPublish(PSearch* ioPSearch);
+
+	// -----
+
+	// The datons and the indexes over them. CollectResults holds on to the current Store
+	// while it walks searches with fMtx released, and MakeChanges copies a Store that's
+	// held like that before changing it, so walks see a consistent snapshot.
+	class Store;
+	ZP<Store> fStore;
+
+	struct Build;
+
+	ZP<QueryEngine::Walker> pMakeWalker(const ZP<Store>& iStore, PSearch* iPSearch);
+
+	void pInstall(Build& ioBuild);
+
+	uint64 fNextBuildID;
+	std::map<uint64,PSearch*> fBuilds_InFlight;
+
+	// -----
+
+	void pRecordScan(PSearch* iPSearch, uint64 iRowsScanned, double iElapsed);
+
+	void pBuildIndex(const IndexSpec& iIndexSpec, const ZP<Store>& iStore);
+
+	std::map<ScanShape,ScanStats> fScanStats;
+	size_t fAutoIndexThreshold;
+
+	// While an index is being built against a pinned Store, the Datons asserted or retracted
+	// since, which are the keys that must be redone when it's installed.
+	bool fIndexBuild_InFlight;
+	std::unordered_set<Daton> fIndexBuild_Touched;
+
+	// -----
+
+	ZP<Journal_Datons> fJournal;
+	uint64 fSnapshotThreshold;
+	bool fSnapshot_InFlight;
+
 	// -----
 
 	class Walker_Map;
@@ -89,13 +215,34 @@ private:
 
 	// -----
 
+	class Walker_Entries;
+	friend class Walker_Entries;
+
+	void pRewind(ZP<Walker_Entries> iWalker_Entries);
+
+	void pPrime(ZP<Walker_Entries> iWalker_Entries,
+		const std::map<string8,size_t>& iOffsets,
+		std::map<string8,size_t>& oOffsets,
+		size_t& ioBaseOffset);
+
+	bool pReadInc(ZP<Walker_Entries> iWalker, Val_DB* ioResults);
+
+	// -----
+
 public:
 	class Index;
 
 private:
 	std::vector<Index*> fIndexes;
 
-	Map_Thing fMap_Thing;
+	// -----
+
+	struct Plan;
+
+	void pPlan(const ZP<Expr_Bool>& iRestriction, Plan& oPlan);
+
+	void pUpdateStats(Index* ioIndex);
+	double pDistinct(const ColName& iColName);
 
 	ThreadVal_NameUniquifier::Type_t::Set_t fUniquifiedNames;
 
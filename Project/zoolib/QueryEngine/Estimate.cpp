@@ -0,0 +1,39 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/QueryEngine/Estimate.h"
+
+#include "zoolib/Util_Chan_UTF_Operators.h"
+
+namespace ZooLib {
+namespace QueryEngine {
+
+// =================================================================================================
+#pragma mark - Estimate
+
+Estimate::Estimate()
+:	fCount(0)
+,	fCost(0)
+	{}
+
+Estimate::Estimate(double iCount, double iCost)
+:	fCount(iCount)
+,	fCost(iCost)
+	{}
+
+Estimate::Estimate(double iCount, double iCost, const string8& iPlan)
+:	fCount(iCount)
+,	fCost(iCost)
+,	fPlan(iPlan)
+	{}
+
+} // namespace QueryEngine
+
+const ChanW_UTF& operator<<(const ChanW_UTF& ww, const QueryEngine::Estimate& iEstimate)
+	{
+	sEWritef(ww, "rows~%.0f cost~%.0f", iEstimate.fCount, iEstimate.fCost);
+	if (not iEstimate.fPlan.empty())
+		ww << " " << iEstimate.fPlan;
+	return ww;
+	}
+
+} // namespace ZooLib
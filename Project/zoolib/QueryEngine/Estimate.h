@@ -0,0 +1,49 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_QueryEngine_Estimate_h__
+#define __ZooLib_QueryEngine_Estimate_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/Callable.h"
+#include "zoolib/ChanW_UTF.h"
+#include "zoolib/ZQ.h"
+
+#include "zoolib/Expr/Expr_Bool.h"
+#include "zoolib/RelationalAlgebra/RelHead.h"
+
+namespace ZooLib {
+namespace QueryEngine {
+
+// =================================================================================================
+#pragma mark - Estimate
+
+// How many rows evaluating something is likely to produce, and how much work it's likely to
+// take, in units of entries examined. fPlan says how it'd be done, for the curious.
+
+class Estimate
+	{
+public:
+	Estimate();
+	Estimate(double iCount, double iCost);
+	Estimate(double iCount, double iCost, const string8& iPlan);
+
+	double fCount;
+	double fCost;
+	string8 fPlan;
+	};
+
+// Estimates a search for the rows of iConcreteHead satisfying iRestriction. The values of
+// iBoundNames will be supplied when the search is made, and so aren't known yet.
+typedef Callable<ZQ<Estimate>(
+	const RelationalAlgebra::ConcreteHead& iConcreteHead,
+	const RelationalAlgebra::RelHead& iBoundNames,
+	const ZP<Expr_Bool>& iRestriction)>
+	Callable_Estimate;
+
+} // namespace QueryEngine
+
+const ChanW_UTF& operator<<(const ChanW_UTF& ww, const QueryEngine::Estimate& iEstimate);
+
+} // namespace ZooLib
+
+#endif // __ZooLib_QueryEngine_Estimate_h__
@@ -18,6 +18,18 @@ Expr_Rel_Search::Expr_Rel_Search(const RelationalAlgebra::RelHead& iRelHead_Boun
 ,	fExpr_Bool(iExpr_Bool)
 	{}
 
+Expr_Rel_Search::Expr_Rel_Search(const RelationalAlgebra::RelHead& iRelHead_Bound,
+	const RelationalAlgebra::Rename& iRename,
+	const RelationalAlgebra::RelHead& iRelHead_Optional,
+	const ZP<Expr_Bool>& iExpr_Bool,
+	const ZQ<Estimate>& iEstimateQ)
+:	fRelHead_Bound(iRelHead_Bound)
+,	fRename(iRename)
+,	fRelHead_Optional(iRelHead_Optional)
+,	fExpr_Bool(iExpr_Bool)
+,	fEstimateQ(iEstimateQ)
+	{}
+
 void Expr_Rel_Search::Accept(const Visitor& iVisitor)
 	{
 	if (Visitor_Expr_Rel_Search* theVisitor = sDynNonConst<Visitor_Expr_Rel_Search>(&iVisitor))
@@ -74,6 +86,9 @@ const RelationalAlgebra::RelHead& Expr_Rel_Search::GetRelHead_Optional() const
 const ZP<Expr_Bool>& Expr_Rel_Search::GetExpr_Bool() const
 	{ return fExpr_Bool; }
 
+const ZQ<Estimate>& Expr_Rel_Search::GetEstimateQ() const
+	{ return fEstimateQ; }
+
 // =================================================================================================
 #pragma mark - Visitor_Expr_Rel_Search
 
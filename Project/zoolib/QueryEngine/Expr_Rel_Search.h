@@ -5,6 +5,7 @@
 #include "zconfig.h"
 
 #include "zoolib/Expr/Expr_Bool.h"
+#include "zoolib/QueryEngine/Estimate.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel.h"
 
 namespace ZooLib {
@@ -26,6 +27,14 @@ public:
 		const RelationalAlgebra::RelHead& iRelHead_Optional,
 		const ZP<Expr_Bool>& iExpr_Bool);
 
+	// iEstimateQ is what's expected of the search. It's for inspecting plans, and takes no
+	// part in Compare.
+	Expr_Rel_Search(const RelationalAlgebra::RelHead& iRelHead_Bound,
+		const RelationalAlgebra::Rename& iRename,
+		const RelationalAlgebra::RelHead& iRelHead_Optional,
+		const ZP<Expr_Bool>& iExpr_Bool,
+		const ZQ<Estimate>& iEstimateQ);
+
 // From Visitee
 	virtual void Accept(const Visitor& iVisitor);
 
@@ -45,12 +54,14 @@ public:
 	const RelationalAlgebra::Rename& GetRename() const;
 	const RelationalAlgebra::RelHead& GetRelHead_Optional() const;
 	const ZP<Expr_Bool>& GetExpr_Bool() const;
+	const ZQ<Estimate>& GetEstimateQ() const;
 
 private:
 	const RelationalAlgebra::RelHead fRelHead_Bound;
 	const RelationalAlgebra::Rename fRename;
 	const RelationalAlgebra::RelHead fRelHead_Optional;
 	const ZP<Expr_Bool> fExpr_Bool;
+	const ZQ<Estimate> fEstimateQ;
 	};
 
 // =================================================================================================
@@ -4,6 +4,8 @@
 
 #include "zoolib/Compare_vector.h"
 
+#include <algorithm> // For std::equal
+
 using std::map;
 using std::pair;
 using std::vector;
@@ -112,5 +114,40 @@ ZP<Result> sApplyDeltas(ZP<Result> iResult, ZP<ResultDeltas> iResultDeltas)
 	return result;
 	}
 
+// =================================================================================================
+#pragma mark - sDeltas
+
+ZP<ResultDeltas> sDeltas(const ZP<Result>& iPrior, const ZP<Result>& iResult)
+	{
+	if (not iPrior || not iResult)
+		return null;
+
+	if (iPrior->GetRelHead() != iResult->GetRelHead())
+		return null;
+
+	const size_t rowCount = iResult->Count();
+	if (iPrior->Count() != rowCount)
+		return null;
+
+	const size_t colCount = iResult->GetRelHead().size();
+
+	ZP<ResultDeltas> theDeltas = new ResultDeltas;
+	vector<Val_DB>& packedRows = theDeltas->fPackedRows;
+	vector<size_t>& mapping = theDeltas->fMapping;
+
+	for (size_t rr = 0; rr < rowCount; ++rr)
+		{
+		const Val_DB* priorVals = iPrior->GetValsAt(rr);
+		const Val_DB* currVals = iResult->GetValsAt(rr);
+		if (not std::equal(priorVals, priorVals + colCount, currVals))
+			{
+			packedRows.insert(packedRows.end(), currVals, currVals + colCount);
+			mapping.push_back(rr);
+			}
+		}
+
+	return theDeltas;
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
@@ -72,6 +72,15 @@ public:
 
 ZP<Result> sApplyDeltas(ZP<Result> iResult, ZP<ResultDeltas> iResultDeltas);
 
+// =================================================================================================
+#pragma mark - sDeltas
+
+// The rows of iResult that differ from those of iPrior, such that sApplyDeltas(iPrior, result)
+// is equivalent to iResult. Null if there's no such thing, because the two results have
+// different RelHeads or different row counts.
+
+ZP<ResultDeltas> sDeltas(const ZP<Result>& iPrior, const ZP<Result>& iResult);
+
 } // namespace QueryEngine
 
 template <>
@@ -14,6 +14,15 @@ using std::set;
 using std::vector;
 using RelationalAlgebra::RelHead;
 
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const size_t kRowsPerBatch = 256;
+
+} // anonymous namespace
+
 // =================================================================================================
 #pragma mark - sQuery
 
@@ -24,14 +33,20 @@ ZP<Result> sResultFromWalker(ZP<Walker> iWalker)
 	iWalker = iWalker->Prime(sDefault(), offsets, baseOffset);
 
 	vector<Val_DB> thePackedRows;
-	vector<Val_DB> theRow(baseOffset);
+	vector<Val_DB> theRows(baseOffset * kRowsPerBatch);
 	for (;;)
 		{
-		if (not iWalker->QReadInc(&theRow[0]))
-			break;
+		const size_t theRead = iWalker->QReadBatch(theRows.data(), baseOffset, kRowsPerBatch);
 
-		foreacha (entry, offsets)
-			thePackedRows.push_back(theRow[entry.second]);
+		for (size_t xx = 0; xx < theRead; ++xx)
+			{
+			const Val_DB* theRow = theRows.data() + xx * baseOffset;
+			foreacha (entry, offsets)
+				thePackedRows.push_back(theRow[entry.second]);
+			}
+
+		if (theRead < kRowsPerBatch)
+			break;
 		}
 
 	RelHead theRelHead;
@@ -24,15 +24,20 @@
 #include "zoolib/RelationalAlgebra/Expr_Rel_Concrete.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Const.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Dee.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Difference.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Dum.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Embed.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Intersect.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Product.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Project.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Rename.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Restrict.h"
+#include "zoolib/RelationalAlgebra/GetRelHead.h"
 
 #include "zoolib/RelationalAlgebra/Util_Strim_Rel.h"
 
+#include <algorithm> // For std::min
+
 namespace ZooLib {
 namespace QueryEngine {
 
@@ -44,6 +49,7 @@ using RA::RelHead;
 using RA::sRelHead;
 using RA::Rename;
 
+using std::map;
 using std::set;
 
 using namespace Util_STL;
@@ -127,11 +133,35 @@ private:
 
 namespace { // anonymous
 
+ZQ<double> spSum(const ZQ<double>& iLHS, const ZQ<double>& iRHS)
+	{
+	if (iLHS && iRHS)
+		return *iLHS + *iRHS;
+	return null;
+	}
+
+ZQ<double> spProduct(const ZQ<double>& iLHS, const ZQ<double>& iRHS)
+	{
+	if (iLHS && iRHS)
+		return *iLHS * *iRHS;
+	return null;
+	}
+
+// What it costs to produce a nested loop's rows. The inner is walked once per outer row, and a
+// search that uses the outer's values is done afresh for each distinct set of them, so
+// charging the inner's cost each time is about right.
+ZQ<double> spNestedCost(const ZQ<double>& iOuterCostQ, const ZQ<double>& iOuterSizeQ,
+	const ZQ<double>& iInnerCostQ)
+	{ return spSum(iOuterCostQ, spProduct(iOuterSizeQ, iInnerCostQ)); }
+
 /*
 Transform_Search
 
 Accumulate the rename, project and restriction on a branch, and when a concrete
 is encountered instead return a search incorporating the accumulated info.
+
+If we have a Callable_Estimate then each search's likely size and cost are known, and
+are accumulated in fLikelySizeQ and fLikelyCostQ as we come back up the tree.
 */
 
 class Transform_Search
@@ -140,8 +170,10 @@ class Transform_Search
 ,	public virtual RA::Visitor_Expr_Rel_Concrete
 ,	public virtual RA::Visitor_Expr_Rel_Const
 ,	public virtual RA::Visitor_Expr_Rel_Dee
+,	public virtual RA::Visitor_Expr_Rel_Difference
 ,	public virtual RA::Visitor_Expr_Rel_Dum
 ,	public virtual RA::Visitor_Expr_Rel_Embed
+,	public virtual RA::Visitor_Expr_Rel_Intersect
 ,	public virtual RA::Visitor_Expr_Rel_Product
 ,	public virtual RA::Visitor_Expr_Rel_Project
 ,	public virtual RA::Visitor_Expr_Rel_Rename
@@ -151,8 +183,9 @@ class Transform_Search
 	{
 	typedef Visitor_Expr_Op_Do_Transform_T<RA::Expr_Rel> inherited;
 public:
-	Transform_Search()
-	:	fRestriction(sTrue())
+	Transform_Search(const ZP<Callable_Estimate>& iCallable_Estimate)
+	:	fCallable_Estimate(iCallable_Estimate)
+	,	fRestriction(sTrue())
 	,	fProjection(UniSet<ColName>::sUniversal())
 		{}
 
@@ -213,8 +246,6 @@ public:
 				sQInsert(theRH_Optional, theColName);
 			}
 
-		// TODO: Manipulate fLikelySizeQ in some fashion.
-
 		// However, fRestriction may well also reference names *not* in the concrete, if we're
 		// part of the embeddee of an embed. The simplest solution for now is to pull up any
 		// terms referencing names *not* in the concrete. So, get fRestriction into CNF. Separate
@@ -256,8 +287,30 @@ public:
 				}
 			}
 
+		ZQ<Estimate> theEstimateQ;
+		if (fCallable_Estimate)
+			{
+			RA::ConcreteHead theConcreteHead;
+			foreacha (entry, newRename)
+				theConcreteHead[entry.first] = not sContains(theRH_Optional, entry.first);
+
+			theEstimateQ =
+				sCall(fCallable_Estimate, theConcreteHead, fBoundNames, conjunctionSearch);
+			}
+
+		if (theEstimateQ)
+			{
+			fLikelySizeQ = theEstimateQ->fCount;
+			fLikelyCostQ = theEstimateQ->fCost;
+			}
+		else
+			{
+			fLikelySizeQ.Clear();
+			fLikelyCostQ.Clear();
+			}
+
 		ZP<Expr_Rel> theRel = new Expr_Rel_Search(fBoundNames,
-			newRename, theRH_Optional, conjunctionSearch);
+			newRename, theRH_Optional, conjunctionSearch, theEstimateQ);
 
 		if (conjunctionRestrict)
 			theRel &= conjunctionRestrict;
@@ -268,18 +321,24 @@ public:
 	virtual void Visit_Expr_Rel_Const(const ZP<RA::Expr_Rel_Const>& iExpr)
 		{
 		fLikelySizeQ = 1;
+		fLikelyCostQ = 0;
 		this->pSetResultWithRestrictProjectRename(iExpr, iExpr->GetColName());
 		}
 
 	virtual void Visit_Expr_Rel_Dee(const ZP<RA::Expr_Rel_Dee>& iExpr)
 		{
 		fLikelySizeQ = 1;
+		fLikelyCostQ = 0;
 		this->pSetResultWithRestrictProjectRename(iExpr, null);
 		}
 
+	virtual void Visit_Expr_Rel_Difference(const ZP<RA::Expr_Rel_Difference>& iExpr)
+		{ this->pVisit_Matching(iExpr, false); }
+
 	virtual void Visit_Expr_Rel_Dum(const ZP<RA::Expr_Rel_Dum>& iExpr)
 		{
 		fLikelySizeQ = 0;
+		fLikelyCostQ = 0;
 		this->pSetResultWithRestrictProjectRename(iExpr, null);
 		}
 
@@ -292,6 +351,8 @@ public:
 		fRestriction = sTrue();
 		fProjection = UniSet<ColName>::sUniversal();
 		ZP<Expr_Rel> newOp0 = this->Do(iExpr->GetOp0());
+		const ZQ<double> op0LikelySizeQ = fLikelySizeQ;
+		const ZQ<double> op0LikelyCostQ = fLikelyCostQ;
 
 		fRestriction = sTrue();
 		fProjection = UniSet<ColName>::sUniversal();
@@ -299,6 +360,10 @@ public:
 		fBoundNames = iExpr->GetBoundNames();
 		ZP<Expr_Rel> newOp1 = this->Do(iExpr->GetOp1());
 
+		// We've a row for each of op0's, and the embeddee is evaluated for each of them.
+		fLikelyCostQ = spNestedCost(op0LikelyCostQ, op0LikelySizeQ, fLikelyCostQ);
+		fLikelySizeQ = op0LikelySizeQ;
+
 		// Restore this stuff -- we don't want anything from the embedee itself to leak up to here.
 		fRestriction = priorRestriction;
 		fProjection = priorProjection;
@@ -312,12 +377,31 @@ public:
 		this->pSetResultWithRestrictProjectRename(newEmbed, null);
 		}
 
+	virtual void Visit_Expr_Rel_Intersect(const ZP<RA::Expr_Rel_Intersect>& iExpr)
+		{ this->pVisit_Matching(iExpr, true); }
+
 	virtual void Visit_Expr_Rel_Product(const ZP<RA::Expr_Rel_Product>& iExpr)
 		{
 		// Remember current state, to use and to restore
 		const ZP<Expr_Bool> priorRestriction = fRestriction;
 		const UniSet<ColName> priorProjection = fProjection;
 		const Rename priorRename_LeafToRoot = fRename_LeafToRoot;
+		const RelHead priorBoundNames = fBoundNames;
+
+		// With an estimator, whichever branch is walked first has its names, other than any the
+		// other has too, bound for the second. Which that is isn't known until both have been
+		// estimated, so each is transformed just once, with only our own bound names, and what
+		// the first binds is recorded in fBindings for sTransform_Search to apply afterwards.
+		RelHead leftOnly, rightOnly;
+		if (fCallable_Estimate)
+			{
+			const RelHead leftNames =
+				RA::sRenamed(priorRename_LeafToRoot, RA::sGetRelHead(iExpr->GetOp0()));
+			const RelHead rightNames =
+				RA::sRenamed(priorRename_LeafToRoot, RA::sGetRelHead(iExpr->GetOp1()));
+			leftOnly = leftNames - rightNames;
+			rightOnly = rightNames - leftNames;
+			}
 
 		// We leave rename in place to be used by children,
 		// but reset the restriction and projection -- children will see only any
@@ -327,8 +411,8 @@ public:
 
 		// Process the left branch.
 		ZP<RA::Expr_Rel> op0 = this->Do(iExpr->GetOp0());
-		const double leftLikelySize = fLikelySizeQ.Get();
-		fLikelySizeQ.Clear();
+		const ZQ<double> leftLikelySizeQ = fLikelySizeQ;
+		const ZQ<double> leftLikelyCostQ = fLikelyCostQ;
 		const RelHead namesOnLeft = RA::sNamesTo(fRename_LeafToRoot);
 
 		// Projection, rename and restriction may have been touched, so reset things
@@ -337,25 +421,44 @@ public:
 		fProjection = UniSet<ColName>::sUniversal();
 		fRename_LeafToRoot = priorRename_LeafToRoot;
 
-		// Can we treat the left branch names as bound for the right?
-
-		// Process the right branch.
-		fBoundNames = namesOnLeft;
+		// Process the right branch. Without an estimator the left branch names are bound.
+		if (not fCallable_Estimate)
+			fBoundNames = namesOnLeft;
 		ZP<RA::Expr_Rel> op1 = this->Do(iExpr->GetOp1());
-		const double rightLikelySize = fLikelySizeQ.Get();
+		const ZQ<double> rightLikelySizeQ = fLikelySizeQ;
+		const ZQ<double> rightLikelyCostQ = fLikelyCostQ;
+		const RelHead namesOnRight = RA::sNamesTo(fRename_LeafToRoot);
+
+		fBoundNames = priorBoundNames;
 
-		fLikelySizeQ = leftLikelySize * rightLikelySize;
+		ZP<RA::Expr_Rel> theProduct = sProduct(op0, op1);
+		fLikelySizeQ = spProduct(leftLikelySizeQ, rightLikelySizeQ);
+		fLikelyCostQ = spNestedCost(leftLikelyCostQ, leftLikelySizeQ, rightLikelyCostQ);
 
-//		if (rightLikelySize < leftLikelySize)
-//			{
-//			this->pSetResultWithRestrictProjectRename(sProduct(op1, op0));
-//			}
-//		else
+		if (fCallable_Estimate)
 			{
-//			this->pSetResult(sProduct(op0, op1));
-			this->pSetResultWithRestrictProjectRename(
-				sProduct(op0, op1), priorRestriction, priorProjection, Rename(), null);
+			RelHead theBinding = namesOnLeft | leftOnly;
+
+			// If the right is likely to be the smaller, see what it'd cost to walk it first.
+			// A product's a set, so its operands can go in either order.
+			if (fLikelyCostQ && fLikelySizeQ && *rightLikelySizeQ < *leftLikelySizeQ)
+				{
+				const ZQ<double> theCostQ =
+					spNestedCost(rightLikelyCostQ, rightLikelySizeQ, leftLikelyCostQ);
+
+				if (theCostQ && *theCostQ < *fLikelyCostQ)
+					{
+					theProduct = sProduct(op1, op0);
+					theBinding = namesOnRight | rightOnly;
+					fLikelyCostQ = theCostQ;
+					}
+				}
+
+			fBindings[theProduct.Get()] = theBinding;
 			}
+
+		this->pSetResultWithRestrictProjectRename(
+			theProduct, priorRestriction, priorProjection, Rename(), null);
 		}
 
 	virtual void Visit_Expr_Rel_Project(const ZP<RA::Expr_Rel_Project>& iExpr)
@@ -409,6 +512,8 @@ public:
 
 		// Process the left branch.
 		ZP<RA::Expr_Rel> op0 = this->Do(iExpr->GetOp0());
+		const ZQ<double> leftLikelySizeQ = fLikelySizeQ;
+		const ZQ<double> leftLikelyCostQ = fLikelyCostQ;
 
 		// Restore state and then process the right
 		fRestriction = priorRestriction;
@@ -417,11 +522,49 @@ public:
 
 		ZP<RA::Expr_Rel> op1 = this->Do(iExpr->GetOp1());
 
+		fLikelySizeQ = spSum(leftLikelySizeQ, fLikelySizeQ);
+		fLikelyCostQ = spSum(leftLikelyCostQ, fLikelyCostQ);
+
 //		this->pSetResultWithRestrictProjectRename(
 //			sUnion(op0, op1), priorRestriction, priorProjection, null);
 		this->pSetResult(sUnion(op0, op1));
 		}
 
+	// Difference and intersect. The restriction can go down both branches, but the rows must be
+	// compared whole, so any projection has to go on top.
+	void pVisit_Matching(const ZP<Expr_Op2_T<RA::Expr_Rel>>& iExpr, bool iRightLimitsSize)
+		{
+		const ZP<Expr_Bool> priorRestriction = fRestriction;
+		const UniSet<ColName> priorProjection = fProjection;
+		const Rename priorRename_LeafToRoot = fRename_LeafToRoot;
+
+		fProjection = UniSet<ColName>::sUniversal();
+		ZP<RA::Expr_Rel> op0 = this->Do(iExpr->GetOp0());
+		const ZQ<double> leftLikelySizeQ = fLikelySizeQ;
+		const ZQ<double> leftLikelyCostQ = fLikelyCostQ;
+
+		fRestriction = priorRestriction;
+		fProjection = UniSet<ColName>::sUniversal();
+		fRename_LeafToRoot = priorRename_LeafToRoot;
+		ZP<RA::Expr_Rel> op1 = this->Do(iExpr->GetOp1());
+
+		if (iRightLimitsSize && leftLikelySizeQ && fLikelySizeQ)
+			fLikelySizeQ = std::min(*leftLikelySizeQ, *fLikelySizeQ);
+		else
+			fLikelySizeQ = leftLikelySizeQ;
+		fLikelyCostQ = spSum(leftLikelyCostQ, fLikelyCostQ);
+
+		// Our branches' names have already been renamed to those used at the root.
+		ZP<RA::Expr_Rel> theRel = iExpr->Clone(op0, op1);
+
+		bool isUniversal;
+		const RelHead& projectElems = priorProjection.GetElems(isUniversal);
+		if (not isUniversal)
+			theRel = sProject(theRel, RA::sRenamed(priorRename_LeafToRoot, projectElems));
+
+		this->pSetResult(theRel);
+		}
+
 	void pSetResultWithRestrictProjectRename(const ZP<Expr_Rel>& iRel, const ZQ<ColName>& iNameQ)
 		{
 		ZP<Expr_Rel> theResult = spGetResultWithRestrictProjectRename(
@@ -490,19 +633,99 @@ public:
 		return theRel;
 		}
 
+	const ZP<Callable_Estimate> fCallable_Estimate;
+
 	RelHead fBoundNames;
+	// For each product we've made, the names its first operand binds for its second.
+	map<const Expr_Rel*,RelHead> fBindings;
 	ZP<Expr_Bool> fRestriction;
 	UniSet<ColName> fProjection;
 	Rename fRename_LeafToRoot;
 	ZQ<double> fLikelySizeQ;
+	ZQ<double> fLikelyCostQ;
+	};
+
+// =================================================================================================
+#pragma mark - Transform_Bind (anonymous)
+
+/*
+Transform_Bind
+
+Add to the bound names of the searches in each product's second operand those that
+Transform_Search recorded its first operand as binding. An embeddee's searches already
+have the embed's bound names, and nothing from outside it.
+*/
+
+class Transform_Bind
+:	public virtual Visitor_Expr_Op_Do_Transform_T<RA::Expr_Rel>
+,	public virtual RA::Visitor_Expr_Rel_Embed
+,	public virtual RA::Visitor_Expr_Rel_Product
+,	public virtual Visitor_Expr_Rel_Search
+	{
+public:
+	Transform_Bind(const map<const Expr_Rel*,RelHead>& iBindings)
+	:	fBindings(iBindings)
+		{}
+
+	virtual void Visit_Expr_Rel_Embed(const ZP<RA::Expr_Rel_Embed>& iExpr)
+		{
+		ZP<Expr_Rel> newOp0 = this->Do(iExpr->GetOp0());
+
+		SaveSetRestore<RelHead> ssr(fBoundNames, RelHead());
+		ZP<Expr_Rel> newOp1 = this->Do(iExpr->GetOp1());
+
+		this->pSetResult(iExpr->SelfOrClone(newOp0, newOp1));
+		}
+
+	virtual void Visit_Expr_Rel_Product(const ZP<RA::Expr_Rel_Product>& iExpr)
+		{
+		ZP<Expr_Rel> newOp0 = this->Do(iExpr->GetOp0());
+
+		SaveSetRestore<RelHead> ssr(fBoundNames,
+			fBoundNames | sGet(fBindings, iExpr.Get()));
+		ZP<Expr_Rel> newOp1 = this->Do(iExpr->GetOp1());
+
+		this->pSetResult(iExpr->SelfOrClone(newOp0, newOp1));
+		}
+
+	virtual void Visit_Expr_Rel_Search(const ZP<Expr_Rel_Search>& iExpr)
+		{
+		if (sIncludes(iExpr->GetRelHead_Bound(), fBoundNames))
+			{
+			this->pSetResult(iExpr);
+			}
+		else
+			{
+			this->pSetResult(new Expr_Rel_Search(iExpr->GetRelHead_Bound() | fBoundNames,
+				iExpr->GetRename(),
+				iExpr->GetRelHead_Optional(),
+				iExpr->GetExpr_Bool(),
+				iExpr->GetEstimateQ()));
+			}
+		}
+
+private:
+	const map<const Expr_Rel*,RelHead>& fBindings;
+	RelHead fBoundNames;
 	};
 
 } // anonymous namespace
 
 ZP<RA::Expr_Rel> sTransform_Search(const ZP<RA::Expr_Rel>& iExpr)
+	{ return sTransform_Search(iExpr, null); }
+
+ZP<RA::Expr_Rel> sTransform_Search(const ZP<RA::Expr_Rel>& iExpr,
+	const ZP<Callable_Estimate>& iCallable_Estimate)
 	{
-	if (ZP<RA::Expr_Rel> result = Transform_Search().Do(iExpr))
+	Transform_Search theTransform(iCallable_Estimate);
+	if (ZP<RA::Expr_Rel> result = theTransform.Do(iExpr))
+		{
+		// Each of the transform's products visits its operands once, and the bindings that
+		// follow from the order it picked are applied here, so planning stays linear.
+		if (sNotEmpty(theTransform.fBindings))
+			result = Transform_Bind(theTransform.fBindings).Do(result);
 		return result;
+		}
 
 	return iExpr;
 	}
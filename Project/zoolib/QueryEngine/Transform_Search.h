@@ -4,6 +4,7 @@
 #define __ZooLib_QueryEngine_Transform_Search_h__ 1
 #include "zconfig.h"
 
+#include "zoolib/QueryEngine/Estimate.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel.h"
 
 namespace ZooLib {
@@ -14,6 +15,11 @@ namespace QueryEngine {
 
 ZP<RelationalAlgebra::Expr_Rel> sTransform_Search(const ZP<RelationalAlgebra::Expr_Rel>& iExpr);
 
+// iCallable_Estimate is asked about each search we generate, and the answer is attached to the
+// search. Where a product's operands are likely to be cheaper taken the other way round, they are.
+ZP<RelationalAlgebra::Expr_Rel> sTransform_Search(const ZP<RelationalAlgebra::Expr_Rel>& iExpr,
+	const ZP<Callable_Estimate>& iCallable_Estimate);
+
 } // namespace QueryEngine
 } // namespace ZooLib
 
@@ -8,7 +8,9 @@
 
 #include "zoolib/QueryEngine/Walker_Comment.h"
 #include "zoolib/QueryEngine/Walker_Embed.h"
+#include "zoolib/QueryEngine/Walker_HashJoin.h"
 #include "zoolib/QueryEngine/Walker_Product.h"
+#include "zoolib/QueryEngine/Walker_SemiJoin.h"
 #include "zoolib/QueryEngine/Walker_Union.h"
 
 #include "zoolib/pdesc.h"
@@ -37,7 +39,9 @@ public:
 		for (size_t xx = 0; xx < fIndent; ++xx)
 			fW << "\t";
 
-		fW << iWalker->fCalled_Rewind << "\t" << iWalker->fCalled_QReadInc;
+		fW << iWalker->fCalled_Rewind
+			<< "\t" << iWalker->fCalled_QReadInc
+			<< "\t" << iWalker->fCalled_QReadBatch;
 		fW << " " << sTypeIdName(*iWalker.Get());
 
 		++fIndent;
@@ -54,11 +58,21 @@ public:
 			theW->GetLeft()->Accept(*this);
 			theW->GetRight()->Accept(*this);
 			}
+		else if (ZP<Walker_HashJoin> theW = iWalker.DynamicCast<Walker_HashJoin>())
+			{
+			theW->GetLeft()->Accept(*this);
+			theW->GetRight()->Accept(*this);
+			}
 		else if (ZP<Walker_Union> theW = iWalker.DynamicCast<Walker_Union>())
 			{
 			theW->GetLeft()->Accept(*this);
 			theW->GetRight()->Accept(*this);
 			}
+		else if (ZP<Walker_SemiJoin> theW = iWalker.DynamicCast<Walker_SemiJoin>())
+			{
+			theW->GetLeft()->Accept(*this);
+			theW->GetRight()->Accept(*this);
+			}
 		else if (ZP<Walker_Unary> theW = iWalker.DynamicCast<Walker_Unary>())
 			{
 			if (ZP<Walker_Comment> theWalker_Comment = iWalker.DynamicCast<Walker_Comment>())
@@ -4,26 +4,261 @@
 
 #include "zoolib/Log.h"
 #include "zoolib/TypeIdName.h"
+#include "zoolib/Util_STL_set.h"
 
+#include "zoolib/ZMACRO_foreach.h"
+
+#include "zoolib/Expr/Util_Expr_Bool_CNF.h"
+
+#include "zoolib/QueryEngine/Expr_Rel_Search.h"
 #include "zoolib/QueryEngine/Walker_Calc.h"
 #include "zoolib/QueryEngine/Walker_Comment.h"
 #include "zoolib/QueryEngine/Walker_Const.h"
 #include "zoolib/QueryEngine/Walker_Dee.h"
 #include "zoolib/QueryEngine/Walker_Dum.h"
 #include "zoolib/QueryEngine/Walker_Embed.h"
+#include "zoolib/QueryEngine/Walker_HashJoin.h"
 #include "zoolib/QueryEngine/Walker_Product.h"
 #include "zoolib/QueryEngine/Walker_Project.h"
 #include "zoolib/QueryEngine/Walker_Rename.h"
 #include "zoolib/QueryEngine/Walker_Restrict.h"
+#include "zoolib/QueryEngine/Walker_SemiJoin.h"
 #include "zoolib/QueryEngine/Walker_Union.h"
 
+#include "zoolib/RelationalAlgebra/Expr_Rel_Concrete.h"
+
 #include "zoolib/ValPred/Expr_Bool_ValPred.h"
+#include "zoolib/ValPred/Visitor_Expr_Bool_ValPred_Do_GetNames.h"
 
 namespace ZooLib {
 namespace QueryEngine {
 
 namespace RA = RelationalAlgebra;
 
+using RA::RelHead;
+
+using std::vector;
+
+using namespace Util_STL;
+
+// =================================================================================================
+#pragma mark - Visitor_GetNames (anonymous)
+
+namespace { // anonymous
+
+// The names a rel produces, and the names it uses without producing them, which must be
+// bound by whatever encloses it.
+struct Names
+	{
+	RelHead fProduced;
+	RelHead fFree;
+	};
+
+// Rels it doesn't know about get no result, unless the maker knows about them.
+class Visitor_GetNames
+:	public virtual Visitor_Do_T<Names>
+,	public virtual RA::Visitor_Expr_Rel_Calc
+,	public virtual RA::Visitor_Expr_Rel_Comment
+,	public virtual RA::Visitor_Expr_Rel_Concrete
+,	public virtual RA::Visitor_Expr_Rel_Const
+,	public virtual RA::Visitor_Expr_Rel_Dee
+,	public virtual RA::Visitor_Expr_Rel_Difference
+,	public virtual RA::Visitor_Expr_Rel_Dum
+,	public virtual RA::Visitor_Expr_Rel_Embed
+,	public virtual RA::Visitor_Expr_Rel_Intersect
+,	public virtual RA::Visitor_Expr_Rel_Product
+,	public virtual RA::Visitor_Expr_Rel_Project
+,	public virtual RA::Visitor_Expr_Rel_Rename
+,	public virtual RA::Visitor_Expr_Rel_Restrict
+,	public virtual RA::Visitor_Expr_Rel_Union
+,	public virtual Visitor_Expr_Rel_Search
+	{
+public:
+	Visitor_GetNames(Visitor_DoMakeWalker& iMaker)
+	:	fMaker(iMaker)
+		{}
+
+	virtual void Visit(const ZP<Visitee>& iRep)
+		{
+		if (ZP<RA::Expr_Rel> asRel = iRep.DynamicCast<RA::Expr_Rel>())
+			{
+			if (ZQ<RelHead> theQ = fMaker.QGetRelHead_Opaque(asRel))
+				{
+				Names result;
+				result.fProduced = *theQ;
+				this->pSetResult(result);
+				}
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Calc(const ZP<RA::Expr_Rel_Calc>& iExpr)
+		{
+		// A calc's callable sees only the values from its operand.
+		if (ZQ<Names> theQ = this->QDo(iExpr->GetOp0()))
+			{
+			Names result = *theQ;
+			result.fProduced |= iExpr->GetColName();
+			this->pSetResult(result);
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Comment(const ZP<RA::Expr_Rel_Comment>& iExpr)
+		{
+		if (ZQ<Names> theQ = this->QDo(iExpr->GetOp0()))
+			this->pSetResult(*theQ);
+		}
+
+	virtual void Visit_Expr_Rel_Concrete(const ZP<RA::Expr_Rel_Concrete>& iExpr)
+		{
+		Names result;
+		result.fProduced = RA::sRelHead(iExpr->GetConcreteHead());
+		this->pSetResult(result);
+		}
+
+	virtual void Visit_Expr_Rel_Const(const ZP<RA::Expr_Rel_Const>& iExpr)
+		{
+		Names result;
+		result.fProduced |= iExpr->GetColName();
+		this->pSetResult(result);
+		}
+
+	virtual void Visit_Expr_Rel_Dee(const ZP<RA::Expr_Rel_Dee>& iExpr)
+		{ this->pSetResult(Names()); }
+
+	virtual void Visit_Expr_Rel_Difference(const ZP<RA::Expr_Rel_Difference>& iExpr)
+		{ this->pSetResult_Matching(iExpr); }
+
+	virtual void Visit_Expr_Rel_Dum(const ZP<RA::Expr_Rel_Dum>& iExpr)
+		{ this->pSetResult(Names()); }
+
+	virtual void Visit_Expr_Rel_Embed(const ZP<RA::Expr_Rel_Embed>& iExpr)
+		{
+		if (ZQ<Names> theQ0 = this->QDo(iExpr->GetOp0()))
+			{
+			if (ZQ<Names> theQ1 = this->QDo(iExpr->GetOp1()))
+				{
+				Names result;
+				result.fProduced = theQ0->fProduced | iExpr->GetColName();
+				result.fFree = theQ0->fFree | (theQ1->fFree - theQ0->fProduced);
+				this->pSetResult(result);
+				}
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Intersect(const ZP<RA::Expr_Rel_Intersect>& iExpr)
+		{ this->pSetResult_Matching(iExpr); }
+
+	virtual void Visit_Expr_Rel_Product(const ZP<RA::Expr_Rel_Product>& iExpr)
+		{
+		if (ZQ<Names> theQ0 = this->QDo(iExpr->GetOp0()))
+			{
+			if (ZQ<Names> theQ1 = this->QDo(iExpr->GetOp1()))
+				{
+				Names result;
+				result.fProduced = theQ0->fProduced | theQ1->fProduced;
+				result.fFree = theQ0->fFree | (theQ1->fFree - theQ0->fProduced);
+				this->pSetResult(result);
+				}
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Project(const ZP<RA::Expr_Rel_Project>& iExpr)
+		{
+		if (ZQ<Names> theQ = this->QDo(iExpr->GetOp0()))
+			{
+			Names result = *theQ;
+			result.fProduced &= iExpr->GetProjectRelHead();
+			this->pSetResult(result);
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Rename(const ZP<RA::Expr_Rel_Rename>& iExpr)
+		{
+		if (ZQ<Names> theQ = this->QDo(iExpr->GetOp0()))
+			{
+			Names result = *theQ;
+			if (sQErase(result.fProduced, iExpr->GetOld()))
+				result.fProduced |= iExpr->GetNew();
+			this->pSetResult(result);
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Restrict(const ZP<RA::Expr_Rel_Restrict>& iExpr)
+		{
+		if (ZQ<Names> theQ = this->QDo(iExpr->GetOp0()))
+			{
+			Names result = *theQ;
+			result.fFree |= RelHead(sGetNames(iExpr->GetExpr_Bool())) - theQ->fProduced;
+			this->pSetResult(result);
+			}
+		}
+
+	virtual void Visit_Expr_Rel_Union(const ZP<RA::Expr_Rel_Union>& iExpr)
+		{ this->pSetResult_Matching(iExpr); }
+
+	virtual void Visit_Expr_Rel_Search(const ZP<Expr_Rel_Search>& iExpr)
+		{
+		// A search is given every name bound where it sits, but uses only those its
+		// expression mentions.
+		Names result;
+		result.fProduced = RA::sNamesTo(iExpr->GetRename());
+		result.fFree =
+			RelHead(sGetNames(iExpr->GetExpr_Bool())) & iExpr->GetRelHead_Bound();
+		this->pSetResult(result);
+		}
+
+	// Union, difference and intersect, whose operands produce the same names.
+	void pSetResult_Matching(const ZP<Expr_Op2_T<RA::Expr_Rel>>& iExpr)
+		{
+		if (ZQ<Names> theQ0 = this->QDo(iExpr->GetOp0()))
+			{
+			if (ZQ<Names> theQ1 = this->QDo(iExpr->GetOp1()))
+				{
+				Names result = *theQ0;
+				result.fFree |= theQ1->fFree;
+				this->pSetResult(result);
+				}
+			}
+		}
+
+private:
+	Visitor_DoMakeWalker& fMaker;
+	};
+
+// If iExpr is an equality between a name in iNames_Left and one in iNames_Right, returns them.
+ZQ<Walker_HashJoin::NamePair> spQJoinNames(const ZP<Expr_Bool>& iExpr,
+	const RelHead& iNames_Left, const RelHead& iNames_Right)
+	{
+	ZP<Expr_Bool_ValPred> asValPred = iExpr.DynamicCast<Expr_Bool_ValPred>();
+	if (not asValPred)
+		return null;
+
+	const ValPred& theValPred = asValPred->GetValPred();
+
+	ZP<ValComparator_Simple> asSimple =
+		theValPred.GetComparator().DynamicCast<ValComparator_Simple>();
+	if (not asSimple || asSimple->GetEComparator() != ValComparator_Simple::eEQ)
+		return null;
+
+	ZP<ValComparand_Name> asNameL = theValPred.GetLHS().DynamicCast<ValComparand_Name>();
+	ZP<ValComparand_Name> asNameR = theValPred.GetRHS().DynamicCast<ValComparand_Name>();
+	if (not asNameL || not asNameR)
+		return null;
+
+	const string8& theNameL = asNameL->GetName();
+	const string8& theNameR = asNameR->GetName();
+
+	if (sContains(iNames_Left, theNameL) && sContains(iNames_Right, theNameR))
+		return Walker_HashJoin::NamePair(theNameL, theNameR);
+
+	if (sContains(iNames_Left, theNameR) && sContains(iNames_Right, theNameL))
+		return Walker_HashJoin::NamePair(theNameR, theNameL);
+
+	return null;
+	}
+
+} // anonymous namespace
+
 // =================================================================================================
 #pragma mark - Visitor_DoMakeWalker
 
@@ -53,6 +288,17 @@ void Visitor_DoMakeWalker::Visit_Expr_Rel_Const(const ZP<RA::Expr_Rel_Const>& iE
 void Visitor_DoMakeWalker::Visit_Expr_Rel_Dee(const ZP<RA::Expr_Rel_Dee>& iExpr)
 	{ this->pSetResult(new Walker_Dee); }
 
+void Visitor_DoMakeWalker::Visit_Expr_Rel_Difference(const ZP<RA::Expr_Rel_Difference>& iExpr)
+	{
+	if (ZP<Walker> op0 = this->Do(iExpr->GetOp0()))
+		{
+		if (ZP<Walker> op1 = this->Do(iExpr->GetOp1()))
+			this->pSetResult(this->pMakeWalker_SemiJoin(iExpr, op0, op1, false));
+		else
+			this->pSetResult(op0);
+		}
+	}
+
 void Visitor_DoMakeWalker::Visit_Expr_Rel_Dum(const ZP<RA::Expr_Rel_Dum>& iExpr)
 	{ this->pSetResult(new Walker_Dum); }
 
@@ -65,6 +311,15 @@ void Visitor_DoMakeWalker::Visit_Expr_Rel_Embed(const ZP<RA::Expr_Rel_Embed>& iE
 		}
 	}
 
+void Visitor_DoMakeWalker::Visit_Expr_Rel_Intersect(const ZP<RA::Expr_Rel_Intersect>& iExpr)
+	{
+	if (ZP<Walker> op0 = this->Do(iExpr->GetOp0()))
+		{
+		if (ZP<Walker> op1 = this->Do(iExpr->GetOp1()))
+			this->pSetResult(this->pMakeWalker_SemiJoin(iExpr, op0, op1, true));
+		}
+	}
+
 void Visitor_DoMakeWalker::Visit_Expr_Rel_Product(const ZP<RA::Expr_Rel_Product>& iExpr)
 	{
 	if (ZP<Walker> op0 = this->Do(iExpr->GetOp0()))
@@ -88,6 +343,12 @@ void Visitor_DoMakeWalker::Visit_Expr_Rel_Rename(const ZP<RA::Expr_Rel_Rename>&
 
 void Visitor_DoMakeWalker::Visit_Expr_Rel_Restrict(const ZP<RA::Expr_Rel_Restrict>& iExpr)
 	{
+	if (ZP<Walker> theWalker = this->pMakeWalker_HashJoin(iExpr))
+		{
+		this->pSetResult(theWalker);
+		return;
+		}
+
 	if (ZP<Walker> op0 = this->Do(iExpr->GetOp0()))
 		this->pSetResult(new Walker_Restrict(op0, iExpr->GetExpr_Bool()));
 	}
@@ -105,5 +366,85 @@ void Visitor_DoMakeWalker::Visit_Expr_Rel_Union(const ZP<RA::Expr_Rel_Union>& iE
 		this->pSetResult(op1);
 	}
 
+ZQ<RelHead> Visitor_DoMakeWalker::QGetRelHead_Opaque(const ZP<RA::Expr_Rel>& iRel)
+	{ return null; }
+
+ZP<Walker> Visitor_DoMakeWalker::pMakeWalker_HashJoin(const ZP<RA::Expr_Rel_Restrict>& iExpr)
+	{
+	// Restricts have usually been decomposed into a stack of them, one per clause.
+	ZP<Expr_Bool> theExpr_Bool = iExpr->GetExpr_Bool();
+	ZP<RA::Expr_Rel> theOp0 = iExpr->GetOp0();
+	while (ZP<RA::Expr_Rel_Restrict> asRestrict = theOp0.DynamicCast<RA::Expr_Rel_Restrict>())
+		{
+		theExpr_Bool &= asRestrict->GetExpr_Bool();
+		theOp0 = asRestrict->GetOp0();
+		}
+
+	ZP<RA::Expr_Rel_Product> asProduct = theOp0.DynamicCast<RA::Expr_Rel_Product>();
+	if (not asProduct)
+		return null;
+
+	// The right side will be read independently of the left, so must not use its values.
+	const ZQ<Names> theQ_Left = Visitor_GetNames(*this).QDo(asProduct->GetOp0());
+	const ZQ<Names> theQ_Right = Visitor_GetNames(*this).QDo(asProduct->GetOp1());
+	if (not theQ_Left || not theQ_Right
+		|| sNotEmpty(theQ_Right->fFree & theQ_Left->fProduced))
+		{ return null; }
+
+	// Take each clause that's a cross-side equality as a join column, and keep the rest.
+	vector<Walker_HashJoin::NamePair> theNames;
+	ZP<Expr_Bool> theRemainder;
+	foreacha (clause, Util_Expr_Bool::sAsCNF(theExpr_Bool))
+		{
+		if (clause.size() == 1)
+			{
+			if (ZQ<Walker_HashJoin::NamePair> theQ = spQJoinNames(
+				clause.begin()->Get(), theQ_Left->fProduced, theQ_Right->fProduced))
+				{
+				theNames.push_back(*theQ);
+				continue;
+				}
+			}
+
+		ZP<Expr_Bool> theClause;
+		foreacha (disjunction, clause)
+			theClause |= disjunction.Get();
+
+		if (theRemainder)
+			theRemainder &= theClause;
+		else
+			theRemainder = theClause;
+		}
+
+	if (theNames.empty())
+		return null;
+
+	ZP<Walker> op0 = this->Do(asProduct->GetOp0());
+	if (not op0)
+		return null;
+
+	ZP<Walker> op1 = this->Do(asProduct->GetOp1());
+	if (not op1)
+		return null;
+
+	ZP<Walker> result =
+		new Walker_HashJoin(op0, op1, theNames, theQ_Left->fFree | theQ_Right->fFree);
+	if (theRemainder)
+		result = new Walker_Restrict(result, theRemainder);
+	return result;
+	}
+
+ZP<Walker> Visitor_DoMakeWalker::pMakeWalker_SemiJoin(
+	const ZP<Expr_Op2_T<RA::Expr_Rel>>& iExpr,
+	const ZP<Walker>& iWalker_Left, const ZP<Walker>& iWalker_Right, bool iKeepFound)
+	{
+	// The right's rows are kept across a Rewind for as long as the values it uses are unchanged.
+	ZQ<RelHead> theNames_BoundQ;
+	if (ZQ<Names> theQ = Visitor_GetNames(*this).QDo(iExpr->GetOp1()))
+		theNames_BoundQ = theQ->fFree;
+
+	return new Walker_SemiJoin(iWalker_Left, iWalker_Right, iKeepFound, theNames_BoundQ);
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
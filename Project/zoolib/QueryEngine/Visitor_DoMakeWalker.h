@@ -12,8 +12,10 @@
 #include "zoolib/RelationalAlgebra/Expr_Rel_Comment.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Const.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Dee.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Difference.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Dum.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Embed.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Intersect.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Product.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Project.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Rename.h"
@@ -32,8 +34,10 @@ class Visitor_DoMakeWalker
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Const
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Comment
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Dee
+,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Difference
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Dum
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Embed
+,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Intersect
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Product
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Project
 ,	public virtual RelationalAlgebra::Visitor_Expr_Rel_Rename
@@ -49,13 +53,32 @@ public:
 	virtual void Visit_Expr_Rel_Comment(const ZP<RelationalAlgebra::Expr_Rel_Comment>& iExpr);
 	virtual void Visit_Expr_Rel_Const(const ZP<RelationalAlgebra::Expr_Rel_Const>& iExpr);
 	virtual void Visit_Expr_Rel_Dee(const ZP<RelationalAlgebra::Expr_Rel_Dee>& iExpr);
+	virtual void Visit_Expr_Rel_Difference(
+		const ZP<RelationalAlgebra::Expr_Rel_Difference>& iExpr);
 	virtual void Visit_Expr_Rel_Dum(const ZP<RelationalAlgebra::Expr_Rel_Dum>& iExpr);
 	virtual void Visit_Expr_Rel_Embed(const ZP<RelationalAlgebra::Expr_Rel_Embed>& iExpr);
+	virtual void Visit_Expr_Rel_Intersect(const ZP<RelationalAlgebra::Expr_Rel_Intersect>& iExpr);
 	virtual void Visit_Expr_Rel_Product(const ZP<RelationalAlgebra::Expr_Rel_Product>& iExpr);
 	virtual void Visit_Expr_Rel_Project(const ZP<RelationalAlgebra::Expr_Rel_Project>& iExpr);
 	virtual void Visit_Expr_Rel_Rename(const ZP<RelationalAlgebra::Expr_Rel_Rename>& iExpr);
 	virtual void Visit_Expr_Rel_Restrict(const ZP<RelationalAlgebra::Expr_Rel_Restrict>& iExpr);
 	virtual void Visit_Expr_Rel_Union(const ZP<RelationalAlgebra::Expr_Rel_Union>& iExpr);
+
+// Our protocol
+	// The names produced by iRel, a leaf we don't otherwise know about that uses no names
+	// bound outside it. Null if iRel isn't such a thing, which is all we assume by default.
+	virtual ZQ<RelationalAlgebra::RelHead> QGetRelHead_Opaque(
+		const ZP<RelationalAlgebra::Expr_Rel>& iRel);
+
+protected:
+	// A Walker_HashJoin if iExpr, possibly with more restricts under it, restricts a product
+	// by equalities between columns of the two sides, otherwise null.
+	ZP<Walker> pMakeWalker_HashJoin(const ZP<RelationalAlgebra::Expr_Rel_Restrict>& iExpr);
+
+	// A Walker_SemiJoin for a difference (not iKeepFound) or intersect (iKeepFound) of
+	// iWalker_Left and iWalker_Right, made from iExpr.
+	ZP<Walker> pMakeWalker_SemiJoin(const ZP<Expr_Op2_T<RelationalAlgebra::Expr_Rel>>& iExpr,
+		const ZP<Walker>& iWalker_Left, const ZP<Walker>& iWalker_Right, bool iKeepFound);
 	};
 
 } // namespace QueryEngine
@@ -2,6 +2,10 @@
 
 #include "zoolib/QueryEngine/Walker.h"
 
+#include "zoolib/Compare_T.h"
+
+#include <algorithm> // For std::swap_ranges
+
 namespace ZooLib {
 namespace QueryEngine {
 
@@ -12,6 +16,7 @@ Walker::Walker()
 	{
 	fCalled_Rewind = 0;
 	fCalled_QReadInc = 0;
+	fCalled_QReadBatch = 0;
 	}
 
 Walker::~Walker()
@@ -28,6 +33,16 @@ void Walker::Accept(const Visitor& iVisitor)
 void Walker::Accept_Walker(Visitor_Walker& iVisitor)
 	{ iVisitor.Visit_Walker(this); }
 
+size_t Walker::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	size_t result = 0;
+	while (result < iCount && this->QReadInc(ioRows + result * iStride))
+		++result;
+	return result;
+	}
+
 void Walker::Called_Rewind()
 	{
 	++fCalled_Rewind;
@@ -38,6 +53,146 @@ void Walker::Called_QReadInc()
 	++fCalled_QReadInc;
 	}
 
+void Walker::Called_QReadBatch()
+	{
+	++fCalled_QReadBatch;
+	}
+
+// =================================================================================================
+#pragma mark - sSwapRows
+
+void sSwapRows(Val_DB* ioRows, size_t iStride, size_t iRowA, size_t iRowB)
+	{
+	std::swap_ranges(
+		ioRows + iRowA * iStride, ioRows + (iRowA + 1) * iStride, ioRows + iRowB * iStride);
+	}
+
+// =================================================================================================
+#pragma mark - sHash
+
+static size_t spMixed(uint64 iHash)
+	{
+	// std::hash of an integer is often the integer itself. Mix the bits, so that tables
+	// indexed by the low bits don't see the same few values.
+	iHash ^= iHash >> 33;
+	iHash *= 0xFF51AFD7ED558CCDULL;
+	iHash ^= iHash >> 33;
+	return size_t(iHash);
+	}
+
+size_t sHash(const Val_DB* iVals, size_t iCount)
+	{
+	uint64 result = 0;
+	for (size_t xx = 0; xx < iCount; ++xx)
+		result = result * 1000003 ^ ZooLib::sHash(iVals[xx]);
+	return spMixed(result);
+	}
+
+size_t sHash(const Val_DB* const* iValPtrs, size_t iCount)
+	{
+	uint64 result = 0;
+	for (size_t xx = 0; xx < iCount; ++xx)
+		result = result * 1000003 ^ ZooLib::sHash(*iValPtrs[xx]);
+	return spMixed(result);
+	}
+
+// =================================================================================================
+#pragma mark - RowSet
+
+static const size_t kRowsPerChunk = 256;
+
+RowSet::RowSet(size_t iWidth)
+:	fWidth(iWidth)
+,	fCount(0)
+	{}
+
+void RowSet::Clear()
+	{
+	fCount = 0;
+	fChunks.clear();
+	fHashes.clear();
+	fSlots.clear();
+	}
+
+bool RowSet::Insert(const Val_DB* iRow)
+	{
+	// Keep the load at no more than a half.
+	if (2 * (fCount + 1) > fSlots.size())
+		this->pGrow();
+
+	const size_t theHash = sHash(iRow, fWidth);
+	const size_t theSlot = this->pFind(iRow, theHash);
+	if (fSlots[theSlot])
+		return false;
+
+	if (fWidth)
+		{
+		if (fCount % kRowsPerChunk == 0)
+			{
+			fChunks.push_back(std::vector<Val_DB>());
+			fChunks.back().reserve(kRowsPerChunk * fWidth);
+			}
+		fChunks.back().insert(fChunks.back().end(), iRow, iRow + fWidth);
+		}
+
+	fHashes.push_back(theHash);
+	fSlots[theSlot] = ++fCount;
+	return true;
+	}
+
+bool RowSet::Contains(const Val_DB* iRow) const
+	{
+	if (not fCount)
+		return false;
+	return fSlots[this->pFind(iRow, sHash(iRow, fWidth))];
+	}
+
+size_t RowSet::Count() const
+	{ return fCount; }
+
+const Val_DB* RowSet::pRow(size_t iIndex) const
+	{ return fChunks[iIndex / kRowsPerChunk].data() + (iIndex % kRowsPerChunk) * fWidth; }
+
+size_t RowSet::pFind(const Val_DB* iRow, size_t iHash) const
+	{
+	// Returns the slot holding iRow, or else the empty slot where it would go.
+	const size_t theMask = fSlots.size() - 1;
+	for (size_t theSlot = iHash & theMask; /*no test*/; theSlot = (theSlot + 1) & theMask)
+		{
+		const size_t theEntry = fSlots[theSlot];
+		if (not theEntry)
+			return theSlot;
+
+		if (fHashes[theEntry - 1] != iHash)
+			continue;
+
+		// Rows of no values are all the same row, and have no storage.
+		if (not fWidth)
+			return theSlot;
+
+		// Hashes can collide, so check the values themselves.
+		const Val_DB* theRow = this->pRow(theEntry - 1);
+		size_t xx = 0;
+		while (xx < fWidth && 0 == sCompare_T(theRow[xx], iRow[xx]))
+			++xx;
+		if (xx == fWidth)
+			return theSlot;
+		}
+	}
+
+void RowSet::pGrow()
+	{
+	fSlots.assign(fSlots.empty() ? 16 : 2 * fSlots.size(), 0);
+	const size_t theMask = fSlots.size() - 1;
+	for (size_t xx = 0; xx < fCount; ++xx)
+		{
+		size_t theSlot = fHashes[xx] & theMask;
+		while (fSlots[theSlot])
+			theSlot = (theSlot + 1) & theMask;
+		fSlots[theSlot] = xx + 1;
+		}
+	}
+
 // =================================================================================================
 #pragma mark - Visitor_Walker
 
@@ -9,6 +9,7 @@
 #include "zoolib/Visitor.h"
 
 #include <set>
+#include <vector>
 
 namespace ZooLib {
 namespace QueryEngine {
@@ -41,13 +42,72 @@ public:
 
 	virtual bool QReadInc(Val_DB* ioResults) = 0;
 
+	// Reads up to iCount rows, row xx being the iStride values starting at ioRows + xx * iStride,
+	// and returns the number read. Fewer than iCount are returned only when we're exhausted.
+	// As with QReadInc, every row must on entry hold the values bound outside of us. The
+	// default reads each row with QReadInc.
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 protected:
 	void Called_Rewind();
 	void Called_QReadInc();
+	void Called_QReadBatch();
 
 public:
 	size_t fCalled_Rewind;
 	size_t fCalled_QReadInc;
+	size_t fCalled_QReadBatch;
+	};
+
+// Exchanges the iStride values of rows iRowA and iRowB, for walkers that compact a batch.
+void sSwapRows(Val_DB* ioRows, size_t iStride, size_t iRowA, size_t iRowB);
+
+// A hash of iCount values, for walkers that hash rows, built on sHash(const Val_ZZ&).
+size_t sHash(const Val_DB* iVals, size_t iCount);
+
+// The same hash, of values held elsewhere.
+size_t sHash(const Val_DB* const* iValPtrs, size_t iCount);
+
+// =================================================================================================
+#pragma mark - RowSet
+
+// A hash set of rows of the same width, for walkers that need to know which rows they've seen.
+//
+// It's open addressed with linear probing, and each slot holds a row's index. Rows are copied
+// into chunks that are never reallocated, so adding a row costs no allocation in the common
+// case, and never moves the rows already held.
+
+class RowSet
+	{
+public:
+	explicit RowSet(size_t iWidth = 0);
+
+	void Clear();
+
+	// Returns true if iRow was not already in the set.
+	bool Insert(const Val_DB* iRow);
+
+	bool Contains(const Val_DB* iRow) const;
+
+	size_t Count() const;
+
+private:
+	const Val_DB* pRow(size_t iIndex) const;
+	size_t pFind(const Val_DB* iRow, size_t iHash) const;
+	void pGrow();
+
+	size_t fWidth;
+	size_t fCount;
+
+	// The rows themselves, fWidth values each.
+	std::vector<std::vector<Val_DB>> fChunks;
+
+	// Each row's hash, so growing the table needn't rehash, and probes compare only the rows
+	// whose hash matches.
+	std::vector<size_t> fHashes;
+
+	// A power of two in size, each slot zero or one more than the index of a row.
+	std::vector<size_t> fSlots;
 	};
 
 // =================================================================================================
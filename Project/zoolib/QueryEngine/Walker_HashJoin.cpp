@@ -0,0 +1,269 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/QueryEngine/Walker_HashJoin.h"
+
+#include "zoolib/Compare_T.h"
+#include "zoolib/Util_STL_map.h"
+
+#include "zoolib/ZMACRO_foreach.h"
+
+#include <iterator> // For std::distance
+
+namespace ZooLib {
+namespace QueryEngine {
+
+using std::map;
+using std::vector;
+
+using namespace Util_STL;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+void spSetOffsets(const map<string8,size_t>& iOffsets, const vector<string8>& iKeyNames,
+	vector<size_t>& oOffsets, vector<size_t>& oKeys)
+	{
+	oOffsets.clear();
+	foreacha (entry, iOffsets)
+		oOffsets.push_back(entry.second);
+
+	oKeys.clear();
+	foreacha (entry, iKeyNames)
+		{
+		const map<string8,size_t>::const_iterator iter = iOffsets.find(entry);
+		ZAssert(iter != iOffsets.end());
+		oKeys.push_back(std::distance(iOffsets.begin(), iter));
+		}
+	}
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - Walker_HashJoin
+
+Walker_HashJoin::Walker_HashJoin(const ZP<Walker>& iWalker_Left, const ZP<Walker>& iWalker_Right,
+	const vector<NamePair>& iNames,
+	const std::set<string8>& iNames_Bound)
+:	fNames(iNames)
+,	fNames_Bound(iNames_Bound)
+,	fRewound(false)
+,	fBuild(nullptr)
+,	fProbe(nullptr)
+,	fProbeIndex(0)
+,	fMatches(fTable.end(), fTable.end())
+	{
+	fLeft.fWalker = iWalker_Left;
+	fLeft.fExhausted = false;
+	fRight.fWalker = iWalker_Right;
+	fRight.fExhausted = false;
+	}
+
+Walker_HashJoin::~Walker_HashJoin()
+	{}
+
+void Walker_HashJoin::Rewind()
+	{
+	this->Called_Rewind();
+
+	fLeft.fWalker->Rewind();
+	fRight.fWalker->Rewind();
+
+	if (not fBuild)
+		{
+		this->pReset(fLeft);
+		this->pReset(fRight);
+		return;
+		}
+
+	// Keep the build side and its table, unless QReadInc finds the bound values have changed.
+	// The probe side is read again from its start.
+	this->pReset(*fProbe);
+	fRewound = true;
+	fProbeIndex = 0;
+	fMatches = std::make_pair(fTable.end(), fTable.end());
+	}
+
+ZP<Walker> Walker_HashJoin::Prime(
+	const map<string8,size_t>& iOffsets,
+	map<string8,size_t>& oOffsets,
+	size_t& ioBaseOffset)
+	{
+	map<string8,size_t> leftOffsets;
+	fLeft.fWalker = fLeft.fWalker->Prime(iOffsets, leftOffsets, ioBaseOffset);
+	oOffsets.insert(leftOffsets.begin(), leftOffsets.end());
+
+	// The right gets to see the left's offsets, just as in a product, even though it must not
+	// use the left's values -- searches record the names bound to their left regardless.
+	map<string8,size_t> combined = iOffsets;
+	combined.insert(leftOffsets.begin(), leftOffsets.end());
+
+	map<string8,size_t> rightOffsets;
+	fRight.fWalker = fRight.fWalker->Prime(combined, rightOffsets, ioBaseOffset);
+	oOffsets.insert(rightOffsets.begin(), rightOffsets.end());
+
+	if (not fLeft.fWalker || not fRight.fWalker)
+		return null;
+
+	vector<string8> theNames_Left;
+	vector<string8> theNames_Right;
+	foreacha (entry, fNames)
+		{
+		theNames_Left.push_back(entry.first);
+		theNames_Right.push_back(entry.second);
+		}
+
+	spSetOffsets(leftOffsets, theNames_Left, fLeft.fOffsets, fLeft.fKeys);
+	spSetOffsets(rightOffsets, theNames_Right, fRight.fOffsets, fRight.fKeys);
+
+	fBound_Offsets.clear();
+	foreacha (entry, fNames_Bound)
+		{
+		if (const size_t* theP = sPGet(iOffsets, entry))
+			fBound_Offsets.push_back(*theP);
+		}
+
+	return this;
+	}
+
+bool Walker_HashJoin::QReadInc(Val_DB* ioResults)
+	{
+	this->Called_QReadInc();
+
+	if (fRewound)
+		{
+		fRewound = false;
+		for (size_t xx = 0; xx < fBound_Offsets.size(); ++xx)
+			{
+			if (0 != sCompare_T(ioResults[fBound_Offsets[xx]], fBound[xx]))
+				{
+				this->pReset(*fBuild);
+				fBuild = nullptr;
+				fProbe = nullptr;
+				fTable.clear();
+				break;
+				}
+			}
+		}
+
+	if (not fBuild)
+		this->pLoad(ioResults);
+
+	const size_t theWidth_Build = fBuild->fOffsets.size();
+	const size_t theWidth_Probe = fProbe->fOffsets.size();
+	const size_t theKeyCount = fProbeKey.size();
+
+	for (;;)
+		{
+		while (fMatches.first != fMatches.second)
+			{
+			const Val_DB* theRow_Build =
+				&fBuild->fRows[(fMatches.first++)->second * theWidth_Build];
+
+			// Hashes can collide, so check the values themselves.
+			bool isMatch = true;
+			for (size_t xx = 0; isMatch && xx < theKeyCount; ++xx)
+				isMatch = 0 == sCompare_T(theRow_Build[fBuild->fKeys[xx]], fProbeKey[xx]);
+
+			if (isMatch)
+				{
+				for (size_t xx = 0; xx < theWidth_Probe; ++xx)
+					ioResults[fProbe->fOffsets[xx]] = fProbeRow[xx];
+
+				for (size_t xx = 0; xx < theWidth_Build; ++xx)
+					ioResults[fBuild->fOffsets[xx]] = theRow_Build[xx];
+
+				return true;
+				}
+			}
+
+		if (fProbeIndex < fProbe->fRows.size())
+			{
+			std::copy_n(&fProbe->fRows[fProbeIndex], theWidth_Probe, fProbeRow.begin());
+			fProbeIndex += theWidth_Probe;
+			}
+		else if (fProbe->fExhausted || not fProbe->fWalker->QReadInc(ioResults))
+			{
+			fProbe->fExhausted = true;
+			return false;
+			}
+		else
+			{
+			for (size_t xx = 0; xx < theWidth_Probe; ++xx)
+				fProbeRow[xx] = ioResults[fProbe->fOffsets[xx]];
+			}
+
+		for (size_t xx = 0; xx < theKeyCount; ++xx)
+			fProbeKey[xx] = fProbeRow[fProbe->fKeys[xx]];
+
+		fMatches = fTable.equal_range(sHash(&fProbeKey[0], theKeyCount));
+		}
+	}
+
+bool Walker_HashJoin::pReadInto(Side& ioSide, Val_DB* ioResults)
+	{
+	if (not ioSide.fWalker->QReadInc(ioResults))
+		{
+		ioSide.fExhausted = true;
+		return false;
+		}
+
+	foreacha (entry, ioSide.fOffsets)
+		ioSide.fRows.push_back(ioResults[entry]);
+
+	return true;
+	}
+
+void Walker_HashJoin::pLoad(Val_DB* ioResults)
+	{
+	fBound.clear();
+	foreacha (entry, fBound_Offsets)
+		fBound.push_back(ioResults[entry]);
+
+	for (;;)
+		{
+		if (not this->pReadInto(fLeft, ioResults))
+			{
+			fBuild = &fLeft;
+			fProbe = &fRight;
+			break;
+			}
+
+		if (not this->pReadInto(fRight, ioResults))
+			{
+			fBuild = &fRight;
+			fProbe = &fLeft;
+			break;
+			}
+		}
+
+	const size_t theWidth = fBuild->fOffsets.size();
+	const size_t theKeyCount = fBuild->fKeys.size();
+	const size_t theCount = fBuild->fRows.size() / theWidth;
+
+	fTable.reserve(theCount);
+
+	vector<Val_DB> theKey(theKeyCount);
+	for (size_t xx = 0; xx < theCount; ++xx)
+		{
+		const Val_DB* theRow = &fBuild->fRows[xx * theWidth];
+		for (size_t yy = 0; yy < theKeyCount; ++yy)
+			theKey[yy] = theRow[fBuild->fKeys[yy]];
+		fTable.insert(std::make_pair(sHash(&theKey[0], theKeyCount), xx));
+		}
+
+	fProbeIndex = 0;
+	fProbeRow.resize(fProbe->fOffsets.size());
+	fProbeKey.resize(theKeyCount);
+	fMatches = std::make_pair(fTable.end(), fTable.end());
+	}
+
+void Walker_HashJoin::pReset(Side& ioSide)
+	{
+	ioSide.fRows.clear();
+	ioSide.fExhausted = false;
+	}
+
+} // namespace QueryEngine
+} // namespace ZooLib
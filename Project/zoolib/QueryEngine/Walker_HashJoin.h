@@ -0,0 +1,104 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_QueryEngine_Walker_HashJoin_h__
+#define __ZooLib_QueryEngine_Walker_HashJoin_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/QueryEngine/Walker.h"
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace ZooLib {
+namespace QueryEngine {
+
+// =================================================================================================
+#pragma mark - Walker_HashJoin
+
+// The rows of the product of left and right in which each of the left's columns named by
+// iNames equals the corresponding right column. The right must not use the left's values.
+//
+// Both sides are read a row at a time in turn, until one is exhausted. That's the smaller
+// side, and its rows go into a hash table keyed by its join columns. The other side's rows
+// already read, and then the rest of them, are looked up in the table. So a join costs
+// O(|L| + |R|) rather than the nested loop's O(|L| * |R|).
+//
+// iNames_Bound are the names from outside the join that either side uses. The table survives
+// a Rewind, and is rebuilt only if the values bound to those names have changed since it was
+// built, so the inner side of a product isn't reloaded for every row of the outer side.
+
+class Walker_HashJoin : public Walker
+	{
+public:
+	typedef std::pair<string8,string8> NamePair;
+
+	Walker_HashJoin(const ZP<Walker>& iWalker_Left, const ZP<Walker>& iWalker_Right,
+		const std::vector<NamePair>& iNames,
+		const std::set<string8>& iNames_Bound);
+
+	virtual ~Walker_HashJoin();
+
+// From QueryEngine::Walker
+	virtual void Rewind();
+
+	virtual ZP<Walker> Prime(
+		const std::map<string8,size_t>& iOffsets,
+		std::map<string8,size_t>& oOffsets,
+		size_t& ioBaseOffset);
+
+	virtual bool QReadInc(Val_DB* ioResults);
+
+// Our protocol
+	ZP<Walker> GetLeft()
+		{ return fLeft.fWalker; }
+
+	ZP<Walker> GetRight()
+		{ return fRight.fWalker; }
+
+private:
+	struct Side
+		{
+		ZP<Walker> fWalker;
+
+		// Where each of our columns is in a row, and which of them are the join columns.
+		std::vector<size_t> fOffsets;
+		std::vector<size_t> fKeys;
+
+		// Rows read before we knew which side is which, fOffsets.size() values each.
+		std::vector<Val_DB> fRows;
+		bool fExhausted;
+		};
+
+	bool pReadInto(Side& ioSide, Val_DB* ioResults);
+	void pLoad(Val_DB* ioResults);
+	void pReset(Side& ioSide);
+
+	const std::vector<NamePair> fNames;
+	const std::set<string8> fNames_Bound;
+
+	// Where the bound values are, and what they were when the table was built.
+	std::vector<size_t> fBound_Offsets;
+	std::vector<Val_DB> fBound;
+	bool fRewound;
+
+	Side fLeft;
+	Side fRight;
+
+	Side* fBuild;
+	Side* fProbe;
+
+	// From the hash of a build row's key to the row's index.
+	typedef std::unordered_multimap<size_t,size_t> Table;
+	Table fTable;
+
+	size_t fProbeIndex;
+	std::vector<Val_DB> fProbeRow;
+	std::vector<Val_DB> fProbeKey;
+	std::pair<Table::const_iterator,Table::const_iterator> fMatches;
+	};
+
+} // namespace QueryEngine
+} // namespace ZooLib
+
+#endif // __ZooLib_QueryEngine_Walker_HashJoin_h__
@@ -84,5 +84,47 @@ bool Walker_Product::QReadInc(Val_DB* ioResults)
 		}
 	}
 
+size_t Walker_Product::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	size_t result = 0;
+	while (result < iCount)
+		{
+		if (fNeedLoadLeft)
+			{
+			fWalker_Right->Rewind();
+			fNeedLoadLeft = false;
+
+			Val_DB* theRow = ioRows + result * iStride;
+			if (not fWalker_Left->QReadInc(theRow))
+				break;
+
+			std::copy_n(theRow, fResults_Left.size(), fResults_Left.begin());
+			}
+
+		// Every row handed to the right walker must hold the left values. The right walker may
+		// produce only a few rows for each left row, so rather than filling the rest of the
+		// batch each time we hand it a doubling number of rows.
+		for (size_t theChunk = 1; result < iCount; theChunk *= 2)
+			{
+			const size_t theWanted = std::min(theChunk, iCount - result);
+			Val_DB* theRows = ioRows + result * iStride;
+			for (size_t xx = 0; xx < theWanted; ++xx)
+				std::copy(fResults_Left.begin(), fResults_Left.end(), theRows + xx * iStride);
+
+			const size_t theRead = fWalker_Right->QReadBatch(theRows, iStride, theWanted);
+			result += theRead;
+			if (theRead < theWanted)
+				{
+				fNeedLoadLeft = true;
+				break;
+				}
+			}
+		}
+
+	return result;
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
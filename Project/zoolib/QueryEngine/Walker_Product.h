@@ -28,6 +28,8 @@ public:
 
 	virtual bool QReadInc(Val_DB* ioResults);
 
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 // Our protocol
 	ZP<Walker> GetLeft()
 		{ return fWalker_Left; }
@@ -10,7 +10,6 @@ namespace ZooLib {
 namespace QueryEngine {
 
 using std::map;
-using std::set;
 using std::vector;
 
 // =================================================================================================
@@ -27,7 +26,7 @@ Walker_Project::~Walker_Project()
 void Walker_Project::Rewind()
 	{
 	Walker_Unary::Rewind();
-	fPriors.clear();
+	fPriors.Clear();
 	}
 
 ZP<Walker> Walker_Project::Prime(
@@ -38,6 +37,27 @@ ZP<Walker> Walker_Project::Prime(
 	map<string8,size_t> childOffsets;
 	fWalker = fWalker->Prime(iOffsets, childOffsets, ioBaseOffset);
 
+	// If we'd keep every one of our child's names its rows are already distinct, and there's
+	// nothing for us to do.
+	if (fWalker && childOffsets.size() == fRelHead.size())
+		{
+		bool isIdentity = true;
+		foreacha (entry, childOffsets)
+			{
+			if (not Util_STL::sContains(fRelHead, entry.first))
+				{
+				isIdentity = false;
+				break;
+				}
+			}
+
+		if (isIdentity)
+			{
+			oOffsets.insert(childOffsets.begin(), childOffsets.end());
+			return fWalker;
+			}
+		}
+
 	foreacha (entry, fRelHead)
 		{
 		const size_t childOffset = childOffsets[entry];
@@ -45,6 +65,9 @@ ZP<Walker> Walker_Project::Prime(
 		oOffsets[entry] = childOffset;
 		}
 
+	fSubset.resize(fChildMapping.size());
+	fPriors = RowSet(fChildMapping.size());
+
 	if (not fWalker)
 		return null;
 
@@ -62,15 +85,50 @@ bool Walker_Project::QReadInc(Val_DB* ioResults)
 		if (not fWalker->QReadInc(ioResults))
 			return false;
 
-		vector<Val_DB> subset;
-		subset.reserve(count);
 		for (size_t xx = 0; xx < count; ++xx)
-			subset.push_back(ioResults[fChildMapping[xx]]);
+			fSubset[xx] = ioResults[fChildMapping[xx]];
 
-		if (Util_STL::sQInsert(fPriors, subset))
+		if (fPriors.Insert(fSubset.data()))
 			return true;
 		}
 	}
 
+size_t Walker_Project::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	const size_t count = fRelHead.size();
+
+	size_t result = 0;
+	while (result < iCount)
+		{
+		Val_DB* theRows = ioRows + result * iStride;
+		const size_t theWanted = iCount - result;
+		const size_t theRead = fWalker->QReadBatch(theRows, iStride, theWanted);
+
+		// Keep the rows whose projection is new, moving them down to close the gaps.
+		size_t theKept = 0;
+		for (size_t xx = 0; xx < theRead; ++xx)
+			{
+			const Val_DB* theRow = theRows + xx * iStride;
+			for (size_t yy = 0; yy < count; ++yy)
+				fSubset[yy] = theRow[fChildMapping[yy]];
+
+			if (fPriors.Insert(fSubset.data()))
+				{
+				if (theKept != xx)
+					sSwapRows(theRows, iStride, xx, theKept);
+				++theKept;
+				}
+			}
+		result += theKept;
+
+		if (theRead < theWanted)
+			break;
+		}
+
+	return result;
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
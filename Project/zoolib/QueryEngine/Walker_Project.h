@@ -29,10 +29,13 @@ public:
 
 	virtual bool QReadInc(Val_DB* ioResults);
 
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 private:
 	const RelationalAlgebra::RelHead fRelHead;
 	std::vector<size_t> fChildMapping;
-	std::set<std::vector<Val_DB>> fPriors;
+	RowSet fPriors;
+	std::vector<Val_DB> fSubset;
 	};
 
 } // namespace QueryEngine
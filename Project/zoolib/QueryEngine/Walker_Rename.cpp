@@ -48,5 +48,11 @@ bool Walker_Rename::QReadInc(Val_DB* ioResults)
 	return fWalker->QReadInc(ioResults);
 	}
 
+size_t Walker_Rename::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+	return fWalker->QReadBatch(ioRows, iStride, iCount);
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
@@ -26,6 +26,8 @@ public:
 
 	virtual bool QReadInc(Val_DB* ioResults);
 
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 private:
 	const string8 fNew;
 	const string8 fOld;
@@ -33,6 +33,21 @@ public:
 	virtual ~Exec() {}
 
 	virtual bool Call(const Val_DB* iVars, const Val_DB* iConsts) = 0;
+
+	// ioSelection holds iCount indices of rows, in ascending order. Those rows that satisfy us
+	// are moved to the front, in the same order, and their number returned.
+	virtual size_t Select(const Val_DB* iRows, size_t iStride, const Val_DB* iConsts,
+		size_t* ioSelection, size_t iCount)
+		{
+		size_t result = 0;
+		for (size_t xx = 0; xx < iCount; ++xx)
+			{
+			const size_t theRow = ioSelection[xx];
+			if (this->Call(iRows + theRow * iStride, iConsts))
+				ioSelection[result++] = theRow;
+			}
+		return result;
+		}
 	};
 
 // =================================================================================================
@@ -45,6 +60,10 @@ class Exec_False : public Walker_Restrict::Exec
 public:
 	virtual bool Call(const Val_DB* iVars, const Val_DB* iConsts)
 		{ return false; }
+
+	virtual size_t Select(const Val_DB* iRows, size_t iStride, const Val_DB* iConsts,
+		size_t* ioSelection, size_t iCount)
+		{ return 0; }
 	};
 
 class Exec_True : public Walker_Restrict::Exec
@@ -52,6 +71,10 @@ class Exec_True : public Walker_Restrict::Exec
 public:
 	virtual bool Call(const Val_DB* iVars, const Val_DB* iConsts)
 		{ return true; }
+
+	virtual size_t Select(const Val_DB* iRows, size_t iStride, const Val_DB* iConsts,
+		size_t* ioSelection, size_t iCount)
+		{ return iCount; }
 	};
 
 class Exec_Not : public Walker_Restrict::Exec
@@ -87,6 +110,13 @@ public:
 	virtual bool Call(const Val_DB* iVars, const Val_DB* iConsts)
 		{ return fLeft->Call(iVars, iConsts) && fRight->Call(iVars, iConsts); }
 
+	virtual size_t Select(const Val_DB* iRows, size_t iStride, const Val_DB* iConsts,
+		size_t* ioSelection, size_t iCount)
+		{
+		return fRight->Select(iRows, iStride, iConsts, ioSelection,
+			fLeft->Select(iRows, iStride, iConsts, ioSelection, iCount));
+		}
+
 	Exec* fLeft;
 	Exec* fRight;
 	};
@@ -123,6 +153,22 @@ public:
 		{}
 
 	virtual bool Call(const Val_DB* iVars, const Val_DB* iConsts)
+		{ return this->pCall(iVars, iConsts); }
+
+	virtual size_t Select(const Val_DB* iRows, size_t iStride, const Val_DB* iConsts,
+		size_t* ioSelection, size_t iCount)
+		{
+		size_t result = 0;
+		for (size_t xx = 0; xx < iCount; ++xx)
+			{
+			const size_t theRow = ioSelection[xx];
+			if (this->pCall(iRows + theRow * iStride, iConsts))
+				ioSelection[result++] = theRow;
+			}
+		return result;
+		}
+
+	bool pCall(const Val_DB* iVars, const Val_DB* iConsts) const
 		{
 		if (UseLeftVar_p)
 			{
@@ -436,5 +482,41 @@ bool Walker_Restrict::QReadInc(Val_DB* ioResults)
 		}
 	}
 
+size_t Walker_Restrict::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	const Val_DB* theConsts = sFirstOrNil(fConsts);
+
+	if (fSelection.size() < iCount)
+		fSelection.resize(iCount);
+
+	size_t result = 0;
+	while (result < iCount)
+		{
+		Val_DB* theRows = ioRows + result * iStride;
+		const size_t theWanted = iCount - result;
+		const size_t theRead = fWalker->QReadBatch(theRows, iStride, theWanted);
+
+		for (size_t xx = 0; xx < theRead; ++xx)
+			fSelection[xx] = xx;
+
+		const size_t theKept = fExec->Select(theRows, iStride, theConsts, &fSelection[0], theRead);
+
+		// fSelection is ascending, so moving each kept row down never disturbs a later one.
+		for (size_t xx = 0; xx < theKept; ++xx)
+			{
+			if (fSelection[xx] != xx)
+				sSwapRows(theRows, iStride, fSelection[xx], xx);
+			}
+		result += theKept;
+
+		if (theRead < theWanted)
+			break;
+		}
+
+	return result;
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
@@ -27,6 +27,8 @@ public:
 
 	virtual bool QReadInc(Val_DB* ioResults);
 
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 	class Exec;
 
 private:
@@ -35,6 +37,7 @@ private:
 
 	std::vector<Val_DB> fConsts;
 	Exec* fExec;
+	std::vector<size_t> fSelection;
 	};
 
 } // namespace QueryEngine
@@ -53,5 +53,17 @@ bool Walker_Result::QReadInc(Val_DB* oResults)
 	return true;
 	}
 
+size_t Walker_Result::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	const size_t theWidth = fResult->GetRelHead().size();
+	const size_t result = std::min(iCount, fResult->Count() - std::min(fIndex, fResult->Count()));
+	for (size_t xx = 0; xx < result; ++xx)
+		std::copy_n(fResult->GetValsAt(fIndex++), theWidth, ioRows + xx * iStride + fBaseOffset);
+
+	return result;
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
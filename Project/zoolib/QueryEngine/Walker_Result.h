@@ -29,6 +29,8 @@ public:
 
 	virtual bool QReadInc(Val_DB* oResults);
 
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 	ZP<Result> fResult;
 	size_t fIndex;
 	size_t fBaseOffset;
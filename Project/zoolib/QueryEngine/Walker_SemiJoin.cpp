@@ -0,0 +1,221 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#include "zoolib/QueryEngine/Walker_SemiJoin.h"
+
+#include "zoolib/Compare_T.h"
+#include "zoolib/Util_STL_map.h"
+
+#include "zoolib/ZMACRO_foreach.h"
+
+namespace ZooLib {
+namespace QueryEngine {
+
+using std::map;
+using std::vector;
+
+using namespace Util_STL;
+
+// =================================================================================================
+#pragma mark - Helpers (anonymous)
+
+namespace { // anonymous
+
+const size_t kRowsPerBatch = 256;
+
+} // anonymous namespace
+
+// =================================================================================================
+#pragma mark - Walker_SemiJoin
+
+Walker_SemiJoin::Walker_SemiJoin(const ZP<Walker>& iWalker_Left, const ZP<Walker>& iWalker_Right,
+	bool iKeepFound,
+	const ZQ<std::set<string8>>& iNames_BoundQ)
+:	fKeepFound(iKeepFound)
+,	fNames_BoundQ(iNames_BoundQ)
+,	fRewound(false)
+,	fWalker_Left(iWalker_Left)
+,	fWalker_Right(iWalker_Right)
+,	fWidth(0)
+,	fLoaded(false)
+	{}
+
+Walker_SemiJoin::~Walker_SemiJoin()
+	{}
+
+void Walker_SemiJoin::Rewind()
+	{
+	this->Called_Rewind();
+	fWalker_Left->Rewind();
+	fWalker_Right->Rewind();
+
+	// Keep fRows_Right, unless the bound values turn out to have changed.
+	fRewound = fLoaded;
+	}
+
+ZP<Walker> Walker_SemiJoin::Prime(
+	const map<string8,size_t>& iOffsets,
+	map<string8,size_t>& oOffsets,
+	size_t& ioBaseOffset)
+	{
+	map<string8,size_t> leftOffsets;
+	fWalker_Left = fWalker_Left->Prime(iOffsets, leftOffsets, ioBaseOffset);
+	oOffsets.insert(leftOffsets.begin(), leftOffsets.end());
+
+	if (not fWalker_Left)
+		return null;
+
+	map<string8,size_t> rightOffsets;
+	fWalker_Right = fWalker_Right->Prime(iOffsets, rightOffsets, ioBaseOffset);
+
+	// Nothing is found in an empty right, so we keep all of the left or none of it.
+	if (not fWalker_Right)
+		return fKeepFound ? null : fWalker_Left;
+
+	size_t count = leftOffsets.size();
+	ZAssert(count == rightOffsets.size());
+
+	fMapping_Left.clear();
+	fMapping_Right.clear();
+	for (map<string8,size_t>::const_iterator iterLeft = leftOffsets.begin(),
+		iterRight = rightOffsets.begin();
+		count--; ++iterLeft, ++iterRight)
+		{
+		ZAssert(iterLeft->first == iterRight->first);
+		fMapping_Left.push_back(iterLeft->second);
+		fMapping_Right.push_back(iterRight->second);
+		}
+
+	fBound_Offsets.clear();
+	if (fNames_BoundQ)
+		{
+		foreacha (entry, *fNames_BoundQ)
+			{
+			if (const size_t* theP = sPGet(iOffsets, entry))
+				fBound_Offsets.push_back(*theP);
+			}
+		}
+	else
+		{
+		foreacha (entry, iOffsets)
+			fBound_Offsets.push_back(entry.second);
+		}
+
+	fSubset.resize(fMapping_Left.size());
+	fRows_Right = RowSet(fMapping_Right.size());
+	fLoaded = false;
+	fWidth = ioBaseOffset;
+
+	return this;
+	}
+
+bool Walker_SemiJoin::QReadInc(Val_DB* ioResults)
+	{
+	this->Called_QReadInc();
+
+	if (not fLoaded || this->pBoundChanged(ioResults))
+		this->pLoad(ioResults);
+
+	const size_t count = fMapping_Left.size();
+
+	for (;;)
+		{
+		if (not fWalker_Left->QReadInc(ioResults))
+			return false;
+
+		for (size_t xx = 0; xx < count; ++xx)
+			fSubset[xx] = ioResults[fMapping_Left[xx]];
+
+		if (fKeepFound == fRows_Right.Contains(fSubset.data()))
+			return true;
+		}
+	}
+
+size_t Walker_SemiJoin::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	if (not fLoaded || this->pBoundChanged(ioRows))
+		this->pLoad(ioRows);
+
+	const size_t count = fMapping_Left.size();
+
+	size_t result = 0;
+	while (result < iCount)
+		{
+		Val_DB* theRows = ioRows + result * iStride;
+		const size_t theWanted = iCount - result;
+		const size_t theRead = fWalker_Left->QReadBatch(theRows, iStride, theWanted);
+
+		// Keep the rows we want, moving them down to close the gaps.
+		size_t theKept = 0;
+		for (size_t xx = 0; xx < theRead; ++xx)
+			{
+			const Val_DB* theRow = theRows + xx * iStride;
+			for (size_t yy = 0; yy < count; ++yy)
+				fSubset[yy] = theRow[fMapping_Left[yy]];
+
+			if (fKeepFound == fRows_Right.Contains(fSubset.data()))
+				{
+				if (theKept != xx)
+					sSwapRows(theRows, iStride, xx, theKept);
+				++theKept;
+				}
+			}
+		result += theKept;
+
+		if (theRead < theWanted)
+			break;
+		}
+
+	return result;
+	}
+
+bool Walker_SemiJoin::pBoundChanged(const Val_DB* iRow)
+	{
+	if (not fRewound)
+		return false;
+
+	fRewound = false;
+	for (size_t xx = 0; xx < fBound_Offsets.size(); ++xx)
+		{
+		if (0 != sCompare_T(iRow[fBound_Offsets[xx]], fBound[xx]))
+			return true;
+		}
+	return false;
+	}
+
+void Walker_SemiJoin::pLoad(const Val_DB* iRow)
+	{
+	fLoaded = true;
+	fRewound = false;
+	fRows_Right.Clear();
+
+	fBound.clear();
+	foreacha (entry, fBound_Offsets)
+		fBound.push_back(iRow[entry]);
+
+	// Every row handed to the right must hold the values bound outside of us, which are
+	// in iRow somewhere below fWidth.
+	vector<Val_DB> theRows(fWidth * kRowsPerBatch);
+	for (size_t xx = 0; xx < kRowsPerBatch; ++xx)
+		std::copy_n(iRow, fWidth, theRows.begin() + xx * fWidth);
+
+	const size_t count = fMapping_Right.size();
+	for (;;)
+		{
+		const size_t theRead = fWalker_Right->QReadBatch(theRows.data(), fWidth, kRowsPerBatch);
+		for (size_t xx = 0; xx < theRead; ++xx)
+			{
+			const Val_DB* theRow = theRows.data() + xx * fWidth;
+			for (size_t yy = 0; yy < count; ++yy)
+				fSubset[yy] = theRow[fMapping_Right[yy]];
+			fRows_Right.Insert(fSubset.data());
+			}
+
+		if (theRead < kRowsPerBatch)
+			break;
+		}
+	}
+
+} // namespace QueryEngine
+} // namespace ZooLib
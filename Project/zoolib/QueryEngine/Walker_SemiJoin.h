@@ -0,0 +1,84 @@
+// Copyright (c) 2026 Andrew Green. MIT License. http://www.zoolib.org
+
+#ifndef __ZooLib_QueryEngine_Walker_SemiJoin_h__
+#define __ZooLib_QueryEngine_Walker_SemiJoin_h__ 1
+#include "zconfig.h"
+
+#include "zoolib/QueryEngine/Walker.h"
+
+#include <set>
+#include <vector>
+
+namespace ZooLib {
+namespace QueryEngine {
+
+// =================================================================================================
+#pragma mark - Walker_SemiJoin
+
+// The left's rows that are (iKeepFound) or are not among the right's, the two having the same
+// names. So an intersect keeps what's found, and a difference what isn't. The right's rows
+// are read into a RowSet before the first of ours is returned, and each of the left's is then
+// looked up in it.
+//
+// iNames_BoundQ are the names from outside us that the right uses, or null if they're not
+// known, in which case all of them are taken to be. The RowSet survives a Rewind, and is
+// rebuilt only if the values bound to those names have changed since it was built.
+
+class Walker_SemiJoin : public Walker
+	{
+public:
+	Walker_SemiJoin(const ZP<Walker>& iWalker_Left, const ZP<Walker>& iWalker_Right,
+		bool iKeepFound,
+		const ZQ<std::set<string8>>& iNames_BoundQ);
+	virtual ~Walker_SemiJoin();
+
+// From QueryEngine::Walker
+	virtual void Rewind();
+
+	virtual ZP<Walker> Prime(
+		const std::map<string8,size_t>& iOffsets,
+		std::map<string8,size_t>& oOffsets,
+		size_t& ioBaseOffset);
+
+	virtual bool QReadInc(Val_DB* ioResults);
+
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
+// Our protocol
+	ZP<Walker> GetLeft()
+		{ return fWalker_Left; }
+
+	ZP<Walker> GetRight()
+		{ return fWalker_Right; }
+
+	bool GetKeepFound()
+		{ return fKeepFound; }
+
+private:
+	void pLoad(const Val_DB* iRow);
+
+	bool pBoundChanged(const Val_DB* iRow);
+
+	const bool fKeepFound;
+	const ZQ<std::set<string8>> fNames_BoundQ;
+
+	// Where the bound values are, and what they were when fRows_Right was built.
+	std::vector<size_t> fBound_Offsets;
+	std::vector<Val_DB> fBound;
+	bool fRewound;
+
+	ZP<Walker> fWalker_Left;
+	std::vector<size_t> fMapping_Left;
+	std::vector<Val_DB> fSubset;
+
+	ZP<Walker> fWalker_Right;
+	std::vector<size_t> fMapping_Right;
+	size_t fWidth;
+	bool fLoaded;
+	RowSet fRows_Right;
+	};
+
+} // namespace QueryEngine
+} // namespace ZooLib
+
+#endif // __ZooLib_QueryEngine_Walker_SemiJoin_h__
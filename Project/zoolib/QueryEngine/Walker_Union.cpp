@@ -6,7 +6,6 @@ namespace ZooLib {
 namespace QueryEngine {
 
 using std::map;
-using std::set;
 using std::vector;
 
 // =================================================================================================
@@ -27,7 +26,7 @@ void Walker_Union::Rewind()
 	fExhaustedLeft = false;
 	fWalker_Left->Rewind();
 	fWalker_Right->Rewind();
-	fPriors.clear();
+	fPriors.Clear();
 	}
 
 ZP<Walker> Walker_Union::Prime(
@@ -68,6 +67,9 @@ ZP<Walker> Walker_Union::Prime(
 		*iterMappingRight++ = (iterRight++)->second;
 		}
 
+	fSubset.resize(fMapping_Left.size());
+	fPriors = RowSet(fMapping_Left.size());
+
 	return this;
 	}
 
@@ -79,16 +81,14 @@ bool Walker_Union::QReadInc(Val_DB* ioResults)
 
 	for (;;)
 		{
-		vector<Val_DB> subset;
-		subset.reserve(count);
 		if (not fExhaustedLeft)
 			{
 			if (fWalker_Left->QReadInc(ioResults))
 				{
 				for (size_t xx = 0; xx < count; ++xx)
-					subset.push_back(ioResults[fMapping_Left[xx]]);
+					fSubset[xx] = ioResults[fMapping_Left[xx]];
 
-				Util_STL::sInsertMust(fPriors, subset);
+				fPriors.Insert(fSubset.data());
 				return true;
 				}
 			fExhaustedLeft = true;
@@ -98,16 +98,74 @@ bool Walker_Union::QReadInc(Val_DB* ioResults)
 			return false;
 
 		for (size_t xx = 0; xx < count; ++xx)
-			subset.push_back(ioResults[fMapping_Right[xx]]);
+			fSubset[xx] = ioResults[fMapping_Right[xx]];
 
-		if (not Util_STL::sContains(fPriors, subset))
+		if (not fPriors.Contains(fSubset.data()))
 			{
 			for (size_t xx = 0; xx < count; ++xx)
-				ioResults[fMapping_Left[xx]] = subset[xx];
+				ioResults[fMapping_Left[xx]] = fSubset[xx];
 			return true;
 			}
 		}
 	}
 
+size_t Walker_Union::QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount)
+	{
+	this->Called_QReadBatch();
+
+	const size_t count = fMapping_Left.size();
+
+	size_t result = 0;
+	if (not fExhaustedLeft)
+		{
+		result = fWalker_Left->QReadBatch(ioRows, iStride, iCount);
+		for (size_t xx = 0; xx < result; ++xx)
+			{
+			const Val_DB* theRow = ioRows + xx * iStride;
+			for (size_t yy = 0; yy < count; ++yy)
+				fSubset[yy] = theRow[fMapping_Left[yy]];
+			fPriors.Insert(fSubset.data());
+			}
+
+		if (result == iCount)
+			return result;
+
+		fExhaustedLeft = true;
+		}
+
+	while (result < iCount)
+		{
+		Val_DB* theRows = ioRows + result * iStride;
+		const size_t theWanted = iCount - result;
+		const size_t theRead = fWalker_Right->QReadBatch(theRows, iStride, theWanted);
+
+		// Keep the rows the left didn't produce, with their values where the left's would be,
+		// moving them down to close the gaps.
+		size_t theKept = 0;
+		for (size_t xx = 0; xx < theRead; ++xx)
+			{
+			Val_DB* theRow = theRows + xx * iStride;
+			for (size_t yy = 0; yy < count; ++yy)
+				fSubset[yy] = theRow[fMapping_Right[yy]];
+
+			if (not fPriors.Contains(fSubset.data()))
+				{
+				for (size_t yy = 0; yy < count; ++yy)
+					theRow[fMapping_Left[yy]] = fSubset[yy];
+
+				if (theKept != xx)
+					sSwapRows(theRows, iStride, xx, theKept);
+				++theKept;
+				}
+			}
+		result += theKept;
+
+		if (theRead < theWanted)
+			break;
+		}
+
+	return result;
+	}
+
 } // namespace QueryEngine
 } // namespace ZooLib
@@ -29,6 +29,8 @@ public:
 
 	virtual bool QReadInc(Val_DB* ioResults);
 
+	virtual size_t QReadBatch(Val_DB* ioRows, size_t iStride, size_t iCount);
+
 // Our protocol
 	ZP<Walker> GetLeft()
 		{ return fWalker_Left; }
@@ -39,7 +41,8 @@ public:
 private:
 	ZP<Walker> fWalker_Left;
 	bool fExhaustedLeft;
-	std::set<std::vector<Val_DB>> fPriors;
+	RowSet fPriors;
+	std::vector<Val_DB> fSubset;
 	std::vector<size_t> fMapping_Left;
 
 	ZP<Walker> fWalker_Right;
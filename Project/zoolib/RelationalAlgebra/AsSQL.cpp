@@ -28,6 +28,7 @@ namespace ZooLib {
 namespace RelationalAlgebra {
 
 using std::map;
+using std::vector;
 using namespace Util_STL;
 
 // =================================================================================================
@@ -252,14 +253,23 @@ class ToStrim_SQL
 ,	public virtual ZVisitor_Expr_Bool_ValPred
 	{
 public:
+	ToStrim_SQL(vector<Val_DB>* ioParams);
+
 	virtual void Visit_Expr_Bool_True(const ZP<ZExpr_Bool_True>& iRep);
 	virtual void Visit_Expr_Bool_False(const ZP<ZExpr_Bool_False>& iRep);
 	virtual void Visit_Expr_Bool_Not(const ZP<ZExpr_Bool_Not>& iRep);
 	virtual void Visit_Expr_Bool_And(const ZP<ZExpr_Bool_And>& iRep);
 	virtual void Visit_Expr_Bool_Or(const ZP<ZExpr_Bool_Or>& iRep);
 	virtual void Visit_Expr_Bool_ValPred(const ZP<ZExpr_Bool_ValPred>& iRep);
+
+private:
+	vector<Val_DB>* fParams;
 	};
 
+ToStrim_SQL::ToStrim_SQL(vector<Val_DB>* ioParams)
+:	fParams(ioParams)
+	{}
+
 void ToStrim_SQL::Visit_Expr_Bool_True(const ZP<ZExpr_Bool_True>& iRep)
 	{ pStrimW() << "1"; }
 
@@ -380,7 +390,21 @@ static void spToStrim_SimpleValue(const ChanW_UTF& s, const Any& iAny)
 static void spWrite_PropName(const string8& iName, const ChanW_UTF& s)
 	{ s << iName; }
 
-static void spToStrim(const ZP<ZValComparand>& iComparand, const ChanW_UTF& s)
+static void spToStrim_Const(const ChanW_UTF& s, const Any& iAny, vector<Val_DB>* ioParams)
+	{
+	if (not ioParams)
+		{
+		spToStrim_SimpleValue(s, iAny);
+		}
+	else
+		{
+		s << "?";
+		ioParams->push_back(iAny.As<Val_DB>());
+		}
+	}
+
+static void spToStrim(const ZP<ZValComparand>& iComparand, const ChanW_UTF& s,
+	vector<Val_DB>* ioParams)
 	{
 	if (not iComparand)
 		{
@@ -393,7 +417,7 @@ static void spToStrim(const ZP<ZValComparand>& iComparand, const ChanW_UTF& s)
 	else if (ZP<ZValComparand_Const_Any> asConst =
 		iComparand.DynamicCast<ZValComparand_Const_Any>())
 		{
-		spToStrim_SimpleValue(s, asConst->GetVal());
+		spToStrim_Const(s, asConst->GetVal(), ioParams);
 		}
 	else
 		{
@@ -401,12 +425,12 @@ static void spToStrim(const ZP<ZValComparand>& iComparand, const ChanW_UTF& s)
 		}
 	}
 
-void spToStrim(const ZValPred& iValPred, const ChanW_UTF& s)
+void spToStrim(const ZValPred& iValPred, const ChanW_UTF& s, vector<Val_DB>* ioParams)
 	{
 	if (ZP<ZValComparator_Simple> asSimple =
 		iValPred.GetComparator().DynamicCast<ZValComparator_Simple>())
 		{
-		spToStrim(iValPred.GetLHS(), s);
+		spToStrim(iValPred.GetLHS(), s, ioParams);
 		switch (asSimple->GetEComparator())
 			{
 			case ZValComparator_Simple::eLT:
@@ -440,7 +464,7 @@ void spToStrim(const ZValPred& iValPred, const ChanW_UTF& s)
 				break;
 				}
 			}
-		spToStrim(iValPred.GetRHS(), s);
+		spToStrim(iValPred.GetRHS(), s, ioParams);
 		}
 	else if (ZP<ZValComparator_StringContains> asStringContains =
 		iValPred.GetComparator().DynamicCast<ZValComparator_StringContains>())
@@ -454,6 +478,12 @@ void spToStrim(const ZValPred& iValPred, const ChanW_UTF& s)
 					{
 					spWrite_PropName(asName->GetName(), s);
 					s << " LIKE ";
+					if (ioParams)
+						{
+						s << "?";
+						ioParams->push_back(Val_DB("%" + *asString + "%"));
+						return;
+						}
 					ZStrimW_Escaped::Options theOptions;
 					theOptions.fQuoteQuotes = true;
 					theOptions.fEscapeHighUnicode = false;
@@ -473,7 +503,7 @@ void spToStrim(const ZValPred& iValPred, const ChanW_UTF& s)
 	}
 
 void ToStrim_SQL::Visit_Expr_Bool_ValPred(const ZP<ZExpr_Bool_ValPred>& iRep)
-	{ spToStrim(iRep->GetValPred(), pStrimW()); }
+	{ spToStrim(iRep->GetValPred(), pStrimW(), fParams); }
 
 } // anonymous namespace
 
@@ -481,7 +511,12 @@ void ToStrim_SQL::Visit_Expr_Bool_ValPred(const ZP<ZExpr_Bool_ValPred>& iRep)
 #pragma mark - RelationalAlgebra::sWriteAsSQL
 
 bool sWriteAsSQL(const map<string8,RelHead>& iTables, ZP<Expr_Rel> iRel, const ZStrimW& s)
+	{ return sWriteAsSQL(iTables, iRel, s, nullptr); }
+
+bool sWriteAsSQL(const map<string8,RelHead>& iTables, ZP<Expr_Rel> iRel, const ZStrimW& s,
+	vector<Val_DB>* oParams)
 	{
+	const size_t theParamCount = oParams ? oParams->size() : 0;
 	try
 		{
 		Analyzer theAnalyzer(iTables);
@@ -531,7 +566,7 @@ bool sWriteAsSQL(const map<string8,RelHead>& iTables, ZP<Expr_Rel> iRel, const Z
 
 		s << " WHERE ";
 
-		ToStrim_SQL().ToStrim(ToStrim_SQL::Options(), s, theAnalysis.fCondition);
+		ToStrim_SQL(oParams).ToStrim(ToStrim_SQL::Options(), s, theAnalysis.fCondition);
 
 		s << ";";
 		return true;
@@ -539,6 +574,9 @@ bool sWriteAsSQL(const map<string8,RelHead>& iTables, ZP<Expr_Rel> iRel, const Z
 	catch (...)
 		{}
 
+	if (oParams)
+		oParams->resize(theParamCount);
+
 	return false;
 	}
 
@@ -5,11 +5,13 @@
 #include "zconfig.h"
 
 #include "zoolib/ChanW_UTF.h"
+#include "zoolib/Val_DB.h"
 
 #include "zoolib/RelationalAlgebra/Expr_Rel.h"
 #include "zoolib/RelationalAlgebra/RelHead.h"
 
 #include <map>
+#include <vector>
 
 namespace ZooLib {
 namespace RelationalAlgebra {
@@ -19,6 +21,11 @@ namespace RelationalAlgebra {
 
 bool sWriteAsSQL(const std::map<string8,RelHead>& iTables, ZP<Expr_Rel> iRel, const ChanW_UTF& w);
 
+// Writes a '?' for each constant in the condition, and appends its value to oParams, so the
+// SQL text is the same for queries differing only in their constants.
+bool sWriteAsSQL(const std::map<string8,RelHead>& iTables, ZP<Expr_Rel> iRel, const ChanW_UTF& w,
+	std::vector<Val_DB>* oParams);
+
 } // namespace RelationalAlgebra
 } // namespace ZooLib
 
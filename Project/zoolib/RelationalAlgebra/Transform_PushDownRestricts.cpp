@@ -29,6 +29,10 @@ void Transform_PushDownRestricts::Visit_Expr_Rel_Concrete(const ZP<Expr_Rel_Conc
 void Transform_PushDownRestricts::Visit_Expr_Rel_Const(const ZP<Expr_Rel_Const>& iExpr)
 	{ this->pHandleIt(sRelHead(iExpr->GetColName()), iExpr); }
 
+void Transform_PushDownRestricts::Visit_Expr_Rel_Difference(
+	const ZP<Expr_Rel_Difference>& iExpr)
+	{ this->pHandleMatching(iExpr); }
+
 void Transform_PushDownRestricts::Visit_Expr_Rel_Embed(const ZP<Expr_Rel_Embed>& iExpr)
 	{
 	// I think this needs to work in a fashion akin to product, because we may have a restrict
@@ -41,6 +45,9 @@ void Transform_PushDownRestricts::Visit_Expr_Rel_Embed(const ZP<Expr_Rel_Embed>&
 	this->pHandleIt(sRelHead(iExpr->GetColName()), iExpr->SelfOrClone(newOp0, newOp1));
 	}
 
+void Transform_PushDownRestricts::Visit_Expr_Rel_Intersect(const ZP<Expr_Rel_Intersect>& iExpr)
+	{ this->pHandleMatching(iExpr); }
+
 void Transform_PushDownRestricts::Visit_Expr_Rel_Product(const ZP<Expr_Rel_Product>& iExpr)
 	{
 	RelHead priorRelHead = fRelHead;
@@ -184,6 +191,9 @@ void Transform_PushDownRestricts::Visit_Expr_Rel_Restrict(const ZP<Expr_Rel_Rest
 	}
 
 void Transform_PushDownRestricts::Visit_Expr_Rel_Union(const ZP<Expr_Rel_Union>& iExpr)
+	{ this->pHandleMatching(iExpr); }
+
+void Transform_PushDownRestricts::pHandleMatching(const ZP<Expr_Op2_T<Expr_Rel>>& iExpr)
 	{
 	const RelHead priorRelHead = fRelHead;
 
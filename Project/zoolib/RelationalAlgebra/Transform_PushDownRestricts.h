@@ -9,7 +9,9 @@
 #include "zoolib/RelationalAlgebra/Expr_Rel_Calc.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Concrete.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Const.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Difference.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Embed.h"
+#include "zoolib/RelationalAlgebra/Expr_Rel_Intersect.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Product.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Rename.h"
 #include "zoolib/RelationalAlgebra/Expr_Rel_Restrict.h"
@@ -28,7 +30,9 @@ class Transform_PushDownRestricts
 ,	public virtual Visitor_Expr_Rel_Calc
 ,	public virtual Visitor_Expr_Rel_Concrete
 ,	public virtual Visitor_Expr_Rel_Const
+,	public virtual Visitor_Expr_Rel_Difference
 ,	public virtual Visitor_Expr_Rel_Embed
+,	public virtual Visitor_Expr_Rel_Intersect
 ,	public virtual Visitor_Expr_Rel_Product
 ,	public virtual Visitor_Expr_Rel_Rename
 ,	public virtual Visitor_Expr_Rel_Restrict
@@ -39,7 +43,9 @@ public:
 	virtual void Visit_Expr_Rel_Calc(const ZP<Expr_Rel_Calc>& iExpr);
 	virtual void Visit_Expr_Rel_Concrete(const ZP<Expr_Rel_Concrete>& iExpr);
 	virtual void Visit_Expr_Rel_Const(const ZP<Expr_Rel_Const>& iExpr);
+	virtual void Visit_Expr_Rel_Difference(const ZP<Expr_Rel_Difference>& iExpr);
 	virtual void Visit_Expr_Rel_Embed(const ZP<Expr_Rel_Embed>& iExpr);
+	virtual void Visit_Expr_Rel_Intersect(const ZP<Expr_Rel_Intersect>& iExpr);
 	virtual void Visit_Expr_Rel_Product(const ZP<Expr_Rel_Product>& iExpr);
 	virtual void Visit_Expr_Rel_Rename(const ZP<Expr_Rel_Rename>& iExpr);
 	virtual void Visit_Expr_Rel_Restrict(const ZP<Expr_Rel_Restrict>& iExpr);
@@ -48,6 +54,10 @@ public:
 protected:
 	void pHandleIt(const RelHead& iRH, const ZP<Expr_Rel>& iRel);
 
+	// Union, difference and intersect, whose operands have the same relhead. A restriction
+	// can go down both branches of each.
+	void pHandleMatching(const ZP<Expr_Op2_T<Expr_Rel>>& iExpr);
+
 	struct Restrict
 		{
 		ZP<Expr_Bool> fExpr_Bool;
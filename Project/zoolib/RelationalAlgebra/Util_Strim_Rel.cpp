@@ -162,6 +162,10 @@ void Visitor::Visit_Expr_Rel_Search(const ZP<QueryEngine::Expr_Rel_Search>& iExp
 	this->pWriteLFIndent();
 	this->pToStrim(iExpr->GetExpr_Bool());
 	ww << ")";
+
+	// Written as a comment, so it's skipped when read back.
+	if (const ZQ<QueryEngine::Estimate>& theEstimateQ = iExpr->GetEstimateQ())
+		ww << " /*" << *theEstimateQ << "*/";
 	}
 
 void Visitor::pWriteBinary(